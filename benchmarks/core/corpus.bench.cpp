@@ -0,0 +1,88 @@
+/**
+ * @file corpus.bench.cpp
+ */
+
+#include <algorithm>    // for std::sort
+#include <cstddef>      // for std::size_t
+#include <filesystem>   // for std::filesystem
+#include <format>       // for std::format
+#include <fstream>      // for std::ifstream
+#include <iterator>     // for std::istreambuf_iterator
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <vector>       // for std::vector
+
+#include "core/text.hpp"
+#include "harness.hpp"
+
+#ifndef UNGPT_BENCHMARK_CORPUS_DIR
+#define UNGPT_BENCHMARK_CORPUS_DIR "benchmarks/corpus"
+#endif
+
+namespace {
+
+/**
+ * @brief Size of the text built from the corpus (16 MiB).
+ */
+constexpr std::size_t TEXT_SIZE = 16 * 1024 * 1024;
+
+/**
+ * @brief Build a large text by repeating every file of the bundled corpus, in name order.
+ *
+ * @return Generated text, about "TEXT_SIZE" bytes long.
+ *
+ * @throws std::runtime_error if the corpus directory is missing or empty.
+ */
+[[nodiscard]] std::string load_corpus()
+{
+    std::vector<std::filesystem::path> paths;
+    for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator{UNGPT_BENCHMARK_CORPUS_DIR}) {
+        if (entry.is_regular_file()) {
+            paths.push_back(entry.path());
+        }
+    }
+    if (paths.empty()) [[unlikely]] {
+        throw std::runtime_error(std::format("No corpus files in '{}'", UNGPT_BENCHMARK_CORPUS_DIR));
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::string corpus;
+    for (const std::filesystem::path &path : paths) {
+        std::ifstream stream{path, std::ios::binary};
+        corpus.append(std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{});
+        corpus.push_back('\n');
+    }
+
+    return benchmarks::harness::repeat_text(corpus, TEXT_SIZE);
+}
+
+}  // namespace
+
+BENCHMARK(corpus)
+{
+    // LLM transcripts, code review, and CJK meeting notes, which is also what the PGO training run feeds the normalizer
+    const std::string text = load_corpus();
+
+    runner.measure("corpus/remove_unwanted_characters (all rules)", text.size(), [&text] {
+        std::string copy = text;
+        core::text::remove_unwanted_characters(copy, {.remove_ai_disclaimers = true, .remove_markdown_bold = true, .trim_trailing_whitespace = true});
+        benchmarks::harness::do_not_optimize(copy.data());
+    });
+
+    runner.measure("corpus/count_words", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::text::count_words(text));
+    });
+
+    // The CJK notes go through the UAX #29 segmenter, the rest mostly through its ASCII fast path
+    runner.measure("corpus/compute_stats (1 thread, segment words)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::text::compute_stats(text, 1, true).words);
+    });
+
+    runner.measure("corpus/count_characters", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::text::count_characters(text));
+    });
+
+    runner.measure("corpus/estimate_tokens", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::text::estimate_tokens(text));
+    });
+}
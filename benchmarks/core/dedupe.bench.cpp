@@ -0,0 +1,56 @@
+/**
+ * @file dedupe.bench.cpp
+ */
+
+#include <cstddef>  // for std::size_t
+#include <string>   // for std::string
+
+#include "core/dedupe.hpp"
+#include "harness.hpp"
+
+namespace {
+
+/**
+ * @brief Size of the generated text (16 MiB).
+ */
+constexpr std::size_t TEXT_SIZE = 16 * 1024 * 1024;
+
+/**
+ * @brief Build distinct paragraphs in the style of a transcript pasted over many turns, half as long as the benchmarked text, so every paragraph appears twice once repeated.
+ *
+ * @return Distinct paragraphs, about "TEXT_SIZE / 2" bytes long.
+ */
+[[nodiscard]] std::string make_answers()
+{
+    std::string answers;
+    for (std::size_t i = 0; answers.size() < TEXT_SIZE / 2; ++i) {
+        answers += "Answer ";
+        answers += std::to_string(i);
+        answers += ": the river keeps flowing under the old bridge,\nwhile the lanterns slowly fade into the quiet morning light over the hills.\n\n";
+    }
+    return answers;
+}
+
+}  // namespace
+
+BENCHMARK(dedupe)
+{
+    const std::string text = benchmarks::harness::repeat_text(make_answers(), TEXT_SIZE);
+
+    runner.measure("dedupe/find_duplicates (paragraphs, 1 thread)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::dedupe::find_duplicates(text, {.thread_count = 1}).size());
+    });
+
+    runner.measure("dedupe/find_duplicates (paragraphs)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::dedupe::find_duplicates(text).size());
+    });
+
+    runner.measure("dedupe/find_duplicates (lines)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::dedupe::find_duplicates(text, {.unit = core::dedupe::Unit::Line}).size());
+    });
+
+    // MinHash signatures cost about one hash per word and MinHash function, so this is the slow path
+    runner.measure("dedupe/find_duplicates (near-duplicates)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::dedupe::find_duplicates(text, {.near_duplicate_threshold = 0.8}).size());
+    });
+}
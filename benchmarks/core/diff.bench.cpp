@@ -0,0 +1,55 @@
+/**
+ * @file diff.bench.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "core/diff.hpp"
+#include "core/text.hpp"
+#include "harness.hpp"
+
+namespace {
+
+/**
+ * @brief Paragraph in the style of a chat transcript, with smart punctuation, bold markers and trailing spaces.
+ */
+constexpr std::string_view PARAGRAPH =
+    "As an AI language model, I can’t browse the web — but here’s a **summary** of the topic…  \n"
+    "The “quick” brown fox jumps over the lazy dog; the river keeps flowing under the old bridge.\n"
+    "Zażółć gęślą jaźń, während die Grüße aus Berlin kommen → alles gut.\t\n";
+
+}  // namespace
+
+BENCHMARK(diff)
+{
+    constexpr core::text::CleanupOptions all_rules{.remove_ai_disclaimers = true, .remove_markdown_bold = true, .trim_trailing_whitespace = true};
+
+    // The preview takes its change list straight from the rule engine
+    const std::string text = benchmarks::harness::repeat_text(PARAGRAPH, 16 * 1024 * 1024);
+    runner.measure("diff/find_changes (all rules)", text.size(), [&text, &all_rules] {
+        benchmarks::harness::do_not_optimize(core::text::find_changes(text, all_rules).size());
+    });
+
+    const std::vector<core::diff::Change> changes = core::text::find_changes(text, all_rules);
+    runner.measure("diff/apply_changes", text.size(), [&text, &changes] {
+        benchmarks::harness::do_not_optimize(core::diff::apply_changes(text, changes).size());
+    });
+
+    // The generic fallback only sees the text before and after, with a change every few dozen bytes
+    const std::string before = benchmarks::harness::repeat_text(PARAGRAPH, 256 * 1024);
+    std::string after = before;
+    core::text::remove_unwanted_characters(after, all_rules);
+    runner.measure("diff/compute_changes (dense edits)", before.size(), [&before, &after] {
+        benchmarks::harness::do_not_optimize(core::diff::compute_changes(before, after).size());
+    });
+
+    // A single edit in a large text is found after trimming the common prefix and suffix
+    std::string edited = text;
+    edited[edited.size() / 2] = '#';
+    runner.measure("diff/compute_changes (single edit)", text.size(), [&text, &edited] {
+        benchmarks::harness::do_not_optimize(core::diff::compute_changes(text, edited).size());
+    });
+}
@@ -0,0 +1,82 @@
+/**
+ * @file encoding.bench.cpp
+ */
+
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "core/encoding.hpp"
+#include "harness.hpp"
+
+namespace {
+
+/**
+ * @brief Size of the generated texts (64 MiB).
+ */
+constexpr std::size_t TEXT_SIZE = 64 * 1024 * 1024;
+
+/**
+ * @brief Serialize UTF-16 code units as little-endian bytes.
+ *
+ * @param units Code units to serialize (e.g., u"hi").
+ *
+ * @return UTF-16LE bytes (e.g., "h\0i\0").
+ */
+[[nodiscard]] std::string to_utf16_le(const std::u16string_view units)
+{
+    std::string bytes;
+    for (const char16_t unit : units) {
+        bytes.push_back(static_cast<char>(unit & 0xFF));
+        bytes.push_back(static_cast<char>(unit >> 8));
+    }
+    return bytes;
+}
+
+/**
+ * @brief Transcode a text one block at a time, as "core::encoding::load_file()" does.
+ *
+ * @param bytes Bytes to transcode.
+ * @param encoding Encoding of the bytes.
+ * @param output String that receives the UTF-8 text, reused between runs.
+ */
+void decode_in_blocks(const std::string_view bytes,
+                      const core::encoding::Encoding encoding,
+                      std::string &output)
+{
+    output.clear();
+    core::encoding::Decoder decoder{encoding};
+    for (std::size_t position = 0; position < bytes.size(); position += core::encoding::BLOCK_SIZE) {
+        decoder.decode(bytes.substr(position, std::min(core::encoding::BLOCK_SIZE, bytes.size() - position)), output);
+    }
+    decoder.finish(output);
+}
+
+}  // namespace
+
+BENCHMARK(encoding)
+{
+    std::string output;
+    output.reserve(TEXT_SIZE * 2);
+
+    const std::string english = benchmarks::harness::repeat_text(to_utf16_le(u"The quick brown fox jumps over the lazy dog; the river keeps flowing under the old bridge.\r\n"), TEXT_SIZE);
+    runner.measure("encoding/decode (UTF-16LE, English)", english.size(), [&english, &output] {
+        decode_in_blocks(english, core::encoding::Encoding::Utf16Le, output);
+        benchmarks::harness::do_not_optimize(output.size());
+    });
+
+    const std::string polish = benchmarks::harness::repeat_text(to_utf16_le(u"Zażółć gęślą jaźń, źdźbło trawy i łąka pełna żółtych kwiatów.\r\n"), TEXT_SIZE);
+    runner.measure("encoding/decode (UTF-16LE, Polish)", polish.size(), [&polish, &output] {
+        decode_in_blocks(polish, core::encoding::Encoding::Utf16Le, output);
+        benchmarks::harness::do_not_optimize(output.size());
+    });
+
+    // Word processor output with curly quotes, dashes, and ellipses in Windows-1252
+    const std::string windows_1252 = benchmarks::harness::repeat_text("As an AI language model, I can\x92t browse the web \x97 but here\x92s a summary\x85\r\n"
+                                                                      "The \x93quick\x94 brown fox jumps over the lazy dog; the river keeps flowing under the old bridge.\r\n", TEXT_SIZE);
+    runner.measure("encoding/decode (Windows-1252)", windows_1252.size(), [&windows_1252, &output] {
+        decode_in_blocks(windows_1252, core::encoding::Encoding::Windows1252, output);
+        benchmarks::harness::do_not_optimize(output.size());
+    });
+}
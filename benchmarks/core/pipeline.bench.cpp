@@ -0,0 +1,69 @@
+/**
+ * @file pipeline.bench.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "core/pipeline.hpp"
+#include "core/text.hpp"
+#include "harness.hpp"
+
+namespace {
+
+/**
+ * @brief Size of the generated text (16 MiB).
+ */
+constexpr std::size_t TEXT_SIZE = 16 * 1024 * 1024;
+
+/**
+ * @brief Paragraph with Windows line endings, smart punctuation, invisible characters and runs of spaces.
+ */
+constexpr std::string_view PARAGRAPH =
+    "Here’s a “summary” of the topic — it​s short,  but  useful.\r\n"
+    "The quick brown fox jumps over the lazy dog; the river keeps flowing under the old bridge.\r\n"
+    "Zażółć gęślą jaźń, während die Grüße aus Berlin kommen − alles gut.\t\r\n";
+
+}  // namespace
+
+BENCHMARK(pipeline)
+{
+    const std::string text = benchmarks::harness::repeat_text(PARAGRAPH, TEXT_SIZE);
+    std::string output;
+    std::string scratch;
+
+    // A single stage is the cost of one pass
+    runner.measure("pipeline/run (fold quotes)", text.size(), [&text, &output] {
+        static_cast<void>(core::pipeline::run(text, {.fold_quotes = true}, output));
+        benchmarks::harness::do_not_optimize(output.data());
+    });
+
+    // Five fused stages should cost close to one pass, as the text is decoded and written once
+    runner.measure("pipeline/run (5 stages fused)", text.size(), [&text, &output] {
+        static_cast<void>(core::pipeline::run(text, {.normalize_line_endings = true, .strip_invisible = true, .fold_quotes = true, .fold_dashes = true, .collapse_spaces = true}, output));
+        benchmarks::harness::do_not_optimize(output.data());
+    });
+
+    // The same five stages as separate whole-buffer passes, for comparison
+    runner.measure("pipeline/run (5 stages chained)", text.size(), [&text, &output, &scratch] {
+        static_cast<void>(core::pipeline::run(text, {.normalize_line_endings = true}, output));
+        static_cast<void>(core::pipeline::run(output, {.strip_invisible = true}, scratch));
+        static_cast<void>(core::pipeline::run(scratch, {.fold_quotes = true}, output));
+        static_cast<void>(core::pipeline::run(output, {.fold_dashes = true}, scratch));
+        static_cast<void>(core::pipeline::run(scratch, {.collapse_spaces = true}, output));
+        benchmarks::harness::do_not_optimize(output.data());
+    });
+
+    // The normalizer runs the stages that its rules cannot express after them, in one more pass
+    runner.measure("text/remove_unwanted_characters (rules only)", text.size(), [&text] {
+        std::string copy = text;
+        core::text::remove_unwanted_characters(copy);
+        benchmarks::harness::do_not_optimize(copy.data());
+    });
+    runner.measure("text/remove_unwanted_characters (rules + 2 stages)", text.size(), [&text] {
+        std::string copy = text;
+        core::text::remove_unwanted_characters(copy, {.normalize_line_endings = true, .collapse_whitespace = true});
+        benchmarks::harness::do_not_optimize(copy.data());
+    });
+}
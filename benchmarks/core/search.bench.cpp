@@ -0,0 +1,54 @@
+/**
+ * @file search.bench.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "core/search.hpp"
+#include "harness.hpp"
+
+namespace {
+
+/**
+ * @brief Size of the generated text (100 MiB).
+ */
+constexpr std::size_t TEXT_SIZE = 100 * 1024 * 1024;
+
+/**
+ * @brief Paragraph with a match roughly every 320 bytes.
+ */
+constexpr std::string_view PARAGRAPH =
+    "The quick brown fox jumps over the lazy dog while the river keeps flowing under the old stone bridge. "
+    "Meanwhile, in a distant town, a baker prepares fresh bread for the morning market and hums a tune. "
+    "As an AI language model, I cannot taste the bread, but the smell reportedly reaches the square.\n";
+
+}  // namespace
+
+BENCHMARK(search)
+{
+    const std::string text = benchmarks::harness::repeat_text(PARAGRAPH, TEXT_SIZE);
+
+    runner.measure("search/count_matches (case-sensitive)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::search::count_matches(text, "As an AI language model", true));
+    });
+
+    runner.measure("search/count_matches (case-insensitive)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::search::count_matches(text, "as an ai language model", false));
+    });
+
+    runner.measure("search/count_matches (no match)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::search::count_matches(text, "nonexistent phrase", true));
+    });
+
+    runner.measure("search/replace_all", text.size(), [&text] {
+        std::string copy = text;
+        benchmarks::harness::do_not_optimize(core::search::replace_all(copy, "As an AI language model, I", "I"));
+    });
+
+    runner.measure("search/copy (baseline for replace_all)", text.size(), [&text] {
+        const std::string copy = text;
+        benchmarks::harness::do_not_optimize(copy.data());
+    });
+}
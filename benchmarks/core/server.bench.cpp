@@ -0,0 +1,67 @@
+/**
+ * @file server.bench.cpp
+ */
+
+#if defined(__linux__)
+
+#include <cstddef>     // for std::size_t
+#include <cstdio>      // for std::fputs, stdout
+#include <filesystem>  // for std::filesystem
+#include <format>      // for std::format
+#include <string>      // for std::string
+#include <thread>      // for std::jthread
+
+#include "core/client.hpp"
+#include "core/protocol.hpp"
+#include "core/server.hpp"
+#include "harness.hpp"
+
+namespace {
+
+/**
+ * @brief Snippet sent with every request, in the style of a short chat reply.
+ */
+constexpr const char *SNIPPET = "As an AI language model, I can’t browse the web — but here’s a “summary” of the topic…\n";
+
+/**
+ * @brief Number of requests pipelined in a single measured run.
+ */
+constexpr std::size_t PIPELINED_REQUESTS = 1000;
+
+}  // namespace
+
+BENCHMARK(server)
+{
+    const std::filesystem::path socket_path = std::filesystem::temp_directory_path() / "ungpt-bench.sock";
+    core::server::Server server{socket_path};
+    std::jthread serving{[&server] { server.run(); }};
+
+    {
+        core::client::Client client{socket_path};
+        const std::string snippet = SNIPPET;
+        runner.measure(std::format("server/normalize ({} pipelined requests)", PIPELINED_REQUESTS), snippet.size() * PIPELINED_REQUESTS, [&client, &snippet] {
+            for (std::size_t i = 0; i < PIPELINED_REQUESTS; ++i) {
+                client.send(core::protocol::Opcode::Normalize, snippet);
+            }
+            for (std::size_t i = 0; i < PIPELINED_REQUESTS; ++i) {
+                benchmarks::harness::do_not_optimize(client.receive());
+            }
+        });
+    }
+
+    // Latency under load, without and with pipelining
+    for (const std::size_t pipeline_depth : {std::size_t{1}, std::size_t{16}}) {
+        const core::client::LoadTestReport report = core::client::run_load_test({
+            .socket_path = socket_path,
+            .connections = 4,
+            .requests_per_connection = 20000,
+            .pipeline_depth = pipeline_depth,
+            .payload = SNIPPET,
+        });
+        std::fputs(std::format("  server/load test (4 connections, depth {}): {}\n", pipeline_depth, report.summary()).c_str(), stdout);
+    }
+
+    server.stop();
+}
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file text.bench.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "core/text.hpp"
+#include "harness.hpp"
+
+namespace {
+
+/**
+ * @brief Size of the generated text (16 MiB).
+ */
+constexpr std::size_t TEXT_SIZE = 16 * 1024 * 1024;
+
+/**
+ * @brief Paragraph in the style of a chat transcript, with smart punctuation, bold markers and trailing spaces.
+ */
+constexpr std::string_view PARAGRAPH =
+    "As an AI language model, I can’t browse the web — but here’s a **summary** of the topic…  \n"
+    "The “quick” brown fox jumps over the lazy dog; the river keeps flowing under the old bridge.\n"
+    "Zażółć gęślą jaźń, während die Grüße aus Berlin kommen → alles gut.\t\n";
+
+}  // namespace
+
+BENCHMARK(text)
+{
+    const std::string text = benchmarks::harness::repeat_text(PARAGRAPH, TEXT_SIZE);
+
+    runner.measure("text/remove_unwanted_characters (default)", text.size(), [&text] {
+        std::string copy = text;
+        core::text::remove_unwanted_characters(copy);
+        benchmarks::harness::do_not_optimize(copy.data());
+    });
+
+    runner.measure("text/remove_unwanted_characters (all rules)", text.size(), [&text] {
+        std::string copy = text;
+        core::text::remove_unwanted_characters(copy, {.remove_ai_disclaimers = true, .remove_markdown_bold = true, .trim_trailing_whitespace = true});
+        benchmarks::harness::do_not_optimize(copy.data());
+    });
+
+    // Same work as above, but written straight into a preallocated buffer, as the C interface does
+    std::string output(text.size() * 2, '\0');
+    runner.measure("text/normalize_into (default)", text.size(), [&text, &output] {
+        benchmarks::harness::do_not_optimize(core::text::normalize_into(text, output.data(), output.size()));
+    });
+
+    // Prose without code pays only for the scan that looks for code and URLs
+    runner.measure("text/normalize_into (preserve code)", text.size(), [&text, &output] {
+        benchmarks::harness::do_not_optimize(core::text::normalize_into(text, output.data(), output.size(), {.preserve_code = true}));
+    });
+
+    runner.measure("text/count_words", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::text::count_words(text));
+    });
+
+    // Every statistic of the status bar in one pass, on one thread and on all of them
+    runner.measure("text/compute_stats (1 thread)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::text::compute_stats(text, 1).words);
+    });
+
+    runner.measure("text/compute_stats", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::text::compute_stats(text).words);
+    });
+
+    // Latin text should take the segmenter's ASCII fast path almost everywhere
+    runner.measure("text/compute_stats (1 thread, segment words)", text.size(), [&text] {
+        benchmarks::harness::do_not_optimize(core::text::compute_stats(text, 1, true).words);
+    });
+}
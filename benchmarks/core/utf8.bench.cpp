@@ -0,0 +1,44 @@
+/**
+ * @file utf8.bench.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+
+#include "core/utf8.hpp"
+#include "harness.hpp"
+
+namespace {
+
+/**
+ * @brief Size of the generated texts (64 MiB).
+ */
+constexpr std::size_t TEXT_SIZE = 64 * 1024 * 1024;
+
+}  // namespace
+
+BENCHMARK(utf8)
+{
+    const std::string ascii = benchmarks::harness::repeat_text("The quick brown fox jumps over the lazy dog; the river keeps flowing under the old bridge.\n", TEXT_SIZE);
+    runner.measure("utf8/find_invalid (ASCII)", ascii.size(), [&ascii] {
+        benchmarks::harness::do_not_optimize(core::utf8::find_invalid(ascii));
+    });
+
+    const std::string chat = benchmarks::harness::repeat_text("As an AI language model, I can’t browse the web — but here’s a **summary** of the topic…\n"
+                                                              "The “quick” brown fox jumps over the lazy dog; the river keeps flowing under the old bridge.\n", TEXT_SIZE);
+    runner.measure("utf8/find_invalid (mostly ASCII)", chat.size(), [&chat] {
+        benchmarks::harness::do_not_optimize(core::utf8::find_invalid(chat));
+    });
+
+    const std::string polish = benchmarks::harness::repeat_text("Zażółć gęślą jaźń, źdźbło trawy i łąka pełna żółtych kwiatów.\n", TEXT_SIZE);
+    runner.measure("utf8/find_invalid (Polish)", polish.size(), [&polish] {
+        benchmarks::harness::do_not_optimize(core::utf8::find_invalid(polish));
+    });
+
+    // Terminal copy-paste that cut a multi-byte character in half every line
+    const std::string broken = benchmarks::harness::repeat_text("The “quick” brown fox jumps over the lazy dog \xE2\x80\n", TEXT_SIZE);
+    runner.measure("utf8/repair (broken)", broken.size(), [&broken] {
+        std::string copy = broken;
+        benchmarks::harness::do_not_optimize(core::utf8::repair(copy));
+    });
+}
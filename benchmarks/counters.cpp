@@ -0,0 +1,204 @@
+/**
+ * @file counters.cpp
+ */
+
+#include <array>         // for std::array
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint32_t, std::uint64_t
+#include <format>        // for std::format
+#include <optional>      // for std::optional
+#include <string>        // for std::string
+#include <system_error>  // for std::error_code, std::system_category
+#include <utility>       // for std::pair
+
+#if defined(__linux__)
+#include <cerrno>              // for errno
+#include <linux/perf_event.h>  // for perf_event_attr, PERF_* constants
+#include <sys/ioctl.h>         // for ioctl
+#include <sys/syscall.h>       // for SYS_perf_event_open
+#include <unistd.h>            // for syscall, read, close
+#endif
+
+#include "counters.hpp"
+
+namespace benchmarks::counters {
+
+namespace {
+
+/**
+ * @brief Format a count in millions.
+ *
+ * @param value Count, or std::nullopt if it is not available.
+ *
+ * @return Formatted count (e.g., "  42.10 M"), or "n/a".
+ */
+[[nodiscard]] std::string format_millions(const std::optional<double> value)
+{
+    return value ? std::format("{:8.2f} M", *value / 1e6) : std::format("{:>10}", "n/a");
+}
+
+/**
+ * @brief Format a ratio.
+ *
+ * @param numerator Numerator, or std::nullopt if it is not available.
+ * @param denominator Denominator, or std::nullopt if it is not available.
+ *
+ * @return Formatted ratio (e.g., "  3.12"), or "n/a" if either value is missing or the denominator is 0.
+ */
+[[nodiscard]] std::string format_ratio(const std::optional<double> numerator,
+                                       const std::optional<double> denominator)
+{
+    if (!numerator || !denominator || *denominator <= 0.0) {
+        return std::format("{:>6}", "n/a");
+    }
+    return std::format("{:6.2f}", *numerator / *denominator);
+}
+
+#if defined(__linux__)
+
+/**
+ * @brief Kind and configuration of an event for "perf_event_open", indexed by "Event".
+ */
+constexpr std::array<std::pair<std::uint32_t, std::uint64_t>, EVENT_COUNT> EVENT_CONFIGS = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16)},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+}};
+
+/**
+ * @brief Value read from an event opened with "PERF_FORMAT_TOTAL_TIME_ENABLED" and "PERF_FORMAT_TOTAL_TIME_RUNNING".
+ */
+struct ReadFormat {
+    /**
+     * @brief Count while the event was on the CPU.
+     */
+    std::uint64_t value = 0;
+
+    /**
+     * @brief Time the event was enabled, in nanoseconds.
+     */
+    std::uint64_t time_enabled = 0;
+
+    /**
+     * @brief Time the event was actually counting, in nanoseconds; less than "time_enabled" if the kernel multiplexed it with other events.
+     */
+    std::uint64_t time_running = 0;
+};
+
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+
+Counters::Counters()
+{
+    this->fds_.fill(-1);
+    for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = EVENT_CONFIGS[i].first;
+        attributes.config = EVENT_CONFIGS[i].second;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attributes.disabled = 1;
+        attributes.inherit = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+
+        // There is no glibc wrapper; the calling thread on any CPU, without a group
+        const long fd = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (fd < 0) {
+            if (this->error_.empty()) {
+                this->error_ = std::error_code{errno, std::system_category()}.message();
+            }
+            continue;
+        }
+        this->fds_[i] = static_cast<int>(fd);
+    }
+}
+
+Counters::~Counters()
+{
+    for (const int fd : this->fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void Counters::start()
+{
+    for (const int fd : this->fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+Sample Counters::stop(const std::size_t runs)
+{
+    for (const int fd : this->fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    Sample sample;
+    for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+        ReadFormat counts;
+        if (this->fds_[i] < 0 || read(this->fds_[i], &counts, sizeof(counts)) != static_cast<ssize_t>(sizeof(counts)) || counts.time_running == 0) {
+            continue;
+        }
+        // Extrapolate to the whole time if the event shared its hardware counter with others
+        const double scale = static_cast<double>(counts.time_enabled) / static_cast<double>(counts.time_running);
+        sample.values[i] = static_cast<double>(counts.value) * scale / static_cast<double>(runs == 0 ? 1 : runs);
+    }
+    return sample;
+}
+
+#else
+
+Counters::Counters()
+    : error_("Hardware counters are only supported on Linux")
+{
+    this->fds_.fill(-1);
+}
+
+Counters::~Counters() = default;
+
+void Counters::start() {}
+
+Sample Counters::stop(const std::size_t)
+{
+    return {};
+}
+
+#endif
+
+bool Counters::is_available() const
+{
+    for (const int fd : this->fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string format(const Sample &sample,
+                   const std::size_t bytes)
+{
+    const std::optional<double> cycles = sample[Event::Cycles];
+    return std::format("IPC {}   {} bytes/cycle   {} cycles   {} branch misses   {} LLC loads   {} LLC misses",
+                       format_ratio(sample[Event::Instructions], cycles),
+                       format_ratio(bytes == 0 ? std::nullopt : std::optional<double>{static_cast<double>(bytes)}, cycles),
+                       format_millions(cycles),
+                       format_millions(sample[Event::BranchMisses]),
+                       format_millions(sample[Event::CacheLoads]),
+                       format_millions(sample[Event::CacheMisses]));
+}
+
+}  // namespace benchmarks::counters
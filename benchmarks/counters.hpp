@@ -0,0 +1,149 @@
+/**
+ * @file counters.hpp
+ *
+ * @brief Optional hardware performance counters for the benchmark harness (Linux "perf_event_open" only).
+ */
+
+#pragma once
+
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+
+namespace benchmarks::counters {
+
+/**
+ * @brief Hardware event counted during a measurement.
+ */
+enum class Event : std::size_t {
+    /**
+     * @brief CPU cycles.
+     */
+    Cycles,
+
+    /**
+     * @brief Retired instructions.
+     */
+    Instructions,
+
+    /**
+     * @brief Mispredicted branches.
+     */
+    BranchMisses,
+
+    /**
+     * @brief Loads that reached the last-level cache.
+     */
+    CacheLoads,
+
+    /**
+     * @brief Loads that missed the last-level cache and went to memory.
+     */
+    CacheMisses,
+};
+
+/**
+ * @brief Number of values of "Event".
+ */
+inline constexpr std::size_t EVENT_COUNT = 5;
+
+/**
+ * @brief Counts of a single run, averaged over the timed runs of a measurement.
+ */
+struct Sample {
+    /**
+     * @brief Count of every event, indexed by "Event", or std::nullopt if the event is not supported or was never scheduled.
+     */
+    std::array<std::optional<double>, EVENT_COUNT> values{};
+
+    /**
+     * @brief Return the count of an event.
+     *
+     * @param event Event to look up (e.g., "Event::Cycles").
+     *
+     * @return Count per run, or std::nullopt if it is not available.
+     */
+    [[nodiscard]] std::optional<double> operator[](const Event event) const
+    {
+        return this->values[static_cast<std::size_t>(event)];
+    }
+};
+
+/**
+ * @brief Counters of the calling thread and the threads it starts while counting.
+ *
+ * Every event is opened on its own, so an event that the CPU or the kernel does not offer (e.g., last-level cache loads in a virtual machine) only leaves that value empty. Only user-space work is counted, which "perf_event_paranoid" up to 2 allows. Threads that already run when counting starts (e.g., a pool created outside of the measured operation) are not counted.
+ */
+class Counters final {
+  public:
+    /**
+     * @brief Construct a new Counters object and open every event that is permitted.
+     *
+     * Failures are not thrown, they leave the events closed; see "is_available()" and "error()".
+     */
+    Counters();
+
+    /**
+     * @brief Close every event.
+     */
+    ~Counters();
+
+    Counters(const Counters &) = delete;
+    Counters &operator=(const Counters &) = delete;
+
+    /**
+     * @brief Return whether any event could be opened.
+     *
+     * @return True if at least one event counts, false if none is permitted (e.g., in a container without "perf_event_open").
+     */
+    [[nodiscard]] bool is_available() const;
+
+    /**
+     * @brief Return why the first event could not be opened.
+     *
+     * @return Error message (e.g., "Operation not permitted"), or an empty string if every event was opened.
+     */
+    [[nodiscard]] const std::string &error() const
+    {
+        return this->error_;
+    }
+
+    /**
+     * @brief Reset every event to zero and start counting.
+     */
+    void start();
+
+    /**
+     * @brief Stop counting and return the counts.
+     *
+     * @param runs Number of runs since "start()" (e.g., "10"), which the counts are divided by.
+     *
+     * @return Counts per run, scaled up if the kernel had to multiplex the events.
+     */
+    [[nodiscard]] Sample stop(const std::size_t runs);
+
+  private:
+    /**
+     * @brief File descriptor of every event, indexed by "Event", or -1 if it could not be opened.
+     */
+    std::array<int, EVENT_COUNT> fds_;
+
+    /**
+     * @brief Why the first event could not be opened, or an empty string.
+     */
+    std::string error_;
+};
+
+/**
+ * @brief Format the counts of a measurement, with the ratios derived from them.
+ *
+ * @param sample Counts per run.
+ * @param bytes Number of bytes processed by a single run, or 0 if bytes per cycle are meaningless.
+ *
+ * @return Counts without a trailing newline (e.g., "IPC   3.12   1.85 bytes/cycle   ..."); unavailable values are shown as "n/a".
+ */
+[[nodiscard]] std::string format(const Sample &sample,
+                                 const std::size_t bytes);
+
+}  // namespace benchmarks::counters
@@ -0,0 +1,198 @@
+/**
+ * @file harness.cpp
+ */
+
+#include <algorithm>    // for std::sort
+#include <chrono>       // for std::chrono::steady_clock, std::chrono::duration
+#include <cstddef>      // for std::size_t
+#include <cstdio>       // for std::fputs, stdout
+#include <cstdlib>      // for EXIT_FAILURE, EXIT_SUCCESS
+#include <exception>    // for std::exception
+#include <format>       // for std::format
+#include <functional>   // for std::function
+#include <memory>       // for std::unique_ptr, std::make_unique
+#include <span>         // for std::span
+#include <string>       // for std::string, std::stoul
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::move
+#include <vector>       // for std::vector
+
+#include "counters.hpp"
+#include "harness.hpp"
+
+namespace benchmarks::harness {
+
+namespace {
+
+/**
+ * @brief Registered benchmark.
+ */
+struct Registration {
+    /**
+     * @brief Name of the benchmark.
+     */
+    std::string_view name;
+
+    /**
+     * @brief Function that performs the measurements.
+     */
+    benchmark_function_t function;
+};
+
+/**
+ * @brief Return the registry, constructed on first use so registration order across translation units does not matter.
+ *
+ * @return Reference to the registry.
+ */
+[[nodiscard]] std::vector<Registration> &registry()
+{
+    static std::vector<Registration> benchmarks;
+    return benchmarks;
+}
+
+}  // namespace
+
+Runner::Runner(const std::size_t iterations,
+               counters::Counters *counters)
+    : iterations_(iterations == 0 ? 1 : iterations),
+      counters_(counters)
+{
+}
+
+void Runner::measure(const std::string_view name,
+                     const std::size_t bytes,
+                     const std::function<void()> &operation)
+{
+    // Warm up caches and the allocator
+    operation();
+
+    std::vector<double> times_ms;
+    times_ms.reserve(this->iterations_);
+    if (this->counters_ != nullptr) {
+        this->counters_->start();
+    }
+    for (std::size_t i = 0; i < this->iterations_; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        operation();
+        const auto end = std::chrono::steady_clock::now();
+        times_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    const counters::Sample sample = this->counters_ != nullptr ? this->counters_->stop(this->iterations_) : counters::Sample{};
+    std::sort(times_ms.begin(), times_ms.end());
+
+    Result result{
+        .name = std::string{name},
+        .median_ms = times_ms[times_ms.size() / 2],
+        .min_ms = times_ms.front(),
+        .bytes = bytes,
+        .counters = sample,
+    };
+
+    std::string line = std::format("{:<40} median {:10.3f} ms   min {:10.3f} ms", result.name, result.median_ms, result.min_ms);
+    if (result.bytes != 0 && result.median_ms > 0.0) {
+        const double megabytes_per_second = (static_cast<double>(result.bytes) / (1024.0 * 1024.0)) / (result.median_ms / 1000.0);
+        line += std::format("   {:10.1f} MB/s", megabytes_per_second);
+    }
+    line += '\n';
+
+    // Counts are averaged over the timed runs, so they match the median rather than the fastest run
+    if (this->counters_ != nullptr) {
+        line += std::format("{:<40} {}\n", "", counters::format(result.counters, result.bytes));
+    }
+    std::fputs(line.c_str(), stdout);
+
+    this->results_.push_back(std::move(result));
+}
+
+bool register_benchmark(const std::string_view name,
+                        const benchmark_function_t function)
+{
+    registry().push_back({name, function});
+    return true;
+}
+
+std::size_t run_benchmarks(const std::string_view filter,
+                           const std::size_t iterations,
+                           const bool use_counters)
+{
+    // Without permission (e.g., in a container), say so once and only measure time
+    std::unique_ptr<counters::Counters> counters;
+    if (use_counters) {
+        counters = std::make_unique<counters::Counters>();
+        if (!counters->is_available()) {
+            std::fputs(std::format("Hardware counters are unavailable ({}), measuring time only\n", counters->error()).c_str(), stdout);
+            counters.reset();
+        }
+        else if (!counters->error().empty()) {
+            std::fputs(std::format("Some hardware counters are unavailable ({}), they are shown as n/a\n", counters->error()).c_str(), stdout);
+        }
+    }
+
+    std::size_t count = 0;
+    for (const Registration &registration : registry()) {
+        if (!filter.empty() && registration.name.find(filter) == std::string_view::npos) {
+            continue;
+        }
+        std::fputs(std::format("[{}]\n", registration.name).c_str(), stdout);
+        Runner runner{iterations, counters.get()};
+        registration.function(runner);
+        ++count;
+    }
+    return count;
+}
+
+std::string repeat_text(const std::string_view paragraph,
+                        const std::size_t size)
+{
+    std::string text;
+    if (paragraph.empty()) [[unlikely]] {
+        return text;
+    }
+    text.reserve(size + paragraph.size());
+    while (text.size() < size) {
+        text.append(paragraph);
+    }
+    return text;
+}
+
+}  // namespace benchmarks::harness
+
+/**
+ * @brief Entry-point of the benchmark executable.
+ *
+ * Usage: "benchmarks [--counters] [filter] [iterations]", e.g., "benchmarks --counters text 20".
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ *
+ * @return EXIT_SUCCESS if at least one benchmark ran, EXIT_FAILURE otherwise.
+ */
+int main(int argc,
+         char *argv[])
+{
+    try {
+        // Take "--counters" from anywhere, so the filter and the number of runs keep their positions
+        const std::span<char *const> all_arguments{argv, static_cast<std::size_t>(argc)};
+        std::vector<std::string_view> arguments;
+        bool use_counters = false;
+        for (const char *argument : all_arguments.subspan(all_arguments.empty() ? 0 : 1)) {
+            if (std::string_view{argument} == "--counters") {
+                use_counters = true;
+            }
+            else {
+                arguments.emplace_back(argument);
+            }
+        }
+        const std::string_view filter = !arguments.empty() ? arguments[0] : "";
+        const std::size_t iterations = arguments.size() > 1 ? std::stoul(std::string{arguments[1]}) : 10;
+        if (benchmarks::harness::run_benchmarks(filter, iterations, use_counters) == 0) {
+            std::fputs(std::format("No benchmark matches '{}'\n", filter).c_str(), stdout);
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception &e) {
+        std::fputs(std::format("Benchmark failed: {}\n", e.what()).c_str(), stdout);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file harness.hpp
+ *
+ * @brief Minimal benchmark harness: registration, repeated timing, and throughput reporting.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <functional>   // for std::function
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "counters.hpp"
+
+namespace benchmarks::harness {
+
+/**
+ * @brief Result of a single measured operation.
+ */
+struct Result {
+    /**
+     * @brief Name of the measured operation (e.g., "search/find_all").
+     */
+    std::string name;
+
+    /**
+     * @brief Median wall-clock time of a single run, in milliseconds.
+     */
+    double median_ms = 0.0;
+
+    /**
+     * @brief Fastest wall-clock time of a single run, in milliseconds.
+     */
+    double min_ms = 0.0;
+
+    /**
+     * @brief Number of bytes processed by a single run, used to compute throughput (0 if not applicable).
+     */
+    std::size_t bytes = 0;
+
+    /**
+     * @brief Hardware counts of a single run, empty unless counters were requested and permitted.
+     */
+    counters::Sample counters{};
+};
+
+/**
+ * @brief Runs and reports measurements for a single benchmark.
+ */
+class Runner final {
+  public:
+    /**
+     * @brief Construct a new Runner object.
+     *
+     * @param iterations Number of timed runs per measurement (e.g., "10"), preceded by one untimed warm-up run.
+     * @param counters Hardware counters to read around the timed runs, or nullptr to only measure time.
+     */
+    explicit Runner(const std::size_t iterations,
+                    counters::Counters *counters = nullptr);
+
+    /**
+     * @brief Time an operation and record the result.
+     *
+     * @param name Name of the operation (e.g., "search/find_all").
+     * @param bytes Number of bytes processed by a single run (e.g., "104857600"), or 0 if throughput is meaningless.
+     * @param operation Operation to time; it must produce the same work on every call.
+     */
+    void measure(const std::string_view name,
+                 const std::size_t bytes,
+                 const std::function<void()> &operation);
+
+    /**
+     * @brief Return all recorded results.
+     *
+     * @return Results in the order they were measured.
+     */
+    [[nodiscard]] const std::vector<Result> &results() const
+    {
+        return this->results_;
+    }
+
+  private:
+    /**
+     * @brief Number of timed runs per measurement.
+     */
+    std::size_t iterations_;
+
+    /**
+     * @brief Hardware counters, or nullptr.
+     */
+    counters::Counters *counters_;
+
+    /**
+     * @brief Recorded results.
+     */
+    std::vector<Result> results_;
+};
+
+/**
+ * @brief Signature of a registered benchmark.
+ */
+using benchmark_function_t = void (*)(Runner &runner);
+
+/**
+ * @brief Register a benchmark, called during static initialization by the "BENCHMARK" macro.
+ *
+ * @param name Name of the benchmark (e.g., "search").
+ * @param function Function that performs the measurements.
+ *
+ * @return Always true, so the call can initialize a static variable.
+ */
+bool register_benchmark(const std::string_view name,
+                        const benchmark_function_t function);
+
+/**
+ * @brief Run every registered benchmark whose name contains the filter and print the results.
+ *
+ * @param filter Substring that benchmark names must contain (e.g., "search"), empty to run everything.
+ * @param iterations Number of timed runs per measurement (e.g., "10").
+ * @param use_counters Whether to also report hardware counters (cycles, instructions, branch misses, and last-level cache loads and misses) for every measurement, if the system permits them.
+ *
+ * @return Number of benchmarks that were run.
+ */
+std::size_t run_benchmarks(const std::string_view filter,
+                           const std::size_t iterations,
+                           const bool use_counters = false);
+
+/**
+ * @brief Build a large input by repeating a paragraph, so a benchmark measures throughput rather than setup.
+ *
+ * @param paragraph Paragraph to repeat (e.g., "hello world\n").
+ * @param size Minimum size of the text, in bytes (e.g., "16777216").
+ *
+ * @return Whole copies of the paragraph, at least "size" bytes long.
+ */
+[[nodiscard]] std::string repeat_text(const std::string_view paragraph,
+                                      const std::size_t size);
+
+/**
+ * @brief Prevent the compiler from optimizing away a value that is otherwise unused.
+ *
+ * @param value Value to keep alive.
+ */
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(_MSC_VER)
+    static_cast<void>(*static_cast<const volatile char *>(static_cast<const void *>(&value)));
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+}  // namespace benchmarks::harness
+
+/**
+ * @brief Define and register a benchmark function.
+ *
+ * @param function_name Identifier of the benchmark, also used as its name (e.g., "search").
+ */
+#define BENCHMARK(function_name)                                                                                                            \
+    static void benchmark_##function_name(benchmarks::harness::Runner &runner);                                                             \
+    [[maybe_unused]] static const bool benchmark_##function_name##_registered = benchmarks::harness::register_benchmark(#function_name, &benchmark_##function_name); \
+    static void benchmark_##function_name(benchmarks::harness::Runner &runner)
@@ -0,0 +1,322 @@
+/**
+ * @file editor.bench.cpp
+ */
+
+#include <algorithm>    // for std::sort, std::min
+#include <array>        // for std::array
+#include <chrono>       // for std::chrono::steady_clock, std::chrono::duration
+#include <cstddef>      // for std::size_t
+#include <cstdio>       // for std::fputs, stdout
+#include <format>       // for std::format
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include <imgui.h>
+
+#include "harness.hpp"
+#include "ui/editor.hpp"
+
+namespace {
+
+/**
+ * @brief Paragraph the documents are made of, with typographic characters for "Normalize" to replace.
+ */
+constexpr std::string_view PARAGRAPH = "As an AI language model, I can’t “browse” the web — but here’s a summary…\n"
+                                       "The quick brown fox jumps over the lazy dog, then rests under the old bridge.\n\n";
+
+/**
+ * @brief Text returned by the clipboard on every paste.
+ */
+constexpr const char *PASTED_TEXT = "Pasted “quote” — with an ellipsis… and a line break\n";
+
+/**
+ * @brief Characters typed one per frame, in a loop.
+ */
+constexpr std::string_view TYPED_TEXT = "The quick brown fox jumps over the lazy dog. ";
+
+/**
+ * @brief Upper bound of the time spent on a single phase, so the largest documents finish in reasonable time.
+ */
+constexpr double PHASE_BUDGET_SECONDS = 5.0;
+
+/**
+ * @brief Number of frames every phase draws even if it exceeds "PHASE_BUDGET_SECONDS".
+ */
+constexpr std::size_t MIN_PHASE_FRAMES = 10;
+
+/**
+ * @brief Document size to benchmark.
+ */
+struct DocumentSize {
+    /**
+     * @brief Size in bytes, rounded up to whole paragraphs.
+     */
+    std::size_t bytes;
+
+    /**
+     * @brief Display name (e.g., "1 MB").
+     */
+    std::string_view label;
+};
+
+/**
+ * @brief Document sizes, from a short chat reply to a large log file.
+ */
+constexpr std::array<DocumentSize, 5> DOCUMENT_SIZES = {{
+    {1024, "1 KB"},
+    {100 * 1024, "100 KB"},
+    {1024 * 1024, "1 MB"},
+    {10 * 1024 * 1024, "10 MB"},
+    {100 * 1024 * 1024, "100 MB"},
+}};
+
+/**
+ * @brief Queue a Ctrl (Cmd on macOS) shortcut; ImGui trickles the releases into the next frame.
+ *
+ * @param io IO to queue the key events on.
+ * @param key Key of the shortcut (e.g., "ImGuiKey_V").
+ * @param shift Whether Shift is held too.
+ */
+void press_shortcut(ImGuiIO &io,
+                    const ImGuiKey key,
+                    const bool shift)
+{
+    io.AddKeyEvent(ImGuiMod_Ctrl, true);
+    if (shift) {
+        io.AddKeyEvent(ImGuiMod_Shift, true);
+    }
+    io.AddKeyEvent(key, true);
+    io.AddKeyEvent(key, false);
+    if (shift) {
+        io.AddKeyEvent(ImGuiMod_Shift, false);
+    }
+    io.AddKeyEvent(ImGuiMod_Ctrl, false);
+}
+
+/**
+ * @brief Scripted input of a phase, queued before each of its frames.
+ */
+struct Phase {
+    /**
+     * @brief Name of the phase (e.g., "typing").
+     */
+    std::string_view name;
+
+    /**
+     * @brief Number of frames to draw, unless "PHASE_BUDGET_SECONDS" runs out first.
+     */
+    std::size_t frames;
+
+    /**
+     * @brief Queue the input of a frame.
+     *
+     * @param io IO to queue the input on.
+     * @param frame Index of the frame within the phase.
+     */
+    void (*queue_input)(ImGuiIO &io,
+                        const std::size_t frame);
+};
+
+/**
+ * @brief Phases of the script, in order; the text widget is focused before "typing" and left before "normalize".
+ */
+constexpr std::array<Phase, 5> PHASES = {{
+    {"idle", 240, [](ImGuiIO &, const std::size_t) {}},
+    {"typing", 600, [](ImGuiIO &io, const std::size_t frame) { io.AddInputCharacter(static_cast<unsigned char>(TYPED_TEXT[frame % TYPED_TEXT.size()])); }},
+    {"paste", 200, [](ImGuiIO &io, const std::size_t frame) {
+         if (frame % 4 == 0) {
+             press_shortcut(io, ImGuiKey_V, false);
+         }
+     }},
+    {"scrolling", 600, [](ImGuiIO &io, const std::size_t frame) { io.AddMouseWheelEvent(0.0f, frame % 200 < 100 ? -1.0f : 1.0f); }},
+    {"normalize", 200, [](ImGuiIO &io, const std::size_t frame) {
+         if (frame % 10 == 0) {
+             press_shortcut(io, ImGuiKey_N, true);
+         }
+     }},
+}};
+
+/**
+ * @brief Cost of a single frame.
+ */
+struct FrameSample {
+    /**
+     * @brief CPU time of "NewFrame()", "update_and_draw()", and "Render()", in milliseconds.
+     */
+    double ms = 0.0;
+
+    /**
+     * @brief Number of vertices submitted to the renderer.
+     */
+    std::size_t vertices = 0;
+
+    /**
+     * @brief Number of draw calls submitted to the renderer.
+     */
+    std::size_t draw_calls = 0;
+};
+
+/**
+ * @brief Headless ImGui context with a built font atlas, a 1280x720 display, and a scripted clipboard, so frames can be drawn without a window or renderer.
+ */
+class HeadlessContext {
+  public:
+    /**
+     * @brief Create the context, with no INI or log file, and Ctrl shortcuts on every platform.
+     */
+    HeadlessContext()
+        : context_(ImGui::CreateContext())
+    {
+        ImGuiIO &io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.LogFilename = nullptr;
+        io.DisplaySize = ImVec2(1280.0f, 720.0f);
+        io.DeltaTime = 1.0f / 60.0f;
+        io.ConfigMacOSXBehaviors = false;
+        unsigned char *pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+        // Paste from a fixed text instead of the system clipboard
+        ImGuiPlatformIO &platform_io = ImGui::GetPlatformIO();
+        platform_io.Platform_GetClipboardTextFn = [](ImGuiContext *) { return PASTED_TEXT; };
+        platform_io.Platform_SetClipboardTextFn = [](ImGuiContext *, const char *) {};
+    }
+
+    /**
+     * @brief Destroy the context.
+     */
+    ~HeadlessContext()
+    {
+        ImGui::DestroyContext(this->context_);
+    }
+
+    HeadlessContext(const HeadlessContext &) = delete;
+    HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+  private:
+    /**
+     * @brief Owned ImGui context.
+     */
+    ImGuiContext *context_;
+};
+
+/**
+ * @brief Draw one frame of the editor and measure it.
+ *
+ * @param editor Editor to draw.
+ *
+ * @return CPU time and draw data of the frame.
+ */
+[[nodiscard]] FrameSample draw_frame(ui::editor::Editor &editor)
+{
+    const auto start = std::chrono::steady_clock::now();
+    ImGui::NewFrame();
+    editor.update_and_draw();
+    ImGui::Render();
+    const auto end = std::chrono::steady_clock::now();
+
+    FrameSample sample{.ms = std::chrono::duration<double, std::milli>(end - start).count()};
+    const ImDrawData *draw_data = ImGui::GetDrawData();
+    sample.vertices = static_cast<std::size_t>(draw_data->TotalVtxCount);
+    for (const ImDrawList *draw_list : draw_data->CmdLists) {
+        sample.draw_calls += static_cast<std::size_t>(draw_list->CmdBuffer.Size);
+    }
+    return sample;
+}
+
+/**
+ * @brief Print the frame time distribution and the average draw data of a phase.
+ *
+ * @param name Name of the measurement (e.g., "editor/typing (1 MB)").
+ * @param samples Samples of the phase, at least one; sorted by frame time in place.
+ */
+void report(const std::string_view name,
+            std::vector<FrameSample> &samples)
+{
+    std::sort(samples.begin(), samples.end(), [](const FrameSample &left, const FrameSample &right) {
+        return left.ms < right.ms;
+    });
+    const auto percentile = [&samples](const std::size_t percent) {
+        return samples[std::min(samples.size() - 1, samples.size() * percent / 100)].ms;
+    };
+    std::size_t vertices = 0;
+    std::size_t draw_calls = 0;
+    for (const FrameSample &sample : samples) {
+        vertices += sample.vertices;
+        draw_calls += sample.draw_calls;
+    }
+    std::fputs(std::format("  {:<30} {:5} frames   p50 {:8.3f} ms   p90 {:8.3f} ms   p99 {:8.3f} ms   max {:8.3f} ms   {:7} vertices   {:3} draw calls\n",
+                           name,
+                           samples.size(),
+                           percentile(50),
+                           percentile(90),
+                           percentile(99),
+                           samples.back().ms,
+                           vertices / samples.size(),
+                           draw_calls / samples.size())
+                   .c_str(),
+               stdout);
+}
+
+}  // namespace
+
+BENCHMARK(editor)
+{
+    for (const DocumentSize &size : DOCUMENT_SIZES) {
+        const std::string document = benchmarks::harness::repeat_text(PARAGRAPH, size.bytes);
+        const HeadlessContext context;
+        std::size_t text_size = 0;
+        ui::editor::Editor editor{{}, [&text_size](const std::size_t, const std::string_view text) { text_size = text.size(); }};
+
+        // Replacing the text includes validating and counting it on the next frame
+        runner.measure(std::format("editor/set_text and first frame ({})", size.label), document.size(), [&editor, &document] {
+            editor.set_text(document);
+            static_cast<void>(draw_frame(editor));
+        });
+
+        ImGuiIO &io = ImGui::GetIO();
+        for (const Phase &phase : PHASES) {
+            // Click into the text widget, so it receives the typed and pasted text and the mouse wheel
+            if (phase.name == "typing") {
+                io.AddMousePosEvent(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f);
+                io.AddMouseButtonEvent(ImGuiMouseButton_Left, true);
+                io.AddMouseButtonEvent(ImGuiMouseButton_Left, false);
+                for (int i = 0; i < 3; ++i) {
+                    static_cast<void>(draw_frame(editor));
+                }
+            }
+
+            // Click the status bar, so "normalize" measures the button path rather than the widget rewriting its own copy
+            if (phase.name == "normalize") {
+                io.AddMousePosEvent(io.DisplaySize.x * 0.5f, io.DisplaySize.y - 2.0f);
+                io.AddMouseButtonEvent(ImGuiMouseButton_Left, true);
+                io.AddMouseButtonEvent(ImGuiMouseButton_Left, false);
+                for (int i = 0; i < 3; ++i) {
+                    static_cast<void>(draw_frame(editor));
+                }
+            }
+            const std::size_t phase_text_size = text_size;
+
+            std::vector<FrameSample> samples;
+            samples.reserve(phase.frames);
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t frame = 0; frame < phase.frames; ++frame) {
+                if (frame >= MIN_PHASE_FRAMES && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > PHASE_BUDGET_SECONDS) [[unlikely]] {
+                    break;
+                }
+                phase.queue_input(io, frame);
+                samples.push_back(draw_frame(editor));
+            }
+            report(std::format("editor/{} ({})", phase.name, size.label), samples);
+
+            // Every paragraph has typographic characters that are longer than their replacements
+            if (phase.name == "normalize" && text_size >= phase_text_size) [[unlikely]] {
+                throw std::runtime_error(std::format("Normalize did not change the text ({})", size.label));
+            }
+        }
+    }
+}
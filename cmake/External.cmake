@@ -1,5 +1,35 @@
 include(FetchContent)
 
+# Download and link the logging dependency only, for targets that must not pull in SFML or ImGui
+function(fetch_and_link_logging_dependencies target)
+  if(NOT TARGET ${target})
+    message(FATAL_ERROR "Target '${target}' does not exist. Cannot fetch and link logging dependencies.")
+  endif()
+
+  set(FETCHCONTENT_UPDATES_DISCONNECTED ON)
+  set(FETCHCONTENT_QUIET OFF)
+  set(FETCHCONTENT_BASE_DIR "${CMAKE_SOURCE_DIR}/deps")
+
+  FetchContent_Declare(
+    spdlog
+    URL https://github.com/gabime/spdlog/archive/refs/tags/v1.15.3.tar.gz
+    DOWNLOAD_EXTRACT_TIMESTAMP TRUE
+    EXCLUDE_FROM_ALL
+    SYSTEM
+  )
+  FetchContent_MakeAvailable(spdlog)
+
+  target_link_libraries(${target} PUBLIC spdlog::spdlog)
+
+  # Set compile-time log level based on the build type
+  # If debug build, set the log level to debug, otherwise keep it default (info)
+  target_compile_definitions(${target} PUBLIC
+    $<$<CONFIG:Debug>:SPDLOG_ACTIVE_LEVEL=SPDLOG_LEVEL_DEBUG>
+  )
+
+  message(STATUS "Linked dependency 'spdlog::spdlog' to target '${target}'.")
+endfunction()
+
 # Download and link base dependencies (graphics, logging, etc.)
 function(fetch_and_link_external_dependencies target)
   if(NOT TARGET ${target})
@@ -48,26 +78,11 @@ function(fetch_and_link_external_dependencies target)
   set(IMGUI_SFML_FIND_SFML OFF)       # Don't call "find_package(SFML)"
   FetchContent_MakeAvailable(imgui-sfml)
 
-  FetchContent_Declare(
-    spdlog
-    URL https://github.com/gabime/spdlog/archive/refs/tags/v1.15.3.tar.gz
-    DOWNLOAD_EXTRACT_TIMESTAMP TRUE
-    EXCLUDE_FROM_ALL
-    SYSTEM
-  )
-  FetchContent_MakeAvailable(spdlog)
-
   # Link dependencies to the target
   target_link_libraries(${target} PUBLIC
     ImGui-SFML::ImGui-SFML  # ImGui-SFML already includes both ImGui and SFML
-    spdlog::spdlog
-  )
-
-  # Set compile-time log level based on the build type
-  # If debug build, set the log level to debug, otherwise keep it default (info)
-  target_compile_definitions(${target} PUBLIC
-    $<$<CONFIG:Debug>:SPDLOG_ACTIVE_LEVEL=SPDLOG_LEVEL_DEBUG>
   )
+  fetch_and_link_logging_dependencies(${target})
 
   # Link SFML::Main for WIN32 targets to manage the WinMain entry point
   # This makes Windows use "main()" instead of "WinMain()", so we can use the same entry point for all platforms
@@ -75,7 +90,7 @@ function(fetch_and_link_external_dependencies target)
     target_link_libraries(${target} PUBLIC SFML::Main)
   endif()
 
-  message(STATUS "Linked dependencies 'ImGui-SFML::ImGui-SFML', and 'spdlog::spdlog' to target '${target}'.")
+  message(STATUS "Linked dependency 'ImGui-SFML::ImGui-SFML' to target '${target}'.")
 endfunction()
 
 # Download and link test dependencies (automated testing)
@@ -0,0 +1,52 @@
+# Profile-guided optimization (PGO) flags for the "ENABLE_PGO" phases
+# GENERATE builds an instrumented binary that writes profiles to "PGO_PROFILE_DIR" when it exits
+# USE rebuilds in the same build directory with those profiles; GCC matches them by object file path, so both phases must share it
+# The whole workflow (baseline, instrumented, training, optimized, report) is driven by "cmake -P cmake/PgoWorkflow.cmake"
+function(apply_pgo_flags target)
+  if(NOT TARGET ${target})
+    message(FATAL_ERROR "Target '${target}' does not exist. Cannot apply PGO flags.")
+  endif()
+
+  if(ENABLE_PGO STREQUAL "OFF")
+    return()
+  endif()
+
+  # The scope is set to PUBLIC so executables linking to this target are instrumented and linked against the profiling runtime
+  if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    if(ENABLE_PGO STREQUAL "GENERATE")
+      target_compile_options(${target} PUBLIC
+        "-fprofile-generate=${PGO_PROFILE_DIR}"  # Instrument the code, write ".gcda" files to the profile directory
+        -fprofile-update=atomic                  # Keep counters exact when the batch workers run the same code
+      )
+      target_link_options(${target} PUBLIC "-fprofile-generate=${PGO_PROFILE_DIR}")
+    else()
+      target_compile_options(${target} PUBLIC
+        "-fprofile-use=${PGO_PROFILE_DIR}"  # Optimize using the ".gcda" files from the training run
+        -fprofile-correction                # Tolerate counters that threads updated inconsistently
+        -Wno-missing-profile                # GUI code is not exercised by the training run, do not fail with "-Werror"
+      )
+      target_link_options(${target} PUBLIC "-fprofile-use=${PGO_PROFILE_DIR}")
+    endif()
+  elseif(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    if(ENABLE_PGO STREQUAL "GENERATE")
+      target_compile_options(${target} PUBLIC "-fprofile-generate=${PGO_PROFILE_DIR}")  # Write ".profraw" files to the profile directory
+      target_link_options(${target} PUBLIC "-fprofile-generate=${PGO_PROFILE_DIR}")
+    else()
+      # Clang cannot read raw profiles, they must be merged with "llvm-profdata" first (the workflow script does that)
+      if(NOT EXISTS "${PGO_PROFILE_DIR}/default.profdata")
+        message(FATAL_ERROR "PGO profile '${PGO_PROFILE_DIR}/default.profdata' does not exist. Run the training and 'llvm-profdata merge' first.")
+      endif()
+      target_compile_options(${target} PUBLIC
+        "-fprofile-use=${PGO_PROFILE_DIR}/default.profdata"  # Optimize using the merged profile
+        -Wno-profile-instr-unprofiled                        # GUI code is not exercised by the training run
+        -Wno-profile-instr-out-of-date                       # Do not fail with "-Werror" after small source edits
+      )
+      target_link_options(${target} PUBLIC "-fprofile-use=${PGO_PROFILE_DIR}/default.profdata")
+    endif()
+  else()
+    message(WARNING "Profile-guided optimization is only supported with GCC and Clang, ignoring ENABLE_PGO=${ENABLE_PGO} for target '${target}'.")
+    return()
+  endif()
+
+  message(STATUS "Applied PGO flags (${ENABLE_PGO}) to target '${target}'.")
+endfunction()
@@ -0,0 +1,136 @@
+# Profile-guided optimization (PGO) workflow, run from the repository root with:
+#   cmake -P cmake/PgoWorkflow.cmake
+# Optional variables (pass them before "-P"): PGO_BUILD_DIR (default "build-pgo"), PGO_ITERATIONS (default 10), CMAKE_CXX_COMPILER
+# 1. Build a regular Release baseline with benchmarks
+# 2. Build an instrumented binary ("ENABLE_PGO=GENERATE")
+# 3. Train it: normalize the bundled corpus headlessly ("ungpt-batch --batch") and run the counters over it ("benchmarks corpus")
+# 4. Rebuild the same directory with the profiles ("ENABLE_PGO=USE"); for Clang, merge the raw profiles with "llvm-profdata" first
+# 5. Run the corpus benchmarks on both builds and report the speedup of every measurement
+cmake_minimum_required(VERSION 3.28)
+
+get_filename_component(SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+if(NOT PGO_BUILD_DIR)
+  set(PGO_BUILD_DIR "${SOURCE_DIR}/build-pgo")
+endif()
+if(NOT PGO_ITERATIONS)
+  set(PGO_ITERATIONS 10)
+endif()
+set(BASELINE_DIR "${PGO_BUILD_DIR}/baseline")
+set(OPTIMIZED_DIR "${PGO_BUILD_DIR}/pgo")
+set(PROFILE_DIR "${OPTIMIZED_DIR}/pgo-profiles")
+set(TRAINING_OUTPUT_DIR "${PGO_BUILD_DIR}/training-output")
+
+set(CONFIGURE_ARGS -DCMAKE_BUILD_TYPE=Release -DBUILD_BENCHMARKS=ON "-DPGO_PROFILE_DIR=${PROFILE_DIR}")
+if(CMAKE_CXX_COMPILER)
+  list(APPEND CONFIGURE_ARGS "-DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}")
+endif()
+
+# Run a command and stop the workflow if it fails
+function(run_step description)
+  message(STATUS "${description}...")
+  execute_process(COMMAND ${ARGN} RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${description} failed with status '${result}'.")
+  endif()
+endfunction()
+
+# Configure and build a directory with the given PGO phase
+function(build_phase directory phase)
+  run_step("Configuring '${directory}' (ENABLE_PGO=${phase})" "${CMAKE_COMMAND}" -S "${SOURCE_DIR}" -B "${directory}" ${CONFIGURE_ARGS} "-DENABLE_PGO=${phase}")
+  run_step("Building '${directory}' (ENABLE_PGO=${phase})" "${CMAKE_COMMAND}" --build "${directory}" --parallel)
+endfunction()
+
+# Run the corpus benchmarks and return "name;median;name;median;..." in the output variable
+function(measure_corpus directory output_variable)
+  execute_process(
+    COMMAND "${directory}/benchmarks" corpus ${PGO_ITERATIONS}
+    OUTPUT_VARIABLE output
+    RESULT_VARIABLE result
+  )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Running the corpus benchmarks in '${directory}' failed with status '${result}'.")
+  endif()
+  set(medians "")
+  string(REPLACE "\n" ";" lines "${output}")
+  foreach(line IN LISTS lines)
+    if(line MATCHES "^([^ ]+( [^ ]+)*) +median +([0-9.]+) ms")
+      list(APPEND medians "${CMAKE_MATCH_1}" "${CMAKE_MATCH_3}")
+    endif()
+  endforeach()
+  set(${output_variable} "${medians}" PARENT_SCOPE)
+endfunction()
+
+# Step 1: baseline
+build_phase("${BASELINE_DIR}" OFF)
+
+# Step 2: instrumented build, stale profiles from an earlier run would be merged with the new ones
+file(REMOVE_RECURSE "${PROFILE_DIR}" "${TRAINING_OUTPUT_DIR}")
+build_phase("${OPTIMIZED_DIR}" GENERATE)
+
+# Step 3: training run, the headless batch executable shares its objects with the application, so it trains both
+run_step("Training the normalizer (batch mode over the corpus)"
+  "${OPTIMIZED_DIR}/ungpt-batch" --batch "${SOURCE_DIR}/benchmarks/corpus" --output "${TRAINING_OUTPUT_DIR}"
+  --remove-ai-disclaimers --remove-markdown-bold --trim-trailing-whitespace)
+run_step("Training the normalizer and counters (corpus benchmarks)" "${OPTIMIZED_DIR}/benchmarks" corpus 3)
+
+# Step 4: GCC reads the ".gcda" files directly, Clang needs its ".profraw" files merged into "default.profdata"
+file(GLOB_RECURSE RAW_PROFILES "${PROFILE_DIR}/*.profraw")
+if(RAW_PROFILES)
+  find_program(LLVM_PROFDATA NAMES llvm-profdata)
+  if(LLVM_PROFDATA)
+    set(MERGE_COMMAND "${LLVM_PROFDATA}")
+  elseif(CMAKE_HOST_APPLE)
+    set(MERGE_COMMAND xcrun llvm-profdata)
+  else()
+    message(FATAL_ERROR "llvm-profdata not found, it is required to merge Clang profiles.")
+  endif()
+  run_step("Merging Clang profiles" ${MERGE_COMMAND} merge "-output=${PROFILE_DIR}/default.profdata" ${RAW_PROFILES})
+else()
+  file(GLOB_RECURSE GCC_PROFILES "${PROFILE_DIR}/*.gcda")
+  if(NOT GCC_PROFILES)
+    message(FATAL_ERROR "The training run did not write any profiles to '${PROFILE_DIR}'.")
+  endif()
+endif()
+build_phase("${OPTIMIZED_DIR}" USE)
+
+# Step 5: report
+measure_corpus("${BASELINE_DIR}" baseline_medians)
+measure_corpus("${OPTIMIZED_DIR}" optimized_medians)
+message(STATUS "")
+message(STATUS "================================================================================")
+message(STATUS "                              PGO SPEEDUP (median)")
+message(STATUS "================================================================================")
+list(LENGTH baseline_medians length)
+if(length EQUAL 0)
+  message(FATAL_ERROR "No corpus benchmark results to compare.")
+endif()
+math(EXPR last "${length} - 1")
+foreach(index RANGE 0 ${last} 2)
+  math(EXPR value_index "${index} + 1")
+  list(GET baseline_medians ${index} name)
+  list(GET baseline_medians ${value_index} baseline_ms)
+  list(FIND optimized_medians "${name}" optimized_index)
+  if(optimized_index EQUAL -1)
+    continue()
+  endif()
+  math(EXPR optimized_index "${optimized_index} + 1")
+  list(GET optimized_medians ${optimized_index} optimized_ms)
+  # "math()" is integer-only, so compute the speedup in hundredths
+  string(REPLACE "." "" baseline_scaled "${baseline_ms}")
+  string(REPLACE "." "" optimized_scaled "${optimized_ms}")
+  string(REGEX REPLACE "^0+([0-9])" "\\1" baseline_scaled "${baseline_scaled}")
+  string(REGEX REPLACE "^0+([0-9])" "\\1" optimized_scaled "${optimized_scaled}")
+  if(optimized_scaled EQUAL 0)
+    continue()
+  endif()
+  math(EXPR speedup "${baseline_scaled} * 100 / ${optimized_scaled}")
+  math(EXPR speedup_whole "${speedup} / 100")
+  math(EXPR speedup_fraction "${speedup} % 100")
+  if(speedup_fraction LESS 10)
+    set(speedup_fraction "0${speedup_fraction}")
+  endif()
+  message(STATUS "  ${name}: ${baseline_ms} ms -> ${optimized_ms} ms (${speedup_whole}.${speedup_fraction}x)")
+endforeach()
+message(STATUS "================================================================================")
+message(STATUS "")
+message(STATUS "Optimized build: '${OPTIMIZED_DIR}'.")
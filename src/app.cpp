@@ -2,24 +2,138 @@
  * @file app.cpp
  */
 
+#include <cstddef>      // for std::size_t
+#include <exception>    // for std::exception
+#include <filesystem>   // for std::filesystem::path
+#include <fstream>      // for std::ofstream
+#include <ios>          // for std::ios
+#include <memory>       // for std::unique_ptr, std::make_unique
+#include <string_view>  // for std::string_view
+
 #include <SFML/Window/Event.hpp>
+#include <spdlog/spdlog.h>
 
+#include "app.hpp"
 #include "core/backend.hpp"
 #include "core/imgui_sfml_ctx.hpp"
+#include "core/instance.hpp"
+#include "core/memory.hpp"
+#include "core/paths.hpp"
+#include "core/session.hpp"
+#include "core/startup.hpp"
 #include "ui/editor.hpp"
 
 namespace app {
 
-void run()
+namespace {
+
+/**
+ * @brief Write the heap usage of every subsystem to a file as JSON.
+ *
+ * @param path Path to the file (e.g., "memory.json").
+ *
+ * @note Failures are logged rather than thrown, so they do not turn a normal exit into an error.
+ */
+void write_memory_report(const std::filesystem::path &path)
+{
+    const core::memory::Snapshot snapshot = core::memory::take_snapshot();
+    std::ofstream stream{path, std::ios::binary};
+    stream << core::memory::to_json(snapshot);
+    if (!stream) [[unlikely]] {
+        SPDLOG_ERROR("Failed to write the memory report to '{}'", path.string());
+        return;
+    }
+    SPDLOG_INFO("Wrote the memory report to '{}' ({} bytes in use)", path.string(), snapshot.total_bytes());
+}
+
+}  // namespace
+
+void run(const core::args::Arguments &arguments)
 {
+    // Measure the startup path up to the first presented frame
+    core::startup::Trace startup_trace{arguments.startup_trace};
+    startup_trace.mark("Entered app::run()");
+
+    // Hand the file over to the editor that is already running, if any, instead of creating a second window, OpenGL context, and font atlas
+    // Without a usable runtime directory, every launch simply opens its own window
+    std::unique_ptr<core::instance::Instance> instance;
+    if (!arguments.new_instance) {
+        try {
+            const std::filesystem::path directory = core::paths::get_runtime_directory();
+            instance = std::make_unique<core::instance::Instance>(directory);
+            if (!instance->is_primary() && core::instance::hand_over(directory, arguments.open_file)) {
+                startup_trace.finish("Handed over to the running instance");
+                return;
+            }
+        }
+        catch (const std::exception &e) {
+            SPDLOG_ERROR("Single-instance mode is disabled: {}", e.what());
+        }
+    }
+
     // Create SFML window with sane defaults
     core::backend::Window window;
+    startup_trace.mark("Window and OpenGL context created");
 
     // Create RAII context with theme and no INI file
     core::imgui_sfml_ctx::ImGuiContext imgui_context{window.raw()};
+    startup_trace.mark("ImGui context created");
+
+    // Restore the documents of the last session, and journal every change to them from now on
+    // Without a usable state directory, or while another instance holds the session, the editor still works, it just does not persist its documents
+    std::unique_ptr<core::session::Session> session;
+    try {
+        session = std::make_unique<core::session::Session>(core::paths::get_state_directory() / "session");
+    }
+    catch (const std::exception &e) {
+        SPDLOG_ERROR("Session persistence is disabled: {}", e.what());
+    }
+    startup_trace.mark("Session restored");
 
     // Create the text editor interface (i.e., this actual app, everything so far was boilerplate)
-    ui::editor::Editor text_editor;
+    // Text entering the editor is forwarded to the ImGui context, which loads glyphs for non-Latin scripts on demand
+    // Every change of a document is recorded by its session journal, which writes it to disk in the background
+    ui::editor::Editor text_editor{
+        [&imgui_context](const std::string_view text) {
+            imgui_context.request_glyphs(text);
+        },
+        [&session](const std::size_t document, const std::string_view text) {
+            if (!session) {
+                return;
+            }
+            try {
+                session->record(document, text);
+            }
+            catch (const std::exception &e) {
+                SPDLOG_ERROR("Failed to persist document '{}': {}", document, e.what());
+            }
+        },
+        [&session](const std::size_t document) {
+            if (session) {
+                session->remove(document);
+            }
+        }};
+    text_editor.set_memory_budget(arguments.memory_budget_mb * 1024 * 1024);
+    startup_trace.mark("Editor created");
+
+    // Continue where the last session left off, with every document in its own tab
+    if (session) {
+        for (std::size_t i = 0; i < session->restored_count(); ++i) {
+            session->adopt(i, text_editor.add_document(session->restored_text(i)));
+        }
+    }
+
+    // Load the file passed on the command line, if any, into a tab of its own next to the restored documents
+    if (!arguments.open_file.empty()) {
+        text_editor.open_file(arguments.open_file);
+        startup_trace.mark("File opened");
+    }
+
+    // Normalize every text copied to the clipboard from now on, if requested
+    if (arguments.watch_clipboard) {
+        text_editor.set_clipboard_watch(true);
+        startup_trace.mark("Clipboard watch started");
+    }
 
     const auto on_event = [&](const sf::Event &event) {
         // Let ImGui handle the event
@@ -32,6 +146,15 @@ void run()
     };
 
     const auto on_update = [&](const float dt) {
+        // Open the documents handed over by later launches, and bring the window to the front for them
+        if (instance) {
+            instance->poll([&](const std::filesystem::path &path, const std::string_view title) {
+                if (!path.empty()) {
+                    text_editor.open_file(path, title);
+                }
+                window.raw().requestFocus();
+            });
+        }
         imgui_context.update(dt);
         text_editor.update_and_draw();  // Won't be drawn until `imgui_context.render()` is called
     };
@@ -40,11 +163,17 @@ void run()
         rt.clear();
         imgui_context.render();
         rt.display();
+        startup_trace.finish("First frame presented");  // No-op after the first frame
     };
 
     // Ask OS to switch to this window and start the main loop
     window.raw().requestFocus();
     window.run(on_event, on_update, on_render);
+
+    // Report the heap usage while the editor and its documents still exist, so the report shows what they held
+    if (!arguments.memory_report.empty()) {
+        write_memory_report(arguments.memory_report);
+    }
 }
 
 }  // namespace app
@@ -6,11 +6,15 @@
 
 #pragma once
 
+#include "core/args.hpp"
+
 namespace app {
 
 /**
  * @brief Run the application.
+ *
+ * @param arguments Options parsed from the command line.
  */
-void run();
+void run(const core::args::Arguments &arguments);
 
 }  // namespace app
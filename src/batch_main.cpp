@@ -0,0 +1,61 @@
+/**
+ * @file batch_main.cpp
+ */
+
+#include <cstddef>    // for std::size_t
+#include <cstdlib>    // for EXIT_FAILURE, EXIT_SUCCESS
+#include <exception>  // for std::exception
+#include <span>       // for std::span
+#include <stdexcept>  // for std::invalid_argument
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN  // Exclude rarely-used stuff from Windows headers
+#include <windows.h>         // for SetConsoleCP, SetConsoleOutputCP, CP_UTF8
+#endif
+
+#include <spdlog/common.h>
+#include <spdlog/spdlog.h>
+
+#include "core/args.hpp"
+#include "core/batch.hpp"
+
+/**
+ * @brief Entry-point of the headless batch executable.
+ *
+ * This takes the same command line as "ungpt --batch", but links neither SFML nor ImGui (nor X11), so it runs on CI nodes and servers without a display or graphics libraries.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments, starting with the program name.
+ *
+ * @return EXIT_SUCCESS if every file was processed, EXIT_FAILURE otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    try {
+#ifndef NDEBUG  // "Not Debug" build (Release)
+        spdlog::set_level(spdlog::level::debug);
+#endif
+#if defined(_WIN32)  // Setup UTF-8 input/output
+        SetConsoleCP(CP_UTF8);
+        SetConsoleOutputCP(CP_UTF8);
+#endif
+        // Parse the command-line arguments, skipping the program name
+        const std::span<const char *const> all_arguments{argv, static_cast<std::size_t>(argc)};
+        const core::args::Arguments arguments = core::args::parse_arguments(all_arguments.empty() ? all_arguments : all_arguments.subspan(1));
+        if (arguments.batch_directory.empty()) {
+            throw std::invalid_argument("Only batch mode is available here, pass '--batch <directory>'");
+        }
+
+        const core::batch::BatchReport report = core::batch::run_batch(core::batch::make_options(arguments));
+        SPDLOG_INFO("{}", report.summary());
+        return report.files_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception &e) {
+        SPDLOG_CRITICAL("{}", e.what());
+        return EXIT_FAILURE;
+    }
+    catch (...) {
+        SPDLOG_CRITICAL("Unknown error occurred!");
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @file ungpt.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <string_view>  // for std::string_view
+
+#include "capi/ungpt.h"
+#include "core/text.hpp"
+
+namespace {
+
+/**
+ * @brief Bitwise OR of every supported flag.
+ */
+constexpr unsigned int ALL_FLAGS = UNGPT_REMOVE_AI_DISCLAIMERS | UNGPT_REMOVE_MARKDOWN_BOLD | UNGPT_TRIM_TRAILING_WHITESPACE | UNGPT_REPAIR_INVALID_UTF8 | UNGPT_PRESERVE_CODE | UNGPT_NORMALIZE_LINE_ENDINGS | UNGPT_COLLAPSE_WHITESPACE;
+
+}  // namespace
+
+extern "C" {
+
+size_t ungpt_normalize(const char *input,
+                       size_t input_size,
+                       char *output,
+                       size_t output_capacity)
+{
+    return ungpt_normalize_with_flags(input, input_size, output, output_capacity, 0);
+}
+
+size_t ungpt_normalize_with_flags(const char *input,
+                                  size_t input_size,
+                                  char *output,
+                                  size_t output_capacity,
+                                  unsigned int flags)
+{
+    if ((input == nullptr && input_size != 0) || (output == nullptr && output_capacity != 0) || (flags & ~ALL_FLAGS) != 0) [[unlikely]] {
+        return UNGPT_ERROR;
+    }
+
+    const core::text::CleanupOptions options{
+        .remove_ai_disclaimers = (flags & UNGPT_REMOVE_AI_DISCLAIMERS) != 0,
+        .remove_markdown_bold = (flags & UNGPT_REMOVE_MARKDOWN_BOLD) != 0,
+        .trim_trailing_whitespace = (flags & UNGPT_TRIM_TRAILING_WHITESPACE) != 0,
+        .repair_invalid_utf8 = (flags & UNGPT_REPAIR_INVALID_UTF8) != 0,
+        .preserve_code = (flags & UNGPT_PRESERVE_CODE) != 0,
+        .normalize_line_endings = (flags & UNGPT_NORMALIZE_LINE_ENDINGS) != 0,
+        .collapse_whitespace = (flags & UNGPT_COLLAPSE_WHITESPACE) != 0,
+    };
+
+    // Exceptions must not cross the C boundary; the only one possible is running out of memory on a thread's first call
+    try {
+        return core::text::normalize_into({input, input_size}, output, output_capacity, options);
+    }
+    catch (...) {
+        return UNGPT_ERROR;
+    }
+}
+
+size_t ungpt_count_words(const char *input,
+                         size_t input_size)
+{
+    if (input == nullptr && input_size != 0) [[unlikely]] {
+        return UNGPT_ERROR;
+    }
+    return core::text::count_words({input, input_size});
+}
+
+size_t ungpt_count_characters(const char *input,
+                              size_t input_size)
+{
+    if (input == nullptr && input_size != 0) [[unlikely]] {
+        return UNGPT_ERROR;
+    }
+    return core::text::count_characters({input, input_size});
+}
+
+int ungpt_api_version(void)
+{
+    return UNGPT_API_VERSION;
+}
+
+}  // extern "C"
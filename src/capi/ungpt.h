@@ -0,0 +1,131 @@
+/**
+ * @file ungpt.h
+ *
+ * @brief Stable C interface to the ungpt text core, for embedding it into other programs.
+ *
+ * All functions are thread-safe. They never allocate memory on behalf of the caller: results are written into caller-provided buffers. Text is UTF-8 and never needs to be null-terminated.
+ */
+
+#ifndef UNGPT_H
+#define UNGPT_H
+
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for SIZE_MAX */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Version of this interface; incremented only for incompatible changes.
+ */
+#define UNGPT_API_VERSION 1
+
+/**
+ * @brief Returned instead of a size when a call fails.
+ */
+#define UNGPT_ERROR SIZE_MAX
+
+/**
+ * @brief Also remove phrases such as "As an AI language model, " together with the whitespace that follows them.
+ */
+#define UNGPT_REMOVE_AI_DISCLAIMERS 1u
+
+/**
+ * @brief Also remove markdown bold markers ("**").
+ */
+#define UNGPT_REMOVE_MARKDOWN_BOLD 2u
+
+/**
+ * @brief Also remove spaces and tabs at the end of every line.
+ */
+#define UNGPT_TRIM_TRAILING_WHITESPACE 4u
+
+/**
+ * @brief Replace invalid UTF-8 sequences with U+FFFD before normalizing; without it, invalid bytes are passed through unchanged.
+ */
+#define UNGPT_REPAIR_INVALID_UTF8 8u
+
+/**
+ * @brief Leave Markdown code (fenced code blocks and inline code spans) and URLs unchanged.
+ */
+#define UNGPT_PRESERVE_CODE 16u
+
+/**
+ * @brief Also turn Windows ("\r\n") and classic Mac ("\r") line endings into "\n".
+ */
+#define UNGPT_NORMALIZE_LINE_ENDINGS 32u
+
+/**
+ * @brief Also collapse every run of spaces and tabs into a single space.
+ */
+#define UNGPT_COLLAPSE_WHITESPACE 64u
+
+/**
+ * @brief Normalize text, replacing typographic characters (e.g., smart quotes, dashes, ellipses) with their ASCII equivalents.
+ *
+ * To size the output buffer, call with "output_capacity" set to 0 first, or retry with the returned size when it exceeds the capacity.
+ *
+ * @param input Text to normalize; may be NULL if "input_size" is 0.
+ * @param input_size Size of the input, in bytes.
+ * @param output Buffer that receives the normalized text, not null-terminated; must not overlap the input. May be NULL if "output_capacity" is 0.
+ * @param output_capacity Size of the output buffer, in bytes.
+ *
+ * @return Size of the normalized text, in bytes. If this exceeds "output_capacity", only the first "output_capacity" bytes were written. UNGPT_ERROR if an argument is invalid or an internal error occurred.
+ */
+size_t ungpt_normalize(const char *input,
+                       size_t input_size,
+                       char *output,
+                       size_t output_capacity);
+
+/**
+ * @brief Normalize text like "ungpt_normalize()", with optional cleanup rules.
+ *
+ * @param input Text to normalize; may be NULL if "input_size" is 0.
+ * @param input_size Size of the input, in bytes.
+ * @param output Buffer that receives the normalized text, not null-terminated; must not overlap the input. May be NULL if "output_capacity" is 0.
+ * @param output_capacity Size of the output buffer, in bytes.
+ * @param flags Bitwise OR of UNGPT_REMOVE_AI_DISCLAIMERS, UNGPT_REMOVE_MARKDOWN_BOLD, UNGPT_TRIM_TRAILING_WHITESPACE, UNGPT_REPAIR_INVALID_UTF8, UNGPT_PRESERVE_CODE, UNGPT_NORMALIZE_LINE_ENDINGS and UNGPT_COLLAPSE_WHITESPACE, or 0.
+ *
+ * @return Same as "ungpt_normalize()"; also UNGPT_ERROR if "flags" contains unknown bits.
+ */
+size_t ungpt_normalize_with_flags(const char *input,
+                                  size_t input_size,
+                                  char *output,
+                                  size_t output_capacity,
+                                  unsigned int flags);
+
+/**
+ * @brief Count the words in text, separated by ASCII whitespace.
+ *
+ * @param input Text to analyze; may be NULL if "input_size" is 0.
+ * @param input_size Size of the input, in bytes.
+ *
+ * @return Number of words, or UNGPT_ERROR if the input is NULL but its size is not 0.
+ */
+size_t ungpt_count_words(const char *input,
+                         size_t input_size);
+
+/**
+ * @brief Count the characters (Unicode code points) in text.
+ *
+ * @param input Text to analyze; may be NULL if "input_size" is 0.
+ * @param input_size Size of the input, in bytes.
+ *
+ * @return Number of characters, or UNGPT_ERROR if the input is NULL but its size is not 0.
+ */
+size_t ungpt_count_characters(const char *input,
+                              size_t input_size);
+
+/**
+ * @brief Return the version of the interface the library was built with.
+ *
+ * @return UNGPT_API_VERSION of the library, which may differ from the header's if the library was swapped.
+ */
+int ungpt_api_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNGPT_H */
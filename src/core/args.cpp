@@ -0,0 +1,185 @@
+/**
+ * @file args.cpp
+ */
+
+#include <charconv>      // for std::from_chars
+#include <cstddef>       // for std::size_t
+#include <format>        // for std::format
+#include <stdexcept>     // for std::invalid_argument
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::errc
+
+#include <spdlog/spdlog.h>
+
+#include "core/args.hpp"
+
+namespace core::args {
+
+namespace {
+
+/**
+ * @brief Parse a positive integer option value.
+ *
+ * @param option Name of the option, used in error messages (e.g., "--jobs").
+ * @param value Value to parse (e.g., "8").
+ *
+ * @return Parsed value.
+ *
+ * @throws std::invalid_argument if the value is not a positive integer.
+ */
+[[nodiscard]] std::size_t parse_positive(const std::string_view option,
+                                         const std::string_view value)
+{
+    std::size_t result = 0;
+    const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+    if (ec != std::errc{} || end != value.data() + value.size() || result == 0) [[unlikely]] {
+        throw std::invalid_argument(std::format("Invalid value '{}' for '{}', expected a positive integer", value, option));
+    }
+    return result;
+}
+
+}  // namespace
+
+Arguments parse_arguments(std::span<const char *const> argv)
+{
+    Arguments arguments;
+    bool has_batch_only_option = false;
+    bool has_headless_option = false;
+    bool has_gui_only_option = false;
+
+    for (std::size_t i = 0; i < argv.size(); ++i) {
+        const std::string argument = argv[i];
+
+        // Return the value following the current option, or throw if there is none
+        const auto next_value = [&argv, &i, &argument]() -> std::string_view {
+            if (i + 1 >= argv.size()) [[unlikely]] {
+                throw std::invalid_argument(std::format("Missing value for '{}'", argument));
+            }
+            return argv[++i];
+        };
+
+        if (argument == "--startup-trace") {
+            arguments.startup_trace = true;
+        }
+        else if (argument == "--open") {
+            arguments.open_file = next_value();
+        }
+        else if (argument == "--new-instance") {
+            arguments.new_instance = true;
+            has_gui_only_option = true;
+        }
+        else if (argument == "--watch-clipboard") {
+            arguments.watch_clipboard = true;
+        }
+        else if (argument == "--memory-budget-mb") {
+            arguments.memory_budget_mb = parse_positive(argument, next_value());
+            has_gui_only_option = true;
+        }
+        else if (argument == "--memory-report") {
+            arguments.memory_report = next_value();
+            has_gui_only_option = true;
+        }
+        else if (argument == "--batch") {
+            arguments.batch_directory = next_value();
+        }
+        else if (argument == "--serve") {
+            arguments.serve_socket = next_value();
+        }
+        else if (argument == "--output") {
+            arguments.output_directory = next_value();
+            has_batch_only_option = true;
+        }
+        else if (argument == "--jobs") {
+            arguments.jobs = parse_positive(argument, next_value());
+            has_headless_option = true;
+        }
+        else if (argument == "--max-in-flight-mb") {
+            arguments.max_in_flight_mb = parse_positive(argument, next_value());
+            has_batch_only_option = true;
+        }
+        else if (argument == "--remove-ai-disclaimers") {
+            arguments.cleanup_options.remove_ai_disclaimers = true;
+            has_headless_option = true;
+        }
+        else if (argument == "--remove-markdown-bold") {
+            arguments.cleanup_options.remove_markdown_bold = true;
+            has_headless_option = true;
+        }
+        else if (argument == "--trim-trailing-whitespace") {
+            arguments.cleanup_options.trim_trailing_whitespace = true;
+            has_headless_option = true;
+        }
+        else if (argument == "--repair-invalid-utf8") {
+            arguments.cleanup_options.repair_invalid_utf8 = true;
+            has_headless_option = true;
+        }
+        else if (argument == "--preserve-code") {
+            arguments.cleanup_options.preserve_code = true;
+            has_headless_option = true;
+        }
+        else if (argument == "--normalize-line-endings") {
+            arguments.cleanup_options.normalize_line_endings = true;
+            has_headless_option = true;
+        }
+        else if (argument == "--collapse-whitespace") {
+            arguments.cleanup_options.collapse_whitespace = true;
+            has_headless_option = true;
+        }
+        else if (argument == "--remove-duplicate-lines") {
+            arguments.remove_duplicates = true;
+            arguments.dedupe_options.unit = dedupe::Unit::Line;
+            has_batch_only_option = true;
+        }
+        else if (argument == "--remove-duplicate-paragraphs") {
+            arguments.remove_duplicates = true;
+            arguments.dedupe_options.unit = dedupe::Unit::Paragraph;
+            has_batch_only_option = true;
+        }
+        else if (argument == "--near-duplicate-threshold") {
+            const std::size_t percent = parse_positive(argument, next_value());
+            if (percent > 100) [[unlikely]] {
+                throw std::invalid_argument(std::format("Invalid value '{}' for '{}', expected a percentage between 1 and 100", percent, argument));
+            }
+            arguments.dedupe_options.near_duplicate_threshold = static_cast<double>(percent) / 100.0;
+            has_batch_only_option = true;
+        }
+        else if (!argument.starts_with('-') && arguments.open_file.empty()) {
+            // A bare path opens the file, so "ungpt notes.txt" works from a shell or a file manager
+            arguments.open_file = argument;
+        }
+        else {
+            throw std::invalid_argument(std::format("Unknown argument '{}'", argument));
+        }
+    }
+
+    const bool is_batch = !arguments.batch_directory.empty();
+    const bool is_serve = !arguments.serve_socket.empty();
+    if (is_batch && is_serve) [[unlikely]] {
+        throw std::invalid_argument("'--batch' and '--serve' cannot be combined");
+    }
+    if (!arguments.open_file.empty() && (is_batch || is_serve)) [[unlikely]] {
+        throw std::invalid_argument("A file to open cannot be combined with '--batch' or '--serve'");
+    }
+    if (arguments.watch_clipboard && (is_batch || is_serve)) [[unlikely]] {
+        throw std::invalid_argument("'--watch-clipboard' cannot be combined with '--batch' or '--serve'");
+    }
+    if (has_gui_only_option && (is_batch || is_serve)) [[unlikely]] {
+        throw std::invalid_argument("'--new-instance', '--memory-budget-mb', and '--memory-report' cannot be combined with '--batch' or '--serve'");
+    }
+    if (arguments.dedupe_options.near_duplicate_threshold > 0.0 && !arguments.remove_duplicates) [[unlikely]] {
+        throw std::invalid_argument("'--near-duplicate-threshold' requires '--remove-duplicate-lines' or '--remove-duplicate-paragraphs'");
+    }
+    if (has_batch_only_option && !is_batch) [[unlikely]] {
+        throw std::invalid_argument("Batch options require '--batch <directory>'");
+    }
+    if (has_headless_option && !is_batch && !is_serve) [[unlikely]] {
+        throw std::invalid_argument("Worker and cleanup options require '--batch <directory>' or '--serve <socket>'");
+    }
+
+    SPDLOG_DEBUG("Parsed '{}' command-line arguments", argv.size());
+
+    return arguments;
+}
+
+}  // namespace core::args
@@ -0,0 +1,104 @@
+/**
+ * @file args.hpp
+ *
+ * @brief Command-line argument parsing.
+ */
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <filesystem>  // for std::filesystem::path
+#include <span>        // for std::span
+
+#include "core/dedupe.hpp"
+#include "core/text.hpp"
+
+namespace core::args {
+
+/**
+ * @brief Options parsed from the command line.
+ */
+struct Arguments {
+    /**
+     * @brief Whether to log a timing report of the startup path once the first frame is on screen.
+     */
+    bool startup_trace = false;
+
+    /**
+     * @brief Text file to load into the editor on startup, in UTF-8, UTF-16, or Windows-1252 (e.g., "notes.txt"), given with "--open" or as the only positional argument, or empty to start with an empty editor.
+     */
+    std::filesystem::path open_file{};
+
+    /**
+     * @brief Whether to open a window of its own even if an editor is already running, instead of handing "open_file" over to it.
+     */
+    bool new_instance = false;
+
+    /**
+     * @brief Whether to start watching the clipboard, normalizing every text copied to it.
+     */
+    bool watch_clipboard = false;
+
+    /**
+     * @brief Memory budget shared by all open documents in the editor, in mebibytes; inactive documents beyond it are compressed or paged out to disk.
+     */
+    std::size_t memory_budget_mb = 256;
+
+    /**
+     * @brief File to write the heap usage of every subsystem to as JSON when the window is closed (e.g., "memory.json"), or empty to write none.
+     */
+    std::filesystem::path memory_report{};
+
+    /**
+     * @brief Directory to normalize headlessly instead of opening the window (e.g., "corpus"), or empty to start the GUI.
+     */
+    std::filesystem::path batch_directory{};
+
+    /**
+     * @brief Unix domain socket to serve normalization requests on instead of opening the window (e.g., "/tmp/ungpt.sock"), or empty to start the GUI.
+     */
+    std::filesystem::path serve_socket{};
+
+    /**
+     * @brief Mirror directory for the batch output (e.g., "corpus-clean"), or empty to rewrite the files in place.
+     */
+    std::filesystem::path output_directory{};
+
+    /**
+     * @brief Number of batch or daemon workers, or 0 to use the number of hardware threads.
+     */
+    std::size_t jobs = 0;
+
+    /**
+     * @brief Maximum combined size of the files processed at the same time by the batch, in mebibytes.
+     */
+    std::size_t max_in_flight_mb = 64;
+
+    /**
+     * @brief Optional cleanup rules applied by the batch or the daemon.
+     */
+    text::CleanupOptions cleanup_options{};
+
+    /**
+     * @brief Whether the batch removes repeated lines or paragraphs.
+     */
+    bool remove_duplicates = false;
+
+    /**
+     * @brief Settings of the duplicate removal applied by the batch.
+     */
+    dedupe::DedupeOptions dedupe_options{};
+};
+
+/**
+ * @brief Parse the command-line arguments passed to the application.
+ *
+ * @param argv Arguments passed to "main()", excluding the program name (e.g., {"--batch", "corpus", "--jobs", "8"} or {"notes.txt"}).
+ *
+ * @return Parsed options.
+ *
+ * @throws std::invalid_argument if an unknown option is provided, an option is missing its value, a numeric value is invalid, a near-duplicate threshold is given without a duplicate option, a headless option is used without "--batch" or "--serve", both modes are requested, or a file to open, "--watch-clipboard", "--new-instance", "--memory-budget-mb", or "--memory-report" is combined with either.
+ */
+[[nodiscard]] Arguments parse_arguments(std::span<const char *const> argv);
+
+}  // namespace core::args
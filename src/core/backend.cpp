@@ -20,8 +20,8 @@ namespace core::backend {
 
 Window::Window()
 {
-    // Create context settings with the current anti-aliasing level
-    const sf::ContextSettings settings{.antiAliasingLevel = 8};
+    // Create context settings without anti-aliasing; the flat ImGui UI gains nothing from MSAA, but context creation and every frame pay for it
+    const sf::ContextSettings settings{.antiAliasingLevel = 0};
     SPDLOG_DEBUG("Created context settings with '{}' anti-aliasing level", settings.antiAliasingLevel);
 
     // Create the window title based on the project name and version
@@ -41,11 +41,10 @@ Window::Window()
     // Set minimum size (only relevant for windowed mode)
     this->window_.setMinimumSize(sf::Vector2u{400, 200});
 
-    // Set 30 FPS limit for reduced CPU usage (remember: you cannot use both FPS limit and vsync at the same time)
-    this->window_.setFramerateLimit(30);
+    // The 30 FPS limit is applied by "run()" after the first frame was presented, otherwise the first "display()" call would sleep for up to a whole frame
 
     // Log the successful creation of the window
-    SPDLOG_DEBUG("Window created successfully with mode '{}x{}', title '{}', 30 FPS limit, and context settings (anti-aliasing level: {})", mode.size.x, mode.size.y, window_title, settings.antiAliasingLevel);
+    SPDLOG_DEBUG("Window created successfully with mode '{}x{}', title '{}', and context settings (anti-aliasing level: {})", mode.size.x, mode.size.y, window_title, settings.antiAliasingLevel);
 }
 
 void Window::run(const event_callback_t &on_event,
@@ -54,6 +53,7 @@ void Window::run(const event_callback_t &on_event,
 {
     SPDLOG_INFO("Starting main window loop!");
     sf::Clock clock;
+    bool is_first_frame = true;
     while (this->window_.isOpen()) {
         // Allow user of this call to explicitly handle events themselves
         this->window_.handleEvents(on_event);
@@ -62,6 +62,12 @@ void Window::run(const event_callback_t &on_event,
         const float dt = std::min(clock.restart().asSeconds(), dt_max);
         on_update(dt);
         on_render(this->window_);
+        // Set 30 FPS limit for reduced CPU usage once the first frame is on screen (remember: you cannot use both FPS limit and vsync at the same time)
+        if (is_first_frame) [[unlikely]] {
+            is_first_frame = false;
+            this->window_.setFramerateLimit(30);
+            SPDLOG_DEBUG("First frame presented, applied 30 FPS limit");
+        }
     }
     SPDLOG_INFO("Main window loop ended!");
 }
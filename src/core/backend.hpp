@@ -26,7 +26,7 @@ class Window {
     /**
      * @brief Construct a new SFML window.
      *
-     * This creates the window with sane defaults for resolution, anti-aliasing, and frame rate.
+     * This creates the window with sane defaults for resolution and anti-aliasing (disabled, since the flat UI does not need it).
      *
      * @note The window is immediately ready for use via the "run()" method or direct access through the "raw()" method.
      */
@@ -72,7 +72,7 @@ class Window {
      * @param on_update Callback function for updating game state (receives delta time).
      * @param on_render Callback function for rendering (receives render window reference).
      *
-     * @note The loop continues until the window is closed. Delta time is clamped to prevent extreme values.
+     * @note The loop continues until the window is closed. Delta time is clamped to prevent extreme values. The 30 FPS limit is applied after the first frame, so the first paint is never delayed by it.
      */
     void run(const event_callback_t &on_event,
              const update_callback_t &on_update,
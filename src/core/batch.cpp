@@ -0,0 +1,345 @@
+/**
+ * @file batch.cpp
+ */
+
+#include <algorithm>           // for std::mismatch, std::none_of
+#include <atomic>              // for std::atomic
+#include <cctype>              // for std::tolower
+#include <chrono>              // for std::chrono::steady_clock, std::chrono::duration
+#include <condition_variable>  // for std::condition_variable
+#include <cstddef>             // for std::size_t
+#include <exception>           // for std::exception
+#include <filesystem>          // for std::filesystem
+#include <format>              // for std::format
+#include <fstream>             // for std::ifstream, std::ofstream
+#include <iterator>            // for std::next
+#include <mutex>               // for std::mutex, std::lock_guard, std::unique_lock
+#include <stdexcept>           // for std::invalid_argument, std::runtime_error
+#include <string>              // for std::string
+#include <system_error>        // for std::error_code
+#include <vector>              // for std::vector
+
+#include <spdlog/spdlog.h>
+
+#include "core/args.hpp"
+#include "core/batch.hpp"
+#include "core/dedupe.hpp"
+#include "core/text.hpp"
+#include "core/thread_pool.hpp"
+
+namespace core::batch {
+
+namespace {
+
+/**
+ * @brief Counting limit on the number of bytes in flight, shared between the directory walker and the workers.
+ */
+class ByteBudget final {
+  public:
+    /**
+     * @brief Construct a new ByteBudget object.
+     *
+     * @param capacity Maximum number of bytes in flight (e.g., "67108864").
+     */
+    explicit ByteBudget(const std::size_t capacity)
+        : capacity_(capacity)
+    {
+    }
+
+    /**
+     * @brief Block until the bytes fit into the budget, then reserve them.
+     *
+     * A request larger than the whole budget is granted once nothing else is in flight, so oversized files cannot deadlock the run.
+     *
+     * @param bytes Number of bytes to reserve.
+     */
+    void acquire(const std::size_t bytes)
+    {
+        std::unique_lock lock{this->mutex_};
+        this->released_.wait(lock, [this, bytes] {
+            return this->in_flight_ == 0 || this->in_flight_ + bytes <= this->capacity_;
+        });
+        this->in_flight_ += bytes;
+    }
+
+    /**
+     * @brief Return previously reserved bytes to the budget.
+     *
+     * @param bytes Number of bytes to return.
+     */
+    void release(const std::size_t bytes)
+    {
+        {
+            const std::lock_guard lock{this->mutex_};
+            this->in_flight_ -= bytes;
+        }
+        this->released_.notify_all();
+    }
+
+  private:
+    /**
+     * @brief Maximum number of bytes in flight.
+     */
+    std::size_t capacity_;
+
+    /**
+     * @brief Number of bytes currently reserved.
+     */
+    std::size_t in_flight_ = 0;
+
+    /**
+     * @brief Guards "in_flight_".
+     */
+    std::mutex mutex_;
+
+    /**
+     * @brief Signalled whenever bytes are returned.
+     */
+    std::condition_variable released_;
+};
+
+/**
+ * @brief Counters updated concurrently by the workers.
+ */
+struct Counters {
+    std::atomic<std::size_t> files_processed{0};
+    std::atomic<std::size_t> files_changed{0};
+    std::atomic<std::size_t> files_failed{0};
+    std::atomic<std::size_t> bytes_processed{0};
+    std::atomic<std::size_t> replacements{0};
+    std::atomic<std::size_t> duplicates_removed{0};
+};
+
+/**
+ * @brief Convert a string to lowercase, ASCII only.
+ *
+ * @param value String to convert (e.g., ".TXT").
+ *
+ * @return Lowercase string (e.g., ".txt").
+ */
+[[nodiscard]] std::string to_lower_ascii(std::string value)
+{
+    for (char &character : value) {
+        character = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+    }
+    return value;
+}
+
+/**
+ * @brief Check whether a path is equal to, or located inside, a directory.
+ *
+ * @param path Path to check (e.g., "corpus/clean").
+ * @param directory Directory (e.g., "corpus").
+ *
+ * @return True if the path is inside the directory, false otherwise.
+ */
+[[nodiscard]] bool is_inside(const std::filesystem::path &path,
+                             const std::filesystem::path &directory)
+{
+    const std::filesystem::path normalized_path = std::filesystem::weakly_canonical(path);
+    const std::filesystem::path normalized_directory = std::filesystem::weakly_canonical(directory);
+    const auto [directory_end, path_it] = std::mismatch(normalized_directory.begin(), normalized_directory.end(), normalized_path.begin(), normalized_path.end());
+    static_cast<void>(path_it);
+    // Tolerate a trailing separator, which shows up as an empty last element
+    return directory_end == normalized_directory.end() || (std::next(directory_end) == normalized_directory.end() && directory_end->empty());
+}
+
+/**
+ * @brief Read a whole file into memory.
+ *
+ * @param path Path to the file.
+ * @param size Expected size of the file, used to size the buffer.
+ *
+ * @return File contents.
+ *
+ * @throws std::runtime_error if the file cannot be read.
+ */
+[[nodiscard]] std::string read_file(const std::filesystem::path &path,
+                                    const std::size_t size)
+{
+    std::ifstream stream{path, std::ios::binary};
+    if (!stream) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to open '{}' for reading", path.string()));
+    }
+    std::string content(size, '\0');
+    stream.read(content.data(), static_cast<std::streamsize>(size));
+    content.resize(static_cast<std::size_t>(stream.gcount()));
+    if (stream.bad()) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to read '{}'", path.string()));
+    }
+    return content;
+}
+
+/**
+ * @brief Write a file atomically by writing a temporary file next to it and renaming it over the destination.
+ *
+ * @param path Destination path.
+ * @param content Contents to write.
+ * @param permissions Mode of the written file, usually that of the source file (e.g., "owner_read | owner_write").
+ *
+ * @throws std::runtime_error if the file cannot be written or renamed.
+ */
+void write_file_atomically(const std::filesystem::path &path,
+                           const std::string &content,
+                           const std::filesystem::perms permissions)
+{
+    const std::filesystem::path temporary_path = std::filesystem::path{path}.concat(".ungpt-tmp");
+    {
+        std::ofstream stream{temporary_path, std::ios::binary | std::ios::trunc};
+        if (!stream) [[unlikely]] {
+            throw std::runtime_error(std::format("Failed to open '{}' for writing", temporary_path.string()));
+        }
+        stream.write(content.data(), static_cast<std::streamsize>(content.size()));
+        if (!stream.flush()) [[unlikely]] {
+            throw std::runtime_error(std::format("Failed to write '{}'", temporary_path.string()));
+        }
+    }
+
+    // The temporary file was created with the default mode, and the rename would otherwise replace the mode of the original with it
+    std::error_code ec;
+    std::filesystem::permissions(temporary_path, permissions, std::filesystem::perm_options::replace, ec);
+    if (ec) [[unlikely]] {
+        std::filesystem::remove(temporary_path, ec);
+        throw std::runtime_error(std::format("Failed to set the permissions of '{}'", temporary_path.string()));
+    }
+
+    std::filesystem::rename(temporary_path, path, ec);
+    if (ec) [[unlikely]] {
+        std::filesystem::remove(temporary_path, ec);
+        throw std::runtime_error(std::format("Failed to rename '{}' to '{}'", temporary_path.string(), path.string()));
+    }
+}
+
+}  // namespace
+
+double BatchReport::files_per_second() const
+{
+    return this->seconds > 0.0 ? static_cast<double>(this->files_processed) / this->seconds : 0.0;
+}
+
+double BatchReport::megabytes_per_second() const
+{
+    return this->seconds > 0.0 ? (static_cast<double>(this->bytes_processed) / (1024.0 * 1024.0)) / this->seconds : 0.0;
+}
+
+std::string BatchReport::summary() const
+{
+    return std::format("Processed {} files ({} changed, {} failed), {:.2f} MB in {:.2f} s: {:.1f} files/s, {:.2f} MB/s, {} replacements, {} duplicates removed",
+                       this->files_processed,
+                       this->files_changed,
+                       this->files_failed,
+                       static_cast<double>(this->bytes_processed) / (1024.0 * 1024.0),
+                       this->seconds,
+                       this->files_per_second(),
+                       this->megabytes_per_second(),
+                       this->replacements,
+                       this->duplicates_removed);
+}
+
+BatchReport run_batch(const BatchOptions &options)
+{
+    if (!std::filesystem::is_directory(options.input_directory)) {
+        throw std::invalid_argument(std::format("Input directory '{}' does not exist", options.input_directory.string()));
+    }
+    const bool in_place = options.output_directory.empty();
+    if (!in_place && is_inside(options.output_directory, options.input_directory)) {
+        throw std::invalid_argument(std::format("Output directory '{}' must not be inside the input directory '{}'", options.output_directory.string(), options.input_directory.string()));
+    }
+
+    std::vector<std::string> extensions;
+    extensions.reserve(options.extensions.size());
+    for (const std::string &extension : options.extensions) {
+        extensions.push_back(to_lower_ascii(extension));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    Counters counters;
+    ByteBudget budget{options.max_in_flight_bytes};
+    std::size_t files_submitted = 0;
+
+    // The pool already keeps every core busy with whole files, so each file is deduplicated on a single thread
+    dedupe::DedupeOptions dedupe_options = options.dedupe_options;
+    dedupe_options.thread_count = 1;
+
+    {
+        thread_pool::ThreadPool pool{options.thread_count};
+        SPDLOG_INFO("Normalizing '{}' with '{}' workers, writing {}", options.input_directory.string(), pool.size(), in_place ? "in place" : std::format("to '{}'", options.output_directory.string()));
+
+        // The walker runs on this thread and blocks on the budget, so it never reads ahead further than the budget allows
+        for (const std::filesystem::directory_entry &entry : std::filesystem::recursive_directory_iterator{options.input_directory}) {
+            if (!entry.is_regular_file()) {
+                continue;
+            }
+            const std::filesystem::path &source = entry.path();
+            const std::string extension = to_lower_ascii(source.extension().string());
+            if (std::none_of(extensions.cbegin(), extensions.cend(), [&extension](const std::string &allowed) { return allowed == extension; })) {
+                continue;
+            }
+
+            std::filesystem::path destination = source;
+            if (!in_place) {
+                destination = options.output_directory / std::filesystem::relative(source, options.input_directory);
+                std::filesystem::create_directories(destination.parent_path());
+            }
+
+            const auto size = static_cast<std::size_t>(entry.file_size());
+            const std::filesystem::perms permissions = entry.status().permissions();
+            budget.acquire(size);
+            ++files_submitted;
+
+            pool.submit([&options, &dedupe_options, &counters, &budget, in_place, source, destination, size, permissions] {
+                try {
+                    std::string content = read_file(source, size);
+                    const std::size_t replaced = text::remove_unwanted_characters(content, options.cleanup_options);
+                    const std::size_t duplicates = options.remove_duplicates ? dedupe::remove_duplicates(content, dedupe_options) : 0;
+                    if (replaced != 0 || duplicates != 0 || !in_place) {
+                        write_file_atomically(destination, content, permissions);
+                    }
+
+                    counters.files_processed.fetch_add(1, std::memory_order_relaxed);
+                    counters.bytes_processed.fetch_add(size, std::memory_order_relaxed);
+                    counters.replacements.fetch_add(replaced, std::memory_order_relaxed);
+                    counters.duplicates_removed.fetch_add(duplicates, std::memory_order_relaxed);
+                    if (replaced != 0 || duplicates != 0) {
+                        counters.files_changed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                catch (const std::exception &e) {
+                    SPDLOG_WARN("Skipping '{}': {}", source.string(), e.what());
+                    counters.files_failed.fetch_add(1, std::memory_order_relaxed);
+                }
+                budget.release(size);
+            });
+        }
+
+        pool.wait();
+    }
+
+    const BatchReport report{
+        .files_processed = counters.files_processed.load(),
+        .files_changed = counters.files_changed.load(),
+        .files_failed = counters.files_failed.load(),
+        .bytes_processed = counters.bytes_processed.load(),
+        .replacements = counters.replacements.load(),
+        .duplicates_removed = counters.duplicates_removed.load(),
+        .seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+    };
+
+    SPDLOG_DEBUG("Submitted '{}' files to the batch", files_submitted);
+    return report;
+}
+
+BatchOptions make_options(const args::Arguments &arguments)
+{
+    return {
+        .input_directory = arguments.batch_directory,
+        .output_directory = arguments.output_directory,
+        .thread_count = arguments.jobs,
+        .max_in_flight_bytes = arguments.max_in_flight_mb * 1024 * 1024,
+        .cleanup_options = arguments.cleanup_options,
+        .remove_duplicates = arguments.remove_duplicates,
+        .dedupe_options = arguments.dedupe_options,
+    };
+}
+
+}  // namespace core::batch
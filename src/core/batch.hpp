@@ -0,0 +1,151 @@
+/**
+ * @file batch.hpp
+ *
+ * @brief Headless, parallel normalization of every text file in a directory tree.
+ */
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <filesystem>  // for std::filesystem::path
+#include <string>      // for std::string
+#include <vector>      // for std::vector
+
+#include "core/args.hpp"
+#include "core/dedupe.hpp"
+#include "core/text.hpp"
+
+namespace core::batch {
+
+/**
+ * @brief Settings of a batch run.
+ */
+struct BatchOptions {
+    /**
+     * @brief Directory whose files are normalized, recursively (e.g., "corpus").
+     */
+    std::filesystem::path input_directory{};
+
+    /**
+     * @brief Directory that receives the normalized files with the same relative paths (e.g., "corpus-clean"), or empty to rewrite the files in place.
+     */
+    std::filesystem::path output_directory{};
+
+    /**
+     * @brief Extensions of the files to process, compared case-insensitively (e.g., {".txt", ".md"}).
+     */
+    std::vector<std::string> extensions{".txt", ".md", ".markdown"};
+
+    /**
+     * @brief Number of worker threads, or 0 to use the number of hardware threads.
+     */
+    std::size_t thread_count = 0;
+
+    /**
+     * @brief Maximum combined size of the files being processed at the same time, in bytes.
+     *
+     * Each file is held twice while it is processed (input and output), so peak memory is roughly twice this value. A single file larger than the budget is still processed, but alone.
+     */
+    std::size_t max_in_flight_bytes = 64 * 1024 * 1024;
+
+    /**
+     * @brief Optional cleanup rules applied to every file.
+     */
+    text::CleanupOptions cleanup_options{};
+
+    /**
+     * @brief Whether to remove lines or paragraphs that repeat an earlier one in the same file, after the cleanup rules.
+     */
+    bool remove_duplicates = false;
+
+    /**
+     * @brief Settings of the duplicate removal; its thread count is ignored, every file is deduplicated on the worker that processes it.
+     */
+    dedupe::DedupeOptions dedupe_options{};
+};
+
+/**
+ * @brief Aggregate statistics of a batch run.
+ */
+struct BatchReport {
+    /**
+     * @brief Number of files that were read and normalized.
+     */
+    std::size_t files_processed = 0;
+
+    /**
+     * @brief Number of processed files with at least one replacement.
+     */
+    std::size_t files_changed = 0;
+
+    /**
+     * @brief Number of files that could not be read or written.
+     */
+    std::size_t files_failed = 0;
+
+    /**
+     * @brief Total size of the processed files, in bytes.
+     */
+    std::size_t bytes_processed = 0;
+
+    /**
+     * @brief Total number of replacements over all files.
+     */
+    std::size_t replacements = 0;
+
+    /**
+     * @brief Total number of removed duplicate lines or paragraphs over all files.
+     */
+    std::size_t duplicates_removed = 0;
+
+    /**
+     * @brief Wall-clock duration of the run, in seconds.
+     */
+    double seconds = 0.0;
+
+    /**
+     * @brief Return the throughput in files per second.
+     *
+     * @return Files per second (e.g., "1520.4"), or 0 if the run took no measurable time.
+     */
+    [[nodiscard]] double files_per_second() const;
+
+    /**
+     * @brief Return the throughput in mebibytes per second.
+     *
+     * @return MB/s (e.g., "310.2"), or 0 if the run took no measurable time.
+     */
+    [[nodiscard]] double megabytes_per_second() const;
+
+    /**
+     * @brief Format the report as a single human-readable line.
+     *
+     * @return Summary (e.g., "Processed 120 files (3 changed, 0 failed), 12.30 MB in 0.52 s: 230.8 files/s, 23.65 MB/s, 412 replacements, 7 duplicates removed").
+     */
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * @brief Normalize every matching file below the input directory, in parallel.
+ *
+ * Files are written to a temporary file next to the destination first and then renamed over it, so a crash never leaves a half-written file behind. In place, unchanged files are not rewritten. Failures of individual files are logged and counted, they do not stop the run.
+ *
+ * @param options Settings of the run.
+ *
+ * @return Aggregate statistics.
+ *
+ * @throws std::invalid_argument if the input directory does not exist, or the output directory is inside the input directory.
+ * @throws std::filesystem::filesystem_error if the directory tree cannot be traversed.
+ */
+[[nodiscard]] BatchReport run_batch(const BatchOptions &options);
+
+/**
+ * @brief Build the settings of a run from the command line, shared by "ungpt --batch" and the headless "ungpt-batch" executable.
+ *
+ * @param arguments Parsed command-line arguments with "--batch <directory>" (e.g., from "args::parse_arguments()").
+ *
+ * @return Settings of the run.
+ */
+[[nodiscard]] BatchOptions make_options(const args::Arguments &arguments);
+
+}  // namespace core::batch
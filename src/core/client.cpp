@@ -0,0 +1,247 @@
+/**
+ * @file client.cpp
+ */
+
+#include <algorithm>     // for std::sort
+#include <chrono>        // for std::chrono::steady_clock, std::chrono::duration
+#include <cmath>         // for std::ceil
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint8_t
+#include <cstring>       // for std::memcpy
+#include <deque>         // for std::deque
+#include <exception>     // for std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <filesystem>    // for std::filesystem::path
+#include <format>        // for std::format
+#include <memory>        // for std::unique_ptr, std::make_unique
+#include <optional>      // for std::optional
+#include <stdexcept>     // for std::invalid_argument, std::runtime_error
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code, std::system_category
+#include <thread>        // for std::jthread
+#include <utility>       // for std::move
+#include <vector>        // for std::vector
+
+#if defined(__linux__)
+#include <cerrno>        // for errno, EINTR
+#include <sys/socket.h>  // for socket, connect, send, recv
+#include <sys/un.h>      // for sockaddr_un
+#include <unistd.h>      // for close
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "core/client.hpp"
+#include "core/posix.hpp"
+#include "core/protocol.hpp"
+
+namespace core::client {
+
+namespace {
+
+/**
+ * @brief Return the value below which a fraction of the sorted samples fall.
+ *
+ * @param sorted Samples in ascending order.
+ * @param fraction Fraction of the samples (e.g., "0.99").
+ *
+ * @return Percentile value, or 0 if there are no samples.
+ */
+[[nodiscard]] double percentile(const std::vector<double> &sorted,
+                                const double fraction)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+}  // namespace
+
+#if defined(__linux__)
+
+Client::Client(const std::filesystem::path &socket_path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = socket_path.string();
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error(std::format("Socket path '{}' must be between 1 and {} bytes long", path, sizeof(address.sun_path) - 1));
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    this->fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (this->fd_ < 0) [[unlikely]] {
+        posix::throw_errno("create socket");
+    }
+    if (connect(this->fd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) [[unlikely]] {
+        const std::error_code ec{errno, std::system_category()};
+        close(this->fd_);
+        throw std::runtime_error(std::format("Failed to connect to '{}': {}", path, ec.message()));
+    }
+}
+
+Client::~Client()
+{
+    close(this->fd_);
+}
+
+void Client::send(const protocol::Opcode opcode,
+                  const std::string_view body)
+{
+    std::string frame;
+    protocol::append_frame(frame, static_cast<std::uint8_t>(opcode), body);
+
+    std::size_t offset = 0;
+    while (offset < frame.size()) {
+        const ssize_t sent = ::send(this->fd_, frame.data() + offset, frame.size() - offset, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            posix::throw_errno("send request");
+        }
+        offset += static_cast<std::size_t>(sent);
+    }
+}
+
+protocol::Frame Client::receive()
+{
+    while (true) {
+        if (std::optional<protocol::Frame> frame = this->decoder_.next()) {
+            return std::move(*frame);
+        }
+
+        char buffer[64 * 1024];
+        const ssize_t received = recv(this->fd_, buffer, sizeof(buffer), 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            posix::throw_errno("receive response");
+        }
+        if (received == 0) {
+            throw std::runtime_error("Connection closed by the daemon");
+        }
+        this->decoder_.feed({buffer, static_cast<std::size_t>(received)});
+    }
+}
+
+#else
+
+Client::Client(const std::filesystem::path &)
+{
+    throw std::runtime_error("The normalization daemon is only supported on Linux");
+}
+
+Client::~Client() = default;
+
+void Client::send(const protocol::Opcode,
+                  const std::string_view) {}
+
+protocol::Frame Client::receive()
+{
+    return {};
+}
+
+#endif
+
+std::string Client::normalize(const std::string_view text)
+{
+    this->send(protocol::Opcode::Normalize, text);
+    protocol::Frame response = this->receive();
+    if (response.kind != static_cast<std::uint8_t>(protocol::Status::Ok)) [[unlikely]] {
+        throw std::runtime_error(std::format("Daemon reported an error: {}", response.body));
+    }
+    return std::move(response.body);
+}
+
+double LoadTestReport::requests_per_second() const
+{
+    return this->seconds > 0.0 ? static_cast<double>(this->requests) / this->seconds : 0.0;
+}
+
+std::string LoadTestReport::summary() const
+{
+    return std::format("{} requests in {:.2f} s: {:.0f} req/s, p50 {:.1f} us, p99 {:.1f} us",
+                       this->requests,
+                       this->seconds,
+                       this->requests_per_second(),
+                       this->p50_microseconds,
+                       this->p99_microseconds);
+}
+
+LoadTestReport run_load_test(const LoadTestOptions &options)
+{
+    if (options.connections == 0 || options.pipeline_depth == 0) {
+        throw std::invalid_argument("Load test needs at least one connection and a pipeline depth of at least one");
+    }
+
+    // Connect up front, so connection setup does not count towards the measured time
+    std::vector<std::unique_ptr<Client>> clients;
+    clients.reserve(options.connections);
+    for (std::size_t i = 0; i < options.connections; ++i) {
+        clients.push_back(std::make_unique<Client>(options.socket_path));
+    }
+
+    std::vector<std::vector<double>> latencies(options.connections);
+    std::vector<std::exception_ptr> errors(options.connections);
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(options.connections);
+        for (std::size_t i = 0; i < options.connections; ++i) {
+            threads.emplace_back([&options, &client = *clients[i], &samples = latencies[i], &error = errors[i]] {
+                try {
+                    samples.reserve(options.requests_per_connection);
+                    std::deque<std::chrono::steady_clock::time_point> sent_at;
+                    std::size_t sent = 0;
+                    while (samples.size() < options.requests_per_connection) {
+                        // Keep the pipeline full, then wait for the oldest response
+                        while (sent < options.requests_per_connection && sent_at.size() < options.pipeline_depth) {
+                            sent_at.push_back(std::chrono::steady_clock::now());
+                            client.send(options.opcode, options.payload);
+                            ++sent;
+                        }
+                        const protocol::Frame response = client.receive();
+                        if (response.kind != static_cast<std::uint8_t>(protocol::Status::Ok)) [[unlikely]] {
+                            throw std::runtime_error(std::format("Daemon reported an error: {}", response.body));
+                        }
+                        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent_at.front()).count());
+                        sent_at.pop_front();
+                    }
+                }
+                catch (...) {
+                    error = std::current_exception();
+                }
+            });
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const std::exception_ptr &error : errors) {
+        if (error) [[unlikely]] {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<double> all_latencies;
+    all_latencies.reserve(options.connections * options.requests_per_connection);
+    for (const std::vector<double> &samples : latencies) {
+        all_latencies.insert(all_latencies.end(), samples.cbegin(), samples.cend());
+    }
+    std::sort(all_latencies.begin(), all_latencies.end());
+
+    const LoadTestReport report{
+        .requests = all_latencies.size(),
+        .seconds = seconds,
+        .p50_microseconds = percentile(all_latencies, 0.50),
+        .p99_microseconds = percentile(all_latencies, 0.99),
+    };
+    SPDLOG_DEBUG("Load test finished: {}", report.summary());
+    return report;
+}
+
+}  // namespace core::client
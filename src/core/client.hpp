@@ -0,0 +1,169 @@
+/**
+ * @file client.hpp
+ *
+ * @brief Client and load generator for the normalization daemon (Linux only).
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <filesystem>   // for std::filesystem::path
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "core/protocol.hpp"
+
+namespace core::client {
+
+/**
+ * @brief Blocking connection to a running daemon.
+ */
+class Client final {
+  public:
+    /**
+     * @brief Construct a new Client object and connect to the daemon.
+     *
+     * @param socket_path Path of the daemon's Unix domain socket (e.g., "/tmp/ungpt.sock").
+     *
+     * @throws std::runtime_error if the connection fails, or the platform is not Linux.
+     */
+    explicit Client(const std::filesystem::path &socket_path);
+
+    /**
+     * @brief Close the connection.
+     */
+    ~Client();
+
+    Client(const Client &) = delete;
+    Client &operator=(const Client &) = delete;
+
+    /**
+     * @brief Send a request without waiting for its response, so several requests can be pipelined.
+     *
+     * @param opcode Operation to request.
+     * @param body Payload of the request (e.g., "hello world").
+     *
+     * @throws std::runtime_error if the connection fails.
+     */
+    void send(const protocol::Opcode opcode,
+              const std::string_view body);
+
+    /**
+     * @brief Wait for the next response; responses arrive in the order the requests were sent.
+     *
+     * @return Response frame, whose kind is a "protocol::Status".
+     *
+     * @throws std::runtime_error if the connection fails or the daemon closes it.
+     */
+    [[nodiscard]] protocol::Frame receive();
+
+    /**
+     * @brief Normalize text on the daemon and wait for the result.
+     *
+     * @param text Text to normalize (e.g., "“hello”").
+     *
+     * @return Normalized text (e.g., "\"hello\"").
+     *
+     * @throws std::runtime_error if the connection fails or the daemon reports an error.
+     */
+    [[nodiscard]] std::string normalize(const std::string_view text);
+
+  private:
+    /**
+     * @brief Connected socket.
+     */
+    int fd_ = -1;
+
+    /**
+     * @brief Splits received bytes into response frames.
+     */
+    protocol::FrameDecoder decoder_;
+};
+
+/**
+ * @brief Settings of a load test.
+ */
+struct LoadTestOptions {
+    /**
+     * @brief Path of the daemon's Unix domain socket (e.g., "/tmp/ungpt.sock").
+     */
+    std::filesystem::path socket_path{};
+
+    /**
+     * @brief Number of concurrent connections, each driven by its own thread.
+     */
+    std::size_t connections = 4;
+
+    /**
+     * @brief Number of requests sent over every connection.
+     */
+    std::size_t requests_per_connection = 10000;
+
+    /**
+     * @brief Maximum number of requests in flight per connection; 1 disables pipelining.
+     */
+    std::size_t pipeline_depth = 16;
+
+    /**
+     * @brief Operation to request.
+     */
+    protocol::Opcode opcode = protocol::Opcode::Normalize;
+
+    /**
+     * @brief Payload of every request.
+     */
+    std::string payload{};
+};
+
+/**
+ * @brief Results of a load test.
+ */
+struct LoadTestReport {
+    /**
+     * @brief Number of completed requests.
+     */
+    std::size_t requests = 0;
+
+    /**
+     * @brief Wall-clock duration of the test, in seconds.
+     */
+    double seconds = 0.0;
+
+    /**
+     * @brief Median latency from sending a request to receiving its response, in microseconds.
+     */
+    double p50_microseconds = 0.0;
+
+    /**
+     * @brief 99th-percentile latency, in microseconds.
+     */
+    double p99_microseconds = 0.0;
+
+    /**
+     * @brief Return the throughput in requests per second.
+     *
+     * @return Requests per second (e.g., "125000.0"), or 0 if the test took no measurable time.
+     */
+    [[nodiscard]] double requests_per_second() const;
+
+    /**
+     * @brief Format the report as a single human-readable line.
+     *
+     * @return Summary (e.g., "40000 requests in 0.32 s: 125000 req/s, p50 98.1 us, p99 310.4 us").
+     */
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * @brief Drive a running daemon with pipelined requests and measure throughput and latency.
+ *
+ * @param options Settings of the test.
+ *
+ * @return Measured results.
+ *
+ * @throws std::invalid_argument if the number of connections or the pipeline depth is 0.
+ * @throws std::runtime_error if a connection fails or the daemon reports an error.
+ */
+[[nodiscard]] LoadTestReport run_load_test(const LoadTestOptions &options);
+
+}  // namespace core::client
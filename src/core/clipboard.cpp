@@ -9,11 +9,15 @@
 #include <spdlog/spdlog.h>
 
 #include "core/clipboard.hpp"
+#include "core/memory.hpp"
 
 namespace core::clipboard {
 
 std::string read_from_clipboard()
 {
+    // Charge the UTF-32 and UTF-8 conversions, and the returned text, to the clipboard
+    const memory::Scope memory_scope{memory::Tag::Clipboard};
+
     // sf::Clipboard.getString() returns a sf::String (UTF-32)
     // We convert it to UTF-8 and then to raw std::string
     const sf::U8String utf8 = sf::Clipboard::getString().toUtf8();
@@ -26,6 +30,9 @@ std::string read_from_clipboard()
 
 void write_to_clipboard(const std::string &text)
 {
+    // Charge the UTF-32 copy to the clipboard
+    const memory::Scope memory_scope{memory::Tag::Clipboard};
+
     // sf::String handles conversion from UTF-8 to UTF-32
     const sf::String utf32 = sf::String::fromUtf8(text.cbegin(), text.cend());
     sf::Clipboard::setString(utf32);
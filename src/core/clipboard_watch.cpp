@@ -0,0 +1,285 @@
+/**
+ * @file clipboard_watch.cpp
+ */
+
+#include <array>        // for std::array
+#include <cerrno>       // for errno, EINTR
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <functional>   // for std::hash
+#include <memory>       // for std::make_unique
+#include <mutex>        // for std::lock_guard
+#include <stdexcept>    // for std::runtime_error
+#include <stop_token>   // for std::stop_token
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::move, std::swap
+
+#include <spdlog/spdlog.h>
+
+#include "core/clipboard_watch.hpp"
+#include "core/memory.hpp"
+#include "core/text.hpp"
+
+// Included last, Xlib defines macros such as "None", "Status", and "Bool" that would break the headers above
+#if defined(__linux__)
+#include <poll.h>         // for poll, pollfd
+#include <sys/eventfd.h>  // for eventfd
+#include <unistd.h>       // for close, write
+
+#include <X11/Xlib.h>
+#include <X11/extensions/Xfixes.h>
+#endif
+
+namespace core::clipboard_watch {
+
+bool ContentFilter::normalize_if_new(std::string &text,
+                                     const text::CleanupOptions &cleanup_options)
+{
+    const std::size_t hash = std::hash<std::string_view>{}(text);
+    if (this->has_last_hash_ && hash == this->last_hash_) {
+        return false;
+    }
+
+    const std::size_t replacements = text::remove_unwanted_characters(text, cleanup_options);
+
+    // Remember the normalized text, so it is recognized when it comes back after being written to the clipboard
+    this->last_hash_ = replacements == 0 ? hash : std::hash<std::string_view>{}(text);
+    this->has_last_hash_ = true;
+    return replacements != 0;
+}
+
+#if defined(__linux__)
+
+/**
+ * @brief Connection to the X server, owned by the background thread once it started.
+ */
+struct Watcher::Platform {
+    /**
+     * @brief Connection to the X server, separate from SFML's, so it can be used from the background thread.
+     */
+    Display *display = nullptr;
+
+    /**
+     * @brief Invisible window that receives the selection events and the converted clipboard contents.
+     */
+    Window window = 0;
+
+    /**
+     * @brief First event code of the XFixes extension.
+     */
+    int xfixes_event_base = 0;
+
+    /**
+     * @brief "CLIPBOARD" selection atom.
+     */
+    Atom clipboard = 0;
+
+    /**
+     * @brief "UTF8_STRING" target atom.
+     */
+    Atom utf8_string = 0;
+
+    /**
+     * @brief "INCR" type atom, used by owners for contents too large for a single property.
+     */
+    Atom incr = 0;
+
+    /**
+     * @brief Property the clipboard contents are converted into.
+     */
+    Atom property = 0;
+
+    /**
+     * @brief Eventfd used by the destructor to wake up the background thread.
+     */
+    int wake_fd = -1;
+
+    ~Platform()
+    {
+        if (this->wake_fd != -1) {
+            close(this->wake_fd);
+        }
+        if (this->display != nullptr) {
+            if (this->window != 0) {
+                XDestroyWindow(this->display, this->window);
+            }
+            XCloseDisplay(this->display);
+        }
+    }
+};
+
+Watcher::Watcher(const text::CleanupOptions &cleanup_options)
+    : platform_(std::make_unique<Platform>()),
+      cleanup_options_(cleanup_options)
+{
+    Platform &platform = *this->platform_;
+    platform.display = XOpenDisplay(nullptr);
+    if (platform.display == nullptr) [[unlikely]] {
+        throw std::runtime_error("Failed to open the X display for clipboard watching");
+    }
+    int xfixes_error_base = 0;
+    if (!XFixesQueryExtension(platform.display, &platform.xfixes_event_base, &xfixes_error_base)) [[unlikely]] {
+        throw std::runtime_error("The X server does not support the XFixes extension required for clipboard watching");
+    }
+
+    platform.window = XCreateSimpleWindow(platform.display, XDefaultRootWindow(platform.display), 0, 0, 1, 1, 0, 0, 0);
+    platform.clipboard = XInternAtom(platform.display, "CLIPBOARD", False);
+    platform.utf8_string = XInternAtom(platform.display, "UTF8_STRING", False);
+    platform.incr = XInternAtom(platform.display, "INCR", False);
+    platform.property = XInternAtom(platform.display, "UNGPT_CLIPBOARD_WATCH", False);
+
+    // Ask to be notified whenever another window takes ownership of the clipboard, which is what copying does
+    XFixesSelectSelectionInput(platform.display, platform.window, platform.clipboard, XFixesSetSelectionOwnerNotifyMask);
+    XFlush(platform.display);
+
+    platform.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (platform.wake_fd == -1) [[unlikely]] {
+        throw std::runtime_error("Failed to create the eventfd for clipboard watching");
+    }
+
+    // From here on, the display connection is only used by the background thread
+    this->thread_ = std::jthread{[this] { this->run(); }};
+    SPDLOG_INFO("Started watching the clipboard");
+}
+
+Watcher::~Watcher()
+{
+    // Wake the background thread up from "poll()", then wait for it before the connection is closed
+    const std::uint64_t value = 1;
+    [[maybe_unused]] const ssize_t written = write(this->platform_->wake_fd, &value, sizeof(value));
+    this->thread_.request_stop();
+    this->thread_.join();
+    SPDLOG_INFO("Stopped watching the clipboard after '{}' hits", this->hit_count());
+}
+
+bool Watcher::is_supported()
+{
+    return true;
+}
+
+void Watcher::run()
+{
+    Platform &platform = *this->platform_;
+    const std::stop_token stop_token = this->thread_.get_stop_token();
+
+    // Charge the copied texts and their normalized copies to the clipboard
+    const memory::Scope memory_scope{memory::Tag::Clipboard};
+
+    while (!stop_token.stop_requested()) {
+        // Handle every queued event first, "poll()" only reports data that Xlib has not buffered yet
+        while (XPending(platform.display) > 0) {
+            XEvent event;
+            XNextEvent(platform.display, &event);
+
+            // The clipboard has a new owner, ask it to convert the contents to UTF-8 into our property
+            if (event.type == platform.xfixes_event_base + XFixesSelectionNotify) {
+                const auto *notify = reinterpret_cast<const XFixesSelectionNotifyEvent *>(&event);
+                if (notify->owner != None) {
+                    XConvertSelection(platform.display, platform.clipboard, platform.utf8_string, platform.property, platform.window, notify->selection_timestamp);
+                }
+            }
+
+            // The owner answered the conversion request
+            else if (event.type == SelectionNotify) {
+                if (event.xselection.property == None) {
+                    SPDLOG_DEBUG("The clipboard owner cannot convert its contents to UTF-8");
+                    continue;
+                }
+                Atom type = 0;
+                int format = 0;
+                unsigned long item_count = 0;
+                unsigned long bytes_after = 0;
+                unsigned char *data = nullptr;
+                XGetWindowProperty(platform.display, platform.window, platform.property, 0, 0x7FFFFFFF, True, AnyPropertyType, &type, &format, &item_count, &bytes_after, &data);
+                if (type == platform.incr) {
+                    SPDLOG_DEBUG("Skipped clipboard contents too large for a single transfer");
+                }
+                else if (data != nullptr && format == 8) {
+                    this->process(std::string{reinterpret_cast<const char *>(data), item_count});
+                }
+                if (data != nullptr) {
+                    XFree(data);
+                }
+            }
+        }
+
+        // Sleep until the X server sends something or the destructor wakes us up
+        std::array<pollfd, 2> fds = {{
+            {.fd = XConnectionNumber(platform.display), .events = POLLIN, .revents = 0},
+            {.fd = platform.wake_fd, .events = POLLIN, .revents = 0},
+        }};
+        if (poll(fds.data(), fds.size(), -1) == -1 && errno != EINTR) [[unlikely]] {
+            SPDLOG_ERROR("Failed to wait for clipboard changes, stopped watching");
+            return;
+        }
+    }
+}
+
+#else
+
+/**
+ * @brief Placeholder, clipboard watching is only implemented for X11.
+ */
+struct Watcher::Platform {};
+
+Watcher::Watcher(const text::CleanupOptions &cleanup_options)
+    : cleanup_options_(cleanup_options)
+{
+    throw std::runtime_error("Clipboard watching is only supported on X11");
+}
+
+Watcher::~Watcher() = default;
+
+bool Watcher::is_supported()
+{
+    return false;
+}
+
+void Watcher::run() {}
+
+#endif
+
+void Watcher::set_cleanup_options(const text::CleanupOptions &cleanup_options)
+{
+    const std::lock_guard lock{this->mutex_};
+    this->cleanup_options_ = cleanup_options;
+}
+
+bool Watcher::take_normalized(std::string &text)
+{
+    // Checked without locking, so an idle frame costs a single atomic load
+    if (!this->has_pending_text_.load(std::memory_order_acquire)) [[likely]] {
+        return false;
+    }
+    const std::lock_guard lock{this->mutex_};
+    std::swap(text, this->pending_text_);
+    this->has_pending_text_.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void Watcher::process(std::string text)
+{
+    text::CleanupOptions cleanup_options;
+    {
+        const std::lock_guard lock{this->mutex_};
+        cleanup_options = this->cleanup_options_;
+    }
+
+    // Normalizing large contents happens here, off the UI thread
+    if (!this->filter_.normalize_if_new(text, cleanup_options)) {
+        return;
+    }
+
+    // A newer copy replaces contents the UI thread did not take yet, only the latest one is worth writing back
+    [[maybe_unused]] const std::size_t size = text.size();
+    {
+        const std::lock_guard lock{this->mutex_};
+        this->pending_text_ = std::move(text);
+        this->has_pending_text_.store(true, std::memory_order_release);
+    }
+    [[maybe_unused]] const std::size_t hits = this->hit_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+    SPDLOG_DEBUG("Normalized copied text ('{}' bytes, hit '{}')", size, hits);
+}
+
+}  // namespace core::clipboard_watch
@@ -0,0 +1,168 @@
+/**
+ * @file clipboard_watch.hpp
+ *
+ * @brief Background watcher that normalizes text copied to the system clipboard (X11 only).
+ */
+
+#pragma once
+
+#include <atomic>   // for std::atomic
+#include <cstddef>  // for std::size_t
+#include <memory>   // for std::unique_ptr
+#include <mutex>    // for std::mutex
+#include <string>   // for std::string
+#include <thread>   // for std::jthread
+
+#include "core/text.hpp"
+
+namespace core::clipboard_watch {
+
+/**
+ * @brief Decides whether clipboard contents are new, and normalizes them if so.
+ *
+ * Only a hash of the last contents is kept, so re-reading the same text (or the normalized text this filter produced, once it is written back) costs a single hashing pass and no normalization.
+ */
+class ContentFilter final {
+  public:
+    /**
+     * @brief Normalize the clipboard contents if they differ from the last ones seen.
+     *
+     * @param text Clipboard contents, normalized in place if they are new (e.g., "a — b").
+     * @param cleanup_options Optional cleanup rules to apply as well.
+     *
+     * @return True if the contents were new and normalizing changed them, so they should be written back; false otherwise.
+     */
+    [[nodiscard]] bool normalize_if_new(std::string &text,
+                                        const text::CleanupOptions &cleanup_options);
+
+  private:
+    /**
+     * @brief Hash of the last contents seen, after normalization.
+     */
+    std::size_t last_hash_ = 0;
+
+    /**
+     * @brief Whether "last_hash_" holds a value.
+     */
+    bool has_last_hash_ = false;
+};
+
+/**
+ * @brief Watches the system clipboard on a background thread and normalizes every new text copied to it.
+ *
+ * Changes are detected through XFixes selection owner notifications, so nothing runs while the clipboard is untouched. The new contents are read, hashed, and normalized on the background thread; the UI thread only writes the result back through "take_normalized()", because SFML serves clipboard requests from the window's event loop.
+ */
+class Watcher final {
+  public:
+    /**
+     * @brief Construct a new Watcher object and start watching.
+     *
+     * @param cleanup_options Optional cleanup rules applied to the copied text.
+     *
+     * @throws std::runtime_error if the platform is not X11, the display cannot be opened, or the XFixes extension is missing.
+     */
+    explicit Watcher(const text::CleanupOptions &cleanup_options = {});
+
+    /**
+     * @brief Stop watching and join the background thread.
+     */
+    ~Watcher();
+
+    Watcher(const Watcher &) = delete;
+    Watcher &operator=(const Watcher &) = delete;
+
+    /**
+     * @brief Return whether clipboard watching is available on this platform at all.
+     *
+     * @return True on X11 builds, false otherwise. The display may still fail to open at runtime (e.g., under Wayland without XWayland).
+     */
+    [[nodiscard]] static bool is_supported();
+
+    /**
+     * @brief Replace the cleanup rules applied to text copied from now on.
+     *
+     * @param cleanup_options Optional cleanup rules.
+     */
+    void set_cleanup_options(const text::CleanupOptions &cleanup_options);
+
+    /**
+     * @brief Take the latest normalized clipboard contents that still have to be written back, if any.
+     *
+     * Does not lock or allocate when there is nothing new, so it can be called every frame.
+     *
+     * @param text String that receives the normalized contents; its old buffer is handed back to the watcher for reuse.
+     *
+     * @return True if "text" now holds contents to write back, false if nothing changed.
+     */
+    [[nodiscard]] bool take_normalized(std::string &text);
+
+    /**
+     * @brief Return the number of copied texts that were normalized so far.
+     *
+     * @return Number of hits (e.g., "3").
+     */
+    [[nodiscard]] std::size_t hit_count() const
+    {
+        return this->hit_count_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    /**
+     * @brief Platform connection and window, defined in the source file so the platform headers do not leak.
+     */
+    struct Platform;
+
+    /**
+     * @brief Wait for clipboard changes and process them until the watcher is destroyed; runs on the background thread.
+     */
+    void run();
+
+    /**
+     * @brief Normalize new clipboard contents and hand them to the UI thread; runs on the background thread.
+     *
+     * @param text Clipboard contents, in UTF-8.
+     */
+    void process(std::string text);
+
+    /**
+     * @brief Platform connection and window.
+     */
+    std::unique_ptr<Platform> platform_;
+
+    /**
+     * @brief Filter that remembers the last contents, only used by the background thread.
+     */
+    ContentFilter filter_;
+
+    /**
+     * @brief Guards "cleanup_options_" and "pending_text_".
+     */
+    std::mutex mutex_;
+
+    /**
+     * @brief Cleanup rules applied to the copied text.
+     */
+    text::CleanupOptions cleanup_options_;
+
+    /**
+     * @brief Normalized contents waiting to be written back by the UI thread.
+     */
+    std::string pending_text_;
+
+    /**
+     * @brief Whether "pending_text_" holds contents that were not taken yet.
+     */
+    std::atomic<bool> has_pending_text_{false};
+
+    /**
+     * @brief Number of copied texts that were normalized.
+     */
+    std::atomic<std::size_t> hit_count_{0};
+
+    /**
+     * @brief Background thread, declared last so it starts after, and is joined before, everything above is destroyed.
+     */
+    std::jthread thread_;
+};
+
+}  // namespace core::clipboard_watch
@@ -0,0 +1,241 @@
+/**
+ * @file compress.cpp
+ */
+
+#include <algorithm>    // for std::min
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <cstring>      // for std::memcpy
+#include <format>       // for std::format
+#include <memory>       // for std::make_unique
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "core/compress.hpp"
+
+namespace core::compress {
+
+namespace {
+
+/**
+ * @brief Shortest match the format can express.
+ */
+constexpr std::size_t MIN_MATCH = 4;
+
+/**
+ * @brief Farthest back a match may start, the largest 16-bit offset.
+ */
+constexpr std::size_t MAX_OFFSET = 65535;
+
+/**
+ * @brief Number of bytes at the end of a block that must be literals, as required by the format.
+ */
+constexpr std::size_t LAST_LITERALS = 5;
+
+/**
+ * @brief Distance from the end of a block after which no match may start, as required by the format.
+ */
+constexpr std::size_t MATCH_START_LIMIT = 12;
+
+/**
+ * @brief Number of bits of the hash table index.
+ */
+constexpr int HASH_BITS = 16;
+
+/**
+ * @brief Read four bytes as an integer in host order; only ever compared or hashed, so endianness does not matter.
+ *
+ * @param data Pointer to the first byte, at least four bytes must be readable.
+ *
+ * @return Integer value.
+ */
+[[nodiscard]] std::uint32_t read_u32(const char *data)
+{
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Hash a 4-byte sequence into a table index (Knuth's multiplicative hash).
+ *
+ * @param sequence Sequence to hash.
+ *
+ * @return Index below "1 << HASH_BITS".
+ */
+[[nodiscard]] std::size_t hash_sequence(const std::uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/**
+ * @brief Append a length that did not fit into its 4-bit token field, as a run of 255 bytes and a remainder.
+ *
+ * @param output Block to append to.
+ * @param length Part of the length above 15 (e.g., "300").
+ */
+void append_length(std::string &output,
+                   std::size_t length)
+{
+    for (; length >= 255; length -= 255) {
+        output.push_back(static_cast<char>(255));
+    }
+    output.push_back(static_cast<char>(length));
+}
+
+/**
+ * @brief Append one sequence: literals, followed by a match unless this is the last sequence.
+ *
+ * @param output Block to append to.
+ * @param literals Literal bytes copied as they are.
+ * @param offset Distance back to the start of the match, or 0 for the last sequence.
+ * @param match_length Length of the match, at least "MIN_MATCH" unless this is the last sequence.
+ */
+void append_sequence(std::string &output,
+                     const std::string_view literals,
+                     const std::size_t offset,
+                     const std::size_t match_length)
+{
+    const std::size_t literal_length = literals.size();
+    const std::size_t match_code = offset != 0 ? match_length - MIN_MATCH : 0;
+    const std::size_t token = (std::min<std::size_t>(literal_length, 15) << 4) | std::min<std::size_t>(match_code, 15);
+    output.push_back(static_cast<char>(token));
+    if (literal_length >= 15) {
+        append_length(output, literal_length - 15);
+    }
+    output.append(literals);
+    if (offset == 0) {
+        return;
+    }
+    output.push_back(static_cast<char>(offset & 0xFF));
+    output.push_back(static_cast<char>(offset >> 8));
+    if (match_code >= 15) {
+        append_length(output, match_code - 15);
+    }
+}
+
+}  // namespace
+
+std::string compress(const std::string_view input)
+{
+    std::string output;
+    output.reserve(input.size() + input.size() / 255 + 16);
+
+    // Inputs too short to hold a match are a single run of literals
+    if (input.size() < MATCH_START_LIMIT + 1) {
+        append_sequence(output, input, 0, 0);
+        return output;
+    }
+
+    // Most recent position of every hashed 4-byte sequence; heap-allocated, as 256 KiB would strain the stack of worker threads
+    const auto table = std::make_unique<std::array<std::uint32_t, std::size_t{1} << HASH_BITS>>();
+    table->fill(0);
+
+    const char *const data = input.data();
+    const std::size_t match_start_limit = input.size() - MATCH_START_LIMIT;
+    const std::size_t match_end_limit = input.size() - LAST_LITERALS;
+    std::size_t anchor = 0;
+    std::size_t position = 0;
+    while (position < match_start_limit) {
+        const std::uint32_t sequence = read_u32(data + position);
+        std::uint32_t &slot = (*table)[hash_sequence(sequence)];
+        std::size_t candidate = slot;
+        slot = static_cast<std::uint32_t>(position);
+
+        // Without a match, step further the longer the literal run gets, so incompressible data is skipped quickly
+        if (candidate >= position || position - candidate > MAX_OFFSET || read_u32(data + candidate) != sequence) {
+            position += 1 + ((position - anchor) >> 6);
+            continue;
+        }
+
+        // Extend the match forwards, then backwards into the pending literals
+        std::size_t length = MIN_MATCH;
+        while (position + length < match_end_limit && data[candidate + length] == data[position + length]) {
+            ++length;
+        }
+        while (position > anchor && candidate > 0 && data[position - 1] == data[candidate - 1]) {
+            --position;
+            --candidate;
+            ++length;
+        }
+
+        append_sequence(output, input.substr(anchor, position - anchor), position - candidate, length);
+        position += length;
+        anchor = position;
+    }
+
+    append_sequence(output, input.substr(anchor), 0, 0);
+    return output;
+}
+
+std::string decompress(const std::string_view block,
+                       const std::size_t original_size)
+{
+    std::string output(original_size, '\0');
+    std::size_t in = 0;
+    std::size_t out = 0;
+
+    // Read a length continued in 255-byte steps after its 4-bit token field
+    const auto read_length = [&block, &in](std::size_t length) {
+        if (length != 15) {
+            return length;
+        }
+        unsigned char byte = 255;
+        while (byte == 255) {
+            if (in >= block.size()) [[unlikely]] {
+                throw std::runtime_error("Compressed block ends inside a length");
+            }
+            byte = static_cast<unsigned char>(block[in++]);
+            length += byte;
+        }
+        return length;
+    };
+
+    while (in < block.size()) {
+        const auto token = static_cast<unsigned char>(block[in++]);
+
+        // Copy the literals
+        const std::size_t literal_length = read_length(static_cast<std::size_t>(token >> 4));
+        if (literal_length > block.size() - in || literal_length > original_size - out) [[unlikely]] {
+            throw std::runtime_error(std::format("Literal run of '{}' bytes overflows the compressed block", literal_length));
+        }
+        std::memcpy(output.data() + out, block.data() + in, literal_length);
+        in += literal_length;
+        out += literal_length;
+
+        // The last sequence has no match
+        if (in == block.size()) {
+            break;
+        }
+
+        // Copy the match; an overlapping one (e.g., a run of one repeated character) reads the bytes it produces, so it is copied byte by byte
+        if (block.size() - in < 2) [[unlikely]] {
+            throw std::runtime_error("Compressed block ends inside a match offset");
+        }
+        const std::size_t offset = static_cast<std::size_t>(static_cast<unsigned char>(block[in])) |
+                                   (static_cast<std::size_t>(static_cast<unsigned char>(block[in + 1])) << 8);
+        in += 2;
+        const std::size_t match_length = read_length(static_cast<std::size_t>(token & 0x0F)) + MIN_MATCH;
+        if (offset == 0 || offset > out || match_length > original_size - out) [[unlikely]] {
+            throw std::runtime_error(std::format("Match of '{}' bytes at offset '{}' is outside the decompressed text", match_length, offset));
+        }
+        if (offset >= match_length) [[likely]] {
+            std::memcpy(output.data() + out, output.data() + out - offset, match_length);
+            out += match_length;
+        }
+        else {
+            for (std::size_t i = 0; i < match_length; ++i, ++out) {
+                output[out] = output[out - offset];
+            }
+        }
+    }
+
+    if (out != original_size) [[unlikely]] {
+        throw std::runtime_error(std::format("Compressed block holds '{}' bytes, expected '{}'", out, original_size));
+    }
+    return output;
+}
+
+}  // namespace core::compress
@@ -0,0 +1,39 @@
+/**
+ * @file compress.hpp
+ *
+ * @brief Fast lossless compression of text buffers, in the LZ4 block format.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+namespace core::compress {
+
+/**
+ * @brief Compress bytes into an LZ4 block.
+ *
+ * Matches are found through a single-probe hash table of 4-byte sequences, which trades ratio for speed: typical text shrinks to about half, at several hundred megabytes per second. The block does not store the original size, the caller keeps it for "decompress()".
+ *
+ * @param input Bytes to compress (e.g., "hello hello hello").
+ *
+ * @return Compressed block, never larger than "input.size() + input.size() / 255 + 16" bytes.
+ */
+[[nodiscard]] std::string compress(const std::string_view input);
+
+/**
+ * @brief Decompress an LZ4 block produced by "compress()" (or any LZ4 block encoder).
+ *
+ * @param block Compressed block.
+ * @param original_size Size of the original bytes (e.g., "17").
+ *
+ * @return Original bytes.
+ *
+ * @throws std::runtime_error if the block is malformed or does not decompress to exactly "original_size" bytes.
+ */
+[[nodiscard]] std::string decompress(const std::string_view block,
+                                     const std::size_t original_size);
+
+}  // namespace core::compress
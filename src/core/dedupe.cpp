@@ -0,0 +1,515 @@
+/**
+ * @file dedupe.cpp
+ */
+
+#include <algorithm>    // for std::max, std::min
+#include <array>        // for std::array
+#include <bit>          // for std::bit_ceil, std::rotl
+#include <cmath>        // for std::isnan
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <cstring>      // for std::memchr
+#include <format>       // for std::format
+#include <limits>       // for std::numeric_limits
+#include <stdexcept>    // for std::invalid_argument
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <thread>       // for std::jthread, std::thread::hardware_concurrency
+#include <vector>       // for std::vector
+
+#include "core/dedupe.hpp"
+#include "core/diff.hpp"
+
+namespace core::dedupe {
+
+namespace {
+
+/**
+ * @brief Primes of XXH64.
+ */
+constexpr std::uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr std::uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+constexpr std::uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+constexpr std::uint64_t PRIME_5 = 0x27D4EB2F165667C5ull;
+
+/**
+ * @brief Number of hash functions in a MinHash signature.
+ */
+constexpr std::size_t SIGNATURE_SIZE = 32;
+
+/**
+ * @brief Number of signature values per locality-sensitive hashing band; two units become candidates if all values of any band match.
+ *
+ * With 8 bands of 4 values, units with a similarity of 0.8 are candidates with a probability above 0.99, and units with a similarity of 0.3 with a probability below 0.07.
+ */
+constexpr std::size_t BAND_SIZE = 4;
+
+/**
+ * @brief Number of locality-sensitive hashing bands.
+ */
+constexpr std::size_t BAND_COUNT = SIGNATURE_SIZE / BAND_SIZE;
+
+/**
+ * @brief Number of consecutive words hashed together into one shingle.
+ */
+constexpr std::size_t SHINGLE_SIZE = 3;
+
+/**
+ * @brief Read a little-endian integer of "Size" bytes, independent of the host's endianness (compilers fold this into a single load).
+ *
+ * @param data Pointer to the first byte, at least "Size" bytes must be readable.
+ *
+ * @return Integer value.
+ */
+template <std::size_t Size>
+[[nodiscard]] std::uint64_t read_little_endian(const char *data)
+{
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < Size; ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Mix one 8-byte lane into an XXH64 accumulator.
+ *
+ * @param accumulator Accumulator to update.
+ * @param input Lane to mix in.
+ *
+ * @return Updated accumulator.
+ */
+[[nodiscard]] constexpr std::uint64_t xxh64_round(std::uint64_t accumulator,
+                                                  const std::uint64_t input)
+{
+    accumulator += input * PRIME_2;
+    accumulator = std::rotl(accumulator, 31);
+    return accumulator * PRIME_1;
+}
+
+/**
+ * @brief Merge one of the four XXH64 accumulators into the hash.
+ *
+ * @param hash Hash to update.
+ * @param accumulator Accumulator to merge.
+ *
+ * @return Updated hash.
+ */
+[[nodiscard]] constexpr std::uint64_t xxh64_merge(std::uint64_t hash,
+                                                  const std::uint64_t accumulator)
+{
+    hash ^= xxh64_round(0, accumulator);
+    return hash * PRIME_1 + PRIME_4;
+}
+
+/**
+ * @brief Scramble the bits of a 64-bit value, so every input bit affects every output bit (the SplitMix64 finalizer).
+ *
+ * @param value Value to scramble (e.g., "42").
+ *
+ * @return Scrambled value.
+ */
+[[nodiscard]] constexpr std::uint64_t mix(std::uint64_t value)
+{
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief Seeds of the MinHash functions; function "i" is "mix(shingle ^ seed[i])".
+ */
+constexpr std::array<std::uint64_t, SIGNATURE_SIZE> MINHASH_SEEDS = [] {
+    std::array<std::uint64_t, SIGNATURE_SIZE> seeds{};
+    for (std::size_t i = 0; i < SIGNATURE_SIZE; ++i) {
+        seeds[i] = mix(PRIME_5 * (i + 1));
+    }
+    return seeds;
+}();
+
+/**
+ * @brief Check whether a byte is ASCII whitespace.
+ *
+ * @param character Byte to check (e.g., ' ').
+ *
+ * @return True for space, tab, line feed, carriage return, vertical tab, and form feed.
+ */
+[[nodiscard]] constexpr bool is_space(const char character)
+{
+    return character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\v' || character == '\f';
+}
+
+/**
+ * @brief Position of a unit in the text.
+ */
+struct Span {
+    /**
+     * @brief Byte offset of the first byte of the unit.
+     */
+    std::size_t begin = 0;
+
+    /**
+     * @brief Byte offset one past the last compared byte, without trailing whitespace.
+     */
+    std::size_t content_end = 0;
+
+    /**
+     * @brief Byte offset one past the last byte removed with the unit, including the line break or blank lines after it.
+     */
+    std::size_t end = 0;
+};
+
+/**
+ * @brief Split the text into units, skipping blank lines.
+ *
+ * @param text Text to split (e.g., "a\n\nb\n").
+ * @param unit Part of the text to split into.
+ *
+ * @return Units in order of appearance.
+ */
+[[nodiscard]] std::vector<Span> split_units(const std::string_view text,
+                                            const Unit unit)
+{
+    std::vector<Span> spans;
+    std::size_t position = 0;
+    bool previous_line_is_blank = true;
+    while (position < text.size()) {
+        // Find the end of the current line, the line break itself belongs to it
+        const void *newline = std::memchr(text.data() + position, '\n', text.size() - position);
+        const std::size_t line_end = newline != nullptr ? static_cast<std::size_t>(static_cast<const char *>(newline) - text.data()) + 1 : text.size();
+        std::size_t content_end = line_end;
+        while (content_end > position && is_space(text[content_end - 1])) {
+            --content_end;
+        }
+
+        const bool is_blank = content_end == position;
+        if (is_blank) {
+            // A blank line ends the current paragraph, and is removed with it; between single lines, it is kept
+            if (unit == Unit::Paragraph && !spans.empty()) {
+                spans.back().end = line_end;
+            }
+        }
+        else if (unit == Unit::Paragraph && !previous_line_is_blank) {
+            // A non-blank line directly after a non-blank line continues the paragraph
+            spans.back().content_end = content_end;
+            spans.back().end = line_end;
+        }
+        else {
+            spans.push_back({.begin = position, .content_end = content_end, .end = line_end});
+        }
+        previous_line_is_blank = is_blank;
+        position = line_end;
+    }
+    return spans;
+}
+
+/**
+ * @brief Compute the MinHash signature of a unit from its three-word shingles.
+ *
+ * @param content Compared bytes of the unit (e.g., "the quick brown fox").
+ * @param signature Receives "SIGNATURE_SIZE" values.
+ */
+void compute_signature(const std::string_view content,
+                       std::uint64_t *signature)
+{
+    std::fill(signature, signature + SIGNATURE_SIZE, std::numeric_limits<std::uint64_t>::max());
+
+    // Fold a shingle hash into every MinHash function
+    const auto add_shingle = [signature](const std::uint64_t shingle) {
+        for (std::size_t i = 0; i < SIGNATURE_SIZE; ++i) {
+            signature[i] = std::min(signature[i], mix(shingle ^ MINHASH_SEEDS[i]));
+        }
+    };
+
+    // Keep the hashes of the last three words, so every shingle is hashed from them without rescanning any word
+    std::array<std::uint64_t, SHINGLE_SIZE> words{};
+    std::size_t word_count = 0;
+    std::size_t position = 0;
+    while (position < content.size()) {
+        while (position < content.size() && is_space(content[position])) {
+            ++position;
+        }
+        const std::size_t word_begin = position;
+        while (position < content.size() && !is_space(content[position])) {
+            ++position;
+        }
+        if (position == word_begin) {
+            break;
+        }
+        words[0] = words[1];
+        words[1] = words[2];
+        words[2] = hash_bytes(content.substr(word_begin, position - word_begin));
+        if (++word_count >= SHINGLE_SIZE) {
+            add_shingle(words[0] ^ std::rotl(words[1], 21) ^ std::rotl(words[2], 42));
+        }
+    }
+
+    // A unit shorter than a shingle is a single shingle of its words
+    if (word_count < SHINGLE_SIZE) {
+        add_shingle(words[0] ^ std::rotl(words[1], 21) ^ std::rotl(words[2], 42));
+    }
+}
+
+/**
+ * @brief Run a function over the index range "[0, count)", split into contiguous chunks on several threads if the text is large.
+ *
+ * @param count Number of items (e.g., "1000").
+ * @param text_size Size of the text the items come from, in bytes (e.g., "8388608").
+ * @param thread_count Number of threads, or 0 to use the number of hardware threads.
+ * @param function Function called with the first and one-past-last index of every chunk; it must not throw.
+ */
+template <typename Function>
+void for_each_chunk(const std::size_t count,
+                    const std::size_t text_size,
+                    const std::size_t thread_count,
+                    const Function &function)
+{
+    const std::size_t threads = thread_count != 0 ? thread_count : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    const std::size_t chunk_count = text_size < PARALLEL_THRESHOLD ? 1 : std::min(threads, count);
+    if (chunk_count <= 1) [[likely]] {
+        function(std::size_t{0}, count);
+        return;
+    }
+
+    // The calling thread takes the first chunk, the others are joined when "workers" goes out of scope
+    std::vector<std::jthread> workers;
+    workers.reserve(chunk_count - 1);
+    for (std::size_t chunk = 1; chunk < chunk_count; ++chunk) {
+        workers.emplace_back([&function, count, chunk_count, chunk] {
+            function(count * chunk / chunk_count, count * (chunk + 1) / chunk_count);
+        });
+    }
+    function(std::size_t{0}, count / chunk_count);
+}
+
+/**
+ * @brief Open-addressing hash table from 64-bit hashes to unit indices, with linear probing.
+ *
+ * The table never grows: it is sized for the number of insertions up front, at a load factor of at most one half.
+ */
+class IndexTable final {
+  public:
+    /**
+     * @brief Construct a new IndexTable object.
+     *
+     * @param capacity Maximum number of insertions (e.g., "1000").
+     */
+    explicit IndexTable(const std::size_t capacity)
+        : slots_(std::bit_ceil(std::max<std::size_t>(16, capacity * 2))),
+          mask_(slots_.size() - 1)
+    {
+    }
+
+    /**
+     * @brief Find an inserted index with the given hash that satisfies a predicate.
+     *
+     * @param hash Hash to look up.
+     * @param predicate Called with every inserted index with an equal hash, in insertion order, until it returns true.
+     *
+     * @return Index for which the predicate returned true, or "NOT_FOUND".
+     */
+    template <typename Predicate>
+    [[nodiscard]] std::size_t find(const std::uint64_t hash,
+                                   const Predicate &predicate) const
+    {
+        for (std::size_t position = hash & this->mask_;; position = (position + 1) & this->mask_) {
+            const Slot &slot = this->slots_[position];
+            if (slot.index == NOT_FOUND) {
+                return NOT_FOUND;
+            }
+            if (slot.hash == hash && predicate(slot.index)) {
+                return slot.index;
+            }
+        }
+    }
+
+    /**
+     * @brief Insert an index under a hash; indices with equal hashes are kept side by side.
+     *
+     * @param hash Hash of the unit.
+     * @param index Index of the unit.
+     */
+    void insert(const std::uint64_t hash,
+                const std::size_t index)
+    {
+        std::size_t position = hash & this->mask_;
+        while (this->slots_[position].index != NOT_FOUND) {
+            position = (position + 1) & this->mask_;
+        }
+        this->slots_[position] = {.hash = hash, .index = index};
+    }
+
+    /**
+     * @brief Index returned by "find()" if nothing matches, also marking empty slots.
+     */
+    static constexpr std::size_t NOT_FOUND = std::numeric_limits<std::size_t>::max();
+
+  private:
+    /**
+     * @brief Single table entry.
+     */
+    struct Slot {
+        /**
+         * @brief Full hash, compared before the predicate is called.
+         */
+        std::uint64_t hash = 0;
+
+        /**
+         * @brief Inserted index, or "NOT_FOUND" if the slot is empty.
+         */
+        std::size_t index = NOT_FOUND;
+    };
+
+    /**
+     * @brief Slots, a power of two in number.
+     */
+    std::vector<Slot> slots_;
+
+    /**
+     * @brief Number of slots minus one, for wrapping positions.
+     */
+    std::size_t mask_;
+};
+
+}  // namespace
+
+std::uint64_t hash_bytes(const std::string_view bytes,
+                         const std::uint64_t seed)
+{
+    const char *data = bytes.data();
+    const char *const end = data + bytes.size();
+    std::uint64_t hash = 0;
+
+    // Long inputs are consumed 32 bytes at a time by four independent accumulators
+    if (bytes.size() >= 32) {
+        std::uint64_t accumulator_1 = seed + PRIME_1 + PRIME_2;
+        std::uint64_t accumulator_2 = seed + PRIME_2;
+        std::uint64_t accumulator_3 = seed;
+        std::uint64_t accumulator_4 = seed - PRIME_1;
+        for (; end - data >= 32; data += 32) {
+            accumulator_1 = xxh64_round(accumulator_1, read_little_endian<8>(data));
+            accumulator_2 = xxh64_round(accumulator_2, read_little_endian<8>(data + 8));
+            accumulator_3 = xxh64_round(accumulator_3, read_little_endian<8>(data + 16));
+            accumulator_4 = xxh64_round(accumulator_4, read_little_endian<8>(data + 24));
+        }
+        hash = std::rotl(accumulator_1, 1) + std::rotl(accumulator_2, 7) + std::rotl(accumulator_3, 12) + std::rotl(accumulator_4, 18);
+        hash = xxh64_merge(hash, accumulator_1);
+        hash = xxh64_merge(hash, accumulator_2);
+        hash = xxh64_merge(hash, accumulator_3);
+        hash = xxh64_merge(hash, accumulator_4);
+    }
+    else {
+        hash = seed + PRIME_5;
+    }
+    hash += bytes.size();
+
+    // Consume the tail in 8-byte, 4-byte, and single-byte steps
+    for (; end - data >= 8; data += 8) {
+        hash ^= xxh64_round(0, read_little_endian<8>(data));
+        hash = std::rotl(hash, 27) * PRIME_1 + PRIME_4;
+    }
+    if (end - data >= 4) {
+        hash ^= read_little_endian<4>(data) * PRIME_1;
+        hash = std::rotl(hash, 23) * PRIME_2 + PRIME_3;
+        data += 4;
+    }
+    for (; data != end; ++data) {
+        hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(*data)) * PRIME_5;
+        hash = std::rotl(hash, 11) * PRIME_1;
+    }
+
+    // Avalanche, so similar inputs end up far apart
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::vector<diff::Change> find_duplicates(const std::string_view text,
+                                          const DedupeOptions &options)
+{
+    const double threshold = options.near_duplicate_threshold;
+    if (std::isnan(threshold) || threshold < 0.0 || threshold > 1.0) [[unlikely]] {
+        throw std::invalid_argument(std::format("Near-duplicate threshold '{}' must be between 0 and 1", threshold));
+    }
+    const bool find_near_duplicates = threshold > 0.0;
+
+    const std::vector<Span> spans = split_units(text, options.unit);
+    const auto content_of = [text, &spans](const std::size_t index) {
+        return text.substr(spans[index].begin, spans[index].content_end - spans[index].begin);
+    };
+
+    // Hashing (and building MinHash signatures, which costs far more) is independent per unit, so large texts are split over threads
+    std::vector<std::uint64_t> hashes(spans.size());
+    std::vector<std::uint64_t> signatures(find_near_duplicates ? spans.size() * SIGNATURE_SIZE : 0);
+    for_each_chunk(spans.size(), text.size(), options.thread_count, [&](const std::size_t first, const std::size_t last) {
+        for (std::size_t index = first; index < last; ++index) {
+            hashes[index] = hash_bytes(content_of(index));
+            if (find_near_duplicates) {
+                compute_signature(content_of(index), signatures.data() + index * SIGNATURE_SIZE);
+            }
+        }
+    });
+
+    // Estimate the similarity of two units as the fraction of equal signature values
+    const auto minimum_equal_values = static_cast<std::size_t>(threshold * static_cast<double>(SIGNATURE_SIZE) + 0.999);
+    const auto is_similar = [&signatures, minimum_equal_values](const std::size_t a, const std::size_t b) {
+        std::size_t equal_values = 0;
+        for (std::size_t i = 0; i < SIGNATURE_SIZE; ++i) {
+            equal_values += signatures[a * SIGNATURE_SIZE + i] == signatures[b * SIGNATURE_SIZE + i] ? 1u : 0u;
+        }
+        return equal_values >= minimum_equal_values;
+    };
+
+    // Hash every band of a signature, with the band number mixed in so equal values in different bands do not collide
+    const auto band_hash = [&signatures](const std::size_t index, const std::size_t band) {
+        const std::string_view band_bytes{reinterpret_cast<const char *>(signatures.data() + index * SIGNATURE_SIZE + band * BAND_SIZE), BAND_SIZE * sizeof(std::uint64_t)};
+        return hash_bytes(band_bytes, band);
+    };
+
+    // Walk the units in order, so the first occurrence is kept and only later ones are removed
+    IndexTable exact_table{spans.size()};
+    IndexTable band_table{find_near_duplicates ? spans.size() * BAND_COUNT : 0};
+    std::vector<diff::Change> changes;
+    for (std::size_t index = 0; index < spans.size(); ++index) {
+        const std::string_view content = content_of(index);
+        bool is_duplicate = exact_table.find(hashes[index], [&content, &content_of](const std::size_t earlier) {
+                                return content_of(earlier) == content;
+                            }) != IndexTable::NOT_FOUND;
+
+        if (!is_duplicate && find_near_duplicates) {
+            for (std::size_t band = 0; band < BAND_COUNT && !is_duplicate; ++band) {
+                is_duplicate = band_table.find(band_hash(index, band), [&is_similar, index](const std::size_t earlier) {
+                                   return is_similar(earlier, index);
+                               }) != IndexTable::NOT_FOUND;
+            }
+        }
+
+        if (is_duplicate) {
+            changes.push_back({.begin = spans[index].begin, .end = spans[index].end, .replacement = {}});
+            continue;
+        }
+        exact_table.insert(hashes[index], index);
+        if (find_near_duplicates) {
+            for (std::size_t band = 0; band < BAND_COUNT; ++band) {
+                band_table.insert(band_hash(index, band), index);
+            }
+        }
+    }
+    return changes;
+}
+
+std::size_t remove_duplicates(std::string &text,
+                              const DedupeOptions &options)
+{
+    const std::vector<diff::Change> changes = find_duplicates(text, options);
+    if (!changes.empty()) {
+        text = diff::apply_changes(text, changes);
+    }
+    return changes.size();
+}
+
+}  // namespace core::dedupe
@@ -0,0 +1,100 @@
+/**
+ * @file dedupe.hpp
+ *
+ * @brief Detection and removal of repeated lines or paragraphs, exact or near-duplicate.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "core/diff.hpp"
+
+namespace core::dedupe {
+
+/**
+ * @brief Input size from which units are hashed on several threads, in bytes (4 MiB); smaller texts are hashed faster than threads start.
+ */
+inline constexpr std::size_t PARALLEL_THRESHOLD = 4 * 1024 * 1024;
+
+/**
+ * @brief Part of the text that is compared against earlier parts.
+ */
+enum class Unit {
+    /**
+     * @brief Single line; blank lines are never duplicates.
+     */
+    Line,
+
+    /**
+     * @brief Run of non-blank lines, separated from the next one by one or more blank lines.
+     */
+    Paragraph,
+};
+
+/**
+ * @brief Settings of the duplicate detection.
+ */
+struct DedupeOptions {
+    /**
+     * @brief Part of the text that is compared.
+     */
+    Unit unit = Unit::Paragraph;
+
+    /**
+     * @brief Minimum similarity (between 0 and 1) for a unit to count as a near-duplicate of an earlier one (e.g., "0.8"), or 0 to only remove exact duplicates.
+     *
+     * Similarity is the Jaccard index of the sets of three-word shingles, estimated with MinHash, so a repeated paragraph with a few reworded words is still found.
+     */
+    double near_duplicate_threshold = 0.0;
+
+    /**
+     * @brief Number of threads used for texts larger than "PARALLEL_THRESHOLD", or 0 to use the number of hardware threads.
+     */
+    std::size_t thread_count = 0;
+};
+
+/**
+ * @brief Hash a byte string with a 64-bit non-cryptographic hash (XXH64).
+ *
+ * @param bytes Bytes to hash (e.g., "hello").
+ * @param seed Seed that selects an independent hash function (e.g., "0").
+ *
+ * @return 64-bit hash, identical on every platform.
+ */
+[[nodiscard]] std::uint64_t hash_bytes(const std::string_view bytes,
+                                       const std::uint64_t seed = 0);
+
+/**
+ * @brief Find every unit that repeats an earlier one.
+ *
+ * Units are hashed (on several threads for large texts) and looked up in an open-addressing table in one pass, so the first occurrence is kept and every later one is reported; hash matches are verified byte by byte. Near-duplicates are found through locality-sensitive hashing of MinHash signatures.
+ *
+ * @param text Text to scan (e.g., "a\n\nb\n\na\n").
+ * @param options Settings of the detection (e.g., "{.unit = Unit::Line}").
+ *
+ * @return Deletions sorted by position, all accepted, each removing a repeated unit together with its line break (and, for paragraphs, the blank lines that follow it) (e.g., {{.begin = 6, .end = 8}}).
+ *
+ * @throws std::invalid_argument if the near-duplicate threshold is not between 0 and 1.
+ */
+[[nodiscard]] std::vector<diff::Change> find_duplicates(const std::string_view text,
+                                                        const DedupeOptions &options = {});
+
+/**
+ * @brief Remove every unit that repeats an earlier one, in place.
+ *
+ * @param text String to modify in place (e.g., "a\n\nb\n\na\n").
+ * @param options Settings of the detection (e.g., "{.unit = Unit::Line}").
+ *
+ * @return Number of removed units (e.g., "1").
+ *
+ * @throws std::invalid_argument if the near-duplicate threshold is not between 0 and 1.
+ */
+std::size_t remove_duplicates(std::string &text,
+                              const DedupeOptions &options = {});
+
+}  // namespace core::dedupe
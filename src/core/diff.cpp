@@ -0,0 +1,377 @@
+/**
+ * @file diff.cpp
+ */
+
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t, std::ptrdiff_t
+#include <format>       // for std::format
+#include <span>         // for std::span
+#include <stdexcept>    // for std::invalid_argument
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "core/diff.hpp"
+
+namespace core::diff {
+
+namespace {
+
+/**
+ * @brief Replaced range in both texts, as produced by the diff before it is turned into a "Change".
+ */
+struct Hunk {
+    std::size_t before_begin = 0;
+    std::size_t before_end = 0;
+    std::size_t after_begin = 0;
+    std::size_t after_end = 0;
+};
+
+/**
+ * @brief Maximum edit distance searched for a middle snake before settling for an approximate split.
+ */
+constexpr std::ptrdiff_t COST_LIMIT = 256;
+
+/**
+ * @brief Check whether a byte continues a UTF-8 sequence (10xxxxxx).
+ *
+ * @param byte Byte to check.
+ *
+ * @return True if the byte is a continuation byte, false otherwise.
+ */
+[[nodiscard]] bool is_continuation(const char byte)
+{
+    return (static_cast<unsigned char>(byte) & 0xC0) == 0x80;
+}
+
+/**
+ * @brief Recursive Myers diff that appends the hunks between two ranges in order.
+ */
+class Differ final {
+  public:
+    /**
+     * @brief Construct a new Differ object.
+     *
+     * @param before Original text.
+     * @param after Modified text.
+     */
+    Differ(const std::string_view before,
+           const std::string_view after)
+        : before_(before),
+          after_(after)
+    {
+    }
+
+    /**
+     * @brief Diff two ranges and append their hunks.
+     *
+     * @param before_begin First byte of the original range.
+     * @param before_end One past the last byte of the original range.
+     * @param after_begin First byte of the modified range.
+     * @param after_end One past the last byte of the modified range.
+     */
+    void diff(std::size_t before_begin,
+              std::size_t before_end,
+              std::size_t after_begin,
+              std::size_t after_end)
+    {
+        // Strip the common prefix and suffix, which are usually most of the text
+        while (before_begin < before_end && after_begin < after_end && this->before_[before_begin] == this->after_[after_begin]) {
+            ++before_begin;
+            ++after_begin;
+        }
+        while (before_begin < before_end && after_begin < after_end && this->before_[before_end - 1] == this->after_[after_end - 1]) {
+            --before_end;
+            --after_end;
+        }
+
+        if (before_begin == before_end && after_begin == after_end) {
+            return;
+        }
+        if (before_begin == before_end || after_begin == after_end) {
+            this->emit({before_begin, before_end, after_begin, after_end});
+            return;
+        }
+
+        this->bisect(before_begin, before_end, after_begin, after_end);
+    }
+
+    /**
+     * @brief Return the hunks collected so far.
+     *
+     * @return Hunks sorted by position.
+     */
+    [[nodiscard]] const std::vector<Hunk> &hunks() const
+    {
+        return this->hunks_;
+    }
+
+  private:
+    /**
+     * @brief Find the middle snake of the edit graph by searching forward and backward at once, then diff both halves.
+     *
+     * @param before_begin First byte of the original range.
+     * @param before_end One past the last byte of the original range.
+     * @param after_begin First byte of the modified range.
+     * @param after_end One past the last byte of the modified range.
+     */
+    void bisect(const std::size_t before_begin,
+                const std::size_t before_end,
+                const std::size_t after_begin,
+                const std::size_t after_end)
+    {
+        const std::string_view a = this->before_.substr(before_begin, before_end - before_begin);
+        const std::string_view b = this->after_.substr(after_begin, after_end - after_begin);
+        const auto n = static_cast<std::ptrdiff_t>(a.size());
+        const auto m = static_cast<std::ptrdiff_t>(b.size());
+        const std::ptrdiff_t delta = n - m;
+        const bool is_front = (delta % 2) != 0;
+
+        // Searching further than the cost limit is quadratic on texts that differ everywhere, so stop there and split at the furthest point reached
+        const std::ptrdiff_t max_d = std::min((n + m + 1) / 2, COST_LIMIT);
+        const bool is_limited = max_d < (n + m + 1) / 2;
+        const std::ptrdiff_t offset = max_d;
+
+        // Furthest reaching x on every diagonal k, for the forward and the backward search
+        this->forward_.assign(static_cast<std::size_t>(2 * max_d + 2), -1);
+        this->backward_.assign(static_cast<std::size_t>(2 * max_d + 2), -1);
+        std::vector<std::ptrdiff_t> &forward = this->forward_;
+        std::vector<std::ptrdiff_t> &backward = this->backward_;
+        const auto at = [offset](std::vector<std::ptrdiff_t> &v, const std::ptrdiff_t k) -> std::ptrdiff_t & {
+            return v[static_cast<std::size_t>(offset + k)];
+        };
+        at(forward, 1) = 0;
+        at(backward, 1) = 0;
+
+        // Diagonals that ran off the edge of the graph are skipped from then on
+        std::ptrdiff_t k1_start = 0;
+        std::ptrdiff_t k1_end = 0;
+        std::ptrdiff_t k2_start = 0;
+        std::ptrdiff_t k2_end = 0;
+
+        for (std::ptrdiff_t d = 0; d < max_d; ++d) {
+            for (std::ptrdiff_t k1 = -d + k1_start; k1 <= d - k1_end; k1 += 2) {
+                std::ptrdiff_t x1 = (k1 == -d || (k1 != d && at(forward, k1 - 1) < at(forward, k1 + 1))) ? at(forward, k1 + 1) : at(forward, k1 - 1) + 1;
+                std::ptrdiff_t y1 = x1 - k1;
+                while (x1 < n && y1 < m && a[static_cast<std::size_t>(x1)] == b[static_cast<std::size_t>(y1)]) {
+                    ++x1;
+                    ++y1;
+                }
+                at(forward, k1) = x1;
+                if (x1 > n) {
+                    k1_end += 2;
+                }
+                else if (y1 > m) {
+                    k1_start += 2;
+                }
+                else if (is_front) {
+                    const std::ptrdiff_t k2 = delta - k1;
+                    if (k2 >= -max_d && k2 <= max_d && at(backward, k2) != -1 && x1 >= n - at(backward, k2)) {
+                        this->split(before_begin, before_end, after_begin, after_end, static_cast<std::size_t>(x1), static_cast<std::size_t>(y1));
+                        return;
+                    }
+                }
+            }
+
+            for (std::ptrdiff_t k2 = -d + k2_start; k2 <= d - k2_end; k2 += 2) {
+                std::ptrdiff_t x2 = (k2 == -d || (k2 != d && at(backward, k2 - 1) < at(backward, k2 + 1))) ? at(backward, k2 + 1) : at(backward, k2 - 1) + 1;
+                std::ptrdiff_t y2 = x2 - k2;
+                while (x2 < n && y2 < m && a[static_cast<std::size_t>(n - x2 - 1)] == b[static_cast<std::size_t>(m - y2 - 1)]) {
+                    ++x2;
+                    ++y2;
+                }
+                at(backward, k2) = x2;
+                if (x2 > n) {
+                    k2_end += 2;
+                }
+                else if (y2 > m) {
+                    k2_start += 2;
+                }
+                else if (!is_front) {
+                    const std::ptrdiff_t k1 = delta - k2;
+                    if (k1 >= -max_d && k1 <= max_d && at(forward, k1) != -1) {
+                        const std::ptrdiff_t x1 = at(forward, k1);
+                        const std::ptrdiff_t y1 = x1 - k1;
+                        if (x1 >= n - x2) {
+                            this->split(before_begin, before_end, after_begin, after_end, static_cast<std::size_t>(x1), static_cast<std::size_t>(y1));
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Too expensive: split at the forward point that got furthest into the graph, so both halves shrink
+        if (is_limited) {
+            std::ptrdiff_t best_x = 0;
+            std::ptrdiff_t best_y = 0;
+            for (std::ptrdiff_t k = -max_d; k <= max_d; ++k) {
+                const std::ptrdiff_t x = at(forward, k);
+                const std::ptrdiff_t y = x - k;
+                if (x >= 0 && x <= n && y >= 0 && y <= m && x + y > best_x + best_y) {
+                    best_x = x;
+                    best_y = y;
+                }
+            }
+            if (best_x + best_y > 0 && best_x + best_y < n + m) {
+                this->split(before_begin, before_end, after_begin, after_end, static_cast<std::size_t>(best_x), static_cast<std::size_t>(best_y));
+                return;
+            }
+        }
+
+        // Nothing in common at all
+        this->emit({before_begin, before_end, after_begin, after_end});
+    }
+
+    /**
+     * @brief Diff the two halves on either side of a point on the middle snake.
+     *
+     * @param before_begin First byte of the original range.
+     * @param before_end One past the last byte of the original range.
+     * @param after_begin First byte of the modified range.
+     * @param after_end One past the last byte of the modified range.
+     * @param x Split point, relative to "before_begin".
+     * @param y Split point, relative to "after_begin".
+     */
+    void split(const std::size_t before_begin,
+               const std::size_t before_end,
+               const std::size_t after_begin,
+               const std::size_t after_end,
+               const std::size_t x,
+               const std::size_t y)
+    {
+        this->diff(before_begin, before_begin + x, after_begin, after_begin + y);
+        this->diff(before_begin + x, before_end, after_begin + y, after_end);
+    }
+
+    /**
+     * @brief Append a hunk.
+     *
+     * @param hunk Hunk to append, after every hunk appended so far.
+     */
+    void emit(const Hunk &hunk)
+    {
+        this->hunks_.push_back(hunk);
+    }
+
+    /**
+     * @brief Original text.
+     */
+    std::string_view before_;
+
+    /**
+     * @brief Modified text.
+     */
+    std::string_view after_;
+
+    /**
+     * @brief Hunks found so far, in order.
+     */
+    std::vector<Hunk> hunks_;
+
+    /**
+     * @brief Furthest reaching x per diagonal of the forward search, reused across calls.
+     */
+    std::vector<std::ptrdiff_t> forward_;
+
+    /**
+     * @brief Furthest reaching x per diagonal of the backward search, reused across calls.
+     */
+    std::vector<std::ptrdiff_t> backward_;
+};
+
+/**
+ * @brief Widen hunks to whole UTF-8 sequences and merge the ones that touch.
+ *
+ * The bytes between two hunks are equal in both texts, so both sides of a hunk can be widened by the same amount until it reaches its neighbor.
+ *
+ * @param before Original text.
+ * @param after Modified text.
+ * @param hunks Hunks sorted by position, as produced by the diff.
+ *
+ * @return Widened and merged hunks.
+ */
+[[nodiscard]] std::vector<Hunk> widen_and_merge(const std::string_view before,
+                                                const std::string_view after,
+                                                const std::vector<Hunk> &hunks)
+{
+    const auto splits_sequence = [&before, &after](const std::size_t before_position, const std::size_t after_position) {
+        return (before_position < before.size() && is_continuation(before[before_position])) ||
+               (after_position < after.size() && is_continuation(after[after_position]));
+    };
+
+    std::vector<Hunk> merged;
+    merged.reserve(hunks.size());
+    for (std::size_t i = 0; i < hunks.size(); ++i) {
+        Hunk hunk = hunks[i];
+
+        // Widen to the left, at most up to the previous hunk
+        const std::size_t floor = merged.empty() ? 0 : merged.back().before_end;
+        while (hunk.before_begin > floor && splits_sequence(hunk.before_begin, hunk.after_begin)) {
+            --hunk.before_begin;
+            --hunk.after_begin;
+        }
+        if (!merged.empty() && hunk.before_begin == merged.back().before_end) {
+            merged.back().before_end = hunk.before_end;
+            merged.back().after_end = hunk.after_end;
+        }
+        else {
+            merged.push_back(hunk);
+        }
+
+        // Widen to the right, at most up to the next hunk, which is then merged by the check above
+        Hunk &last = merged.back();
+        const std::size_t ceiling = i + 1 < hunks.size() ? hunks[i + 1].before_begin : before.size();
+        while (last.before_end < ceiling && splits_sequence(last.before_end, last.after_end)) {
+            ++last.before_end;
+            ++last.after_end;
+        }
+    }
+    return merged;
+}
+
+}  // namespace
+
+std::string apply_changes(const std::string_view text,
+                          const std::span<const Change> changes)
+{
+    std::string result;
+    result.reserve(text.size());
+    std::size_t copied_until = 0;
+
+    for (const Change &change : changes) {
+        if (change.begin < copied_until || change.begin > change.end || change.end > text.size()) [[unlikely]] {
+            throw std::invalid_argument(std::format("Change [{}, {}) is out of order, overlaps another change, or exceeds the text size '{}'", change.begin, change.end, text.size()));
+        }
+        if (!change.is_accepted) {
+            continue;
+        }
+        result.append(text, copied_until, change.begin - copied_until);
+        result.append(change.replacement);
+        copied_until = change.end;
+    }
+    result.append(text, copied_until);
+
+    return result;
+}
+
+std::vector<Change> compute_changes(const std::string_view before,
+                                    const std::string_view after)
+{
+    Differ differ{before, after};
+    differ.diff(0, before.size(), 0, after.size());
+    const std::vector<Hunk> hunks = widen_and_merge(before, after, differ.hunks());
+
+    std::vector<Change> changes;
+    changes.reserve(hunks.size());
+    for (const Hunk &hunk : hunks) {
+        changes.push_back({
+            .begin = hunk.before_begin,
+            .end = hunk.before_end,
+            .replacement = std::string{after.substr(hunk.after_begin, hunk.after_end - hunk.after_begin)},
+        });
+    }
+    return changes;
+}
+
+}  // namespace core::diff
@@ -0,0 +1,68 @@
+/**
+ * @file diff.hpp
+ *
+ * @brief Change lists between two versions of a text, and applying a subset of them.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <span>         // for std::span
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+namespace core::diff {
+
+/**
+ * @brief Replacement of one range of the original text.
+ */
+struct Change {
+    /**
+     * @brief Byte offset of the first replaced byte in the original text.
+     */
+    std::size_t begin = 0;
+
+    /**
+     * @brief Byte offset one past the last replaced byte in the original text; equal to "begin" for a pure insertion.
+     */
+    std::size_t end = 0;
+
+    /**
+     * @brief Text that replaces the range (e.g., "-"); empty for a pure deletion.
+     */
+    std::string replacement{};
+
+    /**
+     * @brief Whether the change is applied by "apply_changes()".
+     */
+    bool is_accepted = true;
+};
+
+/**
+ * @brief Apply the accepted changes to the original text in a single pass.
+ *
+ * @param text Original text the changes refer to (e.g., "a—b").
+ * @param changes Changes sorted by position, not overlapping each other (e.g., {{.begin = 1, .end = 4, .replacement = "-"}}).
+ *
+ * @return Text with every accepted change applied (e.g., "a-b").
+ *
+ * @throws std::invalid_argument if the changes are unsorted, overlap, or reach past the end of the text.
+ */
+[[nodiscard]] std::string apply_changes(const std::string_view text,
+                                        const std::span<const Change> changes);
+
+/**
+ * @brief Compute a minimal list of changes that turns one text into another, using Myers' O(ND) algorithm in linear space.
+ *
+ * This is the fallback for edits that do not come with their own change list (e.g., the preview of Replace All). Changes never split a UTF-8 sequence, and changes separated by nothing are merged. If the texts differ in so many places that an exact search would become quadratic, the search settles for a split that may yield a few more changes than necessary, as GNU diff does.
+ *
+ * @param before Original text (e.g., "the cat sat").
+ * @param after Modified text (e.g., "the dog sat").
+ *
+ * @return Changes sorted by position (e.g., {{.begin = 4, .end = 7, .replacement = "dog"}}).
+ */
+[[nodiscard]] std::vector<Change> compute_changes(const std::string_view before,
+                                                  const std::string_view after);
+
+}  // namespace core::diff
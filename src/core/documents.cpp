@@ -0,0 +1,258 @@
+/**
+ * @file documents.cpp
+ */
+
+#include <algorithm>     // for std::min
+#include <cerrno>        // for errno, EINTR
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint64_t
+#include <exception>     // for std::exception
+#include <filesystem>    // for std::filesystem
+#include <format>        // for std::format
+#include <fstream>       // for std::ifstream
+#include <random>        // for std::random_device
+#include <stdexcept>     // for std::out_of_range, std::runtime_error
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code
+#include <utility>       // for std::move
+
+#if defined(_WIN32)
+#include <fcntl.h>     // for _O_* flags
+#include <io.h>        // for _wopen, _write, _close
+#include <sys/stat.h>  // for _S_IREAD, _S_IWRITE
+#else
+#include <fcntl.h>   // for open, O_* flags
+#include <unistd.h>  // for write, close
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "core/compress.hpp"
+#include "core/documents.hpp"
+#include "core/posix.hpp"
+
+namespace core::documents {
+
+namespace {
+
+/**
+ * @brief Create a page file that only the current user can read, and write a block to it.
+ *
+ * The file is created exclusively, so an existing file (or a symlink planted in a shared directory such as "/tmp") is never followed or overwritten.
+ *
+ * @param path Path to the page file (e.g., "/tmp/ungpt-1f2e3d4c5b6a7988-3.page").
+ * @param bytes Compressed block to write.
+ *
+ * @throws std::runtime_error if the file already exists or cannot be written; a file created by this call is removed again.
+ */
+void write_page_file(const std::filesystem::path &path,
+                     std::string_view bytes)
+{
+#if defined(_WIN32)
+    const int fd = _wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+#endif
+    if (fd == -1) [[unlikely]] {
+        posix::throw_errno(std::format("create page file '{}'", path.string()));
+    }
+    while (!bytes.empty()) {
+#if defined(_WIN32)
+        const int written = _write(fd, bytes.data(), static_cast<unsigned int>(std::min<std::size_t>(bytes.size(), 1 << 30)));
+#else
+        const ssize_t written = ::write(fd, bytes.data(), bytes.size());
+#endif
+        if (written < 0) [[unlikely]] {
+            if (errno == EINTR) {
+                continue;
+            }
+            const int error = errno;
+#if defined(_WIN32)
+            _close(fd);
+#else
+            close(fd);
+#endif
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            errno = error;
+            posix::throw_errno(std::format("write page file '{}'", path.string()));
+        }
+        bytes.remove_prefix(static_cast<std::size_t>(written));
+    }
+#if defined(_WIN32)
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+}  // namespace
+
+DocumentStore::DocumentStore(const std::size_t memory_budget,
+                             std::filesystem::path page_directory)
+    : memory_budget_(memory_budget),
+      page_directory_(std::move(page_directory)),
+      page_token_((static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}())
+{
+}
+
+DocumentStore::~DocumentStore()
+{
+    for (const auto &[id, entry] : this->entries_) {
+        if (entry.residency == Residency::Paged) {
+            std::error_code ec;
+            std::filesystem::remove(this->page_path(id), ec);
+        }
+    }
+}
+
+std::size_t DocumentStore::add(std::string text)
+{
+    const std::size_t id = this->next_id_++;
+    const std::size_t size = text.size();
+    this->entries_.emplace(id, Entry{.residency = Residency::Resident, .data = std::move(text), .text_size = size, .compressed_size = 0, .last_used = ++this->use_counter_});
+    this->inactive_size_ += size;
+    this->enforce_budget();
+    return id;
+}
+
+std::string DocumentStore::take(const std::size_t id)
+{
+    Entry &entry = this->entries_.at(id);
+    std::string text;
+    switch (entry.residency) {
+    case Residency::Resident:
+        this->inactive_size_ -= entry.data.size();
+        text = std::move(entry.data);
+        break;
+    case Residency::Compressed:
+        text = compress::decompress(entry.data, entry.text_size);
+        this->inactive_size_ -= entry.data.size();
+        break;
+    case Residency::Paged: {
+        const std::filesystem::path path = this->page_path(id);
+        std::string block(entry.compressed_size, '\0');
+        std::ifstream stream{path, std::ios::binary};
+        if (!stream.read(block.data(), static_cast<std::streamsize>(block.size()))) [[unlikely]] {
+            throw std::runtime_error(std::format("Failed to read page file '{}'", path.string()));
+        }
+        text = compress::decompress(block, entry.text_size);
+        stream.close();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        SPDLOG_DEBUG("Paged in document '{}' ({} bytes) from '{}'", id, entry.text_size, path.string());
+        break;
+    }
+    case Residency::Active:
+        throw std::out_of_range(std::format("Document '{}' is already taken", id));
+    }
+    entry = Entry{.residency = Residency::Active, .data = {}, .text_size = 0, .compressed_size = 0, .last_used = entry.last_used};
+    this->active_size_ = text.size();
+    this->enforce_budget();
+    return text;
+}
+
+void DocumentStore::put(const std::size_t id,
+                        std::string text)
+{
+    Entry &entry = this->entries_.at(id);
+    if (entry.residency != Residency::Active) [[unlikely]] {
+        throw std::out_of_range(std::format("Document '{}' was not taken", id));
+    }
+    entry.residency = Residency::Resident;
+    entry.text_size = text.size();
+    entry.data = std::move(text);
+    entry.last_used = ++this->use_counter_;
+    this->inactive_size_ += entry.text_size;
+    this->active_size_ = 0;
+    this->enforce_budget();
+}
+
+void DocumentStore::remove(const std::size_t id)
+{
+    const auto it = this->entries_.find(id);
+    if (it == this->entries_.end()) {
+        return;
+    }
+    const Entry &entry = it->second;
+    if (entry.residency == Residency::Resident || entry.residency == Residency::Compressed) {
+        this->inactive_size_ -= entry.data.size();
+    }
+    else if (entry.residency == Residency::Paged) {
+        std::error_code ec;
+        std::filesystem::remove(this->page_path(id), ec);
+    }
+    this->entries_.erase(it);
+}
+
+void DocumentStore::set_active_size(const std::size_t size)
+{
+    this->active_size_ = size;
+    this->enforce_budget();
+}
+
+void DocumentStore::set_memory_budget(const std::size_t memory_budget)
+{
+    this->memory_budget_ = memory_budget;
+    this->enforce_budget();
+}
+
+Residency DocumentStore::residency(const std::size_t id) const
+{
+    return this->entries_.at(id).residency;
+}
+
+void DocumentStore::enforce_budget()
+{
+    while (this->memory_usage() > this->memory_budget_) {
+        // Prefer compressing the least recently used resident document, restoring it is cheap
+        // Only once every inactive document is compressed, page out the least recently used one
+        Entry *victim = nullptr;
+        std::size_t victim_id = 0;
+        for (auto &[id, entry] : this->entries_) {
+            const bool is_better = victim == nullptr ||
+                                   (entry.residency == Residency::Resident && victim->residency != Residency::Resident) ||
+                                   (entry.residency == victim->residency && entry.last_used < victim->last_used);
+            if ((entry.residency == Residency::Resident || entry.residency == Residency::Compressed) && is_better) {
+                victim = &entry;
+                victim_id = id;
+            }
+        }
+        if (victim == nullptr) {
+            return;  // Only the active text is left in memory
+        }
+
+        if (victim->residency == Residency::Resident) {
+            std::string block = compress::compress(victim->data);
+            this->inactive_size_ -= victim->data.size();
+            this->inactive_size_ += block.size();
+            SPDLOG_DEBUG("Compressed document '{}' from {} to {} bytes", victim_id, victim->text_size, block.size());
+            victim->compressed_size = block.size();
+            victim->data = std::move(block);
+            victim->residency = Residency::Compressed;
+            continue;
+        }
+
+        // A page file that cannot be written leaves the document compressed in memory, over budget rather than lost
+        const std::filesystem::path path = this->page_path(victim_id);
+        try {
+            write_page_file(path, victim->data);
+        }
+        catch (const std::exception &e) {
+            SPDLOG_WARN("Keeping document '{}' in memory: {}", victim_id, e.what());
+            return;
+        }
+        SPDLOG_DEBUG("Paged out document '{}' ({} bytes) to '{}'", victim_id, victim->text_size, path.string());
+        this->inactive_size_ -= victim->data.size();
+        victim->data = std::string{};
+        victim->residency = Residency::Paged;
+    }
+}
+
+std::filesystem::path DocumentStore::page_path(const std::size_t id) const
+{
+    return this->page_directory_ / std::format("ungpt-{:016x}-{}.page", this->page_token_, id);
+}
+
+}  // namespace core::documents
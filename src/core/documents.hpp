@@ -0,0 +1,231 @@
+/**
+ * @file documents.hpp
+ *
+ * @brief Storage of inactive documents under a memory budget, compressing or paging out the least recently used ones.
+ */
+
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint64_t
+#include <filesystem>  // for std::filesystem::path
+#include <map>         // for std::map
+#include <string>      // for std::string
+
+namespace core::documents {
+
+/**
+ * @brief Default memory budget for all documents, in bytes (256 MiB).
+ */
+inline constexpr std::size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+/**
+ * @brief Where the text of an inactive document is held.
+ */
+enum class Residency {
+    /**
+     * @brief Uncompressed, in memory.
+     */
+    Resident,
+
+    /**
+     * @brief Compressed, in memory.
+     */
+    Compressed,
+
+    /**
+     * @brief Compressed, in a page file on disk.
+     */
+    Paged,
+
+    /**
+     * @brief Taken out by "take()", held by the caller.
+     */
+    Active,
+};
+
+/**
+ * @brief Holds the text of every document that is not being edited, keeping their combined memory below a budget.
+ *
+ * The caller takes the text of the active document out of the store and puts it back when switching to another document. Whenever the active text plus the documents held in memory exceed the budget, the least recently used documents are compressed (LZ4 block format) first; only once every inactive document is compressed are the least recently used ones paged out to a temporary file, which only the current user can read. Taking a document restores it transparently.
+ */
+class DocumentStore final {
+  public:
+    /**
+     * @brief Construct a new DocumentStore object.
+     *
+     * @param memory_budget Memory budget for all documents, including the active one, in bytes (e.g., "268435456").
+     * @param page_directory Directory that receives the page files (e.g., "/tmp").
+     */
+    explicit DocumentStore(const std::size_t memory_budget = DEFAULT_MEMORY_BUDGET,
+                           std::filesystem::path page_directory = std::filesystem::temp_directory_path());
+
+    /**
+     * @brief Remove the page files of all documents.
+     */
+    ~DocumentStore();
+
+    DocumentStore(const DocumentStore &) = delete;
+    DocumentStore &operator=(const DocumentStore &) = delete;
+
+    /**
+     * @brief Add an inactive document.
+     *
+     * @param text Text of the document (e.g., "hello world").
+     *
+     * @return Identifier of the document, never reused (e.g., "3").
+     */
+    [[nodiscard]] std::size_t add(std::string text);
+
+    /**
+     * @brief Take the text of a document out of the store, to make it the active document.
+     *
+     * @param id Identifier of an inactive document.
+     *
+     * @return Text of the document, decompressed or read back from its page file if necessary.
+     *
+     * @throws std::out_of_range if there is no inactive document with the identifier.
+     * @throws std::runtime_error if the page file cannot be read or is corrupt.
+     */
+    [[nodiscard]] std::string take(const std::size_t id);
+
+    /**
+     * @brief Put the text of a taken document back, making it inactive and the most recently used one.
+     *
+     * @param id Identifier of a taken document.
+     * @param text Current text of the document.
+     *
+     * @throws std::out_of_range if there is no taken document with the identifier.
+     */
+    void put(const std::size_t id,
+             std::string text);
+
+    /**
+     * @brief Remove a document, taken or not, together with its page file.
+     *
+     * @param id Identifier of the document; unknown identifiers are ignored.
+     */
+    void remove(const std::size_t id);
+
+    /**
+     * @brief Update the size of the active text held by the caller, which counts against the budget, and enforce the budget.
+     *
+     * @param size Size of the active text, in bytes (e.g., "1048576").
+     */
+    void set_active_size(const std::size_t size);
+
+    /**
+     * @brief Change the memory budget and enforce it.
+     *
+     * @param memory_budget Memory budget for all documents, including the active one, in bytes (e.g., "268435456").
+     */
+    void set_memory_budget(const std::size_t memory_budget);
+
+    /**
+     * @brief Return where the text of a document is held.
+     *
+     * @param id Identifier of the document.
+     *
+     * @return Residency of the document.
+     *
+     * @throws std::out_of_range if there is no document with the identifier.
+     */
+    [[nodiscard]] Residency residency(const std::size_t id) const;
+
+    /**
+     * @brief Return the memory held for all documents, including the active text.
+     *
+     * @return Memory in bytes, excluding paged documents (e.g., "1048576").
+     */
+    [[nodiscard]] std::size_t memory_usage() const
+    {
+        return this->active_size_ + this->inactive_size_;
+    }
+
+  private:
+    /**
+     * @brief Stored document.
+     */
+    struct Entry {
+        /**
+         * @brief Where the text is held.
+         */
+        Residency residency = Residency::Resident;
+
+        /**
+         * @brief Uncompressed text if resident, compressed block if compressed, empty otherwise.
+         */
+        std::string data{};
+
+        /**
+         * @brief Size of the uncompressed text, in bytes.
+         */
+        std::size_t text_size = 0;
+
+        /**
+         * @brief Size of the compressed block, in bytes, also when it is paged out.
+         */
+        std::size_t compressed_size = 0;
+
+        /**
+         * @brief Value of "use_counter_" when the document was last put back; lower means less recently used.
+         */
+        std::uint64_t last_used = 0;
+    };
+
+    /**
+     * @brief Compress or page out the least recently used documents until the budget is met, or nothing is left to evict.
+     */
+    void enforce_budget();
+
+    /**
+     * @brief Return the path of the page file of a document.
+     *
+     * @param id Identifier of the document.
+     *
+     * @return Path inside the page directory (e.g., "/tmp/ungpt-1f2e3d4c5b6a7988-3.page").
+     */
+    [[nodiscard]] std::filesystem::path page_path(const std::size_t id) const;
+
+    /**
+     * @brief Memory budget for all documents, in bytes.
+     */
+    std::size_t memory_budget_;
+
+    /**
+     * @brief Directory that receives the page files.
+     */
+    std::filesystem::path page_directory_;
+
+    /**
+     * @brief Random token in the page file names, so several instances can share the page directory.
+     */
+    std::uint64_t page_token_;
+
+    /**
+     * @brief Documents by identifier.
+     */
+    std::map<std::size_t, Entry> entries_;
+
+    /**
+     * @brief Identifier of the next added document.
+     */
+    std::size_t next_id_ = 1;
+
+    /**
+     * @brief Incremented whenever a document is added or put back, to order documents by recency.
+     */
+    std::uint64_t use_counter_ = 0;
+
+    /**
+     * @brief Size of the active text, in bytes.
+     */
+    std::size_t active_size_ = 0;
+
+    /**
+     * @brief Memory held by inactive documents, resident or compressed, in bytes.
+     */
+    std::size_t inactive_size_ = 0;
+};
+
+}  // namespace core::documents
@@ -0,0 +1,430 @@
+/**
+ * @file encoding.cpp
+ */
+
+#include <algorithm>     // for std::min
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint8_t, std::uintmax_t
+#include <filesystem>    // for std::filesystem::path, std::filesystem::file_size
+#include <format>        // for std::format
+#include <fstream>       // for std::ifstream
+#include <ios>           // for std::ios, std::streamsize
+#include <stdexcept>     // for std::runtime_error
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define UNGPT_ENCODING_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define UNGPT_ENCODING_NEON
+#include <arm_neon.h>
+#endif
+
+#include "core/encoding.hpp"
+#include "core/utf8.hpp"
+
+namespace core::encoding {
+
+namespace {
+
+/**
+ * @brief Number of leading bytes whose null bytes are counted to recognize UTF-16 without a byte order mark.
+ */
+constexpr std::size_t UTF16_SNIFF_SIZE = 4096;
+
+/**
+ * @brief Number of code units transcoded one at a time before returning to the ASCII fast path.
+ */
+constexpr std::size_t SCALAR_STRIDE = 16;
+
+/**
+ * @brief Code points of the Windows-1252 bytes 0x80 to 0x9F; the five undefined bytes map to the C1 control characters, as browsers do.
+ */
+constexpr char16_t WINDOWS_1252_HIGH[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+};
+
+/**
+ * @brief U+FFFD REPLACEMENT CHARACTER, which replaces unpaired surrogates and incomplete input.
+ */
+constexpr char32_t REPLACEMENT_CODE_POINT = 0xFFFD;
+
+/**
+ * @brief Encode a code point as UTF-8.
+ *
+ * @param code_point Code point to encode, which must not be a surrogate (e.g., "U+00E9").
+ * @param output Destination with room for at least 4 bytes.
+ *
+ * @return Number of bytes written (e.g., "2").
+ */
+[[nodiscard]] inline std::size_t write_code_point(const char32_t code_point,
+                                                  char *output)
+{
+    if (code_point < 0x80) [[likely]] {
+        output[0] = static_cast<char>(code_point);
+        return 1;
+    }
+    if (code_point < 0x800) {
+        output[0] = static_cast<char>(0xC0 | (code_point >> 6));
+        output[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+        return 2;
+    }
+    if (code_point < 0x10000) {
+        output[0] = static_cast<char>(0xE0 | (code_point >> 12));
+        output[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        output[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    output[0] = static_cast<char>(0xF0 | (code_point >> 18));
+    output[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    output[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    output[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+/**
+ * @brief Read a UTF-16 code unit.
+ *
+ * @param data Two bytes of the code unit.
+ * @param is_big_endian Whether the most significant byte comes first.
+ *
+ * @return Code unit.
+ */
+[[nodiscard]] inline char16_t read_unit(const unsigned char *data,
+                                        const bool is_big_endian)
+{
+    return is_big_endian ? static_cast<char16_t>((data[0] << 8) | data[1])
+                         : static_cast<char16_t>((data[1] << 8) | data[0]);
+}
+
+#if defined(UNGPT_ENCODING_SSE2)
+
+/**
+ * @brief Narrow 16 UTF-16 code units to bytes if they are all ASCII.
+ *
+ * @param input 32 bytes of UTF-16.
+ * @param is_big_endian Whether the most significant byte of each code unit comes first.
+ * @param output Destination with room for 16 bytes, only written if the code units are all ASCII.
+ *
+ * @return True if the code units were all ASCII and were written, false otherwise.
+ */
+[[nodiscard]] inline bool narrow_ascii_units(const unsigned char *input,
+                                             const bool is_big_endian,
+                                             char *output)
+{
+    __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input));
+    __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + 16));
+    if (is_big_endian) {
+        first = _mm_or_si128(_mm_slli_epi16(first, 8), _mm_srli_epi16(first, 8));
+        second = _mm_or_si128(_mm_slli_epi16(second, 8), _mm_srli_epi16(second, 8));
+    }
+    const __m128i non_ascii = _mm_and_si128(_mm_or_si128(first, second), _mm_set1_epi16(static_cast<short>(0xFF80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output), _mm_packus_epi16(first, second));
+    return true;
+}
+
+/**
+ * @brief Copy 16 bytes if they are all ASCII.
+ *
+ * @param input 16 bytes of input.
+ * @param output Destination with room for 16 bytes, only written if the bytes are all ASCII.
+ *
+ * @return True if the bytes were all ASCII and were written, false otherwise.
+ */
+[[nodiscard]] inline bool copy_ascii_bytes(const unsigned char *input,
+                                           char *output)
+{
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input));
+    if (_mm_movemask_epi8(bytes) != 0) {
+        return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output), bytes);
+    return true;
+}
+
+#elif defined(UNGPT_ENCODING_NEON)
+
+[[nodiscard]] inline bool narrow_ascii_units(const unsigned char *input,
+                                             const bool is_big_endian,
+                                             char *output)
+{
+    uint8x16_t first = vld1q_u8(input);
+    uint8x16_t second = vld1q_u8(input + 16);
+    if (is_big_endian) {
+        first = vrev16q_u8(first);
+        second = vrev16q_u8(second);
+    }
+    const uint16x8_t first_units = vreinterpretq_u16_u8(first);
+    const uint16x8_t second_units = vreinterpretq_u16_u8(second);
+    if (vmaxvq_u16(vorrq_u16(first_units, second_units)) >= 0x80) {
+        return false;
+    }
+    vst1q_u8(reinterpret_cast<std::uint8_t *>(output), vcombine_u8(vmovn_u16(first_units), vmovn_u16(second_units)));
+    return true;
+}
+
+[[nodiscard]] inline bool copy_ascii_bytes(const unsigned char *input,
+                                           char *output)
+{
+    const uint8x16_t bytes = vld1q_u8(input);
+    if (vmaxvq_u8(bytes) >= 0x80) {
+        return false;
+    }
+    vst1q_u8(reinterpret_cast<std::uint8_t *>(output), bytes);
+    return true;
+}
+
+#endif
+
+}  // namespace
+
+std::string_view to_string(const Encoding encoding)
+{
+    switch (encoding) {
+    case Encoding::Utf8:
+        return "UTF-8";
+    case Encoding::Utf16Le:
+        return "UTF-16LE";
+    case Encoding::Utf16Be:
+        return "UTF-16BE";
+    case Encoding::Windows1252:
+        return "Windows-1252";
+    }
+    return "Unknown";
+}
+
+Detection detect(const std::string_view sample,
+                 const bool is_whole_text)
+{
+    // A byte order mark is unambiguous
+    if (sample.starts_with("\xEF\xBB\xBF")) {
+        return {.encoding = Encoding::Utf8, .bom_size = 3};
+    }
+    if (sample.starts_with("\xFF\xFE")) {
+        return {.encoding = Encoding::Utf16Le, .bom_size = 2};
+    }
+    if (sample.starts_with("\xFE\xFF")) {
+        return {.encoding = Encoding::Utf16Be, .bom_size = 2};
+    }
+
+    // ASCII characters in UTF-16 have a null high byte, which text in any 8-bit encoding almost never has; UTF-16LE puts it at odd offsets, UTF-16BE at even ones
+    const std::string_view head = sample.substr(0, UTF16_SNIFF_SIZE);
+    const std::size_t unit_count = head.size() / 2;
+    std::size_t even_nulls = 0;
+    std::size_t odd_nulls = 0;
+    for (std::size_t i = 0; i + 1 < head.size(); i += 2) {
+        even_nulls += head[i] == '\0' ? 1u : 0u;
+        odd_nulls += head[i + 1] == '\0' ? 1u : 0u;
+    }
+    // Require a quarter of the code units to be ASCII, and the null bytes to lean clearly to one side
+    if (odd_nulls * 4 >= unit_count && odd_nulls > even_nulls * 4 && odd_nulls > 0) {
+        return {.encoding = Encoding::Utf16Le, .bom_size = 0};
+    }
+    if (even_nulls * 4 >= unit_count && even_nulls > odd_nulls * 4 && even_nulls > 0) {
+        return {.encoding = Encoding::Utf16Be, .bom_size = 0};
+    }
+
+    // Valid UTF-8 stays UTF-8, tolerating a sequence cut off by the end of the sample
+    const std::size_t invalid = utf8::find_invalid(sample);
+    if (invalid == std::string_view::npos ||
+        (!is_whole_text && invalid + utf8::invalid_sequence_length(sample, invalid) == sample.size() && sample.size() - invalid < 4)) [[likely]] {
+        return {.encoding = Encoding::Utf8, .bom_size = 0};
+    }
+
+    // Anything else is most likely a legacy Windows text file
+    return {.encoding = Encoding::Windows1252, .bom_size = 0};
+}
+
+Decoder::Decoder(const Encoding encoding)
+    : encoding_(encoding)
+{
+}
+
+void Decoder::decode(const std::string_view block,
+                     std::string &output)
+{
+    if (this->encoding_ == Encoding::Utf8) {
+        output.append(block);
+        return;
+    }
+
+    const auto *data = reinterpret_cast<const unsigned char *>(block.data());
+    const std::size_t size = block.size();
+    const std::size_t old_size = output.size();
+
+    if (this->encoding_ == Encoding::Windows1252) {
+        // Every byte becomes at most 3 bytes of UTF-8
+        output.resize(old_size + this->max_output_size(size));
+        char *out = output.data() + old_size;
+        std::size_t position = 0;
+        while (position < size) {
+#if defined(UNGPT_ENCODING_SSE2) || defined(UNGPT_ENCODING_NEON)
+            // Copy ASCII runs 16 bytes at a time
+            while (position + 16 <= size && copy_ascii_bytes(data + position, out)) {
+                position += 16;
+                out += 16;
+            }
+#endif
+            const std::size_t stride_end = std::min(size, position + SCALAR_STRIDE);
+            for (; position < stride_end; ++position) {
+                const unsigned char byte = data[position];
+                if (byte < 0x80) [[likely]] {
+                    *out++ = static_cast<char>(byte);
+                }
+                else {
+                    out += write_code_point(byte < 0xA0 ? WINDOWS_1252_HIGH[byte - 0x80] : char32_t{byte}, out);
+                }
+            }
+        }
+        output.resize(static_cast<std::size_t>(out - output.data()));
+        return;
+    }
+
+    // Every code unit becomes at most 3 bytes of UTF-8, plus one U+FFFD for a high surrogate carried over from the last block
+    const bool is_big_endian = this->encoding_ == Encoding::Utf16Be;
+    output.resize(old_size + this->max_output_size(size));
+    char *out = output.data() + old_size;
+
+    // Transcode one code unit, pairing surrogates
+    const auto process_unit = [this, &out](const char16_t unit) {
+        if (this->pending_high_surrogate_ != 0) [[unlikely]] {
+            if (unit >= 0xDC00 && unit <= 0xDFFF) {
+                const char32_t code_point = 0x10000 + ((static_cast<char32_t>(this->pending_high_surrogate_) - 0xD800) << 10) + (static_cast<char32_t>(unit) - 0xDC00);
+                this->pending_high_surrogate_ = 0;
+                out += write_code_point(code_point, out);
+                return;
+            }
+            this->pending_high_surrogate_ = 0;
+            out += write_code_point(REPLACEMENT_CODE_POINT, out);
+        }
+        if (unit >= 0xD800 && unit <= 0xDBFF) [[unlikely]] {
+            this->pending_high_surrogate_ = unit;
+        }
+        else if (unit >= 0xDC00 && unit <= 0xDFFF) [[unlikely]] {
+            out += write_code_point(REPLACEMENT_CODE_POINT, out);
+        }
+        else {
+            out += write_code_point(unit, out);
+        }
+    };
+
+    // Complete the code unit split across the previous block and this one
+    std::size_t position = 0;
+    if (this->has_pending_byte_ && size > 0) {
+        const unsigned char unit_bytes[2] = {this->pending_byte_, data[0]};
+        this->has_pending_byte_ = false;
+        process_unit(read_unit(unit_bytes, is_big_endian));
+        position = 1;
+    }
+
+    while (position + 2 <= size) {
+#if defined(UNGPT_ENCODING_SSE2) || defined(UNGPT_ENCODING_NEON)
+        // Narrow ASCII runs 16 code units at a time, unless a high surrogate is waiting for its pair
+        if (this->pending_high_surrogate_ == 0) [[likely]] {
+            while (position + 32 <= size && narrow_ascii_units(data + position, is_big_endian, out)) {
+                position += 32;
+                out += 16;
+            }
+        }
+#endif
+        const std::size_t stride_end = std::min(size - (size - position) % 2, position + SCALAR_STRIDE * 2);
+        for (; position < stride_end; position += 2) {
+            process_unit(read_unit(data + position, is_big_endian));
+        }
+    }
+
+    // Keep the odd byte for the next block
+    if (position < size) {
+        this->pending_byte_ = data[position];
+        this->has_pending_byte_ = true;
+    }
+    output.resize(static_cast<std::size_t>(out - output.data()));
+}
+
+void Decoder::finish(std::string &output)
+{
+    if (this->pending_high_surrogate_ != 0 || this->has_pending_byte_) {
+        output.append(utf8::REPLACEMENT_CHARACTER);
+    }
+    this->pending_high_surrogate_ = 0;
+    this->has_pending_byte_ = false;
+}
+
+std::size_t Decoder::max_output_size(const std::size_t size) const
+{
+    switch (this->encoding_) {
+    case Encoding::Utf8:
+        return size;
+    case Encoding::Windows1252:
+        return size * 3;
+    case Encoding::Utf16Le:
+    case Encoding::Utf16Be:
+        // A code unit split across blocks or a carried-over high surrogate adds at most one unit and one U+FFFD
+        return (size / 2 + 1) * 3 + 3;
+    }
+    return size * 3;
+}
+
+std::string decode(const std::string_view bytes,
+                   const Encoding encoding)
+{
+    std::string output;
+    Decoder decoder{encoding};
+    decoder.decode(bytes, output);
+    decoder.finish(output);
+    return output;
+}
+
+LoadedFile load_file(const std::filesystem::path &path)
+{
+    std::ifstream stream{path, std::ios::binary};
+    if (!stream) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to open '{}' for reading", path.string()));
+    }
+
+    // Read one block at a time into the same buffer, so only the text itself grows with the file
+    std::string block(BLOCK_SIZE, '\0');
+    const auto read_block = [&stream, &block, &path]() -> std::string_view {
+        stream.read(block.data(), static_cast<std::streamsize>(block.size()));
+        if (stream.bad()) [[unlikely]] {
+            throw std::runtime_error(std::format("Failed to read '{}'", path.string()));
+        }
+        return std::string_view{block.data(), static_cast<std::size_t>(stream.gcount())};
+    };
+
+    // Detect the encoding from the first block
+    const std::string_view first_block = read_block();
+    const Detection detection = detect(first_block, first_block.size() < block.size());
+    LoadedFile loaded{.text = {}, .encoding = detection.encoding};
+    Decoder decoder{detection.encoding};
+
+    // Reserve the worst-case expansion of the whole file, so no later block can outgrow the text, even if it expands more than the first one
+    // Pages of the reservation beyond the decoded text are never touched, so they cost address space rather than memory
+    std::error_code error;
+    const std::uintmax_t file_size = std::filesystem::file_size(path, error);
+    const std::size_t input_size = !error && file_size > first_block.size() ? static_cast<std::size_t>(file_size) : first_block.size();
+    loaded.text.reserve(decoder.max_output_size(input_size - std::min(input_size, detection.bom_size)));
+    decoder.decode(first_block.substr(detection.bom_size), loaded.text);
+
+    // Transcode the rest of the file
+    while (stream) {
+        const std::string_view next_block = read_block();
+        if (next_block.empty()) {
+            break;
+        }
+        decoder.decode(next_block, loaded.text);
+    }
+    decoder.finish(loaded.text);
+
+    return loaded;
+}
+
+}  // namespace core::encoding
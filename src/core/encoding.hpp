@@ -0,0 +1,170 @@
+/**
+ * @file encoding.hpp
+ *
+ * @brief Encoding detection and streamed transcoding into UTF-8.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <filesystem>   // for std::filesystem::path
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+namespace core::encoding {
+
+/**
+ * @brief Size of the blocks read from disk and transcoded one at a time, in bytes.
+ */
+inline constexpr std::size_t BLOCK_SIZE = 1024 * 1024;
+
+/**
+ * @brief Text encodings that can be transcoded into UTF-8.
+ */
+enum class Encoding {
+    Utf8,
+    Utf16Le,
+    Utf16Be,
+    Windows1252,
+};
+
+/**
+ * @brief Return the display name of an encoding.
+ *
+ * @param encoding Encoding to name (e.g., "Encoding::Utf16Le").
+ *
+ * @return Display name (e.g., "UTF-16LE").
+ */
+[[nodiscard]] std::string_view to_string(const Encoding encoding);
+
+/**
+ * @brief Result of sniffing the encoding of some bytes.
+ */
+struct Detection {
+    /**
+     * @brief Detected encoding.
+     */
+    Encoding encoding = Encoding::Utf8;
+
+    /**
+     * @brief Number of byte order mark bytes at the start, which are not part of the text (e.g., "2" for UTF-16).
+     */
+    std::size_t bom_size = 0;
+};
+
+/**
+ * @brief Sniff the encoding of some bytes.
+ *
+ * A byte order mark wins; otherwise UTF-16 is recognized by the null high bytes of its ASCII characters, valid UTF-8 stays UTF-8, and anything else falls back to Windows-1252.
+ *
+ * @param sample Bytes to sniff, usually the first block of a file (e.g., "\xFF\xFEh\0i\0").
+ * @param is_whole_text Whether the sample is the whole text; if false, a UTF-8 sequence cut off at the end of the sample is not treated as invalid.
+ *
+ * @return Detected encoding and byte order mark size (e.g., {Encoding::Utf16Le, 2}).
+ */
+[[nodiscard]] Detection detect(const std::string_view sample,
+                               const bool is_whole_text = true);
+
+/**
+ * @brief Streaming transcoder into UTF-8.
+ *
+ * The input can be fed in blocks of any size; a code unit, surrogate pair, or UTF-8 sequence split across blocks is carried over to the next block. Unpaired surrogates and bytes left over at the end become U+FFFD. UTF-8 input is passed through unchanged.
+ */
+class Decoder {
+  public:
+    /**
+     * @brief Construct a new Decoder object.
+     *
+     * @param encoding Encoding of the input (e.g., "Encoding::Utf16Le").
+     */
+    explicit Decoder(const Encoding encoding);
+
+    /**
+     * @brief Transcode the next block of input, appending the UTF-8 text to the output.
+     *
+     * @param block Next block of input, without the byte order mark (e.g., "h\0i\0").
+     * @param output String the UTF-8 text is appended to.
+     */
+    void decode(const std::string_view block,
+                std::string &output);
+
+    /**
+     * @brief Flush the input carried over from the last block, appending U+FFFD if it was incomplete.
+     *
+     * @param output String the UTF-8 text is appended to.
+     */
+    void finish(std::string &output);
+
+    /**
+     * @brief Return the most UTF-8 bytes that decoding an input of a given size can produce, however it is split into blocks.
+     *
+     * Reserving this much up front lets "decode()" and "finish()" run without reallocating the output.
+     *
+     * @param size Size of the input in bytes, without the byte order mark (e.g., "1048576").
+     *
+     * @return Upper bound in bytes (e.g., "3145728" for Windows-1252, where every byte can become 3 bytes).
+     */
+    [[nodiscard]] std::size_t max_output_size(const std::size_t size) const;
+
+  private:
+    /**
+     * @brief Encoding of the input.
+     */
+    Encoding encoding_;
+
+    /**
+     * @brief First byte of a UTF-16 code unit split across blocks.
+     */
+    unsigned char pending_byte_ = 0;
+
+    /**
+     * @brief Whether "pending_byte_" holds a byte.
+     */
+    bool has_pending_byte_ = false;
+
+    /**
+     * @brief High surrogate waiting for its low surrogate in the next block, or 0 if none.
+     */
+    char16_t pending_high_surrogate_ = 0;
+};
+
+/**
+ * @brief Transcode a whole buffer into UTF-8.
+ *
+ * @param bytes Bytes to transcode, without the byte order mark (e.g., "caf\xE9").
+ * @param encoding Encoding of the bytes (e.g., "Encoding::Windows1252").
+ *
+ * @return UTF-8 text (e.g., "café").
+ */
+[[nodiscard]] std::string decode(const std::string_view bytes,
+                                 const Encoding encoding);
+
+/**
+ * @brief Text loaded from a file.
+ */
+struct LoadedFile {
+    /**
+     * @brief Contents of the file, transcoded into UTF-8 without the byte order mark.
+     */
+    std::string text;
+
+    /**
+     * @brief Encoding the file was detected to be in.
+     */
+    Encoding encoding = Encoding::Utf8;
+};
+
+/**
+ * @brief Load a text file into UTF-8, detecting its encoding from the first block.
+ *
+ * The file is read and transcoded one "BLOCK_SIZE" block at a time, and the output is reserved for the worst-case expansion of the whole file, so it is never reallocated and a large file needs about one block of memory on top of its text (the unused part of the reservation is address space that is never touched).
+ *
+ * @param path Path to the file (e.g., "notes.txt").
+ *
+ * @return Transcoded text and detected encoding.
+ *
+ * @throws std::runtime_error if the file cannot be read.
+ */
+[[nodiscard]] LoadedFile load_file(const std::filesystem::path &path);
+
+}  // namespace core::encoding
@@ -0,0 +1,317 @@
+/**
+ * @file glyphs.cpp
+ */
+
+#include <array>         // for std::array
+#include <bit>           // for std::countr_zero
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <cstring>       // for std::memcpy
+#include <filesystem>    // for std::filesystem
+#include <format>        // for std::format
+#include <fstream>       // for std::ifstream, std::ofstream
+#include <stdexcept>     // for std::runtime_error
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code
+#include <utility>       // for std::move
+#include <vector>        // for std::vector
+
+#include <spdlog/spdlog.h>
+
+#include "core/glyphs.hpp"
+
+namespace core::glyphs {
+
+namespace {
+
+/**
+ * @brief Magic bytes at the start of every cache file, the last character is the format version.
+ */
+constexpr std::array<char, 8> CACHE_MAGIC = {'U', 'N', 'G', 'P', 'T', 'G', 'C', '2'};
+
+/**
+ * @brief Mask that selects the high bit of every byte in a 64-bit word.
+ */
+constexpr std::uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+/**
+ * @brief Mix a value into a 64-bit FNV-1a hash.
+ *
+ * @param hash Current hash value.
+ * @param bytes Bytes to mix in.
+ *
+ * @return Updated hash value.
+ */
+[[nodiscard]] std::uint64_t fnv1a(std::uint64_t hash, const std::string_view bytes)
+{
+    for (const char byte : bytes) {
+        hash ^= static_cast<unsigned char>(byte);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Write a trivially copyable value to a binary stream.
+ *
+ * @param stream Output stream opened in binary mode.
+ * @param value Value to write.
+ */
+template <typename T>
+void write_value(std::ofstream &stream, const T &value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * @brief Read a trivially copyable value from a binary stream.
+ *
+ * @param stream Input stream opened in binary mode.
+ * @param path Path of the file, used in the error message.
+ *
+ * @return Value that was read.
+ *
+ * @throws std::runtime_error if the stream ends before the value was read.
+ */
+template <typename T>
+[[nodiscard]] T read_value(std::ifstream &stream, const std::filesystem::path &path)
+{
+    T value{};
+    if (!stream.read(reinterpret_cast<char *>(&value), sizeof(T))) [[unlikely]] {
+        throw std::runtime_error(std::format("Glyph cache '{}' is truncated", path.string()));
+    }
+    return value;
+}
+
+}  // namespace
+
+GlyphSet::GlyphSet(const char32_t first_code_point,
+                   const char32_t last_code_point)
+    : first_code_point_(first_code_point),
+      last_code_point_(last_code_point),
+      bits_((static_cast<std::size_t>(last_code_point - first_code_point) / 64) + 1, 0)
+{
+}
+
+bool GlyphSet::insert(const char32_t code_point)
+{
+    if (code_point < this->first_code_point_ || code_point > this->last_code_point_) {
+        return false;
+    }
+    const std::size_t index = code_point - this->first_code_point_;
+    const std::uint64_t mask = std::uint64_t{1} << (index % 64);
+    std::uint64_t &word = this->bits_[index / 64];
+    if ((word & mask) != 0) [[likely]] {
+        return false;
+    }
+    word |= mask;
+    ++this->size_;
+    return true;
+}
+
+bool GlyphSet::add_from_text(const std::string_view text)
+{
+    const std::size_t size = text.size();
+    const auto *bytes = reinterpret_cast<const unsigned char *>(text.data());
+    bool added = false;
+    std::size_t i = 0;
+
+    while (i < size) {
+        // Skip ASCII eight bytes at a time, no ASCII character is ever tracked
+        while (i + 8 <= size) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            if ((word & HIGH_BITS) != 0) {
+                break;
+            }
+            i += 8;
+        }
+        if (i >= size) {
+            break;
+        }
+
+        const unsigned char lead = bytes[i];
+        if (lead < 0x80) {
+            ++i;
+            continue;
+        }
+
+        // Determine the sequence length and the payload bits of the lead byte
+        std::size_t length;
+        char32_t code_point;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+            code_point = lead & 0x1Fu;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            code_point = lead & 0x0Fu;
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            code_point = lead & 0x07u;
+        }
+        else {
+            // Stray continuation byte or invalid lead byte
+            ++i;
+            continue;
+        }
+
+        if (i + length > size) [[unlikely]] {
+            break;
+        }
+
+        // Accumulate the continuation bytes, bailing out on the first malformed one
+        bool is_valid = true;
+        for (std::size_t j = 1; j < length; ++j) {
+            const unsigned char continuation = bytes[i + j];
+            if ((continuation & 0xC0u) != 0x80u) [[unlikely]] {
+                is_valid = false;
+                break;
+            }
+            code_point = (code_point << 6) | (continuation & 0x3Fu);
+        }
+        if (!is_valid) [[unlikely]] {
+            ++i;
+            continue;
+        }
+
+        added |= this->insert(code_point);
+        i += length;
+    }
+
+    return added;
+}
+
+bool GlyphSet::contains(const char32_t code_point) const
+{
+    if (code_point < this->first_code_point_ || code_point > this->last_code_point_) {
+        return false;
+    }
+    const std::size_t index = code_point - this->first_code_point_;
+    return (this->bits_[index / 64] & (std::uint64_t{1} << (index % 64))) != 0;
+}
+
+std::vector<char32_t> GlyphSet::code_points() const
+{
+    std::vector<char32_t> result;
+    result.reserve(this->size_);
+    for (std::size_t word_index = 0; word_index < this->bits_.size(); ++word_index) {
+        std::uint64_t word = this->bits_[word_index];
+        while (word != 0) {
+            const auto bit = static_cast<std::size_t>(std::countr_zero(word));
+            result.push_back(this->first_code_point_ + static_cast<char32_t>(word_index * 64 + bit));
+            word &= word - 1;  // Clear the lowest set bit
+        }
+    }
+    return result;
+}
+
+GlyphCache::GlyphCache(const std::uint64_t font_fingerprint)
+    : font_fingerprint_(font_fingerprint)
+{
+}
+
+GlyphCache GlyphCache::load(const std::filesystem::path &path,
+                            const std::uint64_t font_fingerprint)
+{
+    GlyphCache cache{font_fingerprint};
+
+    std::ifstream stream{path, std::ios::binary};
+    if (!stream) {
+        SPDLOG_DEBUG("No glyph cache found at '{}'", path.string());
+        return cache;
+    }
+
+    const auto magic = read_value<std::array<char, 8>>(stream, path);
+    const auto stored_fingerprint = read_value<std::uint64_t>(stream, path);
+    if (magic != CACHE_MAGIC || stored_fingerprint != font_fingerprint) {
+        SPDLOG_DEBUG("Ignoring glyph cache '{}' written by a different version or for a different font", path.string());
+        return cache;
+    }
+
+    const auto count = read_value<std::uint32_t>(stream, path);
+    cache.glyphs_.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        Glyph glyph;
+        glyph.code_point = read_value<char32_t>(stream, path);
+        glyph.width = read_value<std::uint16_t>(stream, path);
+        glyph.height = read_value<std::uint16_t>(stream, path);
+        glyph.offset_x = read_value<float>(stream, path);
+        glyph.offset_y = read_value<float>(stream, path);
+        glyph.advance_x = read_value<float>(stream, path);
+        glyph.is_missing = read_value<std::uint8_t>(stream, path) != 0;
+        glyph.pixels.resize(static_cast<std::size_t>(glyph.width) * glyph.height);
+        if (!stream.read(reinterpret_cast<char *>(glyph.pixels.data()), static_cast<std::streamsize>(glyph.pixels.size()))) [[unlikely]] {
+            throw std::runtime_error(std::format("Glyph cache '{}' is truncated", path.string()));
+        }
+        cache.insert(std::move(glyph));
+    }
+
+    SPDLOG_DEBUG("Loaded '{}' glyphs from cache '{}'", cache.size(), path.string());
+    return cache;
+}
+
+void GlyphCache::save(const std::filesystem::path &path) const
+{
+    const std::filesystem::path temporary_path = std::filesystem::path{path}.concat(".tmp");
+    {
+        std::ofstream stream{temporary_path, std::ios::binary | std::ios::trunc};
+        if (!stream) [[unlikely]] {
+            throw std::runtime_error(std::format("Failed to open '{}' for writing", temporary_path.string()));
+        }
+
+        write_value(stream, CACHE_MAGIC);
+        write_value(stream, this->font_fingerprint_);
+        write_value(stream, static_cast<std::uint32_t>(this->glyphs_.size()));
+        for (const auto &[code_point, glyph] : this->glyphs_) {
+            write_value(stream, code_point);
+            write_value(stream, glyph.width);
+            write_value(stream, glyph.height);
+            write_value(stream, glyph.offset_x);
+            write_value(stream, glyph.offset_y);
+            write_value(stream, glyph.advance_x);
+            write_value(stream, static_cast<std::uint8_t>(glyph.is_missing ? 1 : 0));
+            stream.write(reinterpret_cast<const char *>(glyph.pixels.data()), static_cast<std::streamsize>(glyph.pixels.size()));
+        }
+
+        if (!stream.flush()) [[unlikely]] {
+            throw std::runtime_error(std::format("Failed to write '{}'", temporary_path.string()));
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporary_path, path, ec);
+    if (ec) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to rename '{}' to '{}': {}", temporary_path.string(), path.string(), ec.message()));
+    }
+
+    SPDLOG_DEBUG("Saved '{}' glyphs to cache '{}'", this->glyphs_.size(), path.string());
+}
+
+void GlyphCache::insert(Glyph glyph)
+{
+    const char32_t code_point = glyph.code_point;
+    this->glyphs_.insert_or_assign(code_point, std::move(glyph));
+}
+
+const Glyph *GlyphCache::find(const char32_t code_point) const
+{
+    const auto it = this->glyphs_.find(code_point);
+    return it != this->glyphs_.cend() ? &it->second : nullptr;
+}
+
+std::uint64_t fingerprint_font_file(const std::filesystem::path &path)
+{
+    const std::filesystem::path absolute_path = std::filesystem::absolute(path);
+    const auto size = static_cast<std::uint64_t>(std::filesystem::file_size(absolute_path));
+    const auto modified = static_cast<std::uint64_t>(std::filesystem::last_write_time(absolute_path).time_since_epoch().count());
+
+    std::uint64_t hash = 0xCBF29CE484222325ULL;  // FNV-1a offset basis
+    hash = fnv1a(hash, absolute_path.generic_string());
+    hash = fnv1a(hash, std::string_view{reinterpret_cast<const char *>(&size), sizeof(size)});
+    hash = fnv1a(hash, std::string_view{reinterpret_cast<const char *>(&modified), sizeof(modified)});
+    return hash;
+}
+
+}  // namespace core::glyphs
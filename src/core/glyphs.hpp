@@ -0,0 +1,246 @@
+/**
+ * @file glyphs.hpp
+ *
+ * @brief Tracking of code points used by the text, and an on-disk cache of rasterized glyph bitmaps.
+ */
+
+#pragma once
+
+#include <cstddef>        // for std::size_t
+#include <cstdint>        // for std::uint8_t, std::uint16_t, std::uint64_t
+#include <filesystem>     // for std::filesystem::path
+#include <string_view>    // for std::string_view
+#include <unordered_map>  // for std::unordered_map
+#include <vector>         // for std::vector
+
+namespace core::glyphs {
+
+/**
+ * @brief Set of code points that were requested for rendering.
+ *
+ * Only code points within the trackable range are stored; everything else is ignored, because the default font already covers it (below) or the renderer cannot display it (above).
+ */
+class GlyphSet final {
+  public:
+    /**
+     * @brief Construct a new, empty GlyphSet object.
+     *
+     * @param first_code_point First code point that is tracked (e.g., "0x100", as Latin-1 is covered by the default font).
+     * @param last_code_point Last code point that is tracked (e.g., "0xFFFF" for a 16-bit renderer).
+     */
+    explicit GlyphSet(const char32_t first_code_point = 0x100,
+                      const char32_t last_code_point = 0xFFFF);
+
+    /**
+     * @brief Add all trackable code points found in the provided text.
+     *
+     * ASCII runs are skipped eight bytes at a time, so scanning mostly-English text is close to memory bandwidth. Malformed UTF-8 sequences are skipped.
+     *
+     * @param text UTF-8 text to scan (e.g., "Zażółć").
+     *
+     * @return True if at least one code point was not in the set before, false otherwise.
+     */
+    bool add_from_text(const std::string_view text);
+
+    /**
+     * @brief Check whether a code point is in the set.
+     *
+     * @param code_point Code point to look up (e.g., "U+017C").
+     *
+     * @return True if the code point is in the set, false otherwise.
+     */
+    [[nodiscard]] bool contains(const char32_t code_point) const;
+
+    /**
+     * @brief Return all code points in the set.
+     *
+     * @return Code points sorted in ascending order.
+     */
+    [[nodiscard]] std::vector<char32_t> code_points() const;
+
+    /**
+     * @brief Return the number of code points in the set.
+     *
+     * @return Number of code points (e.g., "3").
+     */
+    [[nodiscard]] std::size_t size() const
+    {
+        return this->size_;
+    }
+
+  private:
+    /**
+     * @brief Insert a single code point, ignoring code points outside the trackable range.
+     *
+     * @param code_point Code point to insert.
+     *
+     * @return True if the code point was inserted, false if it was already present or is not trackable.
+     */
+    bool insert(const char32_t code_point);
+
+    /**
+     * @brief First tracked code point.
+     */
+    char32_t first_code_point_;
+
+    /**
+     * @brief Last tracked code point.
+     */
+    char32_t last_code_point_;
+
+    /**
+     * @brief One bit per trackable code point.
+     */
+    std::vector<std::uint64_t> bits_;
+
+    /**
+     * @brief Number of set bits.
+     */
+    std::size_t size_ = 0;
+};
+
+/**
+ * @brief Rasterized glyph, ready to be copied into a font atlas.
+ */
+struct Glyph {
+    /**
+     * @brief Unicode code point of the glyph (e.g., "U+4E2D").
+     */
+    char32_t code_point = 0;
+
+    /**
+     * @brief Width of the bitmap in pixels.
+     */
+    std::uint16_t width = 0;
+
+    /**
+     * @brief Height of the bitmap in pixels.
+     */
+    std::uint16_t height = 0;
+
+    /**
+     * @brief Horizontal offset of the bitmap relative to the pen position, in pixels.
+     */
+    float offset_x = 0.0f;
+
+    /**
+     * @brief Vertical offset of the bitmap relative to the top of the line, in pixels.
+     */
+    float offset_y = 0.0f;
+
+    /**
+     * @brief Distance the pen moves after drawing the glyph, in pixels.
+     */
+    float advance_x = 0.0f;
+
+    /**
+     * @brief 8-bit alpha bitmap, "width * height" bytes, row-major; empty for whitespace, which only has an advance.
+     */
+    std::vector<std::uint8_t> pixels;
+
+    /**
+     * @brief Whether the font has no glyph for the code point; such an entry has no bitmap and only records that rasterizing it again is pointless.
+     */
+    bool is_missing = false;
+};
+
+/**
+ * @brief Collection of rasterized glyphs for a single font file, which can be saved to and loaded from disk.
+ *
+ * Code points that the font lacks, or that have no bitmap (whitespace), are cached as well, so they are looked up rather than rasterized on every launch.
+ */
+class GlyphCache final {
+  public:
+    /**
+     * @brief Construct a new, empty GlyphCache object.
+     *
+     * @param font_fingerprint Fingerprint of the font file the glyphs were rasterized from (see "fingerprint_font_file()").
+     */
+    explicit GlyphCache(const std::uint64_t font_fingerprint);
+
+    /**
+     * @brief Load a cache from disk.
+     *
+     * @param path Path to the cache file (e.g., "~/.cache/ungpt/glyphs-0123456789abcdef.bin").
+     * @param font_fingerprint Expected fingerprint of the font file.
+     *
+     * @return Cache with all stored glyphs, or an empty cache if the file does not exist or belongs to a different font.
+     *
+     * @throws std::runtime_error if the file exists but is truncated or malformed.
+     */
+    [[nodiscard]] static GlyphCache load(const std::filesystem::path &path,
+                                         const std::uint64_t font_fingerprint);
+
+    /**
+     * @brief Save the cache to disk.
+     *
+     * The file is written to a temporary path first and then renamed, so a crash never leaves a half-written cache behind.
+     *
+     * @param path Path to the cache file (e.g., "~/.cache/ungpt/glyphs-0123456789abcdef.bin").
+     *
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save(const std::filesystem::path &path) const;
+
+    /**
+     * @brief Insert or replace a glyph.
+     *
+     * @param glyph Glyph to store.
+     */
+    void insert(Glyph glyph);
+
+    /**
+     * @brief Find a glyph by its code point.
+     *
+     * @param code_point Code point to look up (e.g., "U+4E2D").
+     *
+     * @return Pointer to the glyph, or nullptr if it is not cached.
+     */
+    [[nodiscard]] const Glyph *find(const char32_t code_point) const;
+
+    /**
+     * @brief Return the number of cached glyphs.
+     *
+     * @return Number of glyphs (e.g., "42").
+     */
+    [[nodiscard]] std::size_t size() const
+    {
+        return this->glyphs_.size();
+    }
+
+    /**
+     * @brief Return the fingerprint of the font file the glyphs belong to.
+     *
+     * @return Fingerprint passed to the constructor.
+     */
+    [[nodiscard]] std::uint64_t font_fingerprint() const
+    {
+        return this->font_fingerprint_;
+    }
+
+  private:
+    /**
+     * @brief Fingerprint of the font file the glyphs were rasterized from.
+     */
+    std::uint64_t font_fingerprint_;
+
+    /**
+     * @brief Glyphs indexed by code point.
+     */
+    std::unordered_map<char32_t, Glyph> glyphs_;
+};
+
+/**
+ * @brief Compute a cheap fingerprint of a font file, used as the cache key.
+ *
+ * The fingerprint covers the absolute path, file size and modification time, so an updated font invalidates the cache without hashing megabytes of font data at startup.
+ *
+ * @param path Path to the font file (e.g., "/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc").
+ *
+ * @return 64-bit fingerprint.
+ *
+ * @throws std::filesystem::filesystem_error if the file cannot be inspected.
+ */
+[[nodiscard]] std::uint64_t fingerprint_font_file(const std::filesystem::path &path);
+
+}  // namespace core::glyphs
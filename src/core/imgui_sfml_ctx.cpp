@@ -2,26 +2,175 @@
  * @file imgui_sfml_ctx.cpp
  */
 
-#include <stdexcept>  // for std::runtime_error
+#include <array>         // for std::array
+#include <chrono>        // for std::chrono::seconds
+#include <cmath>         // for std::round
+#include <cstddef>       // for std::size_t, std::max_align_t
+#include <cstdint>       // for std::uint16_t, std::uint64_t
+#include <cstring>       // for std::memcpy
+#include <exception>     // for std::exception
+#include <filesystem>    // for std::filesystem
+#include <format>        // for std::format
+#include <fstream>       // for std::ifstream
+#include <future>        // for std::async, std::future_status
+#include <memory>        // for std::unique_ptr, std::make_unique, std::shared_ptr, std::make_shared
+#include <stdexcept>     // for std::runtime_error
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code
+#include <utility>       // for std::move, std::pair
+#include <vector>        // for std::vector
 
 #include <imgui-SFML.h>
 #include <imgui.h>
 #include <SFML/System/Time.hpp>
 #include <spdlog/spdlog.h>
 
+#include "core/glyphs.hpp"
 #include "core/imgui_sfml_ctx.hpp"
+#include "core/memory.hpp"
+#include "core/paths.hpp"
+
+// Compile a private copy of ImGui's stb_truetype for the background thread, allocating through the regular allocator rather than ImGui's, whose counters live in the ImGui context
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#define STBTT_malloc(size, user_data) core::memory::allocate((size), alignof(std::max_align_t), core::memory::Tag::FontAtlas)
+#define STBTT_free(pointer, user_data) core::memory::deallocate(pointer)
+#include <imstb_truetype.h>
 
 namespace core::imgui_sfml_ctx {
 
+namespace {
+
+/**
+ * @brief Pixel size of the fallback font, which matches the size of the default ProggyClean font.
+ */
+constexpr float FALLBACK_FONT_SIZE_PIXELS = 13.0f;
+
+/**
+ * @brief System fonts with wide Unicode coverage (Latin Extended, Cyrillic, Greek, CJK), tried in order.
+ */
+constexpr std::array FALLBACK_FONT_CANDIDATES = {
+#if defined(_WIN32)
+    "C:/Windows/Fonts/msyh.ttc",      // Microsoft YaHei
+    "C:/Windows/Fonts/arialuni.ttf",  // Arial Unicode MS
+    "C:/Windows/Fonts/segoeui.ttf",   // Segoe UI (no CJK)
+#elif defined(__APPLE__)
+    "/System/Library/Fonts/Supplemental/Arial Unicode.ttf",
+    "/Library/Fonts/Arial Unicode.ttf",
+    "/System/Library/Fonts/Hiragino Sans GB.ttc",
+    "/System/Library/Fonts/Supplemental/Arial.ttf",  // No CJK
+#else
+    "/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc",         // Debian, Ubuntu
+    "/usr/share/fonts/noto-cjk/NotoSansCJK-Regular.ttc",              // Arch
+    "/usr/share/fonts/google-noto-cjk/NotoSansCJK-Regular.ttc",       // Fedora
+    "/usr/share/fonts/truetype/droid/DroidSansFallbackFull.ttf",      // Older Debian, Ubuntu
+    "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",                // Debian, Ubuntu (no CJK)
+    "/usr/share/fonts/TTF/DejaVuSans.ttf",                            // Arch (no CJK)
+#endif
+};
+
+/**
+ * @brief Return the first fallback font that exists on this system.
+ *
+ * @return Path to the font, or an empty path if none of the candidates exist.
+ */
+[[nodiscard]] std::filesystem::path find_fallback_font()
+{
+    for (const char *candidate : FALLBACK_FONT_CANDIDATES) {
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(candidate, ec)) {
+            return candidate;
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief Read an entire file into memory.
+ *
+ * @param path Path to the file (e.g., "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf").
+ *
+ * @return File contents.
+ *
+ * @throws std::runtime_error if the file cannot be read.
+ */
+[[nodiscard]] std::vector<char> read_file(const std::filesystem::path &path)
+{
+    std::ifstream stream{path, std::ios::binary | std::ios::ate};
+    if (!stream) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to open '{}'", path.string()));
+    }
+    std::vector<char> data(static_cast<std::size_t>(stream.tellg()));
+    stream.seekg(0);
+    if (!stream.read(data.data(), static_cast<std::streamsize>(data.size()))) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to read '{}'", path.string()));
+    }
+    return data;
+}
+
+/**
+ * @brief Allocate memory for ImGui, charged to the font atlas while a rebuild runs on the current thread, otherwise to ImGui itself.
+ *
+ * @param size Number of bytes to allocate.
+ * @param user_data Unused.
+ *
+ * @return Pointer to the memory, or nullptr if it could not be allocated.
+ */
+[[nodiscard]] void *allocate_for_imgui(const std::size_t size,
+                                       void *user_data)
+{
+    static_cast<void>(user_data);
+    const core::memory::Tag tag = core::memory::current_tag() == core::memory::Tag::FontAtlas ? core::memory::Tag::FontAtlas : core::memory::Tag::ImGui;
+    return core::memory::allocate(size, alignof(std::max_align_t), tag);
+}
+
+/**
+ * @brief Free memory allocated by "allocate_for_imgui()".
+ *
+ * @param pointer Memory to free, may be nullptr.
+ * @param user_data Unused.
+ */
+void free_for_imgui(void *pointer,
+                    void *user_data)
+{
+    static_cast<void>(user_data);
+    core::memory::deallocate(pointer);
+}
+
+}  // namespace
+
+struct ImGuiContext::AtlasBuild {
+    /**
+     * @brief Deleter for atlases allocated with ImGui's allocator.
+     */
+    struct AtlasDeleter {
+        void operator()(ImFontAtlas *atlas) const
+        {
+            IM_DELETE(atlas);
+        }
+    };
+
+    /**
+     * @brief Built atlas.
+     */
+    std::unique_ptr<ImFontAtlas, AtlasDeleter> atlas;
+};
+
 ImGuiContext::ImGuiContext(sf::RenderWindow &window)
     : window_(window)
 {
     SPDLOG_DEBUG("Creating ImGui context...");
+
+    // Account ImGui's own memory (e.g., the wide-character copy of the text being edited, draw lists, and the font atlas) separately from the rest
+    ImGui::SetAllocatorFunctions(allocate_for_imgui, free_for_imgui, nullptr);
     if (!ImGui::SFML::Init(window)) [[unlikely]] {
         throw std::runtime_error("Failed to initialize ImGui-SFML");
     }
     SPDLOG_DEBUG("ImGui context created, applying settings...");
 
+    // Remember the atlas owned by the ImGui context, so it can be handed back before shutdown
+    this->default_atlas_ = ImGui::GetIO().Fonts;
+
     this->disable_ini_saving();
     SPDLOG_DEBUG("Disabled INI file saving!");
 
@@ -33,6 +182,13 @@ ImGuiContext::ImGuiContext(sf::RenderWindow &window)
 
 ImGuiContext::~ImGuiContext()
 {
+    // Wait for a background rasterization, so it does not outlive the app while saving the cache
+    if (this->pending_glyphs_.valid()) {
+        this->pending_glyphs_.wait();
+    }
+
+    // Hand the context-owned atlas back, so ImGui destroys its own atlas on shutdown and never ours
+    ImGui::GetIO().Fonts = this->default_atlas_;
     ImGui::SFML::Shutdown();
 }
 
@@ -172,8 +328,12 @@ void ImGuiContext::process_event(const sf::Event &event) const
     ImGui::SFML::ProcessEvent(this->window_, event);
 }
 
-void ImGuiContext::update(const float dt) const
+void ImGuiContext::update(const float dt)
 {
+    // Swap atlases before the new frame starts, nothing references the fonts between frames
+    this->apply_rasterized_glyphs();
+    this->start_glyph_rasterization();
+
     ImGui::SFML::Update(this->window_, sf::seconds(dt));
 }
 
@@ -182,4 +342,253 @@ void ImGuiContext::render() const
     ImGui::SFML::Render(this->window_);
 }
 
+void ImGuiContext::request_glyphs(const std::string_view text)
+{
+    if (this->requested_glyphs_.add_from_text(text)) {
+        this->glyphs_need_rebuild_ = true;
+        SPDLOG_DEBUG("Requested glyphs for new code points, '{}' code points requested in total", this->requested_glyphs_.size());
+    }
+}
+
+void ImGuiContext::start_glyph_rasterization()
+{
+    // Only one rasterization runs at a time, code points requested meanwhile are picked up by the next one
+    if (!this->glyphs_need_rebuild_ || this->pending_glyphs_.valid()) [[likely]] {
+        return;
+    }
+
+    // Resolve the fallback font and its cache lazily, so startup never pays for it
+    if (!this->fallback_font_resolved_) {
+        this->fallback_font_resolved_ = true;
+        this->fallback_font_path_ = find_fallback_font();
+        if (this->fallback_font_path_.empty()) {
+            SPDLOG_WARN("No fallback font found, characters outside of Latin-1 will not be displayed");
+        }
+        else {
+            SPDLOG_DEBUG("Using fallback font '{}'", this->fallback_font_path_.string());
+            try {
+                this->font_fingerprint_ = core::glyphs::fingerprint_font_file(this->fallback_font_path_);
+                this->glyph_cache_path_ = core::paths::get_cache_directory() / std::format("glyphs-{:016x}.bin", this->font_fingerprint_);
+            }
+            catch (const std::exception &e) {
+                SPDLOG_WARN("Glyph cache disabled: {}", e.what());
+            }
+        }
+
+        // Every atlas starts with the default font, which the context-owned atlas has already built, so its ascent is known
+        this->glyph_baseline_ = std::round(this->default_atlas_->Fonts[0]->Ascent);
+    }
+
+    this->glyphs_need_rebuild_ = false;
+    if (this->fallback_font_path_.empty()) [[unlikely]] {
+        return;
+    }
+
+    // The task only receives copies and never calls into ImGui, so it shares no state with the UI thread
+    this->pending_glyphs_ = std::async(std::launch::async,
+                                       &ImGuiContext::rasterize_glyphs,
+                                       this->requested_glyphs_.code_points(),
+                                       this->glyph_cache_,
+                                       this->fallback_font_path_,
+                                       this->font_fingerprint_,
+                                       this->glyph_cache_path_,
+                                       this->glyph_baseline_);
+    SPDLOG_DEBUG("Started background glyph rasterization");
+}
+
+void ImGuiContext::apply_rasterized_glyphs()
+{
+    if (!this->pending_glyphs_.valid() ||
+        this->pending_glyphs_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) [[likely]] {
+        return;
+    }
+
+    std::unique_ptr<AtlasBuild> build;
+    try {
+        this->glyph_cache_ = this->pending_glyphs_.get();
+        build = build_font_atlas(this->requested_glyphs_.code_points(), *this->glyph_cache_);
+    }
+    catch (const std::exception &e) {
+        SPDLOG_WARN("Failed to rebuild font atlas, keeping the previous one: {}", e.what());
+        return;
+    }
+
+    // Point ImGui at the new atlas and upload its texture
+    ImGuiIO &io = ImGui::GetIO();
+    ImFontAtlas *previous_atlas = io.Fonts;
+    io.Fonts = build->atlas.get();
+    if (!ImGui::SFML::UpdateFontTexture()) [[unlikely]] {
+        io.Fonts = previous_atlas;
+        SPDLOG_WARN("Failed to upload rebuilt font atlas texture, keeping the previous one");
+        return;
+    }
+
+    // Destroys the previous atlas, unless it was the context-owned default one
+    this->current_atlas_build_ = std::move(build);
+    SPDLOG_DEBUG("Swapped in rebuilt font atlas ({}x{})", io.Fonts->TexWidth, io.Fonts->TexHeight);
+}
+
+std::shared_ptr<const core::glyphs::GlyphCache> ImGuiContext::rasterize_glyphs(const std::vector<char32_t> code_points,
+                                                                              std::shared_ptr<const core::glyphs::GlyphCache> glyph_cache,
+                                                                              const std::filesystem::path font_path,
+                                                                              const std::uint64_t font_fingerprint,
+                                                                              const std::filesystem::path cache_path,
+                                                                              const float baseline)
+{
+    // Charge everything this rasterization allocates to the font atlas
+    const core::memory::Scope memory_scope{core::memory::Tag::FontAtlas};
+
+    // Load the on-disk cache on the first rasterization, on this thread rather than during startup
+    if (!glyph_cache) {
+        if (!cache_path.empty()) {
+            try {
+                glyph_cache = std::make_shared<const core::glyphs::GlyphCache>(core::glyphs::GlyphCache::load(cache_path, font_fingerprint));
+            }
+            catch (const std::exception &e) {
+                SPDLOG_WARN("Ignoring glyph cache: {}", e.what());
+            }
+        }
+        if (!glyph_cache) {
+            glyph_cache = std::make_shared<const core::glyphs::GlyphCache>(font_fingerprint);
+        }
+    }
+
+    // Every code point that was looked at before has an entry, including whitespace and code points the font lacks
+    std::vector<char32_t> missing_code_points;
+    for (const char32_t code_point : code_points) {
+        if (glyph_cache->find(code_point) == nullptr) {
+            missing_code_points.push_back(code_point);
+        }
+    }
+    if (missing_code_points.empty()) {
+        return glyph_cache;
+    }
+
+    const std::vector<char> font_data = read_file(font_path);
+    const auto *font_bytes = reinterpret_cast<const unsigned char *>(font_data.data());
+    stbtt_fontinfo font_info;
+    const int font_offset = stbtt_GetFontOffsetForIndex(font_bytes, 0);  // First font of a collection (.ttc), like ImGui
+    if (font_offset < 0 || stbtt_InitFont(&font_info, font_bytes, font_offset) == 0) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to parse fallback font '{}'", font_path.string()));
+    }
+    const float scale = stbtt_ScaleForPixelHeight(&font_info, FALLBACK_FONT_SIZE_PIXELS);
+
+    // Rasterize at 1:1 without oversampling and with whole-pixel advances, the way ImGui would with "OversampleH = 1" and "PixelSnapH"
+    auto extended_cache = std::make_shared<core::glyphs::GlyphCache>(*glyph_cache);
+    std::size_t bitmap_count = 0;
+    for (const char32_t code_point : missing_code_points) {
+        core::glyphs::Glyph glyph;
+        glyph.code_point = code_point;
+        const int glyph_index = stbtt_FindGlyphIndex(&font_info, static_cast<int>(code_point));
+        if (glyph_index == 0) {
+            glyph.is_missing = true;
+            extended_cache->insert(std::move(glyph));
+            continue;
+        }
+
+        int advance = 0;
+        int left_side_bearing = 0;
+        stbtt_GetGlyphHMetrics(&font_info, glyph_index, &advance, &left_side_bearing);
+        int x0 = 0;
+        int y0 = 0;
+        int x1 = 0;
+        int y1 = 0;
+        stbtt_GetGlyphBitmapBox(&font_info, glyph_index, scale, scale, &x0, &y0, &x1, &y1);
+        glyph.offset_x = static_cast<float>(x0);
+        glyph.offset_y = static_cast<float>(y0) + baseline;
+        glyph.advance_x = std::round(static_cast<float>(advance) * scale);
+
+        // Whitespace has no outline, its entry only carries the advance
+        if (x1 > x0 && y1 > y0) {
+            glyph.width = static_cast<std::uint16_t>(x1 - x0);
+            glyph.height = static_cast<std::uint16_t>(y1 - y0);
+            glyph.pixels.resize(static_cast<std::size_t>(glyph.width) * glyph.height);
+            stbtt_MakeGlyphBitmap(&font_info, glyph.pixels.data(), glyph.width, glyph.height, glyph.width, scale, scale, glyph_index);
+            ++bitmap_count;
+        }
+        extended_cache->insert(std::move(glyph));
+    }
+
+    // Persist the extended cache; a failure only costs rasterizing the glyphs again on the next launch
+    if (!cache_path.empty()) {
+        try {
+            extended_cache->save(cache_path);
+        }
+        catch (const std::exception &e) {
+            SPDLOG_WARN("Failed to save glyph cache: {}", e.what());
+        }
+    }
+
+    SPDLOG_DEBUG("Rasterized '{}' glyphs, '{}' of them with a bitmap", missing_code_points.size(), bitmap_count);
+    return extended_cache;
+}
+
+std::unique_ptr<ImGuiContext::AtlasBuild> ImGuiContext::build_font_atlas(const std::vector<char32_t> &code_points,
+                                                                         const core::glyphs::GlyphCache &glyph_cache)
+{
+    // Charge everything this rebuild allocates, through ImGui or not, to the font atlas
+    const core::memory::Scope memory_scope{core::memory::Tag::FontAtlas};
+    auto build = std::make_unique<AtlasBuild>();
+    build->atlas.reset(IM_NEW(ImFontAtlas)());
+    ImFontAtlas &atlas = *build->atlas;
+    ImFont *font = atlas.AddFontDefault();
+
+    // Register cached bitmaps as custom rectangles of the default font, they are copied in after packing
+    std::vector<std::pair<int, const core::glyphs::Glyph *>> cached_rects;
+    std::vector<const core::glyphs::Glyph *> blank_glyphs;
+    for (const char32_t code_point : code_points) {
+        const core::glyphs::Glyph *glyph = glyph_cache.find(code_point);
+        if (glyph == nullptr || glyph->is_missing) {
+            continue;  // Not rasterized yet, or not in the fallback font either; drawn as ImGui's fallback character
+        }
+        if (glyph->width == 0 || glyph->height == 0) {
+            blank_glyphs.push_back(glyph);
+            continue;
+        }
+        const int rect_id = atlas.AddCustomRectFontGlyph(font,
+                                                         static_cast<ImWchar>(code_point),
+                                                         glyph->width,
+                                                         glyph->height,
+                                                         glyph->advance_x,
+                                                         ImVec2(glyph->offset_x, glyph->offset_y));
+        cached_rects.emplace_back(rect_id, glyph);
+    }
+
+    if (!atlas.Build()) [[unlikely]] {
+        throw std::runtime_error("Failed to build font atlas");
+    }
+
+    unsigned char *pixels = nullptr;
+    int texture_width = 0;
+    int texture_height = 0;
+    atlas.GetTexDataAsAlpha8(&pixels, &texture_width, &texture_height);
+    const auto stride = static_cast<std::size_t>(texture_width);
+
+    // Copy cached bitmaps into their packed rectangles
+    for (const auto &[rect_id, glyph] : cached_rects) {
+        const ImFontAtlasCustomRect *rect = atlas.GetCustomRectByIndex(rect_id);
+        for (std::size_t row = 0; row < glyph->height; ++row) {
+            std::memcpy(pixels + (rect->Y + row) * stride + rect->X,
+                        glyph->pixels.data() + row * glyph->width,
+                        glyph->width);
+        }
+    }
+
+    // Custom rectangles cannot be empty, so whitespace is added to the built font as invisible glyphs with only an advance
+    for (const core::glyphs::Glyph *glyph : blank_glyphs) {
+        font->AddGlyph(nullptr, static_cast<ImWchar>(glyph->code_point), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, glyph->advance_x);
+    }
+    if (!blank_glyphs.empty()) {
+        font->BuildLookupTable();
+    }
+
+    SPDLOG_DEBUG("Built font atlas with '{}' cached glyphs and '{}' blank glyphs ({}x{})",
+                 cached_rects.size(),
+                 blank_glyphs.size(),
+                 texture_width,
+                 texture_height);
+
+    return build;
+}
+
 }  // namespace core::imgui_sfml_ctx
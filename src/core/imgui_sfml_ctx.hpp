@@ -6,8 +6,19 @@
 
 #pragma once
 
+#include <cstdint>      // for std::uint64_t
+#include <filesystem>   // for std::filesystem::path
+#include <future>       // for std::future
+#include <memory>       // for std::unique_ptr, std::shared_ptr
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
 #include <SFML/Graphics.hpp>
 
+#include "core/glyphs.hpp"
+
+struct ImFontAtlas;
+
 namespace core::imgui_sfml_ctx {
 
 /**
@@ -15,6 +26,8 @@ namespace core::imgui_sfml_ctx {
  *
  * On construction, the class initializes the ImGui-SFML context with the specified SFML window, disables INI file saving, and applies the macOS-inspired theme.
  * On destruction, it automatically shuts down ImGui-SFML.
+ *
+ * The default font only covers Latin-1. Glyphs for other scripts (e.g., Polish, CJK) are loaded on demand from a system fallback font via "request_glyphs()": only the code points the text actually uses are rasterized, on a background thread that never touches ImGui, and the atlas is rebuilt from the bitmaps and swapped in between frames. Rasterized glyphs are cached on disk, keyed by the font fingerprint, together with the code points that have no bitmap (whitespace) or no glyph at all, so later launches only copy bitmaps instead of rasterizing anything again.
  */
 class ImGuiContext final {
   public:
@@ -52,9 +65,9 @@ class ImGuiContext final {
      *
      * @param dt Time passed since the previous frame, in seconds.
      *
-     * @note Call this method once per frame after handling events and before calling "render()".
+     * @note Call this method once per frame after handling events and before calling "render()". This is also where the atlas is rebuilt with glyphs rasterized in the background.
      */
-    void update(const float dt) const;
+    void update(const float dt);
 
     /**
      * @brief Render ImGui draw data onto the provided window.
@@ -65,6 +78,15 @@ class ImGuiContext final {
      */
     void render() const;
 
+    /**
+     * @brief Make sure the font atlas contains glyphs for every code point used by the provided text.
+     *
+     * This only scans the text; if new code points were found, they are rasterized on a background thread, and a later "update()" call rebuilds the atlas with them.
+     *
+     * @param text UTF-8 text that will be rendered (e.g., "中文").
+     */
+    void request_glyphs(const std::string_view text);
+
     // Delete copy operations
     ImGuiContext(const ImGuiContext &) = delete;
     ImGuiContext &operator=(const ImGuiContext &) = delete;
@@ -88,10 +110,120 @@ class ImGuiContext final {
      */
     void apply_theme() const;
 
+    /**
+     * @brief Start rasterizing the requested glyphs in the background if any were requested and no rasterization is in flight.
+     */
+    void start_glyph_rasterization();
+
+    /**
+     * @brief Rebuild the atlas once the background rasterization has finished, then swap it in and upload its texture.
+     *
+     * @note Call this between frames only, because the previous atlas is destroyed.
+     */
+    void apply_rasterized_glyphs();
+
+    /**
+     * @brief Font atlas assembled from the default font and cached glyph bitmaps.
+     */
+    struct AtlasBuild;
+
+    /**
+     * @brief Rasterize the requested code points that are not cached yet from the fallback font; runs on a background thread.
+     *
+     * The font is rasterized with a private copy of stb_truetype that allocates through the regular allocator, so nothing here touches ImGui or its global state. Every requested code point gets a cache entry: a bitmap, an advance only (whitespace), or a note that the font lacks it. New entries are saved to disk.
+     *
+     * @param code_points Code points that should be available in the atlas.
+     * @param glyph_cache Glyphs rasterized so far, or nullptr to load them from "cache_path" first.
+     * @param font_path Path to the fallback font.
+     * @param font_fingerprint Fingerprint of the fallback font, used to validate the cache.
+     * @param cache_path Path to the on-disk glyph cache, or empty to disable caching.
+     * @param baseline Distance from the top of the line to the baseline of the default font, in pixels (e.g., "11"), so the fallback glyphs sit on the same baseline.
+     *
+     * @return Cache with an entry for every requested code point.
+     *
+     * @throws std::runtime_error if the font cannot be read or parsed.
+     */
+    [[nodiscard]] static std::shared_ptr<const core::glyphs::GlyphCache> rasterize_glyphs(const std::vector<char32_t> code_points,
+                                                                                         std::shared_ptr<const core::glyphs::GlyphCache> glyph_cache,
+                                                                                         const std::filesystem::path font_path,
+                                                                                         const std::uint64_t font_fingerprint,
+                                                                                         const std::filesystem::path cache_path,
+                                                                                         const float baseline);
+
+    /**
+     * @brief Build a new font atlas with the default font plus the cached glyphs of the requested code points; runs on the UI thread.
+     *
+     * Only bitmaps are copied, nothing is rasterized from the fallback font. Code points that are not cached yet, or that the font lacks, fall back to ImGui's fallback character.
+     *
+     * @param code_points Code points that should be available in the atlas.
+     * @param glyph_cache Glyphs rasterized so far.
+     *
+     * @return Built atlas.
+     *
+     * @throws std::runtime_error if the atlas cannot be built.
+     */
+    [[nodiscard]] static std::unique_ptr<AtlasBuild> build_font_atlas(const std::vector<char32_t> &code_points,
+                                                                      const core::glyphs::GlyphCache &glyph_cache);
+
     /**
      * @brief Target window where the ImGui will be drawn.
      */
     sf::RenderWindow &window_;
+
+    /**
+     * @brief Atlas created by ImGui itself, which is owned by the ImGui context and must be restored before shutdown.
+     */
+    ImFontAtlas *default_atlas_ = nullptr;
+
+    /**
+     * @brief Code points requested so far, beyond the Latin-1 range of the default font.
+     */
+    core::glyphs::GlyphSet requested_glyphs_;
+
+    /**
+     * @brief Whether code points were requested since the last rasterization was started.
+     */
+    bool glyphs_need_rebuild_ = false;
+
+    /**
+     * @brief Whether the fallback font and cache paths were already resolved.
+     */
+    bool fallback_font_resolved_ = false;
+
+    /**
+     * @brief System font used for glyphs missing from the default font, or empty if none was found.
+     */
+    std::filesystem::path fallback_font_path_;
+
+    /**
+     * @brief Fingerprint of the fallback font, used as the glyph cache key.
+     */
+    std::uint64_t font_fingerprint_ = 0;
+
+    /**
+     * @brief On-disk glyph cache for the fallback font, or empty if caching is unavailable.
+     */
+    std::filesystem::path glyph_cache_path_;
+
+    /**
+     * @brief Distance from the top of the line to the baseline of the default font, in pixels, read when the fallback font is resolved.
+     */
+    float glyph_baseline_ = 0.0f;
+
+    /**
+     * @brief Glyph bitmaps known so far, or nullptr before the cache was loaded by the first rasterization.
+     */
+    std::shared_ptr<const core::glyphs::GlyphCache> glyph_cache_;
+
+    /**
+     * @brief Atlas currently used by ImGui, or nullptr while ImGui still uses its own default atlas.
+     */
+    std::unique_ptr<AtlasBuild> current_atlas_build_;
+
+    /**
+     * @brief Background rasterization in flight, if any.
+     */
+    std::future<std::shared_ptr<const core::glyphs::GlyphCache>> pending_glyphs_;
 };
 
-}  // namespace core::backend
+}  // namespace core::imgui_sfml_ctx
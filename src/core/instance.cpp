@@ -0,0 +1,582 @@
+/**
+ * @file instance.cpp
+ */
+
+#include <chrono>        // for std::chrono::steady_clock, std::chrono::milliseconds, std::chrono::seconds
+#include <cstddef>       // for std::size_t, std::ptrdiff_t
+#include <cstdint>       // for std::uint8_t
+#include <cstring>       // for std::memcpy
+#include <exception>     // for std::exception
+#include <filesystem>    // for std::filesystem
+#include <format>        // for std::format
+#include <optional>      // for std::optional
+#include <stdexcept>     // for std::runtime_error
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code, std::system_category
+#include <thread>        // for std::this_thread::sleep_for
+#include <utility>       // for std::move
+
+#if defined(__linux__)
+#include <cerrno>          // for errno, EAGAIN, EINTR, ENOENT, ECONNREFUSED, EWOULDBLOCK
+#include <fcntl.h>         // for open, fcntl, O_* flags, F_ADD_SEALS, F_GET_SEALS, F_SEAL_*
+#include <sys/file.h>      // for flock, LOCK_EX, LOCK_NB
+#include <sys/mman.h>      // for memfd_create, MFD_CLOEXEC, MFD_ALLOW_SEALING
+#include <sys/sendfile.h>  // for sendfile
+#include <sys/socket.h>    // for socket, bind, listen, accept4, connect, sendmsg, recvmsg, SCM_RIGHTS
+#include <sys/time.h>      // for timeval
+#include <sys/un.h>        // for sockaddr_un
+#include <unistd.h>        // for close, read, write, geteuid
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "core/instance.hpp"
+#include "core/posix.hpp"
+#include "core/protocol.hpp"
+
+namespace core::instance {
+
+namespace {
+
+#if defined(__linux__)
+
+/**
+ * @brief Name of the lock file held by the primary instance.
+ */
+constexpr std::string_view LOCK_FILE_NAME = "instance.lock";
+
+/**
+ * @brief Name of the socket the primary instance listens on.
+ */
+constexpr std::string_view SOCKET_FILE_NAME = "instance.sock";
+
+/**
+ * @brief How long "hand_over()" retries connecting, in case the primary instance took the lock but has not bound its socket yet.
+ */
+constexpr std::chrono::milliseconds CONNECT_TIMEOUT{500};
+
+/**
+ * @brief Pause between two connection attempts.
+ */
+constexpr std::chrono::milliseconds CONNECT_RETRY_INTERVAL{10};
+
+/**
+ * @brief How long the primary instance waits for a connected launch to send its request before dropping it.
+ */
+constexpr std::chrono::seconds REQUEST_TIMEOUT{5};
+
+/**
+ * @brief How long "hand_over()" waits for the answer, in seconds; the primary instance answers between two frames, after reading the first block of the file.
+ */
+constexpr long ANSWER_TIMEOUT_SECONDS = 10;
+
+/**
+ * @brief Seals that make the memfd immutable, so its size and contents cannot change while the primary instance reads it.
+ */
+constexpr int REQUIRED_SEALS = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE;
+
+/**
+ * @brief Size of the buffer used for copying a file that "sendfile" does not support, and for a single read from a socket.
+ */
+constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+/**
+ * @brief Closes a file descriptor when it goes out of scope.
+ */
+class FileDescriptor final {
+  public:
+    /**
+     * @brief Construct a new FileDescriptor object.
+     *
+     * @param fd Descriptor to own, or -1 for none.
+     */
+    explicit FileDescriptor(const int fd) noexcept
+        : fd_(fd)
+    {
+    }
+
+    /**
+     * @brief Close the descriptor, if any.
+     */
+    ~FileDescriptor()
+    {
+        if (this->fd_ >= 0) {
+            close(this->fd_);
+        }
+    }
+
+    FileDescriptor(const FileDescriptor &) = delete;
+    FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+    /**
+     * @brief Return the descriptor.
+     *
+     * @return Owned descriptor, or -1 for none.
+     */
+    [[nodiscard]] int get() const noexcept
+    {
+        return this->fd_;
+    }
+
+    /**
+     * @brief Give up ownership of the descriptor.
+     *
+     * @return Descriptor that the caller must close.
+     */
+    [[nodiscard]] int release() noexcept
+    {
+        const int fd = this->fd_;
+        this->fd_ = -1;
+        return fd;
+    }
+
+  private:
+    /**
+     * @brief Owned descriptor, or -1 for none.
+     */
+    int fd_;
+};
+
+/**
+ * @brief Build the address of a Unix domain socket.
+ *
+ * @param socket_path Path of the socket (e.g., "/run/user/1000/ungpt/instance.sock").
+ *
+ * @return Socket address.
+ *
+ * @throws std::runtime_error if the path is too long.
+ */
+[[nodiscard]] sockaddr_un make_address(const std::filesystem::path &socket_path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = socket_path.string();
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) [[unlikely]] {
+        throw std::runtime_error(std::format("Socket path '{}' must be between 1 and {} bytes long", path, sizeof(address.sun_path) - 1));
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+/**
+ * @brief Write a whole buffer to a file descriptor.
+ *
+ * @param fd Descriptor to write to.
+ * @param bytes Bytes to write.
+ *
+ * @throws std::runtime_error if writing fails.
+ */
+void write_all(const int fd,
+               const std::string_view bytes)
+{
+    std::size_t offset = 0;
+    while (offset < bytes.size()) {
+        const ssize_t written = write(fd, bytes.data() + offset, bytes.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            posix::throw_errno("write memfd");
+        }
+        offset += static_cast<std::size_t>(written);
+    }
+}
+
+/**
+ * @brief Copy a file into a new memfd, and seal it.
+ *
+ * @param file File to copy (e.g., "notes.txt").
+ *
+ * @return Sealed memfd that the caller must close.
+ *
+ * @throws std::runtime_error if the file cannot be read, or the memfd cannot be created.
+ */
+[[nodiscard]] int copy_into_memfd(const std::filesystem::path &file)
+{
+    const FileDescriptor source{open(file.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (source.get() < 0) [[unlikely]] {
+        posix::throw_errno(std::format("open '{}' for reading", file.string()));
+    }
+    FileDescriptor memfd{memfd_create("ungpt-document", MFD_CLOEXEC | MFD_ALLOW_SEALING)};
+    if (memfd.get() < 0) [[unlikely]] {
+        posix::throw_errno("create memfd");
+    }
+
+    // Let the kernel copy the file from the page cache; pipes and other special files fall back to reading and writing
+    bool is_sendfile_supported = true;
+    while (is_sendfile_supported) {
+        const ssize_t copied = sendfile(memfd.get(), source.get(), nullptr, 1 << 30);
+        if (copied == 0) {
+            break;
+        }
+        if (copied < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EINVAL && errno != ENOSYS) [[unlikely]] {
+                posix::throw_errno(std::format("read '{}'", file.string()));
+            }
+            is_sendfile_supported = false;
+        }
+    }
+    if (!is_sendfile_supported) {
+        char buffer[CHUNK_SIZE];
+        while (true) {
+            const ssize_t received = read(source.get(), buffer, sizeof(buffer));
+            if (received == 0) {
+                break;
+            }
+            if (received < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                posix::throw_errno(std::format("read '{}'", file.string()));
+            }
+            write_all(memfd.get(), {buffer, static_cast<std::size_t>(received)});
+        }
+    }
+
+    if (fcntl(memfd.get(), F_ADD_SEALS, REQUIRED_SEALS | F_SEAL_SEAL) != 0) [[unlikely]] {
+        posix::throw_errno("seal memfd");
+    }
+    return memfd.release();
+}
+
+/**
+ * @brief Connect to the socket of the primary instance, retrying briefly while it is not bound yet.
+ *
+ * @param address Address of the socket.
+ *
+ * @return Connected socket that the caller must close, or -1 if no instance is reachable.
+ *
+ * @throws std::runtime_error if the socket cannot be created.
+ */
+[[nodiscard]] int connect_to_primary(const sockaddr_un &address)
+{
+    const auto deadline = std::chrono::steady_clock::now() + CONNECT_TIMEOUT;
+    while (true) {
+        FileDescriptor fd{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        if (fd.get() < 0) [[unlikely]] {
+            posix::throw_errno("create socket");
+        }
+        if (connect(fd.get(), reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0) [[likely]] {
+            return fd.release();
+        }
+        if ((errno != ENOENT && errno != ECONNREFUSED && errno != EINTR) || std::chrono::steady_clock::now() >= deadline) {
+            SPDLOG_WARN("Failed to reach the running instance at '{}': {}", address.sun_path, std::error_code{errno, std::system_category()}.message());
+            return -1;
+        }
+        std::this_thread::sleep_for(CONNECT_RETRY_INTERVAL);
+    }
+}
+
+/**
+ * @brief Send a request frame, with a file descriptor attached to its first byte.
+ *
+ * @param socket_fd Connected socket.
+ * @param frame Encoded request frame.
+ * @param document_fd Descriptor to pass along (SCM_RIGHTS), or -1 for none.
+ *
+ * @throws std::runtime_error if sending fails.
+ */
+void send_request(const int socket_fd,
+                  const std::string_view frame,
+                  const int document_fd)
+{
+    std::size_t offset = 0;
+    while (offset < frame.size()) {
+        iovec part{.iov_base = const_cast<char *>(frame.data() + offset), .iov_len = frame.size() - offset};
+        msghdr message{};
+        message.msg_iov = &part;
+        message.msg_iovlen = 1;
+
+        // The descriptor travels with the first bytes only
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        if (offset == 0 && document_fd >= 0) {
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            cmsghdr *header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int));
+            std::memcpy(CMSG_DATA(header), &document_fd, sizeof(int));
+        }
+
+        const ssize_t sent = sendmsg(socket_fd, &message, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            posix::throw_errno("send document");
+        }
+        offset += static_cast<std::size_t>(sent);
+    }
+}
+
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+
+Instance::Instance(const std::filesystem::path &directory)
+    : socket_path_(directory / SOCKET_FILE_NAME)
+{
+    const sockaddr_un address = make_address(this->socket_path_);
+
+    // The lock, not the socket file, decides who is primary, so two launches at the same time cannot both listen
+    const std::filesystem::path lock_path = directory / LOCK_FILE_NAME;
+    this->lock_fd_ = open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (this->lock_fd_ < 0) [[unlikely]] {
+        posix::throw_errno(std::format("open '{}'", lock_path.string()));
+    }
+    if (flock(this->lock_fd_, LOCK_EX | LOCK_NB) != 0) {
+        const std::error_code ec{errno, std::system_category()};
+        close(this->lock_fd_);
+        this->lock_fd_ = -1;
+        if (ec.value() == EWOULDBLOCK) {
+            SPDLOG_DEBUG("Another instance holds '{}'", lock_path.string());
+            return;
+        }
+        throw std::runtime_error(std::format("Failed to lock '{}': {}", lock_path.string(), ec.message()));
+    }
+
+    // Holding the lock, any socket file was left behind by a primary instance that was killed
+    std::error_code ec;
+    std::filesystem::remove(this->socket_path_, ec);
+
+    // From here on, the destructor will not run if anything throws, so release the descriptors by hand
+    try {
+        this->listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (this->listen_fd_ < 0) [[unlikely]] {
+            posix::throw_errno("create socket");
+        }
+        if (bind(this->listen_fd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) [[unlikely]] {
+            posix::throw_errno(std::format("bind '{}'", this->socket_path_.string()));
+        }
+        if (listen(this->listen_fd_, SOMAXCONN) != 0) [[unlikely]] {
+            posix::throw_errno("listen");
+        }
+    }
+    catch (...) {
+        if (this->listen_fd_ >= 0) {
+            close(this->listen_fd_);
+        }
+        close(this->lock_fd_);
+        throw;
+    }
+
+    this->is_primary_ = true;
+    SPDLOG_DEBUG("Listening for other instances on '{}'", this->socket_path_.string());
+}
+
+Instance::~Instance()
+{
+    for (const Connection &connection : this->connections_) {
+        close(connection.fd);
+        if (connection.document_fd >= 0) {
+            close(connection.document_fd);
+        }
+    }
+
+    // Remove the socket before releasing the lock, so the removal cannot hit the socket of the next primary instance
+    if (this->listen_fd_ >= 0) {
+        close(this->listen_fd_);
+        std::error_code ec;
+        std::filesystem::remove(this->socket_path_, ec);
+    }
+    if (this->lock_fd_ >= 0) {
+        close(this->lock_fd_);
+    }
+}
+
+void Instance::poll(const open_callback_t &on_open)
+{
+    if (this->listen_fd_ < 0) {
+        return;
+    }
+
+    while (true) {
+        const int fd = accept4(this->listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Nothing pending, or out of descriptors, in which case the launch sees its connection fail and opens its own window
+            break;
+        }
+
+        // Only take documents from the same user, even if the directory lets others reach the socket
+        ucred credentials{};
+        socklen_t size = sizeof(credentials);
+        if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0 || credentials.uid != geteuid()) [[unlikely]] {
+            SPDLOG_WARN("Rejected a connection from another user on '{}'", this->socket_path_.string());
+            close(fd);
+            continue;
+        }
+        this->connections_.push_back({.fd = fd, .accepted_at = std::chrono::steady_clock::now()});
+    }
+
+    for (std::size_t i = 0; i < this->connections_.size();) {
+        Connection &connection = this->connections_[i];
+        if (!this->receive(connection, on_open)) {
+            ++i;
+            continue;
+        }
+        close(connection.fd);
+        if (connection.document_fd >= 0) {
+            close(connection.document_fd);
+        }
+        this->connections_.erase(this->connections_.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+bool Instance::receive(Connection &connection,
+                       const open_callback_t &on_open)
+{
+    std::optional<protocol::Frame> request;
+    try {
+        while (!(request = connection.decoder.next())) {
+            char buffer[CHUNK_SIZE];
+            iovec part{.iov_base = buffer, .iov_len = sizeof(buffer)};
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 4)];
+            msghdr message{};
+            message.msg_iov = &part;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            const ssize_t received = recvmsg(connection.fd, &message, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+
+            // Take every descriptor that arrived, keeping only the first, so none leaks
+            for (cmsghdr *header = CMSG_FIRSTHDR(&message); received >= 0 && header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+                if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) {
+                    continue;
+                }
+                const std::size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                for (std::size_t j = 0; j < count; ++j) {
+                    int fd = -1;
+                    std::memcpy(&fd, CMSG_DATA(header) + j * sizeof(int), sizeof(int));
+                    if (connection.document_fd < 0) {
+                        connection.document_fd = fd;
+                    }
+                    else {
+                        close(fd);
+                    }
+                }
+            }
+
+            if (received < 0) {
+                // Wait for the rest of the request in a later frame, unless the launch is stuck
+                return errno != EAGAIN || std::chrono::steady_clock::now() - connection.accepted_at > REQUEST_TIMEOUT;
+            }
+            if (received == 0) {
+                return true;
+            }
+            connection.decoder.feed({buffer, static_cast<std::size_t>(received)});
+        }
+    }
+    catch (const std::exception &e) {
+        SPDLOG_WARN("Dropped a malformed request from another instance: {}", e.what());
+        return true;
+    }
+
+    std::string answer;
+    try {
+        if (request->kind != static_cast<std::uint8_t>(protocol::Opcode::OpenDocument)) [[unlikely]] {
+            throw std::runtime_error(std::format("Unknown opcode '{}'", request->kind));
+        }
+        std::filesystem::path path;
+        if (connection.document_fd >= 0) {
+            const int seals = fcntl(connection.document_fd, F_GET_SEALS);
+            if (seals < 0 || (seals & REQUIRED_SEALS) != REQUIRED_SEALS) [[unlikely]] {
+                throw std::runtime_error("Document is not a sealed memfd");
+            }
+            path = std::format("/proc/self/fd/{}", connection.document_fd);
+        }
+        on_open(path, request->body);
+        protocol::append_frame(answer, static_cast<std::uint8_t>(protocol::Status::Ok), {});
+        SPDLOG_INFO("Opened '{}' handed over by another instance", request->body);
+    }
+    catch (const std::exception &e) {
+        SPDLOG_ERROR("Failed to open '{}' handed over by another instance: {}", request->body, e.what());
+        answer.clear();
+        protocol::append_frame(answer, static_cast<std::uint8_t>(protocol::Status::Error), e.what());
+    }
+
+    // The answer is a few bytes, which always fit into the socket buffer; a launch that gave up waiting does not read it
+    static_cast<void>(send(connection.fd, answer.data(), answer.size(), MSG_NOSIGNAL | MSG_DONTWAIT));
+    return true;
+}
+
+bool hand_over(const std::filesystem::path &directory,
+               const std::filesystem::path &file)
+{
+    const sockaddr_un address = make_address(directory / SOCKET_FILE_NAME);
+
+    // Copy first, so a file that cannot be read fails before the running instance is involved
+    const FileDescriptor document{file.empty() ? -1 : copy_into_memfd(file)};
+
+    const FileDescriptor connection{connect_to_primary(address)};
+    if (connection.get() < 0) {
+        return false;
+    }
+    std::string request;
+    protocol::append_frame(request, static_cast<std::uint8_t>(protocol::Opcode::OpenDocument), file.filename().string());
+    send_request(connection.get(), request, document.get());
+
+    // Wait until the file is open, so the window shows it by the time this launch exits
+    const timeval timeout{.tv_sec = ANSWER_TIMEOUT_SECONDS, .tv_usec = 0};
+    if (setsockopt(connection.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0) [[unlikely]] {
+        posix::throw_errno("set receive timeout");
+    }
+    protocol::FrameDecoder decoder;
+    std::optional<protocol::Frame> answer;
+    while (!(answer = decoder.next())) {
+        char buffer[CHUNK_SIZE];
+        const ssize_t received = recv(connection.get(), buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            SPDLOG_WARN("The running instance did not answer: {}", received == 0 ? "connection closed" : std::error_code{errno, std::system_category()}.message());
+            return false;
+        }
+        decoder.feed({buffer, static_cast<std::size_t>(received)});
+    }
+    if (answer->kind != static_cast<std::uint8_t>(protocol::Status::Ok)) [[unlikely]] {
+        throw std::runtime_error(std::format("The running instance failed to open '{}': {}", file.string(), answer->body));
+    }
+    return true;
+}
+
+#else
+
+Instance::Instance(const std::filesystem::path &directory)
+    : socket_path_(directory),
+      is_primary_(true)
+{
+}
+
+Instance::~Instance() = default;
+
+void Instance::poll(const open_callback_t &) {}
+
+bool Instance::receive(Connection &,
+                       const open_callback_t &)
+{
+    return true;
+}
+
+bool hand_over(const std::filesystem::path &,
+               const std::filesystem::path &)
+{
+    return false;
+}
+
+#endif
+
+}  // namespace core::instance
@@ -0,0 +1,144 @@
+/**
+ * @file instance.hpp
+ *
+ * @brief Single-instance mode, in which later launches hand their file over to the editor that is already running (Linux only).
+ */
+
+#pragma once
+
+#include <chrono>       // for std::chrono::steady_clock
+#include <filesystem>   // for std::filesystem::path
+#include <functional>   // for std::function
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "core/protocol.hpp"
+
+namespace core::instance {
+
+/**
+ * @brief Claim on being the running editor, which receives the documents of later launches.
+ *
+ * The first instance holds an exclusive lock on "instance.lock" in the runtime directory for as long as it lives, and listens on "instance.sock" next to it. A later launch finds the lock taken and calls "hand_over()" instead of opening a window of its own, so it never creates an OpenGL context or a font atlas.
+ */
+class Instance final {
+  public:
+    using open_callback_t = std::function<void(const std::filesystem::path &, std::string_view)>;
+
+    /**
+     * @brief Construct a new Instance object and try to become the primary instance.
+     *
+     * A stale socket file left behind by a primary instance that was killed is replaced. On platforms other than Linux, every instance is primary and receives nothing.
+     *
+     * @param directory Directory of the lock and the socket (e.g., "/run/user/1000/ungpt").
+     *
+     * @throws std::runtime_error if the lock file or the socket cannot be created.
+     */
+    explicit Instance(const std::filesystem::path &directory);
+
+    /**
+     * @brief Stop listening, remove the socket file if this is the primary instance, and release the lock.
+     */
+    ~Instance();
+
+    Instance(const Instance &) = delete;
+    Instance &operator=(const Instance &) = delete;
+
+    /**
+     * @brief Return whether this is the primary instance.
+     *
+     * @return True if this instance holds the lock and receives documents, false if another instance does.
+     */
+    [[nodiscard]] bool is_primary() const
+    {
+        return this->is_primary_;
+    }
+
+    /**
+     * @brief Receive the documents handed over since the last call, without blocking; meant to be called once per frame.
+     *
+     * Every document is acknowledged once "on_open" returns, or answered with the error it threw, so the launch that sent it can exit.
+     *
+     * @param on_open Callback invoked with a readable path to the text (e.g., "/proc/self/fd/12"), valid only during the call, and the title of the tab (e.g., "notes.txt"); the path is empty if the launch had no file and only asks to raise the window.
+     */
+    void poll(const open_callback_t &on_open);
+
+  private:
+    /**
+     * @brief Launch that connected and has not finished sending its document yet.
+     */
+    struct Connection {
+        /**
+         * @brief Socket of the connection.
+         */
+        int fd = -1;
+
+        /**
+         * @brief Memfd received alongside the request, or -1 if none arrived yet.
+         */
+        int document_fd = -1;
+
+        /**
+         * @brief Splits received bytes into the request frame.
+         */
+        protocol::FrameDecoder decoder{};
+
+        /**
+         * @brief When the connection was accepted, so a launch that never finishes sending is dropped.
+         */
+        std::chrono::steady_clock::time_point accepted_at{};
+    };
+
+    /**
+     * @brief Read what a connection sent so far, and open its document once the request is complete.
+     *
+     * @param connection Connection to read from.
+     * @param on_open Callback of "poll()".
+     *
+     * @return True if the connection is done (answered, failed, or timed out) and must be closed, false if more bytes are expected.
+     */
+    [[nodiscard]] bool receive(Connection &connection,
+                               const open_callback_t &on_open);
+
+    /**
+     * @brief Path of the Unix domain socket.
+     */
+    std::filesystem::path socket_path_;
+
+    /**
+     * @brief Whether this instance holds the lock (always true on platforms other than Linux).
+     */
+    bool is_primary_ = false;
+
+    /**
+     * @brief Lock file held for as long as this instance lives, or -1 if this is not the primary instance.
+     */
+    int lock_fd_ = -1;
+
+    /**
+     * @brief Listening socket, or -1 if this is not the primary instance.
+     */
+    int listen_fd_ = -1;
+
+    /**
+     * @brief Connections accepted by "poll()" that have not finished sending their document yet.
+     */
+    std::vector<Connection> connections_;
+};
+
+/**
+ * @brief Hand a file over to the primary instance, and wait until it has opened it.
+ *
+ * The file is copied into a sealed memfd by the kernel, and the memfd is passed over the socket (SCM_RIGHTS), so the text itself never goes through the socket, and the running editor reads it with the same encoding detection and progressive loading as any other file.
+ *
+ * @param directory Directory of the lock and the socket, the same as for "Instance" (e.g., "/run/user/1000/ungpt").
+ * @param file File to open (e.g., "notes.txt"), or an empty path to only raise the window of the primary instance.
+ *
+ * @return True if the primary instance opened the file, false if none is reachable (e.g., it exited meanwhile) or the platform is not Linux.
+ *
+ * @throws std::runtime_error if the file cannot be read, or the primary instance failed to open it.
+ */
+[[nodiscard]] bool hand_over(const std::filesystem::path &directory,
+                             const std::filesystem::path &file);
+
+}  // namespace core::instance
@@ -0,0 +1,208 @@
+/**
+ * @file loader.cpp
+ */
+
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uintmax_t
+#include <exception>     // for std::exception
+#include <filesystem>    // for std::filesystem::path, std::filesystem::file_size
+#include <format>        // for std::format
+#include <ios>           // for std::ios, std::streamsize
+#include <mutex>         // for std::lock_guard, std::unique_lock
+#include <stdexcept>     // for std::runtime_error
+#include <stop_token>    // for std::stop_token
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code
+#include <thread>        // for std::jthread
+#include <utility>       // for std::swap
+#include <vector>        // for std::vector
+
+#include "core/encoding.hpp"
+#include "core/loader.hpp"
+#include "core/memory.hpp"
+#include "core/utf8.hpp"
+
+namespace core::loader {
+
+namespace {
+
+/**
+ * @brief Return the size of the longest prefix of some UTF-8 text that does not end inside a character.
+ *
+ * @param text Text that may end with an incomplete sequence (e.g., "caf\xC3").
+ *
+ * @return Size of the prefix (e.g., "3"); the whole size if the last sequence is complete or can never be completed.
+ */
+[[nodiscard]] std::size_t complete_prefix_size(const std::string_view text)
+{
+    // Walk back over up to three continuation bytes to the byte that starts the last sequence
+    std::size_t start = text.size();
+    while (start > 0 && text.size() - start < 3 && (static_cast<unsigned char>(text[start - 1]) & 0xC0) == 0x80) {
+        --start;
+    }
+    if (start == 0) {
+        return text.size();
+    }
+    const auto lead = static_cast<unsigned char>(text[start - 1]);
+    if (lead < 0xC0) {
+        return text.size();
+    }
+    const std::size_t expected = lead >= 0xF0 ? 4 : (lead >= 0xE0 ? 3 : 2);
+    return text.size() - (start - 1) < expected ? start - 1 : text.size();
+}
+
+}  // namespace
+
+Loader::Loader(const std::filesystem::path &path,
+               const bool repair_invalid_utf8,
+               const bool segment_words)
+    : stream_(path, std::ios::binary),
+      path_(path),
+      repair_invalid_utf8_(repair_invalid_utf8),
+      decoder_(encoding::Encoding::Utf8),
+      counter_(segment_words)
+{
+    if (!this->stream_) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to open '{}' for reading", path.string()));
+    }
+
+    std::error_code error;
+    const std::uintmax_t file_size = std::filesystem::file_size(path, error);
+    this->file_size_ = error ? 0 : static_cast<std::size_t>(file_size);
+    this->pending_progress_.file_size = this->file_size_;
+
+    // Detect the encoding from the first block, like "encoding::load_file()", and hand it over right away
+    std::string block(encoding::BLOCK_SIZE, '\0');
+    this->stream_.read(block.data(), static_cast<std::streamsize>(block.size()));
+    if (this->stream_.bad()) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to read '{}'", path.string()));
+    }
+    const std::string_view first_block{block.data(), static_cast<std::size_t>(this->stream_.gcount())};
+    const encoding::Detection detection = encoding::detect(first_block, first_block.size() < block.size());
+    this->encoding_ = detection.encoding;
+    this->decoder_ = encoding::Decoder{detection.encoding};
+
+    std::string part;
+    this->decoder_.decode(first_block.substr(detection.bom_size), part);
+    if (first_block.size() < block.size()) {
+        this->decoder_.finish(part);
+        this->publish(part, first_block.size(), true);
+        return;
+    }
+    this->carry_.assign(part, complete_prefix_size(part));
+    part.resize(part.size() - this->carry_.size());
+    this->publish(part, first_block.size(), false);
+
+    // The rest of the file is read in the background
+    this->thread_ = std::jthread{[this](const std::stop_token &stop_token) {
+        this->run(stop_token);
+    }};
+}
+
+Loader::~Loader()
+{
+    // Reading a block is short, so the thread notices the stop request quickly; "thread_" joins it when destroyed
+    this->thread_.request_stop();
+}
+
+bool Loader::take(std::string &text,
+                  std::vector<std::size_t> &utf8_offsets,
+                  Progress &progress)
+{
+    // Checked without locking, so an idle frame costs a single atomic load
+    if (!this->has_pending_.load(std::memory_order_acquire)) [[likely]] {
+        return false;
+    }
+    const std::lock_guard lock{this->mutex_};
+
+    // Hand the whole buffer over when the caller has nothing to append to, which saves copying the text
+    if (text.empty()) {
+        std::swap(text, this->pending_text_);
+    }
+    else {
+        text += this->pending_text_;
+    }
+    this->pending_text_.clear();
+    utf8_offsets.insert(utf8_offsets.end(), this->pending_offsets_.cbegin(), this->pending_offsets_.cend());
+    this->pending_offsets_.clear();
+    progress = this->pending_progress_;
+    this->has_pending_.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void Loader::wait()
+{
+    std::unique_lock lock{this->mutex_};
+    this->pending_changed_.wait(lock, [this] { return this->has_pending_.load(std::memory_order_relaxed); });
+}
+
+void Loader::run(const std::stop_token &stop_token)
+{
+    // The parts end up in the editor, so charge them to its buffer rather than to this thread
+    const memory::Scope memory_scope{memory::Tag::EditorBuffer};
+    std::string block(encoding::BLOCK_SIZE, '\0');
+    std::string part;
+    std::size_t bytes_read = block.size();
+    try {
+        while (!stop_token.stop_requested()) {
+            this->stream_.read(block.data(), static_cast<std::streamsize>(block.size()));
+            if (this->stream_.bad()) [[unlikely]] {
+                throw std::runtime_error(std::format("Failed to read '{}'", this->path_.string()));
+            }
+            const auto size = static_cast<std::size_t>(this->stream_.gcount());
+            bytes_read += size;
+
+            // Continue the character cut off at the end of the previous block
+            std::swap(part, this->carry_);
+            this->carry_.clear();
+            this->decoder_.decode(std::string_view{block.data(), size}, part);
+            if (size < block.size()) {
+                this->decoder_.finish(part);
+                this->publish(part, bytes_read, true);
+                return;
+            }
+            this->carry_.assign(part, complete_prefix_size(part));
+            part.resize(part.size() - this->carry_.size());
+            this->publish(part, bytes_read, false);
+        }
+    }
+    catch (const std::exception &e) {
+        const std::lock_guard lock{this->mutex_};
+        this->pending_progress_.error = e.what();
+        this->pending_progress_.is_done = true;
+        this->has_pending_.store(true, std::memory_order_release);
+        this->pending_changed_.notify_all();
+    }
+}
+
+void Loader::publish(std::string &part,
+                     const std::size_t bytes_read,
+                     const bool is_done)
+{
+    // Validate and count the part here, off the UI thread; offsets are made relative to the whole text
+    std::vector<std::size_t> offsets;
+    if (this->repair_invalid_utf8_) {
+        utf8::repair(part, &offsets);
+    }
+    else {
+        offsets = utf8::find_invalid_sequences(part);
+    }
+    for (std::size_t &offset : offsets) {
+        offset += this->transcoded_size_;
+    }
+    this->counter_.add(part);
+    this->transcoded_size_ += part.size();
+
+    const std::lock_guard lock{this->mutex_};
+    this->pending_text_ += part;
+    this->pending_offsets_.insert(this->pending_offsets_.end(), offsets.cbegin(), offsets.cend());
+    this->pending_progress_.bytes_read = bytes_read;
+    this->pending_progress_.stats = this->counter_.stats();
+    this->pending_progress_.is_done = is_done;
+    this->has_pending_.store(true, std::memory_order_release);
+    this->pending_changed_.notify_all();
+    part.clear();
+}
+
+}  // namespace core::loader
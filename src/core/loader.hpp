@@ -0,0 +1,215 @@
+/**
+ * @file loader.hpp
+ *
+ * @brief Progressive loading of text files on a background thread.
+ */
+
+#pragma once
+
+#include <atomic>              // for std::atomic
+#include <condition_variable>  // for std::condition_variable
+#include <cstddef>             // for std::size_t
+#include <filesystem>          // for std::filesystem::path
+#include <fstream>             // for std::ifstream
+#include <mutex>               // for std::mutex
+#include <stop_token>          // for std::stop_token
+#include <string>              // for std::string
+#include <thread>              // for std::jthread
+#include <vector>              // for std::vector
+
+#include "core/encoding.hpp"
+#include "core/text.hpp"
+
+namespace core::loader {
+
+/**
+ * @brief Progress of a load, consistent with the text taken so far.
+ */
+struct Progress {
+    /**
+     * @brief Number of bytes of the file read so far.
+     */
+    std::size_t bytes_read = 0;
+
+    /**
+     * @brief Size of the file in bytes, or 0 if it could not be determined.
+     */
+    std::size_t file_size = 0;
+
+    /**
+     * @brief Statistics of the text taken so far.
+     */
+    text::TextStats stats;
+
+    /**
+     * @brief Whether the whole file was read and taken.
+     */
+    bool is_done = false;
+
+    /**
+     * @brief Error that stopped the load early, or an empty string if there was none.
+     */
+    std::string error;
+};
+
+/**
+ * @brief Loads a text file into UTF-8 on a background thread, handing the text over in parts as it is read.
+ *
+ * The encoding is detected from the first block, which is read and transcoded by the constructor, so the beginning of the file is available right away. The rest is read, transcoded, validated (or repaired), and counted on the background thread, one "encoding::BLOCK_SIZE" block at a time; every part ends at a character boundary. The UI thread picks the new parts up with "take()" once per frame, or blocks in "wait()" when it needs the whole file at once.
+ */
+class Loader final {
+  public:
+    /**
+     * @brief Construct a new Loader object, read the first block, and start reading the rest.
+     *
+     * @param path Path to the file (e.g., "notes.txt").
+     * @param repair_invalid_utf8 Whether to replace invalid sequences with U+FFFD, like "utf8::repair()".
+     * @param segment_words Whether the statistics split runs of scripts written without spaces into words, like "text::compute_stats()".
+     *
+     * @throws std::runtime_error if the file cannot be opened or its first block cannot be read.
+     */
+    explicit Loader(const std::filesystem::path &path,
+                    const bool repair_invalid_utf8 = false,
+                    const bool segment_words = false);
+
+    /**
+     * @brief Stop reading and join the background thread.
+     */
+    ~Loader();
+
+    Loader(const Loader &) = delete;
+    Loader &operator=(const Loader &) = delete;
+
+    /**
+     * @brief Return the encoding the file was detected to be in.
+     *
+     * @return Detected encoding (e.g., "Encoding::Utf16Le").
+     */
+    [[nodiscard]] encoding::Encoding encoding() const
+    {
+        return this->encoding_;
+    }
+
+    /**
+     * @brief Take the text transcoded since the last call.
+     *
+     * Does not lock when there is nothing new, so it can be called every frame.
+     *
+     * @param text String the new text is appended to.
+     * @param utf8_offsets Vector the byte offsets of the new invalid sequences are appended to, or of the inserted U+FFFD characters when repairing; offsets count from the start of the loaded text.
+     * @param progress Progress that is updated to match the text taken so far.
+     *
+     * @return True if anything was taken or the load finished, false if nothing changed.
+     */
+    [[nodiscard]] bool take(std::string &text,
+                            std::vector<std::size_t> &utf8_offsets,
+                            Progress &progress);
+
+    /**
+     * @brief Block until there is something to take.
+     *
+     * Returns right away if a part or the end of the load is already waiting, so "wait()" followed by "take()" drains the loader without spinning.
+     */
+    void wait();
+
+  private:
+    /**
+     * @brief Read and hand over the rest of the file until it ends or the loader is destroyed; runs on the background thread.
+     *
+     * @param stop_token Token that asks the thread to stop.
+     */
+    void run(const std::stop_token &stop_token);
+
+    /**
+     * @brief Validate (or repair) and count a transcoded part, then hand it to the UI thread.
+     *
+     * @param part Text that ends at a character boundary, or at the end of the file.
+     * @param bytes_read Total number of bytes of the file read so far.
+     * @param is_done Whether this is the last part.
+     */
+    void publish(std::string &part,
+                 const std::size_t bytes_read,
+                 const bool is_done);
+
+    /**
+     * @brief File being read, only used by the background thread after construction.
+     */
+    std::ifstream stream_;
+
+    /**
+     * @brief Path to the file, for error messages.
+     */
+    std::filesystem::path path_;
+
+    /**
+     * @brief Whether invalid sequences are repaired instead of reported.
+     */
+    bool repair_invalid_utf8_;
+
+    /**
+     * @brief Detected encoding of the file.
+     */
+    encoding::Encoding encoding_ = encoding::Encoding::Utf8;
+
+    /**
+     * @brief Transcoder into UTF-8, only used by the background thread after construction.
+     */
+    encoding::Decoder decoder_;
+
+    /**
+     * @brief Bytes of an incomplete character at the end of the last block, prepended to the next part.
+     */
+    std::string carry_;
+
+    /**
+     * @brief Statistics of the text transcoded so far, only used by the background thread after construction.
+     */
+    text::StatsCounter counter_;
+
+    /**
+     * @brief Number of UTF-8 bytes transcoded so far, to turn offsets within a part into offsets within the text.
+     */
+    std::size_t transcoded_size_ = 0;
+
+    /**
+     * @brief Size of the file in bytes, or 0 if it could not be determined.
+     */
+    std::size_t file_size_ = 0;
+
+    /**
+     * @brief Guards "pending_text_", "pending_offsets_", and "pending_progress_", and the waits on "pending_changed_".
+     */
+    std::mutex mutex_;
+
+    /**
+     * @brief Text waiting to be taken by the UI thread.
+     */
+    std::string pending_text_;
+
+    /**
+     * @brief Offsets of invalid or repaired sequences waiting to be taken by the UI thread.
+     */
+    std::vector<std::size_t> pending_offsets_;
+
+    /**
+     * @brief Progress matching the text transcoded so far.
+     */
+    Progress pending_progress_;
+
+    /**
+     * @brief Whether anything is waiting to be taken.
+     */
+    std::atomic<bool> has_pending_{false};
+
+    /**
+     * @brief Signaled, under "mutex_", whenever "has_pending_" becomes true.
+     */
+    std::condition_variable pending_changed_;
+
+    /**
+     * @brief Background thread, declared last so it starts after, and is joined before, everything above is destroyed.
+     */
+    std::jthread thread_;
+};
+
+}  // namespace core::loader
@@ -0,0 +1,306 @@
+/**
+ * @file markdown.cpp
+ */
+
+#include <algorithm>    // for std::max
+#include <cstddef>      // for std::size_t
+#include <optional>     // for std::optional, std::nullopt
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "core/markdown.hpp"
+
+namespace core::markdown {
+
+namespace {
+
+/**
+ * @brief Opening line of a fenced code block.
+ */
+struct Fence {
+    /**
+     * @brief Fence character, "`" or "~".
+     */
+    char character = '`';
+
+    /**
+     * @brief Number of fence characters, at least three; the closing fence must have at least as many.
+     */
+    std::size_t length = 0;
+};
+
+/**
+ * @brief Run of backticks inside a paragraph, a candidate delimiter of an inline code span.
+ */
+struct BacktickRun {
+    /**
+     * @brief Byte offset of the first backtick in the text.
+     */
+    std::size_t position = 0;
+
+    /**
+     * @brief Number of backticks.
+     */
+    std::size_t length = 0;
+
+    /**
+     * @brief Index of the next run of the same length in the paragraph, or std::string_view::npos if there is none.
+     */
+    std::size_t next_same_length = std::string_view::npos;
+
+    /**
+     * @brief Whether the run is preceded by a backslash, so it cannot open a code span.
+     */
+    bool is_escaped = false;
+};
+
+/**
+ * @brief Parse a line as the opening fence of a code block.
+ *
+ * @param line Line without its line break (e.g., "```cpp").
+ *
+ * @return Fence, or std::nullopt if the line does not open a code block.
+ */
+[[nodiscard]] std::optional<Fence> parse_opening_fence(const std::string_view line)
+{
+    const std::size_t indent = line.find_first_not_of(' ');
+    if (indent == std::string_view::npos || indent > 3 || (line[indent] != '`' && line[indent] != '~')) [[likely]] {
+        return std::nullopt;
+    }
+    const char character = line[indent];
+    const std::size_t fence_end = line.find_first_not_of(character, indent);
+    const std::size_t length = (fence_end == std::string_view::npos ? line.size() : fence_end) - indent;
+    if (length < 3) {
+        return std::nullopt;
+    }
+
+    // The info string of a backtick fence cannot contain backticks, otherwise the line is inline code
+    if (character == '`' && fence_end != std::string_view::npos && line.find('`', fence_end) != std::string_view::npos) {
+        return std::nullopt;
+    }
+    return Fence{.character = character, .length = length};
+}
+
+/**
+ * @brief Check whether a line closes a fenced code block.
+ *
+ * @param line Line without its line break (e.g., "```").
+ * @param fence Opening fence of the block.
+ *
+ * @return True if the line is a closing fence, false otherwise.
+ */
+[[nodiscard]] bool is_closing_fence(const std::string_view line,
+                                    const Fence &fence)
+{
+    const std::size_t indent = line.find_first_not_of(' ');
+    if (indent == std::string_view::npos || indent > 3 || line[indent] != fence.character) {
+        return false;
+    }
+    const std::size_t fence_end = line.find_first_not_of(fence.character, indent);
+    if (fence_end == std::string_view::npos) {
+        return line.size() - indent >= fence.length;
+    }
+    return fence_end - indent >= fence.length && line.find_first_not_of(" \t\r", fence_end) == std::string_view::npos;
+}
+
+/**
+ * @brief Check whether a byte may appear in a URL scheme (e.g., "https" or "svn+ssh").
+ *
+ * @param character Byte to check.
+ *
+ * @return True if the byte is an ASCII letter, digit, "+", "-", or ".".
+ */
+[[nodiscard]] bool is_scheme_character(const char character)
+{
+    return (character >= 'a' && character <= 'z') ||
+           (character >= 'A' && character <= 'Z') ||
+           (character >= '0' && character <= '9') ||
+           character == '+' || character == '-' || character == '.';
+}
+
+/**
+ * @brief Find the URLs in part of a paragraph that holds no code, and append their ranges.
+ *
+ * @param text Full text.
+ * @param begin Byte offset where the part begins.
+ * @param end Byte offset where the part ends.
+ * @param ranges Vector to append to.
+ */
+void find_urls(const std::string_view text,
+               const std::size_t begin,
+               const std::size_t end,
+               std::vector<Range> &ranges)
+{
+    const std::string_view part = text.substr(0, end);
+    std::size_t position = begin;
+    while (true) {
+        const std::size_t separator = part.find("://", position);
+        if (separator == std::string_view::npos) [[likely]] {
+            return;
+        }
+
+        // Walk back over the scheme, which must start with a letter
+        std::size_t url_begin = separator;
+        while (url_begin > position && is_scheme_character(part[url_begin - 1])) {
+            --url_begin;
+        }
+        while (url_begin < separator && !((part[url_begin] >= 'a' && part[url_begin] <= 'z') || (part[url_begin] >= 'A' && part[url_begin] <= 'Z'))) {
+            ++url_begin;
+        }
+
+        // The URL runs until whitespace or a delimiter, without the punctuation that ends the surrounding sentence
+        std::size_t url_end = part.find_first_of(" \t\r\n<>`", separator + 3);
+        if (url_end == std::string_view::npos) {
+            url_end = part.size();
+        }
+        while (url_end > separator + 3) {
+            const char last = part[url_end - 1];
+            if (last == '.' || last == ',' || last == ':' || last == ';' || last == '!' || last == '?' || last == '\'' || last == '"' || last == '*' || last == '_' || last == '~') {
+                --url_end;
+            }
+            else if (last == ')') {
+                // Keep a closing parenthesis that belongs to the URL (e.g., a Wikipedia link), drop the one of a Markdown link
+                const std::string_view url = part.substr(separator, url_end - separator);
+                std::size_t opening = 0;
+                std::size_t closing = 0;
+                for (const char character : url) {
+                    opening += character == '(' ? 1 : 0;
+                    closing += character == ')' ? 1 : 0;
+                }
+                if (closing <= opening) {
+                    break;
+                }
+                --url_end;
+            }
+            else {
+                break;
+            }
+        }
+
+        if (url_begin < separator && url_end > separator + 3) {
+            ranges.push_back({.begin = url_begin, .end = url_end});
+        }
+        position = std::max(url_end, separator + 3);
+    }
+}
+
+/**
+ * @brief Find the inline code spans and URLs of a paragraph, and append their ranges.
+ *
+ * @param text Full text.
+ * @param begin Byte offset where the paragraph begins.
+ * @param end Byte offset where the paragraph ends.
+ * @param ranges Vector to append to.
+ */
+void find_inline_ranges(const std::string_view text,
+                        const std::size_t begin,
+                        const std::size_t end,
+                        std::vector<Range> &ranges)
+{
+    // Scratch space reused across paragraphs and calls, so scanning does not allocate once it has warmed up
+    thread_local std::vector<BacktickRun> runs;
+    thread_local std::vector<std::size_t> last_run_by_length;
+
+    // Collect every backtick run of the paragraph
+    runs.clear();
+    std::size_t longest = 0;
+    const std::string_view paragraph = text.substr(0, end);
+    for (std::size_t position = paragraph.find('`', begin); position != std::string_view::npos;) {
+        std::size_t run_end = paragraph.find_first_not_of('`', position);
+        if (run_end == std::string_view::npos) {
+            run_end = end;
+        }
+        runs.push_back({.position = position, .length = run_end - position, .is_escaped = position > begin && text[position - 1] == '\\'});
+        longest = std::max(longest, run_end - position);
+        position = paragraph.find('`', run_end);
+    }
+
+    // Link every run to the next one of the same length, back to front, so pairing them takes a single pass
+    last_run_by_length.assign(longest + 1, std::string_view::npos);
+    for (std::size_t index = runs.size(); index-- > 0;) {
+        runs[index].next_same_length = last_run_by_length[runs[index].length];
+        last_run_by_length[runs[index].length] = index;
+    }
+
+    // Pair runs into code spans, searching the text between them for URLs
+    std::size_t searched_until = begin;
+    for (std::size_t index = 0; index < runs.size(); ++index) {
+        const BacktickRun &opening = runs[index];
+        if (opening.is_escaped || opening.next_same_length == std::string_view::npos) {
+            continue;
+        }
+        const BacktickRun &closing = runs[opening.next_same_length];
+        find_urls(text, searched_until, opening.position, ranges);
+        ranges.push_back({.begin = opening.position, .end = closing.position + closing.length});
+        searched_until = closing.position + closing.length;
+        index = opening.next_same_length;
+    }
+    find_urls(text, searched_until, end, ranges);
+}
+
+}  // namespace
+
+void find_verbatim_ranges(const std::string_view text,
+                          std::vector<Range> &ranges)
+{
+    ranges.clear();
+
+    // Walk the text line by line, gathering paragraphs until a blank line or a fence ends them
+    std::size_t paragraph_begin = std::string_view::npos;
+    const auto flush_paragraph = [&](const std::size_t paragraph_end) {
+        if (paragraph_begin != std::string_view::npos) {
+            find_inline_ranges(text, paragraph_begin, paragraph_end, ranges);
+            paragraph_begin = std::string_view::npos;
+        }
+    };
+
+    std::size_t line_begin = 0;
+    while (line_begin < text.size()) {
+        std::size_t line_end = text.find('\n', line_begin);
+        if (line_end == std::string_view::npos) {
+            line_end = text.size();
+        }
+        const std::size_t next_line = line_end == text.size() ? line_end : line_end + 1;
+        const std::string_view line = text.substr(line_begin, line_end - line_begin);
+
+        // Keep the whole block verbatim, fences included; an unclosed block runs to the end of the text
+        if (const std::optional<Fence> fence = parse_opening_fence(line)) [[unlikely]] {
+            flush_paragraph(line_begin);
+            std::size_t block_end = text.size();
+            std::size_t after_block = text.size();
+            for (std::size_t inner_begin = next_line; inner_begin < text.size();) {
+                std::size_t inner_end = text.find('\n', inner_begin);
+                if (inner_end == std::string_view::npos) {
+                    inner_end = text.size();
+                }
+                if (is_closing_fence(text.substr(inner_begin, inner_end - inner_begin), *fence)) {
+                    block_end = inner_end;
+                    after_block = inner_end == text.size() ? inner_end : inner_end + 1;
+                    break;
+                }
+                inner_begin = inner_end == text.size() ? inner_end : inner_end + 1;
+            }
+            ranges.push_back({.begin = line_begin, .end = block_end});
+            line_begin = after_block;
+            continue;
+        }
+
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+            flush_paragraph(line_begin);
+        }
+        else if (paragraph_begin == std::string_view::npos) {
+            paragraph_begin = line_begin;
+        }
+        line_begin = next_line;
+    }
+    flush_paragraph(text.size());
+}
+
+std::vector<Range> find_verbatim_ranges(const std::string_view text)
+{
+    std::vector<Range> ranges;
+    find_verbatim_ranges(text, ranges);
+    return ranges;
+}
+
+}  // namespace core::markdown
@@ -0,0 +1,50 @@
+/**
+ * @file markdown.hpp
+ *
+ * @brief Detection of the parts of a Markdown text that must be kept verbatim, i.e., code and URLs.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+namespace core::markdown {
+
+/**
+ * @brief Byte range of the text, from "begin" up to but excluding "end".
+ */
+struct Range {
+    /**
+     * @brief Byte offset of the first byte of the range.
+     */
+    std::size_t begin = 0;
+
+    /**
+     * @brief Byte offset one past the last byte of the range.
+     */
+    std::size_t end = 0;
+};
+
+/**
+ * @brief Find the fenced code blocks, inline code spans, and URLs of a Markdown text, which normalization must not change.
+ *
+ * The text is scanned once, line by line: a line that opens a fence ("```" or "~~~", indented by up to three spaces) starts a block that runs until the matching closing fence, or to the end of the text if there is none. Between fences, every paragraph is searched for backtick runs, and a run is paired with the next run of the same length in the paragraph, following CommonMark; backticks without a partner are ordinary text. Outside of code, "scheme://" URLs (also inside "<...>" autolinks) run until whitespace, "<", ">", or a backtick, without trailing punctuation.
+ *
+ * @param text Text to scan (e.g., "Use `a — b` here.").
+ * @param ranges Vector that receives the ranges, sorted and non-overlapping (e.g., {{.begin = 4, .end = 13}}); its previous contents are replaced, its capacity is reused.
+ */
+void find_verbatim_ranges(const std::string_view text,
+                          std::vector<Range> &ranges);
+
+/**
+ * @brief Find the fenced code blocks, inline code spans, and URLs of a Markdown text, which normalization must not change.
+ *
+ * @param text Text to scan (e.g., "Use `a — b` here.").
+ *
+ * @return Ranges, sorted and non-overlapping (e.g., {{.begin = 4, .end = 13}}).
+ */
+[[nodiscard]] std::vector<Range> find_verbatim_ranges(const std::string_view text);
+
+}  // namespace core::markdown
@@ -0,0 +1,224 @@
+/**
+ * @file memory.cpp
+ */
+
+#include <array>        // for std::array
+#include <atomic>       // for std::atomic, std::memory_order_relaxed
+#include <chrono>       // for std::chrono::steady_clock, std::chrono::duration
+#include <cstddef>      // for std::size_t, std::byte, std::max_align_t
+#include <cstdint>      // for std::uint32_t, std::uintptr_t, SIZE_MAX
+#include <cstdlib>      // for std::malloc, std::free
+#include <cstring>      // for std::memcpy
+#include <format>       // for std::format_to
+#include <iterator>     // for std::back_inserter
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "core/memory.hpp"
+
+namespace core::memory {
+
+namespace {
+
+/**
+ * @brief Approximation of the process start time, captured during static initialization (before "main()").
+ */
+const std::chrono::steady_clock::time_point process_start = std::chrono::steady_clock::now();
+
+/**
+ * @brief Counters of a single tag, on their own cache line so threads charging different tags do not contend.
+ */
+struct alignas(64) Counters {
+    std::atomic<std::size_t> bytes{0};
+    std::atomic<std::size_t> peak_bytes{0};
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> allocated_bytes{0};
+};
+
+/**
+ * @brief Counters of every tag, constant-initialized so allocations made during static initialization are accounted too.
+ */
+constinit std::array<Counters, TAG_COUNT> counters{};
+
+/**
+ * @brief Whether the global "operator new" is routed through "allocate()".
+ */
+constinit std::atomic<bool> global_accounting{false};
+
+/**
+ * @brief Tag of the innermost "Scope" on the current thread.
+ */
+constinit thread_local Tag current_thread_tag = Tag::Other;
+
+/**
+ * @brief Bookkeeping stored right in front of every allocation.
+ */
+struct Header {
+    std::size_t size;
+    std::uint32_t offset;
+    Tag tag;
+};
+
+/**
+ * @brief Space reserved in front of every allocation for its header, rounded up so the returned memory keeps the alignment of "std::malloc()".
+ */
+constexpr std::size_t HEADER_SPACE = (sizeof(Header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+}  // namespace
+
+std::string_view to_string(const Tag tag)
+{
+    switch (tag) {
+    case Tag::Other:
+        return "Other";
+    case Tag::EditorBuffer:
+        return "Editor buffer";
+    case Tag::TextEngine:
+        return "Text engine";
+    case Tag::Clipboard:
+        return "Clipboard";
+    case Tag::FontAtlas:
+        return "Font atlas";
+    case Tag::ImGui:
+        return "ImGui";
+    }
+    return "Unknown";
+}
+
+std::size_t Snapshot::total_bytes() const
+{
+    std::size_t total = 0;
+    for (const Usage &usage : this->usages) {
+        total += usage.bytes;
+    }
+    return total;
+}
+
+Snapshot take_snapshot()
+{
+    Snapshot snapshot;
+    for (std::size_t i = 0; i < TAG_COUNT; ++i) {
+        snapshot.usages[i] = {
+            .bytes = counters[i].bytes.load(std::memory_order_relaxed),
+            .peak_bytes = counters[i].peak_bytes.load(std::memory_order_relaxed),
+            .allocations = counters[i].allocations.load(std::memory_order_relaxed),
+            .allocated_bytes = counters[i].allocated_bytes.load(std::memory_order_relaxed),
+        };
+    }
+    snapshot.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - process_start).count();
+    return snapshot;
+}
+
+std::array<Rate, TAG_COUNT> compute_rates(const Snapshot &previous,
+                                          const Snapshot &current)
+{
+    std::array<Rate, TAG_COUNT> rates{};
+    const double seconds = current.seconds - previous.seconds;
+    if (seconds <= 0.0) [[unlikely]] {
+        return rates;
+    }
+    for (std::size_t i = 0; i < TAG_COUNT; ++i) {
+        rates[i] = {
+            .allocations_per_second = static_cast<double>(current.usages[i].allocations - previous.usages[i].allocations) / seconds,
+            .bytes_per_second = static_cast<double>(current.usages[i].allocated_bytes - previous.usages[i].allocated_bytes) / seconds,
+        };
+    }
+    return rates;
+}
+
+std::string to_json(const Snapshot &snapshot)
+{
+    // Average the rates over the whole run; the tag names need no escaping
+    const std::array<Rate, TAG_COUNT> rates = compute_rates(Snapshot{}, snapshot);
+    std::string json;
+    auto out = std::back_inserter(json);
+    std::format_to(out,
+                   "{{\n  \"uptime_seconds\": {:.3f},\n  \"global_accounting\": {},\n  \"total_bytes\": {},\n  \"tags\": [\n",
+                   snapshot.seconds,
+                   is_global_accounting_enabled(),
+                   snapshot.total_bytes());
+    for (std::size_t i = 0; i < TAG_COUNT; ++i) {
+        const Usage &usage = snapshot.usages[i];
+        std::format_to(out,
+                       "    {{\"name\": \"{}\", \"bytes\": {}, \"peak_bytes\": {}, \"allocations\": {}, \"allocated_bytes\": {}, \"allocations_per_second\": {:.1f}, \"bytes_per_second\": {:.1f}}}{}\n",
+                       to_string(static_cast<Tag>(i)),
+                       usage.bytes,
+                       usage.peak_bytes,
+                       usage.allocations,
+                       usage.allocated_bytes,
+                       rates[i].allocations_per_second,
+                       rates[i].bytes_per_second,
+                       i + 1 < TAG_COUNT ? "," : "");
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+Tag current_tag() noexcept
+{
+    return current_thread_tag;
+}
+
+void *allocate(const std::size_t size,
+               const std::size_t alignment,
+               const Tag tag) noexcept
+{
+    // "std::malloc()" already aligns to "std::max_align_t", so only over-aligned memory needs extra room to shift into place
+    const std::size_t padding = HEADER_SPACE + (alignment > alignof(std::max_align_t) ? alignment - alignof(std::max_align_t) : 0);
+    if (size > SIZE_MAX - padding) [[unlikely]] {
+        return nullptr;
+    }
+    auto *base = static_cast<std::byte *>(std::malloc(size + padding));
+    if (base == nullptr) [[unlikely]] {
+        return nullptr;
+    }
+    const auto base_address = reinterpret_cast<std::uintptr_t>(base);
+    const std::uintptr_t address = (base_address + HEADER_SPACE + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    std::byte *memory = base + (address - base_address);
+    const Header header{.size = size, .offset = static_cast<std::uint32_t>(address - base_address), .tag = tag};
+    std::memcpy(memory - sizeof(Header), &header, sizeof(Header));
+
+    Counters &counter = counters[static_cast<std::size_t>(tag)];
+    const std::size_t bytes = counter.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak_bytes = counter.peak_bytes.load(std::memory_order_relaxed);
+    while (bytes > peak_bytes && !counter.peak_bytes.compare_exchange_weak(peak_bytes, bytes, std::memory_order_relaxed)) {
+    }
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+    counter.allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    return memory;
+}
+
+void deallocate(void *pointer) noexcept
+{
+    if (pointer == nullptr) {
+        return;
+    }
+    auto *memory = static_cast<std::byte *>(pointer);
+    Header header;
+    std::memcpy(&header, memory - sizeof(Header), sizeof(Header));
+    counters[static_cast<std::size_t>(header.tag)].bytes.fetch_sub(header.size, std::memory_order_relaxed);
+    std::free(memory - header.offset);
+}
+
+void enable_global_accounting() noexcept
+{
+    global_accounting.store(true, std::memory_order_relaxed);
+}
+
+bool is_global_accounting_enabled() noexcept
+{
+    return global_accounting.load(std::memory_order_relaxed);
+}
+
+Scope::Scope(const Tag tag) noexcept
+    : previous_(current_thread_tag)
+{
+    current_thread_tag = tag;
+}
+
+Scope::~Scope()
+{
+    current_thread_tag = this->previous_;
+}
+
+}  // namespace core::memory
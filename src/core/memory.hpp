@@ -0,0 +1,218 @@
+/**
+ * @file memory.hpp
+ *
+ * @brief Heap usage accounted per subsystem, using tagged allocations.
+ */
+
+#pragma once
+
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+namespace core::memory {
+
+/**
+ * @brief Subsystems that heap allocations are charged to.
+ */
+enum class Tag : std::uint8_t {
+    Other,
+    EditorBuffer,
+    TextEngine,
+    Clipboard,
+    FontAtlas,
+    ImGui,
+};
+
+/**
+ * @brief Number of tags, for arrays indexed by tag.
+ */
+inline constexpr std::size_t TAG_COUNT = 6;
+
+/**
+ * @brief Return the display name of a tag.
+ *
+ * @param tag Tag to name (e.g., "Tag::EditorBuffer").
+ *
+ * @return Display name (e.g., "Editor buffer").
+ */
+[[nodiscard]] std::string_view to_string(const Tag tag);
+
+/**
+ * @brief Heap usage of a single tag.
+ */
+struct Usage {
+    /**
+     * @brief Number of bytes currently allocated.
+     */
+    std::size_t bytes = 0;
+
+    /**
+     * @brief Largest number of bytes allocated at the same time.
+     */
+    std::size_t peak_bytes = 0;
+
+    /**
+     * @brief Number of allocations made since the process started.
+     */
+    std::size_t allocations = 0;
+
+    /**
+     * @brief Number of bytes allocated since the process started, including bytes that were freed since.
+     */
+    std::size_t allocated_bytes = 0;
+};
+
+/**
+ * @brief Heap usage of every tag at a point in time.
+ */
+struct Snapshot {
+    /**
+     * @brief Usage of every tag, indexed by the tag.
+     */
+    std::array<Usage, TAG_COUNT> usages{};
+
+    /**
+     * @brief Time the snapshot was taken, in seconds since the process started.
+     */
+    double seconds = 0.0;
+
+    /**
+     * @brief Return the usage of a tag.
+     *
+     * @param tag Tag to look up (e.g., "Tag::ImGui").
+     *
+     * @return Usage of the tag.
+     */
+    [[nodiscard]] const Usage &operator[](const Tag tag) const
+    {
+        return this->usages[static_cast<std::size_t>(tag)];
+    }
+
+    /**
+     * @brief Return the number of bytes currently allocated by all tags together.
+     *
+     * @return Number of bytes (e.g., "1048576").
+     */
+    [[nodiscard]] std::size_t total_bytes() const;
+};
+
+/**
+ * @brief Allocation rates of a tag between two snapshots.
+ */
+struct Rate {
+    /**
+     * @brief Allocations per second.
+     */
+    double allocations_per_second = 0.0;
+
+    /**
+     * @brief Allocated bytes per second.
+     */
+    double bytes_per_second = 0.0;
+};
+
+/**
+ * @brief Read the current usage of every tag.
+ *
+ * @return Snapshot of the counters; each counter is read atomically, but the counters are not read at the same instant.
+ */
+[[nodiscard]] Snapshot take_snapshot();
+
+/**
+ * @brief Compute the allocation rate of every tag between two snapshots.
+ *
+ * @param previous Earlier snapshot.
+ * @param current Later snapshot.
+ *
+ * @return Rates indexed by the tag; all zero if no time passed between the snapshots.
+ */
+[[nodiscard]] std::array<Rate, TAG_COUNT> compute_rates(const Snapshot &previous,
+                                                        const Snapshot &current);
+
+/**
+ * @brief Format a snapshot as a JSON object.
+ *
+ * Every tag is listed with its current and peak bytes, its totals, and its average rates since the process started.
+ *
+ * @param snapshot Snapshot to format.
+ *
+ * @return JSON text (e.g., "{"uptime_seconds": 1.5, "total_bytes": 1024, "tags": [...]}").
+ */
+[[nodiscard]] std::string to_json(const Snapshot &snapshot);
+
+/**
+ * @brief Return the tag that allocations on the calling thread are charged to.
+ *
+ * @return Tag of the innermost "Scope" on this thread, or "Tag::Other" outside of any.
+ */
+[[nodiscard]] Tag current_tag() noexcept;
+
+/**
+ * @brief Allocate memory and charge it to a tag.
+ *
+ * The size and tag are stored in a small header in front of the returned memory, so "deallocate()" credits the same tag, whichever thread frees it.
+ *
+ * @param size Number of bytes to allocate.
+ * @param alignment Alignment of the returned memory, a power of two.
+ * @param tag Tag to charge the memory to (e.g., "Tag::ImGui").
+ *
+ * @return Pointer to the memory, or nullptr if it could not be allocated.
+ */
+[[nodiscard]] void *allocate(const std::size_t size,
+                             const std::size_t alignment,
+                             const Tag tag) noexcept;
+
+/**
+ * @brief Free memory returned by "allocate()" and credit its tag.
+ *
+ * @param pointer Memory to free, may be nullptr.
+ */
+void deallocate(void *pointer) noexcept;
+
+/**
+ * @brief Record that the global "operator new" and "operator delete" are routed through "allocate()" and "deallocate()".
+ *
+ * Only the executable replaces them, so the libraries, tests, and benchmarks keep the default allocator; without the replacement, only memory allocated through "allocate()" directly (e.g., by ImGui) is accounted.
+ */
+void enable_global_accounting() noexcept;
+
+/**
+ * @brief Return whether "enable_global_accounting()" was called.
+ *
+ * @return True if every heap allocation is accounted, false if only direct "allocate()" calls are.
+ */
+[[nodiscard]] bool is_global_accounting_enabled() noexcept;
+
+/**
+ * @brief Charges the allocations made on the current thread to a tag while it is alive.
+ *
+ * Scopes nest; the innermost one wins, and the previous tag is restored on destruction. Memory stays charged to the tag it was allocated under, wherever it is moved to afterwards.
+ */
+class Scope final {
+  public:
+    /**
+     * @brief Construct a new Scope object.
+     *
+     * @param tag Tag to charge the allocations to (e.g., "Tag::TextEngine").
+     */
+    explicit Scope(const Tag tag) noexcept;
+
+    /**
+     * @brief Restore the tag that was current before this scope.
+     */
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    /**
+     * @brief Tag that was current before this scope.
+     */
+    Tag previous_;
+};
+
+}  // namespace core::memory
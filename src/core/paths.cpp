@@ -0,0 +1,137 @@
+/**
+ * @file paths.cpp
+ */
+
+#include <cstdlib>       // for std::getenv
+#include <filesystem>    // for std::filesystem
+#include <format>        // for std::format
+#include <stdexcept>     // for std::runtime_error
+#include <system_error>  // for std::error_code
+
+#include <spdlog/spdlog.h>
+
+#include "core/paths.hpp"
+#include "generated.hpp"
+
+namespace core::paths {
+
+namespace {
+
+/**
+ * @brief Return the value of an environment variable as a path, or an empty path if it is unset or empty.
+ *
+ * @param name Name of the environment variable (e.g., "HOME").
+ *
+ * @return Path stored in the variable (e.g., "/home/user").
+ */
+[[nodiscard]] std::filesystem::path get_environment_path(const char *name)
+{
+    // MSVC deprecates "std::getenv" in favor of "_dupenv_s", but the variable is only read once and never stored
+#if defined(_MSC_VER)
+#pragma warning(suppress : 4996)
+#endif
+    const char *value = std::getenv(name);
+    if (value == nullptr || *value == '\0') {
+        return {};
+    }
+    return std::filesystem::path{value};
+}
+
+/**
+ * @brief Create the directory (and its parents) if it does not exist.
+ *
+ * @param directory Directory to create (e.g., "/home/user/.cache/ungpt").
+ *
+ * @return The same directory, for convenience.
+ *
+ * @throws std::runtime_error if the directory cannot be created.
+ */
+std::filesystem::path ensure_directory(const std::filesystem::path &directory)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to create directory '{}': {}", directory.string(), ec.message()));
+    }
+    return directory;
+}
+
+}  // namespace
+
+std::filesystem::path get_cache_directory()
+{
+#if defined(_WIN32)
+    const std::filesystem::path base = get_environment_path("LOCALAPPDATA");
+    if (base.empty()) [[unlikely]] {
+        throw std::runtime_error("Failed to determine cache directory: LOCALAPPDATA is not set");
+    }
+    const std::filesystem::path directory = base / generated::PROJECT_NAME / "cache";
+#elif defined(__APPLE__)
+    const std::filesystem::path home = get_environment_path("HOME");
+    if (home.empty()) [[unlikely]] {
+        throw std::runtime_error("Failed to determine cache directory: HOME is not set");
+    }
+    const std::filesystem::path directory = home / "Library" / "Caches" / generated::PROJECT_NAME;
+#else
+    std::filesystem::path base = get_environment_path("XDG_CACHE_HOME");
+    if (base.empty()) {
+        const std::filesystem::path home = get_environment_path("HOME");
+        if (home.empty()) [[unlikely]] {
+            throw std::runtime_error("Failed to determine cache directory: neither XDG_CACHE_HOME nor HOME is set");
+        }
+        base = home / ".cache";
+    }
+    const std::filesystem::path directory = base / generated::PROJECT_NAME;
+#endif
+
+    SPDLOG_DEBUG("Using cache directory '{}'", directory.string());
+    return ensure_directory(directory);
+}
+
+std::filesystem::path get_state_directory()
+{
+#if defined(_WIN32)
+    const std::filesystem::path base = get_environment_path("LOCALAPPDATA");
+    if (base.empty()) [[unlikely]] {
+        throw std::runtime_error("Failed to determine state directory: LOCALAPPDATA is not set");
+    }
+    const std::filesystem::path directory = base / generated::PROJECT_NAME / "state";
+#elif defined(__APPLE__)
+    const std::filesystem::path home = get_environment_path("HOME");
+    if (home.empty()) [[unlikely]] {
+        throw std::runtime_error("Failed to determine state directory: HOME is not set");
+    }
+    const std::filesystem::path directory = home / "Library" / "Application Support" / generated::PROJECT_NAME;
+#else
+    std::filesystem::path base = get_environment_path("XDG_STATE_HOME");
+    if (base.empty()) {
+        const std::filesystem::path home = get_environment_path("HOME");
+        if (home.empty()) [[unlikely]] {
+            throw std::runtime_error("Failed to determine state directory: neither XDG_STATE_HOME nor HOME is set");
+        }
+        base = home / ".local" / "state";
+    }
+    const std::filesystem::path directory = base / generated::PROJECT_NAME;
+#endif
+
+    SPDLOG_DEBUG("Using state directory '{}'", directory.string());
+    return ensure_directory(directory);
+}
+
+std::filesystem::path get_runtime_directory()
+{
+#if defined(_WIN32) || defined(__APPLE__)
+    return get_state_directory();
+#else
+    const std::filesystem::path base = get_environment_path("XDG_RUNTIME_DIR");
+    if (base.empty()) {
+        return get_state_directory();
+    }
+    const std::filesystem::path directory = base / generated::PROJECT_NAME;
+
+    SPDLOG_DEBUG("Using runtime directory '{}'", directory.string());
+    return ensure_directory(directory);
+#endif
+}
+
+}  // namespace core::paths
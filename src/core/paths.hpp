@@ -0,0 +1,46 @@
+/**
+ * @file paths.hpp
+ *
+ * @brief Platform-specific locations for files written by the application.
+ */
+
+#pragma once
+
+#include <filesystem>  // for std::filesystem::path
+
+namespace core::paths {
+
+/**
+ * @brief Return the per-user cache directory of the application, creating it if it does not exist.
+ *
+ * The directory is "$XDG_CACHE_HOME/ungpt" (or "~/.cache/ungpt") on GNU/Linux, "~/Library/Caches/ungpt" on macOS, and "%LOCALAPPDATA%\ungpt\cache" on Windows.
+ *
+ * @return Absolute path to the cache directory (e.g., "/home/user/.cache/ungpt").
+ *
+ * @throws std::runtime_error if the home directory cannot be determined or the directory cannot be created.
+ */
+[[nodiscard]] std::filesystem::path get_cache_directory();
+
+/**
+ * @brief Return the per-user state directory of the application, creating it if it does not exist.
+ *
+ * Unlike the cache directory, files in it must not be deleted by the system. The directory is "$XDG_STATE_HOME/ungpt" (or "~/.local/state/ungpt") on GNU/Linux, "~/Library/Application Support/ungpt" on macOS, and "%LOCALAPPDATA%\ungpt\state" on Windows.
+ *
+ * @return Absolute path to the state directory (e.g., "/home/user/.local/state/ungpt").
+ *
+ * @throws std::runtime_error if the home directory cannot be determined or the directory cannot be created.
+ */
+[[nodiscard]] std::filesystem::path get_state_directory();
+
+/**
+ * @brief Return the per-user runtime directory of the application, for sockets and lock files that only live as long as the session, creating it if it does not exist.
+ *
+ * The directory is "$XDG_RUNTIME_DIR/ungpt" on GNU/Linux, falling back to the state directory if the variable is not set, and the state directory on other platforms.
+ *
+ * @return Absolute path to the runtime directory (e.g., "/run/user/1000/ungpt").
+ *
+ * @throws std::runtime_error if the home directory cannot be determined or the directory cannot be created.
+ */
+[[nodiscard]] std::filesystem::path get_runtime_directory();
+
+}  // namespace core::paths
@@ -0,0 +1,71 @@
+/**
+ * @file pipeline.cpp
+ */
+
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::index_sequence, std::make_index_sequence
+
+#include "core/pipeline.hpp"
+
+namespace core::pipeline {
+
+namespace {
+
+/**
+ * @brief Number of stages that "PipelineOptions" can enable.
+ */
+constexpr std::size_t STAGE_COUNT = 5;
+
+/**
+ * @brief Run the fused pipeline for one combination of stages.
+ *
+ * @tparam Mask Enabled stages, one bit per option in declaration order (e.g., "0b01100").
+ *
+ * @param text Text to transform.
+ * @param output String that receives the transformed text.
+ *
+ * @return Number of changes made.
+ */
+template <std::size_t Mask>
+std::size_t run_combination(const std::string_view text,
+                            std::string &output)
+{
+    Pipeline<stage_if<(Mask & 1u) != 0, NormalizeLineEndings>,
+             stage_if<(Mask & 2u) != 0, StripInvisible>,
+             stage_if<(Mask & 4u) != 0, FoldQuotes>,
+             stage_if<(Mask & 8u) != 0, FoldDashes>,
+             stage_if<(Mask & 16u) != 0, CollapseSpaces>>
+        pipeline;
+    return pipeline.run(text, output);
+}
+
+/**
+ * @brief Build the table of fused pipelines, one per combination of stages.
+ *
+ * @return Function pointers indexed by the mask of enabled stages.
+ */
+template <std::size_t... Masks>
+[[nodiscard]] constexpr auto make_combinations(std::index_sequence<Masks...>)
+{
+    return std::array<std::size_t (*)(std::string_view, std::string &), sizeof...(Masks)>{&run_combination<Masks>...};
+}
+
+}  // namespace
+
+std::size_t run(const std::string_view text,
+                const PipelineOptions &options,
+                std::string &output)
+{
+    static constexpr auto combinations = make_combinations(std::make_index_sequence<std::size_t{1} << STAGE_COUNT>{});
+    const std::size_t mask = (options.normalize_line_endings ? 1u : 0u) |
+                             (options.strip_invisible ? 2u : 0u) |
+                             (options.fold_quotes ? 4u : 0u) |
+                             (options.fold_dashes ? 8u : 0u) |
+                             (options.collapse_spaces ? 16u : 0u);
+    return combinations[mask](text, output);
+}
+
+}  // namespace core::pipeline
@@ -0,0 +1,494 @@
+/**
+ * @file pipeline.hpp
+ *
+ * @brief Cleanup stages that are fused at compile time into a single pass over the text.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <cstring>      // for std::memcpy
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <tuple>        // for std::tuple, std::get, std::tuple_element_t
+#include <type_traits>  // for std::conditional_t
+
+namespace core::pipeline {
+
+/**
+ * @brief First of the 128 lone low surrogates (U+DC80 to U+DCFF) that carry the bytes of invalid UTF-8 through the stages, so they are written back unchanged.
+ */
+inline constexpr char32_t ESCAPED_BYTE_BASE = 0xDC00;
+
+/**
+ * @brief Decode the code point at a byte offset and advance past it.
+ *
+ * A byte that does not start a valid sequence is returned as "ESCAPED_BYTE_BASE" plus the byte, one byte at a time; valid UTF-8 never encodes surrogates, so no stage mistakes it for a character.
+ *
+ * @param text Text to decode (e.g., "café").
+ * @param position Byte offset of the code point, advanced to the next one (e.g., "3").
+ *
+ * @return Code point (e.g., "U+00E9").
+ */
+[[nodiscard]] inline char32_t decode(const std::string_view text,
+                                     std::size_t &position)
+{
+    const auto byte = [&text](const std::size_t index) {
+        return static_cast<unsigned char>(text[index]);
+    };
+    const unsigned char lead = byte(position);
+    const std::size_t remaining = text.size() - position;
+    if (lead < 0x80) [[likely]] {
+        ++position;
+        return lead;
+    }
+    if (lead >= 0xC2 && lead < 0xE0 && remaining >= 2 && (byte(position + 1) & 0xC0) == 0x80) {
+        const char32_t code_point = (static_cast<char32_t>(lead & 0x1F) << 6) | (byte(position + 1) & 0x3Fu);
+        position += 2;
+        return code_point;
+    }
+    if (lead >= 0xE0 && lead < 0xF0 && remaining >= 3 && (byte(position + 1) & 0xC0) == 0x80 && (byte(position + 2) & 0xC0) == 0x80) {
+        const char32_t code_point = (static_cast<char32_t>(lead & 0x0F) << 12) | (static_cast<char32_t>(byte(position + 1) & 0x3F) << 6) | (byte(position + 2) & 0x3Fu);
+        if (code_point >= 0x800 && (code_point < 0xD800 || code_point > 0xDFFF)) [[likely]] {
+            position += 3;
+            return code_point;
+        }
+    }
+    if (lead >= 0xF0 && lead < 0xF5 && remaining >= 4 && (byte(position + 1) & 0xC0) == 0x80 && (byte(position + 2) & 0xC0) == 0x80 && (byte(position + 3) & 0xC0) == 0x80) {
+        const char32_t code_point = (static_cast<char32_t>(lead & 0x07) << 18) | (static_cast<char32_t>(byte(position + 1) & 0x3F) << 12) | (static_cast<char32_t>(byte(position + 2) & 0x3F) << 6) | (byte(position + 3) & 0x3Fu);
+        if (code_point >= 0x10000 && code_point <= 0x10FFFF) [[likely]] {
+            position += 4;
+            return code_point;
+        }
+    }
+    ++position;
+    return ESCAPED_BYTE_BASE + lead;
+}
+
+/**
+ * @brief Output buffer of a pipeline, which encodes code points back into UTF-8.
+ */
+class Writer final {
+  public:
+    /**
+     * @brief Construct a new Writer object that overwrites a string, sized for an output as long as the input.
+     *
+     * @param output String that receives the text; its contents are replaced.
+     * @param size_hint Expected size of the output, in bytes (e.g., "1024").
+     */
+    Writer(std::string &output,
+           const std::size_t size_hint)
+        : output_(output)
+    {
+        this->output_.resize(size_hint + 4);
+    }
+
+    /**
+     * @brief Append a code point, or the raw byte it escapes.
+     *
+     * @param code_point Code point to append (e.g., "U+0022").
+     */
+    void put(const char32_t code_point)
+    {
+        if (this->size_ + 4 > this->output_.size()) [[unlikely]] {
+            this->output_.resize(this->output_.size() * 2);
+        }
+        char *const out = this->output_.data() + this->size_;
+        if (code_point < 0x80) [[likely]] {
+            out[0] = static_cast<char>(code_point);
+            this->size_ += 1;
+        }
+        else if (code_point < 0x800) {
+            out[0] = static_cast<char>(0xC0 | (code_point >> 6));
+            out[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+            this->size_ += 2;
+        }
+        else if (code_point >= ESCAPED_BYTE_BASE + 0x80 && code_point <= ESCAPED_BYTE_BASE + 0xFF) [[unlikely]] {
+            out[0] = static_cast<char>(code_point - ESCAPED_BYTE_BASE);
+            this->size_ += 1;
+        }
+        else if (code_point < 0x10000) {
+            out[0] = static_cast<char>(0xE0 | (code_point >> 12));
+            out[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+            this->size_ += 3;
+        }
+        else {
+            out[0] = static_cast<char>(0xF0 | (code_point >> 18));
+            out[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+            out[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            out[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+            this->size_ += 4;
+        }
+    }
+
+    /**
+     * @brief Append bytes as they are, for runs that no stage changes.
+     *
+     * @param bytes Bytes to append (e.g., "hello").
+     */
+    void put_bytes(const std::string_view bytes)
+    {
+        if (this->size_ + bytes.size() + 4 > this->output_.size()) [[unlikely]] {
+            this->output_.resize((this->size_ + bytes.size()) * 2 + 4);
+        }
+        std::memcpy(this->output_.data() + this->size_, bytes.data(), bytes.size());
+        this->size_ += bytes.size();
+    }
+
+    /**
+     * @brief Trim the string to the written text.
+     */
+    void finish()
+    {
+        this->output_.resize(this->size_);
+    }
+
+  private:
+    /**
+     * @brief String that receives the text, larger than the written part until "finish()".
+     */
+    std::string &output_;
+
+    /**
+     * @brief Number of bytes written so far.
+     */
+    std::size_t size_ = 0;
+};
+
+/**
+ * @brief Stage that passes every code point through unchanged; it takes the place of a disabled stage and compiles away.
+ *
+ * Every stage has the same shape: "push()" receives one code point, hands zero or more code points to "next", and returns whether that was anything but the code point itself, so the pipeline can count the changes; an optional "finish()" flushes what the stage held back at the end of the text. A stage that declares "ascii_transparent" promises to pass every ASCII character through unchanged.
+ */
+struct Identity {
+    static constexpr bool ascii_transparent = true;
+
+    template <typename Next>
+    bool push(const char32_t code_point,
+              Next &&next)
+    {
+        next(code_point);
+        return false;
+    }
+};
+
+/**
+ * @brief Stage that replaces curly and low quotation marks with straight ASCII quotes (e.g., "“hi”" becomes "\"hi\"").
+ */
+struct FoldQuotes {
+    static constexpr bool ascii_transparent = true;
+
+    template <typename Next>
+    bool push(const char32_t code_point,
+              Next &&next)
+    {
+        if (code_point >= 0x2018 && code_point <= 0x201B) {
+            next(U'\'');
+            return true;
+        }
+        if (code_point >= 0x201C && code_point <= 0x201F) {
+            next(U'"');
+            return true;
+        }
+        next(code_point);
+        return false;
+    }
+};
+
+/**
+ * @brief Stage that replaces hyphens, dashes, and the minus sign with an ASCII hyphen-minus (e.g., "a — b" becomes "a - b").
+ */
+struct FoldDashes {
+    static constexpr bool ascii_transparent = true;
+
+    template <typename Next>
+    bool push(const char32_t code_point,
+              Next &&next)
+    {
+        const bool is_dash = (code_point >= 0x2010 && code_point <= 0x2015) || code_point == 0x2212;
+        next(is_dash ? U'-' : code_point);
+        return is_dash;
+    }
+};
+
+/**
+ * @brief Stage that removes zero-width characters, directional marks, the soft hyphen, and byte order marks.
+ */
+struct StripInvisible {
+    static constexpr bool ascii_transparent = true;
+
+    template <typename Next>
+    bool push(const char32_t code_point,
+              Next &&next)
+    {
+        if ((code_point >= 0x200B && code_point <= 0x200F) || code_point == 0x2060 || code_point == 0x00AD || code_point == 0xFEFF) {
+            return true;
+        }
+        next(code_point);
+        return false;
+    }
+};
+
+/**
+ * @brief Stage that collapses every run of spaces, tabs, and Unicode spaces (e.g., U+00A0) into a single ASCII space.
+ */
+struct CollapseSpaces {
+    static constexpr bool ascii_transparent = false;
+
+    template <typename Next>
+    bool push(const char32_t code_point,
+              Next &&next)
+    {
+        const bool is_space = code_point < 0x80 ? code_point == U' ' || code_point == U'\t'
+                                                : code_point == 0x00A0 ||
+                                                      code_point == 0x1680 ||
+                                                      (code_point >= 0x2000 && code_point <= 0x200A) ||
+                                                      code_point == 0x202F ||
+                                                      code_point == 0x205F ||
+                                                      code_point == 0x3000;
+        if (!is_space) [[likely]] {
+            this->inside_run_ = false;
+            next(code_point);
+            return false;
+        }
+        if (this->inside_run_) {
+            return true;
+        }
+        this->inside_run_ = true;
+        next(U' ');
+        return code_point != U' ';
+    }
+
+  private:
+    /**
+     * @brief Whether the previous code point was a space, so this one is dropped.
+     */
+    bool inside_run_ = false;
+};
+
+/**
+ * @brief Stage that turns Windows ("\r\n") and classic Mac ("\r") line endings into "\n".
+ */
+struct NormalizeLineEndings {
+    static constexpr bool ascii_transparent = false;
+
+    template <typename Next>
+    bool push(const char32_t code_point,
+              Next &&next)
+    {
+        const bool after_carriage_return = this->after_carriage_return_;
+        this->after_carriage_return_ = code_point == U'\r';
+        if (code_point == U'\r') {
+            next(U'\n');
+            return true;
+        }
+        if (code_point == U'\n' && after_carriage_return) {
+            return true;
+        }
+        next(code_point);
+        return false;
+    }
+
+  private:
+    /**
+     * @brief Whether the previous code point was "\r", so a following "\n" belongs to the same line ending.
+     */
+    bool after_carriage_return_ = false;
+};
+
+/**
+ * @brief Select a stage, or "Identity" if it is disabled, to build pipelines from compile-time flags.
+ */
+template <bool Enabled, typename Stage>
+using stage_if = std::conditional_t<Enabled, Stage, Identity>;
+
+/**
+ * @brief Chain of stages that runs in a single pass over the text.
+ *
+ * The text is decoded once, and every code point is pushed through all stages before the next one is read; the calls are resolved at compile time, so the compiler inlines them into one loop. If every stage is ASCII-transparent, runs of ASCII are copied eight bytes at a time without entering the stages at all.
+ *
+ * @tparam Stages Stages in the order they see the text (e.g., "NormalizeLineEndings, FoldQuotes").
+ */
+template <typename... Stages>
+class Pipeline final {
+  public:
+    /**
+     * @brief Whether every stage passes ASCII through unchanged, so ASCII runs may skip the stages.
+     */
+    static constexpr bool ascii_transparent = (Stages::ascii_transparent && ...);
+
+    /**
+     * @brief Run all stages over the text.
+     *
+     * The stages keep their state from previous calls, so a pipeline is meant for one text; construct a new one for the next.
+     *
+     * @param text Text to transform (e.g., "“a”\r\n").
+     * @param output String that receives the transformed text; its contents are replaced, its capacity is reused.
+     *
+     * @return Number of changes made, where a run of adjacent code points that were replaced or removed counts once (e.g., "2").
+     */
+    std::size_t run(const std::string_view text,
+                    std::string &output)
+    {
+        Writer writer{output, text.size()};
+        std::size_t changes = 0;
+        bool is_changing = false;
+        std::size_t position = 0;
+        while (position < text.size()) {
+            if constexpr (ascii_transparent) {
+                // Skip the stages for every ASCII run, the common case for English text
+                const std::size_t run_end = find_non_ascii(text, position);
+                if (run_end != position) {
+                    writer.put_bytes(text.substr(position, run_end - position));
+                    is_changing = false;
+                    position = run_end;
+                    if (position == text.size()) {
+                        break;
+                    }
+                }
+            }
+
+            // Adjacent code points that the stages changed are counted as a single change
+            const bool is_changed = this->push<0>(decode(text, position), writer);
+            changes += is_changed && !is_changing ? 1 : 0;
+            is_changing = is_changed;
+        }
+        this->finish<0>(writer);
+        writer.finish();
+        return changes;
+    }
+
+  private:
+    /**
+     * @brief Find the end of the ASCII run that starts at an offset.
+     *
+     * @param text Text to scan.
+     * @param position Byte offset where the run starts.
+     *
+     * @return Byte offset of the first non-ASCII byte, or the size of the text.
+     */
+    [[nodiscard]] static std::size_t find_non_ascii(const std::string_view text,
+                                                    std::size_t position)
+    {
+        for (; position + 8 <= text.size(); position += 8) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, text.data() + position, sizeof(chunk));
+            if ((chunk & 0x8080808080808080ull) != 0) {
+                break;
+            }
+        }
+        while (position < text.size() && static_cast<unsigned char>(text[position]) < 0x80) {
+            ++position;
+        }
+        return position;
+    }
+
+    /**
+     * @brief Push a code point into a stage, which hands its output on to the next stage, and the last one to the writer.
+     *
+     * @tparam Index Index of the stage.
+     *
+     * @param code_point Code point to push.
+     * @param writer Output buffer.
+     *
+     * @return True if this stage or a later one changed the code point, false if it reached the writer as it was.
+     */
+    template <std::size_t Index>
+    bool push(const char32_t code_point,
+              Writer &writer)
+    {
+        if constexpr (Index == sizeof...(Stages)) {
+            writer.put(code_point);
+            return false;
+        }
+        else {
+            using Stage = std::tuple_element_t<Index, std::tuple<Stages...>>;
+            if constexpr (Stage::ascii_transparent) {
+                // Once a code point is known to be ASCII, every later ASCII-transparent stage is skipped by the same check
+                if (code_point < 0x80) [[likely]] {
+                    return this->push<Index + 1>(code_point, writer);
+                }
+            }
+            bool is_changed_later = false;
+            const bool is_changed = std::get<Index>(this->stages_).push(code_point, [this, &writer, &is_changed_later](const char32_t next_code_point) {
+                is_changed_later |= this->push<Index + 1>(next_code_point, writer);
+            });
+            return is_changed || is_changed_later;
+        }
+    }
+
+    /**
+     * @brief Flush the stages that hold code points back, from a stage onwards, in order.
+     *
+     * @tparam Index Index of the first stage to flush.
+     *
+     * @param writer Output buffer.
+     */
+    template <std::size_t Index>
+    void finish(Writer &writer)
+    {
+        if constexpr (Index < sizeof...(Stages)) {
+            auto &stage = std::get<Index>(this->stages_);
+            if constexpr (requires { stage.finish([](char32_t) {}); }) {
+                stage.finish([this, &writer](const char32_t next_code_point) {
+                    this->push<Index + 1>(next_code_point, writer);
+                });
+            }
+            this->finish<Index + 1>(writer);
+        }
+    }
+
+    /**
+     * @brief Stages, with their state.
+     */
+    std::tuple<Stages...> stages_{};
+};
+
+/**
+ * @brief Cleanup stages to run, chosen at runtime.
+ */
+struct PipelineOptions {
+    /**
+     * @brief Turn "\r\n" and "\r" into "\n".
+     */
+    bool normalize_line_endings = false;
+
+    /**
+     * @brief Remove zero-width characters, directional marks, the soft hyphen, and byte order marks.
+     */
+    bool strip_invisible = false;
+
+    /**
+     * @brief Replace curly quotation marks with straight quotes.
+     */
+    bool fold_quotes = false;
+
+    /**
+     * @brief Replace dashes and the minus sign with a hyphen-minus.
+     */
+    bool fold_dashes = false;
+
+    /**
+     * @brief Collapse runs of horizontal whitespace into a single space.
+     */
+    bool collapse_spaces = false;
+};
+
+/**
+ * @brief Run the selected stages over the text in a single pass.
+ *
+ * Every combination of stages is compiled into its own fused pipeline; this only picks the matching one, so a disabled stage costs nothing. The stages run in the order the options are declared.
+ *
+ * @param text Text to transform (e.g., "“a”  —  b\r\n").
+ * @param options Stages to run (e.g., "{.fold_quotes = true, .fold_dashes = true}").
+ * @param output String that receives the transformed text (e.g., "\"a\" - b\n" with all stages enabled); its contents are replaced, its capacity is reused.
+ *
+ * @return Number of changes made, where a run of adjacent code points that were replaced or removed counts once (e.g., "3").
+ */
+std::size_t run(const std::string_view text,
+                const PipelineOptions &options,
+                std::string &output);
+
+}  // namespace core::pipeline
@@ -0,0 +1,21 @@
+/**
+ * @file posix.cpp
+ */
+
+#include <cerrno>        // for errno
+#include <format>        // for std::format
+#include <stdexcept>     // for std::runtime_error
+#include <string>        // for std::string
+#include <system_error>  // for std::error_code, std::system_category
+
+#include "core/posix.hpp"
+
+namespace core::posix {
+
+void throw_errno(const std::string &what)
+{
+    const std::error_code ec{errno, std::system_category()};
+    throw std::runtime_error(std::format("Failed to {}: {}", what, ec.message()));
+}
+
+}  // namespace core::posix
@@ -0,0 +1,22 @@
+/**
+ * @file posix.hpp
+ *
+ * @brief Helpers shared by the modules that call the operating system directly (sockets, locks, memory maps).
+ */
+
+#pragma once
+
+#include <string>  // for std::string
+
+namespace core::posix {
+
+/**
+ * @brief Throw the current "errno" as an exception.
+ *
+ * @param what Description of the failed operation (e.g., "bind '/tmp/ungpt.sock'").
+ *
+ * @throws std::runtime_error always, with a message such as "Failed to bind '/tmp/ungpt.sock': Address already in use".
+ */
+[[noreturn]] void throw_errno(const std::string &what);
+
+}  // namespace core::posix
@@ -0,0 +1,92 @@
+/**
+ * @file protocol.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint32_t, std::uint64_t
+#include <format>       // for std::format
+#include <optional>     // for std::optional, std::nullopt
+#include <stdexcept>    // for std::invalid_argument, std::runtime_error
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include "core/protocol.hpp"
+
+namespace core::protocol {
+
+void append_frame(std::string &buffer,
+                  const std::uint8_t kind,
+                  const std::string_view body)
+{
+    const std::size_t size = body.size() + 1;
+    if (size > MAX_FRAME_SIZE) [[unlikely]] {
+        throw std::invalid_argument(std::format("Frame of '{}' bytes exceeds the limit of '{}' bytes", size, MAX_FRAME_SIZE));
+    }
+
+    // Encode the length byte by byte, so the format does not depend on the host's endianness
+    buffer.reserve(buffer.size() + HEADER_SIZE + size);
+    for (std::size_t i = 0; i < HEADER_SIZE; ++i) {
+        buffer.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+    }
+    buffer.push_back(static_cast<char>(kind));
+    buffer.append(body);
+}
+
+void append_u64(std::string &buffer,
+                const std::uint64_t value)
+{
+    for (std::size_t i = 0; i < 8; ++i) {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+std::uint64_t read_u64(const std::string_view bytes,
+                       const std::size_t offset)
+{
+    if (offset > bytes.size() || bytes.size() - offset < 8) [[unlikely]] {
+        throw std::runtime_error(std::format("Expected 8 bytes at offset '{}', but only '{}' bytes are available", offset, bytes.size()));
+    }
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[offset + i])) << (8 * i);
+    }
+    return value;
+}
+
+void FrameDecoder::feed(const std::string_view bytes)
+{
+    // Drop the decoded prefix once it dominates the buffer, so a long-lived connection does not grow without bound
+    if (this->offset_ != 0 && this->offset_ >= this->buffer_.size() / 2) {
+        this->buffer_.erase(0, this->offset_);
+        this->offset_ = 0;
+    }
+    this->buffer_.append(bytes);
+}
+
+std::optional<Frame> FrameDecoder::next()
+{
+    if (this->buffered() < HEADER_SIZE) {
+        return std::nullopt;
+    }
+
+    std::uint32_t size = 0;
+    for (std::size_t i = 0; i < HEADER_SIZE; ++i) {
+        size |= static_cast<std::uint32_t>(static_cast<unsigned char>(this->buffer_[this->offset_ + i])) << (8 * i);
+    }
+    if (size == 0 || size > MAX_FRAME_SIZE) [[unlikely]] {
+        throw std::runtime_error(std::format("Invalid frame size '{}'", size));
+    }
+    if (this->buffered() - HEADER_SIZE < size) {
+        return std::nullopt;
+    }
+
+    const std::size_t start = this->offset_ + HEADER_SIZE;
+    Frame frame{
+        .kind = static_cast<std::uint8_t>(this->buffer_[start]),
+        .body = this->buffer_.substr(start + 1, size - 1),
+    };
+    this->offset_ = start + size;
+    return frame;
+}
+
+}  // namespace core::protocol
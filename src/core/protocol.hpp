@@ -0,0 +1,162 @@
+/**
+ * @file protocol.hpp
+ *
+ * @brief Length-prefixed wire format spoken by the normalization daemon and its clients.
+ *
+ * Every message is a frame: a 4-byte little-endian length, followed by that many bytes. The first byte is the kind (an opcode for requests, a status for responses), the rest is the body. Responses are sent in the same order as the requests on a connection, so clients may pipeline requests without tagging them.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint64_t
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+namespace core::protocol {
+
+/**
+ * @brief Operation requested by a client.
+ */
+enum class Opcode : std::uint8_t {
+    /**
+     * @brief Normalize the body; the response body is the normalized text.
+     */
+    Normalize = 1,
+
+    /**
+     * @brief Count the body; the response body is the word count followed by the character count, both as 8-byte little-endian integers.
+     */
+    Count = 2,
+
+    /**
+     * @brief Estimate the tokens in the body; the response body is the estimate as an 8-byte little-endian integer.
+     */
+    EstimateTokens = 3,
+
+    /**
+     * @brief Open a document in the running editor (see "core::instance"), not served by the daemon; the body is the title of the tab, and the text travels alongside as a sealed memfd (or nothing, to only raise the window).
+     */
+    OpenDocument = 4,
+};
+
+/**
+ * @brief Outcome of a request.
+ */
+enum class Status : std::uint8_t {
+    /**
+     * @brief The request succeeded; the body holds the result.
+     */
+    Ok = 0,
+
+    /**
+     * @brief The request failed; the body holds a human-readable error message.
+     */
+    Error = 1,
+};
+
+/**
+ * @brief Size of the length prefix, in bytes.
+ */
+inline constexpr std::size_t HEADER_SIZE = 4;
+
+/**
+ * @brief Largest accepted frame (kind and body), in bytes (64 MiB).
+ */
+inline constexpr std::size_t MAX_FRAME_SIZE = 64 * 1024 * 1024;
+
+/**
+ * @brief Decoded frame.
+ */
+struct Frame {
+    /**
+     * @brief Opcode of a request, or status of a response.
+     */
+    std::uint8_t kind = 0;
+
+    /**
+     * @brief Payload of the frame.
+     */
+    std::string body{};
+};
+
+/**
+ * @brief Append an encoded frame to a buffer.
+ *
+ * @param buffer Buffer to append to.
+ * @param kind Opcode or status of the frame.
+ * @param body Payload of the frame (e.g., "hello world").
+ *
+ * @throws std::invalid_argument if the frame is larger than "MAX_FRAME_SIZE".
+ */
+void append_frame(std::string &buffer,
+                  const std::uint8_t kind,
+                  const std::string_view body);
+
+/**
+ * @brief Append an 8-byte little-endian integer to a buffer.
+ *
+ * @param buffer Buffer to append to.
+ * @param value Value to append (e.g., "42").
+ */
+void append_u64(std::string &buffer,
+                const std::uint64_t value);
+
+/**
+ * @brief Read an 8-byte little-endian integer.
+ *
+ * @param bytes Bytes to read from.
+ * @param offset Position of the integer within the bytes (e.g., "8").
+ *
+ * @return Decoded value.
+ *
+ * @throws std::runtime_error if fewer than 8 bytes are available at the offset.
+ */
+[[nodiscard]] std::uint64_t read_u64(const std::string_view bytes,
+                                     const std::size_t offset);
+
+/**
+ * @brief Incremental decoder that splits a byte stream into frames.
+ */
+class FrameDecoder final {
+  public:
+    /**
+     * @brief Append bytes received from the stream.
+     *
+     * @param bytes Received bytes, which may contain partial or multiple frames.
+     */
+    void feed(const std::string_view bytes);
+
+    /**
+     * @brief Decode the next complete frame, if there is one.
+     *
+     * @return Next frame, or std::nullopt if more bytes are needed.
+     *
+     * @throws std::runtime_error if the stream announces an empty frame or one larger than "MAX_FRAME_SIZE".
+     */
+    [[nodiscard]] std::optional<Frame> next();
+
+    /**
+     * @brief Return the number of buffered bytes that were not decoded yet.
+     *
+     * @return Number of buffered bytes (e.g., "3").
+     */
+    [[nodiscard]] std::size_t buffered() const
+    {
+        return this->buffer_.size() - this->offset_;
+    }
+
+  private:
+    /**
+     * @brief Received bytes; everything before "offset_" was already decoded.
+     */
+    std::string buffer_;
+
+    /**
+     * @brief Position of the first byte that was not decoded yet.
+     */
+    std::size_t offset_ = 0;
+};
+
+}  // namespace core::protocol
@@ -0,0 +1,954 @@
+/**
+ * @file regex.cpp
+ */
+
+#include <algorithm>    // for std::fill, std::min
+#include <bitset>       // for std::bitset
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint32_t
+#include <format>       // for std::format
+#include <functional>   // for std::function
+#include <limits>       // for std::numeric_limits
+#include <optional>     // for std::optional, std::nullopt
+#include <span>         // for std::span
+#include <stdexcept>    // for std::invalid_argument
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::move, std::pair, std::swap
+#include <vector>       // for std::vector
+
+#include "core/regex.hpp"
+
+namespace core::regex {
+
+namespace {
+
+/**
+ * @brief Marker for a repetition without an upper bound.
+ */
+constexpr std::size_t UNBOUNDED = std::numeric_limits<std::size_t>::max();
+
+/**
+ * @brief Highest repetition count accepted in "{n,m}", which bounds the size of the expanded program.
+ */
+constexpr std::size_t MAX_REPETITION = 1000;
+
+/**
+ * @brief Parsed regular expression.
+ */
+struct Node {
+    /**
+     * @brief Kind of the node.
+     */
+    enum class Kind : std::uint8_t {
+        Empty,      // Matches the empty string
+        Literal,    // Matches "bytes" exactly (one character, possibly multi-byte)
+        Class,      // Matches one character from "ascii", or any non-ASCII character if "non_ascii" is set
+        Concat,     // Matches "children" in sequence
+        Alternate,  // Matches any of "children", earlier children preferred
+        Repeat,     // Matches "children[0]" between "min" and "max" times
+        LineStart,  // Matches the empty string at the start of a line
+        LineEnd,    // Matches the empty string at the end of a line
+    };
+
+    /**
+     * @brief Kind of the node.
+     */
+    Kind kind = Kind::Empty;
+
+    /**
+     * @brief Bytes matched by a "Literal" node.
+     */
+    std::string bytes{};
+
+    /**
+     * @brief ASCII characters matched by a "Class" node.
+     */
+    std::bitset<128> ascii{};
+
+    /**
+     * @brief Whether a "Class" node matches every non-ASCII character.
+     */
+    bool non_ascii = false;
+
+    /**
+     * @brief Sub-expressions of "Concat", "Alternate" and "Repeat" nodes.
+     */
+    std::vector<Node> children{};
+
+    /**
+     * @brief Minimum number of repetitions.
+     */
+    std::size_t min = 0;
+
+    /**
+     * @brief Maximum number of repetitions, or "UNBOUNDED".
+     */
+    std::size_t max = 0;
+
+    /**
+     * @brief Whether a "Repeat" node prefers more repetitions (true) or fewer (false).
+     */
+    bool greedy = true;
+};
+
+/**
+ * @brief Create a class node from a list of ASCII characters.
+ *
+ * @param characters Characters in the class (e.g., " \t").
+ * @param negated Whether the class should match everything except the characters.
+ *
+ * @return Class node.
+ */
+[[nodiscard]] Node make_class(const std::string_view characters,
+                              const bool negated)
+{
+    Node node{.kind = Node::Kind::Class};
+    for (const char character : characters) {
+        node.ascii.set(static_cast<unsigned char>(character));
+    }
+    if (negated) {
+        node.ascii.flip();
+        node.non_ascii = true;
+    }
+    return node;
+}
+
+/**
+ * @brief Recursive-descent parser that turns a pattern into a syntax tree.
+ */
+class Parser final {
+  public:
+    /**
+     * @brief Construct a new Parser object.
+     *
+     * @param pattern Pattern to parse (e.g., "[ \t]+$").
+     */
+    explicit Parser(const std::string_view pattern)
+        : pattern_(pattern)
+    {
+    }
+
+    /**
+     * @brief Parse the whole pattern.
+     *
+     * @return Root of the syntax tree.
+     *
+     * @throws std::invalid_argument if the pattern has invalid syntax.
+     */
+    [[nodiscard]] Node parse()
+    {
+        Node root = this->parse_alternation();
+        if (!this->at_end()) {
+            this->fail("unmatched ')'");
+        }
+        return root;
+    }
+
+  private:
+    /**
+     * @brief Throw an exception describing a syntax error at the current position.
+     *
+     * @param message Description of the error (e.g., "unmatched '('").
+     *
+     * @throws std::invalid_argument always.
+     */
+    [[noreturn]] void fail(const std::string_view message) const
+    {
+        throw std::invalid_argument(std::format("Invalid pattern '{}' at offset {}: {}", this->pattern_, this->position_, message));
+    }
+
+    /**
+     * @brief Check whether the whole pattern was consumed.
+     *
+     * @return True if there are no characters left, false otherwise.
+     */
+    [[nodiscard]] bool at_end() const
+    {
+        return this->position_ >= this->pattern_.size();
+    }
+
+    /**
+     * @brief Return the current character without consuming it.
+     *
+     * @return Current character, or '\0' at the end of the pattern.
+     */
+    [[nodiscard]] char peek() const
+    {
+        return this->at_end() ? '\0' : this->pattern_[this->position_];
+    }
+
+    /**
+     * @brief Consume the current character if it equals the expected one.
+     *
+     * @param expected Character to consume (e.g., ')').
+     *
+     * @return True if the character was consumed, false otherwise.
+     */
+    bool consume(const char expected)
+    {
+        if (!this->at_end() && this->pattern_[this->position_] == expected) {
+            ++this->position_;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Parse alternatives separated by '|'.
+     *
+     * @return Alternate node, or the single alternative.
+     */
+    [[nodiscard]] Node parse_alternation()
+    {
+        Node first = this->parse_concatenation();
+        if (this->peek() != '|') {
+            return first;
+        }
+        Node node{.kind = Node::Kind::Alternate};
+        node.children.push_back(std::move(first));
+        while (this->consume('|')) {
+            node.children.push_back(this->parse_concatenation());
+        }
+        return node;
+    }
+
+    /**
+     * @brief Parse a sequence of quantified atoms, up to '|', ')' or the end of the pattern.
+     *
+     * @return Concat node, or the single atom.
+     */
+    [[nodiscard]] Node parse_concatenation()
+    {
+        Node node{.kind = Node::Kind::Concat};
+        while (!this->at_end() && this->peek() != '|' && this->peek() != ')') {
+            node.children.push_back(this->parse_quantifiers(this->parse_atom()));
+        }
+        if (node.children.size() == 1) {
+            return std::move(node.children.front());
+        }
+        return node;
+    }
+
+    /**
+     * @brief Parse a decimal number inside "{n,m}".
+     *
+     * @return Parsed number, or std::nullopt if there is no digit at the current position.
+     */
+    [[nodiscard]] std::optional<std::size_t> parse_number()
+    {
+        if (this->peek() < '0' || this->peek() > '9') {
+            return std::nullopt;
+        }
+        std::size_t value = 0;
+        while (this->peek() >= '0' && this->peek() <= '9') {
+            value = value * 10 + static_cast<std::size_t>(this->pattern_[this->position_++] - '0');
+            if (value > MAX_REPETITION) {
+                this->fail(std::format("repetition count exceeds {}", MAX_REPETITION));
+            }
+        }
+        return value;
+    }
+
+    /**
+     * @brief Parse any quantifiers following an atom.
+     *
+     * @param atom Atom the quantifiers apply to.
+     *
+     * @return Repeat node wrapping the atom, or the atom itself if there is no quantifier.
+     */
+    [[nodiscard]] Node parse_quantifiers(Node atom)
+    {
+        while (true) {
+            std::size_t min;
+            std::size_t max;
+            if (this->consume('*')) {
+                min = 0;
+                max = UNBOUNDED;
+            }
+            else if (this->consume('+')) {
+                min = 1;
+                max = UNBOUNDED;
+            }
+            else if (this->consume('?')) {
+                min = 0;
+                max = 1;
+            }
+            else if (this->peek() == '{') {
+                ++this->position_;
+                const std::optional<std::size_t> lower = this->parse_number();
+                if (!lower) {
+                    this->fail("expected a number after '{'");
+                }
+                min = *lower;
+                max = min;
+                if (this->consume(',')) {
+                    const std::optional<std::size_t> upper = this->parse_number();
+                    max = upper ? *upper : UNBOUNDED;
+                }
+                if (!this->consume('}')) {
+                    this->fail("expected '}'");
+                }
+                if (max < min) {
+                    this->fail("repetition range is reversed");
+                }
+            }
+            else {
+                return atom;
+            }
+
+            Node node{.kind = Node::Kind::Repeat, .min = min, .max = max, .greedy = !this->consume('?')};
+            node.children.push_back(std::move(atom));
+            atom = std::move(node);
+        }
+    }
+
+    /**
+     * @brief Parse a single atom: a character, class, group or anchor.
+     *
+     * @return Parsed atom.
+     */
+    [[nodiscard]] Node parse_atom()
+    {
+        const char character = this->pattern_[this->position_++];
+        switch (character) {
+        case '(': {
+            // All groups are non-capturing, so "(?:" is accepted as a synonym
+            if (this->consume('?') && !this->consume(':')) {
+                this->fail("only '(?:' groups are supported");
+            }
+            Node group = this->parse_alternation();
+            if (!this->consume(')')) {
+                this->fail("unmatched '('");
+            }
+            return group;
+        }
+        case '[':
+            return this->parse_class();
+        case '.':
+            return make_class("\n", true);
+        case '^':
+            return Node{.kind = Node::Kind::LineStart};
+        case '$':
+            return Node{.kind = Node::Kind::LineEnd};
+        case '\\':
+            return this->parse_escape();
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            this->fail("nothing to repeat");
+        default:
+            break;
+        }
+
+        // Keep multi-byte characters together, so a quantifier repeats the whole character
+        Node node{.kind = Node::Kind::Literal};
+        node.bytes.push_back(character);
+        while (!this->at_end() && (static_cast<unsigned char>(this->peek()) & 0xC0u) == 0x80u) {
+            node.bytes.push_back(this->pattern_[this->position_++]);
+        }
+        return node;
+    }
+
+    /**
+     * @brief Parse the character after a backslash, which may be a class shorthand.
+     *
+     * @return Literal or class node.
+     */
+    [[nodiscard]] Node parse_escape()
+    {
+        if (this->at_end()) {
+            this->fail("trailing '\\'");
+        }
+        const char character = this->pattern_[this->position_++];
+        if (const std::optional<Node> shorthand = this->class_shorthand(character)) {
+            return *shorthand;
+        }
+        return Node{.kind = Node::Kind::Literal, .bytes = std::string(1, this->escaped_character(character))};
+    }
+
+    /**
+     * @brief Resolve a class shorthand such as "\d".
+     *
+     * @param character Character after the backslash (e.g., 'd').
+     *
+     * @return Class node, or std::nullopt if the character is not a shorthand.
+     */
+    [[nodiscard]] static std::optional<Node> class_shorthand(const char character)
+    {
+        switch (character) {
+        case 'd':
+            return make_class("0123456789", false);
+        case 'D':
+            return make_class("0123456789", true);
+        case 'w':
+            return make_class("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz_", false);
+        case 'W':
+            return make_class("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz_", true);
+        case 's':
+            return make_class(" \t\n\r\f\v", false);
+        case 'S':
+            return make_class(" \t\n\r\f\v", true);
+        default:
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * @brief Resolve an escaped literal character such as "\n" or "\.".
+     *
+     * @param character Character after the backslash (e.g., 'n').
+     *
+     * @return Character to match (e.g., '\n').
+     */
+    [[nodiscard]] char escaped_character(const char character) const
+    {
+        switch (character) {
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'f':
+            return '\f';
+        case 'v':
+            return '\v';
+        default:
+            break;
+        }
+        // Escaping letters and digits is reserved for future shorthands, everything else is taken literally
+        if ((character >= '0' && character <= '9') || (character >= 'A' && character <= 'Z') || (character >= 'a' && character <= 'z')) {
+            this->fail(std::format("unsupported escape '\\{}'", character));
+        }
+        return character;
+    }
+
+    /**
+     * @brief Parse a bracketed character class, after the opening '['.
+     *
+     * @return Class node.
+     */
+    [[nodiscard]] Node parse_class()
+    {
+        Node node{.kind = Node::Kind::Class};
+        const bool negated = this->consume('^');
+        bool first = true;
+
+        while (first || this->peek() != ']') {
+            if (this->at_end()) {
+                this->fail("unmatched '['");
+            }
+            first = false;
+
+            char low = this->pattern_[this->position_++];
+            if ((static_cast<unsigned char>(low) & 0x80u) != 0) {
+                this->fail("non-ASCII characters in classes are not supported");
+            }
+            if (low == '\\') {
+                if (this->at_end()) {
+                    this->fail("trailing '\\'");
+                }
+                const char escaped = this->pattern_[this->position_++];
+                if (const std::optional<Node> shorthand = this->class_shorthand(escaped)) {
+                    node.ascii |= shorthand->ascii;
+                    node.non_ascii |= shorthand->non_ascii;
+                    continue;
+                }
+                low = this->escaped_character(escaped);
+            }
+
+            // A '-' right before ']' is a literal dash, not a range
+            char high = low;
+            if (this->peek() == '-' && this->position_ + 1 < this->pattern_.size() && this->pattern_[this->position_ + 1] != ']') {
+                ++this->position_;
+                high = this->pattern_[this->position_++];
+                if (high == '\\') {
+                    if (this->at_end()) {
+                        this->fail("trailing '\\'");
+                    }
+                    high = this->escaped_character(this->pattern_[this->position_++]);
+                }
+                if ((static_cast<unsigned char>(high) & 0x80u) != 0) {
+                    this->fail("non-ASCII characters in classes are not supported");
+                }
+                if (high < low) {
+                    this->fail("class range is reversed");
+                }
+            }
+            for (int value = low; value <= high; ++value) {
+                node.ascii.set(static_cast<std::size_t>(value));
+            }
+        }
+        ++this->position_;  // Consume ']'
+
+        if (negated) {
+            node.ascii.flip();
+            node.non_ascii = !node.non_ascii;
+        }
+        return node;
+    }
+
+    /**
+     * @brief Pattern being parsed.
+     */
+    std::string_view pattern_;
+
+    /**
+     * @brief Offset of the next character to parse.
+     */
+    std::size_t position_ = 0;
+};
+
+/**
+ * @brief Emits instructions for a syntax tree, following Thompson's construction.
+ */
+class Compiler final {
+  public:
+    /**
+     * @brief Construct a new Compiler object.
+     *
+     * @param instructions Program to append instructions to.
+     */
+    explicit Compiler(std::vector<Instruction> &instructions)
+        : instructions_(instructions)
+    {
+    }
+
+    /**
+     * @brief Emit instructions that match a node.
+     *
+     * @param node Node to compile.
+     */
+    void emit(const Node &node)
+    {
+        switch (node.kind) {
+        case Node::Kind::Empty:
+            break;
+        case Node::Kind::Literal:
+            for (const char byte : node.bytes) {
+                this->emit_byte_range(static_cast<std::uint8_t>(byte), static_cast<std::uint8_t>(byte));
+            }
+            break;
+        case Node::Kind::Class:
+            this->emit_class(node);
+            break;
+        case Node::Kind::Concat:
+            for (const Node &child : node.children) {
+                this->emit(child);
+            }
+            break;
+        case Node::Kind::Alternate:
+            this->emit_alternation(node.children.size(), [this, &node](const std::size_t index) {
+                this->emit(node.children[index]);
+            });
+            break;
+        case Node::Kind::Repeat:
+            this->emit_repeat(node);
+            break;
+        case Node::Kind::LineStart:
+            this->push({.opcode = Instruction::Opcode::AssertLineStart});
+            break;
+        case Node::Kind::LineEnd:
+            this->push({.opcode = Instruction::Opcode::AssertLineEnd});
+            break;
+        }
+    }
+
+    /**
+     * @brief Append an instruction.
+     *
+     * @param instruction Instruction to append.
+     *
+     * @return Index of the appended instruction.
+     */
+    std::uint32_t push(const Instruction &instruction)
+    {
+        this->instructions_.push_back(instruction);
+        return this->current_index() - 1;
+    }
+
+  private:
+    /**
+     * @brief Return the index the next instruction will get.
+     *
+     * @return Instruction index.
+     */
+    [[nodiscard]] std::uint32_t current_index() const
+    {
+        return static_cast<std::uint32_t>(this->instructions_.size());
+    }
+
+    /**
+     * @brief Emit an instruction that consumes one byte in a range.
+     *
+     * @param low Lowest accepted byte.
+     * @param high Highest accepted byte.
+     */
+    void emit_byte_range(const std::uint8_t low,
+                         const std::uint8_t high)
+    {
+        this->push({.opcode = Instruction::Opcode::ByteRange, .low = low, .high = high});
+    }
+
+    /**
+     * @brief Emit a prioritized choice between branches.
+     *
+     * @param count Number of branches.
+     * @param emit_branch Function that emits the branch with the given index.
+     */
+    void emit_alternation(const std::size_t count,
+                          const std::function<void(std::size_t)> &emit_branch)
+    {
+        std::vector<std::uint32_t> jumps_to_end;
+        for (std::size_t index = 0; index + 1 < count; ++index) {
+            const std::uint32_t split = this->push({.opcode = Instruction::Opcode::Split});
+            this->instructions_[split].x = this->current_index();
+            emit_branch(index);
+            jumps_to_end.push_back(this->push({.opcode = Instruction::Opcode::Jump}));
+            this->instructions_[split].y = this->current_index();
+        }
+        if (count != 0) {
+            emit_branch(count - 1);
+        }
+        for (const std::uint32_t jump : jumps_to_end) {
+            this->instructions_[jump].x = this->current_index();
+        }
+    }
+
+    /**
+     * @brief Emit a character class as a choice between byte ranges and, optionally, any multi-byte UTF-8 sequence.
+     *
+     * @param node Class node.
+     */
+    void emit_class(const Node &node)
+    {
+        // Collapse the ASCII bitset into contiguous ranges
+        std::vector<std::pair<std::uint8_t, std::uint8_t>> ranges;
+        for (std::size_t value = 0; value < 128; ++value) {
+            if (!node.ascii.test(value)) {
+                continue;
+            }
+            if (!ranges.empty() && ranges.back().second + 1u == value) {
+                ranges.back().second = static_cast<std::uint8_t>(value);
+            }
+            else {
+                ranges.emplace_back(static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value));
+            }
+        }
+
+        const std::size_t branch_count = ranges.size() + (node.non_ascii ? 3 : 0);
+        if (branch_count == 0) {
+            // A class that matches nothing, such as "[^\x00-\x7F]" without non-ASCII support, compiles to a range that never matches
+            this->emit_byte_range(1, 0);
+            return;
+        }
+
+        this->emit_alternation(branch_count, [this, &ranges](const std::size_t index) {
+            if (index < ranges.size()) {
+                this->emit_byte_range(ranges[index].first, ranges[index].second);
+                return;
+            }
+            // Well-formed 2, 3 and 4 byte UTF-8 sequences, by lead byte
+            const std::size_t continuation_count = index - ranges.size() + 1;
+            static constexpr std::uint8_t lead_low[] = {0xC2, 0xE0, 0xF0};
+            static constexpr std::uint8_t lead_high[] = {0xDF, 0xEF, 0xF4};
+            this->emit_byte_range(lead_low[continuation_count - 1], lead_high[continuation_count - 1]);
+            for (std::size_t i = 0; i < continuation_count; ++i) {
+                this->emit_byte_range(0x80, 0xBF);
+            }
+        });
+    }
+
+    /**
+     * @brief Emit a repetition by expanding it into mandatory copies followed by optional copies or a loop.
+     *
+     * @param node Repeat node.
+     */
+    void emit_repeat(const Node &node)
+    {
+        const Node &child = node.children.front();
+        for (std::size_t i = 0; i < node.min; ++i) {
+            this->emit(child);
+        }
+
+        if (node.max == UNBOUNDED) {
+            // Loop: split between another iteration and leaving
+            const std::uint32_t split = this->push({.opcode = Instruction::Opcode::Split});
+            const std::uint32_t body = this->current_index();
+            this->emit(child);
+            this->push({.opcode = Instruction::Opcode::Jump, .x = split});
+            this->set_split_targets(split, body, this->current_index(), node.greedy);
+            return;
+        }
+
+        // Optional copies: each split either continues with another copy or skips all remaining ones
+        std::vector<std::uint32_t> splits;
+        for (std::size_t i = node.min; i < node.max; ++i) {
+            const std::uint32_t split = this->push({.opcode = Instruction::Opcode::Split});
+            this->instructions_[split].x = this->current_index();
+            splits.push_back(split);
+            this->emit(child);
+        }
+        for (const std::uint32_t split : splits) {
+            this->set_split_targets(split, this->instructions_[split].x, this->current_index(), node.greedy);
+        }
+    }
+
+    /**
+     * @brief Set the targets of a split, in the order given by the greediness.
+     *
+     * @param split Index of the split instruction.
+     * @param repeat Target that repeats the sub-expression.
+     * @param leave Target that leaves the repetition.
+     * @param greedy Whether repeating is preferred over leaving.
+     */
+    void set_split_targets(const std::uint32_t split,
+                           const std::uint32_t repeat,
+                           const std::uint32_t leave,
+                           const bool greedy)
+    {
+        this->instructions_[split].x = greedy ? repeat : leave;
+        this->instructions_[split].y = greedy ? leave : repeat;
+    }
+
+    /**
+     * @brief Program being appended to.
+     */
+    std::vector<Instruction> &instructions_;
+};
+
+/**
+ * @brief Compute every byte a non-empty match starting at an instruction can begin with.
+ *
+ * Assertions are treated as always passing, which can only add bytes, so the result is a safe prefilter.
+ *
+ * @param instructions Program instructions.
+ * @param entry Instruction to start at.
+ *
+ * @return Set of possible first bytes.
+ */
+[[nodiscard]] std::bitset<256> first_bytes(const std::vector<Instruction> &instructions,
+                                           const std::uint32_t entry)
+{
+    std::bitset<256> bytes;
+    std::vector<bool> visited(instructions.size(), false);
+    std::vector<std::uint32_t> stack{entry};
+    while (!stack.empty()) {
+        const std::uint32_t pc = stack.back();
+        stack.pop_back();
+        if (visited[pc]) {
+            continue;
+        }
+        visited[pc] = true;
+
+        const Instruction &instruction = instructions[pc];
+        switch (instruction.opcode) {
+        case Instruction::Opcode::ByteRange:
+            for (unsigned value = instruction.low; value <= instruction.high; ++value) {
+                bytes.set(value);
+            }
+            break;
+        case Instruction::Opcode::Split:
+            stack.push_back(instruction.y);
+            stack.push_back(instruction.x);
+            break;
+        case Instruction::Opcode::Jump:
+            stack.push_back(instruction.x);
+            break;
+        case Instruction::Opcode::AssertLineStart:
+        case Instruction::Opcode::AssertLineEnd:
+            stack.push_back(pc + 1);
+            break;
+        case Instruction::Opcode::Match:
+            break;
+        }
+    }
+    return bytes;
+}
+
+/**
+ * @brief Check whether a position is at the end of a line.
+ *
+ * @param text Text being searched.
+ * @param position Byte offset to check.
+ *
+ * @return True at the end of the text or before "\n" or "\r\n", false otherwise.
+ */
+[[nodiscard]] bool is_line_end(const std::string_view text,
+                               const std::size_t position)
+{
+    if (position >= text.size() || text[position] == '\n') {
+        return true;
+    }
+    return text[position] == '\r' && position + 1 < text.size() && text[position + 1] == '\n';
+}
+
+}  // namespace
+
+Program::Program(const std::span<const Pattern> patterns)
+{
+    Compiler compiler{this->instructions_};
+    for (std::size_t index = 0; index < patterns.size(); ++index) {
+        const Pattern &pattern = patterns[index];
+        if (pattern.expression.empty()) {
+            throw std::invalid_argument(std::format("Pattern {} is empty", index));
+        }
+
+        const auto entry = static_cast<std::uint32_t>(this->instructions_.size());
+        if (pattern.is_literal) {
+            compiler.emit(Node{.kind = Node::Kind::Literal, .bytes = std::string{pattern.expression}});
+        }
+        else {
+            compiler.emit(Parser{pattern.expression}.parse());
+        }
+        compiler.push({.opcode = Instruction::Opcode::Match, .x = static_cast<std::uint32_t>(index)});
+
+        // Collect the fixed bytes every match starts with, so candidates can be verified with a comparison before any thread is started
+        Entry entry_point{.pc = entry, .prefix_offset = static_cast<std::uint32_t>(this->literal_prefixes_.size())};
+        for (std::uint32_t pc = entry; this->instructions_[pc].opcode == Instruction::Opcode::ByteRange && this->instructions_[pc].low == this->instructions_[pc].high; ++pc) {
+            this->literal_prefixes_.push_back(static_cast<char>(this->instructions_[pc].low));
+            ++entry_point.prefix_size;
+        }
+
+        const std::bitset<256> bytes = first_bytes(this->instructions_, entry);
+        for (std::size_t byte = 0; byte < bytes.size(); ++byte) {
+            if (bytes.test(byte)) {
+                this->entries_by_first_byte_[byte].push_back(entry_point);
+            }
+        }
+    }
+}
+
+void Matcher::ThreadList::clear()
+{
+    this->threads.clear();
+    // Bump the generation to invalidate every "visited" entry at once; reset on the (practically unreachable) wrap-around
+    if (++this->generation == 0) {
+        std::fill(this->visited.begin(), this->visited.end(), 0);
+        this->generation = 1;
+    }
+}
+
+Matcher::Matcher(const Program &program)
+    : program_(program)
+{
+    const std::size_t size = program.instructions().size();
+    this->current_.visited.assign(size, 0);
+    this->next_.visited.assign(size, 0);
+    this->current_.threads.reserve(size);
+    this->next_.threads.reserve(size);
+    this->stack_.reserve(size);
+}
+
+void Matcher::add_thread(ThreadList &list,
+                         const std::uint32_t pc,
+                         const std::size_t begin,
+                         const std::string_view text,
+                         const std::size_t position)
+{
+    const std::vector<Instruction> &instructions = this->program_.instructions();
+    this->stack_.clear();
+    this->stack_.push_back(pc);
+    while (!this->stack_.empty()) {
+        const std::uint32_t current = this->stack_.back();
+        this->stack_.pop_back();
+        if (list.visited[current] == list.generation) {
+            continue;
+        }
+        list.visited[current] = list.generation;
+
+        const Instruction &instruction = instructions[current];
+        switch (instruction.opcode) {
+        case Instruction::Opcode::Split:
+            // Push the lower-priority target first, so the higher-priority one is explored first
+            this->stack_.push_back(instruction.y);
+            this->stack_.push_back(instruction.x);
+            break;
+        case Instruction::Opcode::Jump:
+            this->stack_.push_back(instruction.x);
+            break;
+        case Instruction::Opcode::AssertLineStart:
+            if (position == 0 || text[position - 1] == '\n') {
+                this->stack_.push_back(current + 1);
+            }
+            break;
+        case Instruction::Opcode::AssertLineEnd:
+            if (is_line_end(text, position)) {
+                this->stack_.push_back(current + 1);
+            }
+            break;
+        case Instruction::Opcode::ByteRange:
+        case Instruction::Opcode::Match:
+            list.threads.push_back({current, begin});
+            break;
+        }
+    }
+}
+
+std::optional<Match> Matcher::find(const std::string_view text,
+                                   const std::size_t start,
+                                   const std::size_t limit)
+{
+    const std::vector<Instruction> &instructions = this->program_.instructions();
+    const auto *bytes = reinterpret_cast<const unsigned char *>(text.data());
+    const std::size_t size = text.size();
+    const std::size_t start_limit = std::min(limit, size);
+    std::optional<Match> best;
+
+    this->current_.clear();
+    for (std::size_t position = start; position <= size; ++position) {
+        // Start new threads until a match is found; later starts have lower priority, which makes the match leftmost
+        if (!best) {
+            if (this->current_.threads.empty()) {
+                // Nothing is running, so skip every byte that cannot begin a match
+                while (position < start_limit && this->program_.entries_for(bytes[position]).empty()) {
+                    ++position;
+                }
+                if (position >= start_limit) {
+                    break;
+                }
+            }
+            if (position < start_limit) {
+                for (const Entry &entry : this->program_.entries_for(bytes[position])) {
+                    // Most candidates of literal-heavy rule sets fail on their prefix, which is far cheaper to compare than to simulate
+                    if (!text.substr(position).starts_with(this->program_.literal_prefix(entry))) {
+                        continue;
+                    }
+                    this->add_thread(this->current_, entry.pc, position, text, position);
+                }
+            }
+        }
+        if (this->current_.threads.empty()) {
+            if (best) {
+                break;
+            }
+            // Every new thread failed an assertion, forget them and try the next position
+            this->current_.clear();
+            continue;
+        }
+
+        // Advance every thread by one byte, in priority order
+        this->next_.clear();
+        for (const Thread &thread : this->current_.threads) {
+            const Instruction &instruction = instructions[thread.pc];
+            if (instruction.opcode == Instruction::Opcode::Match) {
+                if (thread.begin == position) {
+                    continue;  // Empty matches are never reported
+                }
+                // Lower-priority threads can only produce less preferred matches, so they are dropped
+                best = Match{.begin = thread.begin, .end = position, .pattern_index = instruction.x};
+                break;
+            }
+            if (position < size && bytes[position] >= instruction.low && bytes[position] <= instruction.high) {
+                this->add_thread(this->next_, thread.pc + 1, thread.begin, text, position + 1);
+            }
+        }
+        std::swap(this->current_, this->next_);
+    }
+
+    return best;
+}
+
+}  // namespace core::regex
@@ -0,0 +1,291 @@
+/**
+ * @file regex.hpp
+ *
+ * @brief Linear-time regular expression engine that matches many patterns in a single scan.
+ */
+
+#pragma once
+
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint32_t
+#include <optional>     // for std::optional
+#include <span>         // for std::span
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+namespace core::regex {
+
+/**
+ * @brief Pattern to compile into a program.
+ */
+struct Pattern {
+    /**
+     * @brief Pattern text (e.g., "[ \t]+$" or "As an AI").
+     */
+    std::string_view expression;
+
+    /**
+     * @brief Whether the expression is matched literally (true) or parsed as a regular expression (false).
+     */
+    bool is_literal = false;
+};
+
+/**
+ * @brief Non-empty match found by a "Matcher".
+ */
+struct Match {
+    /**
+     * @brief Byte offset of the first byte of the match.
+     */
+    std::size_t begin = 0;
+
+    /**
+     * @brief Byte offset one past the last byte of the match.
+     */
+    std::size_t end = 0;
+
+    /**
+     * @brief Index of the matching pattern in the span passed to "Program".
+     */
+    std::size_t pattern_index = 0;
+};
+
+/**
+ * @brief Single instruction of a compiled program.
+ */
+struct Instruction {
+    /**
+     * @brief Operation performed by the instruction.
+     */
+    enum class Opcode : std::uint8_t {
+        ByteRange,        // Consume one byte in [low, high], then continue at the next instruction
+        Split,            // Continue at "x" and, with lower priority, at "y"
+        Jump,             // Continue at "x"
+        AssertLineStart,  // Continue only at the start of the text or after "\n"
+        AssertLineEnd,    // Continue only at the end of the text or before "\n" or "\r\n"
+        Match,            // Report a match of pattern "x"
+    };
+
+    /**
+     * @brief Operation performed by the instruction.
+     */
+    Opcode opcode = Opcode::Match;
+
+    /**
+     * @brief Lowest accepted byte, used by "ByteRange".
+     */
+    std::uint8_t low = 0;
+
+    /**
+     * @brief Highest accepted byte, used by "ByteRange".
+     */
+    std::uint8_t high = 0;
+
+    /**
+     * @brief Jump target ("Split", "Jump") or pattern index ("Match").
+     */
+    std::uint32_t x = 0;
+
+    /**
+     * @brief Second, lower-priority jump target ("Split").
+     */
+    std::uint32_t y = 0;
+};
+
+/**
+ * @brief Entry point of a pattern in a compiled program.
+ */
+struct Entry {
+    /**
+     * @brief Index of the pattern's first instruction.
+     */
+    std::uint32_t pc = 0;
+
+    /**
+     * @brief Offset of the pattern's literal prefix in the program's concatenated prefixes.
+     */
+    std::uint32_t prefix_offset = 0;
+
+    /**
+     * @brief Length of the literal prefix that every match of the pattern starts with, 0 if it does not start with a fixed byte.
+     */
+    std::uint32_t prefix_size = 0;
+};
+
+/**
+ * @brief Compiled set of patterns, immutable and safe to share between threads.
+ *
+ * Supported syntax: literal characters, ".", "[...]" and "[^...]" with ASCII ranges, "\d \w \s" and their negations, "^" and "$" (per line), "(...)" and "(?:...)" (both non-capturing), "|", and the greedy or lazy ("?" suffix) quantifiers "* + ? {n} {n,} {n,m}".
+ * Non-ASCII characters are matched as whole UTF-8 sequences, so "." and negated classes never split a character.
+ */
+class Program final {
+  public:
+    /**
+     * @brief Compile patterns into a single program.
+     *
+     * @param patterns Patterns to compile, earlier patterns take priority when several match at the same position.
+     *
+     * @throws std::invalid_argument if a pattern is empty or has invalid syntax.
+     */
+    explicit Program(const std::span<const Pattern> patterns);
+
+    /**
+     * @brief Return the instructions of the program.
+     *
+     * @return All instructions.
+     */
+    [[nodiscard]] const std::vector<Instruction> &instructions() const
+    {
+        return this->instructions_;
+    }
+
+    /**
+     * @brief Return the entry points of the patterns that can begin with the given byte.
+     *
+     * @param byte First byte of a candidate match.
+     *
+     * @return Entry points in pattern priority order, empty if no pattern can begin with this byte.
+     */
+    [[nodiscard]] std::span<const Entry> entries_for(const unsigned char byte) const
+    {
+        return this->entries_by_first_byte_[byte];
+    }
+
+    /**
+     * @brief Return the literal prefix of an entry point.
+     *
+     * @param entry Entry point returned by "entries_for()".
+     *
+     * @return Bytes every match of the pattern starts with (e.g., "As an AI" for "As an AI(?: language model)?"), may be empty.
+     */
+    [[nodiscard]] std::string_view literal_prefix(const Entry &entry) const
+    {
+        return std::string_view{this->literal_prefixes_}.substr(entry.prefix_offset, entry.prefix_size);
+    }
+
+  private:
+    /**
+     * @brief All instructions, every pattern ends with a "Match" instruction.
+     */
+    std::vector<Instruction> instructions_;
+
+    /**
+     * @brief Entry points of the patterns, indexed by every byte a match of the pattern can begin with.
+     *
+     * Dispatching on the first byte replaces a split over all patterns and doubles as a prefilter: positions whose byte begins no pattern are skipped without starting the machine.
+     */
+    std::array<std::vector<Entry>, 256> entries_by_first_byte_;
+
+    /**
+     * @brief Literal prefixes of all patterns, concatenated; stored as offsets so the program stays valid when moved.
+     */
+    std::string literal_prefixes_;
+};
+
+/**
+ * @brief Finds matches of a program, keeping scratch memory between searches.
+ *
+ * The matcher simulates all patterns in lockstep (a Pike VM), so every byte of the text is examined a bounded number of times regardless of the patterns; there is no backtracking.
+ */
+class Matcher final {
+  public:
+    /**
+     * @brief Construct a new Matcher object.
+     *
+     * @param program Program to run, must outlive the matcher.
+     */
+    explicit Matcher(const Program &program);
+
+    /**
+     * @brief Find the leftmost non-empty match, preferring earlier patterns and, within a pattern, the Perl-style (leftmost-first) alternative.
+     *
+     * @param text Text to search (e.g., "trailing   \nspace").
+     * @param start Byte offset where the search starts; "^" still inspects the byte before it.
+     * @param limit Byte offset before which a match must begin, although it may end after it; "$" still inspects the bytes after it (e.g., "42").
+     *
+     * @return Match, or std::nullopt if there is none.
+     */
+    [[nodiscard]] std::optional<Match> find(const std::string_view text,
+                                            const std::size_t start = 0,
+                                            const std::size_t limit = std::string_view::npos);
+
+  private:
+    /**
+     * @brief Running thread of the machine.
+     */
+    struct Thread {
+        /**
+         * @brief Index of the next instruction.
+         */
+        std::uint32_t pc;
+
+        /**
+         * @brief Byte offset where the thread's match began.
+         */
+        std::size_t begin;
+    };
+
+    /**
+     * @brief Ordered list of threads with at most one thread per instruction.
+     */
+    struct ThreadList {
+        /**
+         * @brief Threads in priority order.
+         */
+        std::vector<Thread> threads;
+
+        /**
+         * @brief Generation in which each instruction was last added, compared against "generation".
+         */
+        std::vector<std::uint32_t> visited;
+
+        /**
+         * @brief Current generation, bumped instead of clearing "visited".
+         */
+        std::uint32_t generation = 0;
+
+        /**
+         * @brief Remove all threads.
+         */
+        void clear();
+    };
+
+    /**
+     * @brief Add a thread and everything reachable from it without consuming a byte, in priority order.
+     *
+     * @param list List to add to.
+     * @param pc Instruction to start at.
+     * @param begin Byte offset where the thread's match began.
+     * @param text Text being searched, used to evaluate assertions.
+     * @param position Byte offset the thread is at.
+     */
+    void add_thread(ThreadList &list,
+                    const std::uint32_t pc,
+                    const std::size_t begin,
+                    const std::string_view text,
+                    const std::size_t position);
+
+    /**
+     * @brief Program to run.
+     */
+    const Program &program_;
+
+    /**
+     * @brief Threads at the current position.
+     */
+    ThreadList current_;
+
+    /**
+     * @brief Threads at the next position.
+     */
+    ThreadList next_;
+
+    /**
+     * @brief Explicit stack for "add_thread()", avoiding recursion on long alternations.
+     */
+    std::vector<std::uint32_t> stack_;
+};
+
+}  // namespace core::regex
@@ -0,0 +1,156 @@
+/**
+ * @file rules.cpp
+ */
+
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t
+#include <cstring>      // for std::memcpy
+#include <optional>     // for std::optional
+#include <span>         // for std::span
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::move
+#include <vector>       // for std::vector
+
+#include "core/diff.hpp"
+#include "core/markdown.hpp"
+#include "core/regex.hpp"
+#include "core/rules.hpp"
+
+namespace core::rules {
+
+namespace {
+
+/**
+ * @brief Call a function for every match outside the verbatim ranges, in order, resuming the search after each match.
+ *
+ * The search stops at the start of every verbatim range and resumes at its end, so the range is never scanned.
+ *
+ * @param matcher Matcher of the rule set's program.
+ * @param text Text to search.
+ * @param verbatim Sorted, non-overlapping ranges to skip.
+ * @param function Function that receives every match (e.g., "[](const regex::Match &match) {}").
+ */
+template <typename Function>
+void for_each_match(regex::Matcher &matcher,
+                    const std::string_view text,
+                    const std::span<const markdown::Range> verbatim,
+                    Function &&function)
+{
+    std::size_t position = 0;
+    std::size_t next_range = 0;
+    while (true) {
+        while (next_range < verbatim.size() && verbatim[next_range].end <= position) {
+            ++next_range;
+        }
+        const bool has_range = next_range < verbatim.size();
+        if (has_range && position >= verbatim[next_range].begin) {
+            position = verbatim[next_range].end;
+            continue;
+        }
+
+        const std::size_t limit = has_range ? verbatim[next_range].begin : std::string_view::npos;
+        const std::optional<regex::Match> match = matcher.find(text, position, limit);
+        if (!match) {
+            if (!has_range) {
+                return;
+            }
+            position = verbatim[next_range].end;
+            continue;
+        }
+
+        // A match that runs into a verbatim range is dropped, a later one may still fit before the range
+        if (match->end > limit) [[unlikely]] {
+            position = match->begin + 1;
+            continue;
+        }
+        function(*match);
+        position = match->end;
+    }
+}
+
+}  // namespace
+
+RuleSet::RuleSet(std::vector<Rule> rules)
+    : rules_(std::move(rules)),
+      program_(to_patterns(this->rules_))
+{
+}
+
+std::vector<regex::Pattern> RuleSet::to_patterns(const std::vector<Rule> &rules)
+{
+    std::vector<regex::Pattern> patterns;
+    patterns.reserve(rules.size());
+    for (const Rule &rule : rules) {
+        patterns.push_back({.expression = rule.pattern, .is_literal = !rule.is_regex});
+    }
+    return patterns;
+}
+
+std::size_t RuleSet::apply(std::string &text,
+                          const std::span<const markdown::Range> verbatim) const
+{
+    // Copy the unchanged spans and the replacements into a fresh buffer, so every byte is moved exactly once
+    regex::Matcher matcher{this->program_};
+    std::string result;
+    std::size_t copied_until = 0;
+    std::size_t count = 0;
+    for_each_match(matcher, text, verbatim, [this, &text, &result, &copied_until, &count](const regex::Match &match) {
+        if (count == 0) [[unlikely]] {
+            result.reserve(text.size());
+        }
+        result.append(text, copied_until, match.begin - copied_until);
+        result.append(this->rules_[match.pattern_index].replacement);
+        copied_until = match.end;
+        ++count;
+    });
+    if (count == 0) [[likely]] {
+        return 0;
+    }
+    result.append(text, copied_until);
+    text.swap(result);
+
+    return count;
+}
+
+std::size_t RuleSet::apply_to(const std::string_view input,
+                              char *output,
+                              const std::size_t capacity,
+                              regex::Matcher &matcher,
+                              const std::span<const markdown::Range> verbatim) const
+{
+    // Copy what still fits and keep counting past the end, so the caller learns the size it needs
+    std::size_t written = 0;
+    const auto emit = [output, capacity, &written](const std::string_view bytes) {
+        if (written < capacity) {
+            std::memcpy(output + written, bytes.data(), std::min(bytes.size(), capacity - written));
+        }
+        written += bytes.size();
+    };
+
+    std::size_t copied_until = 0;
+    for_each_match(matcher, input, verbatim, [this, &input, &emit, &copied_until](const regex::Match &match) {
+        emit(input.substr(copied_until, match.begin - copied_until));
+        emit(this->rules_[match.pattern_index].replacement);
+        copied_until = match.end;
+    });
+    emit(input.substr(copied_until));
+
+    return written;
+}
+
+std::vector<diff::Change> RuleSet::find_changes(const std::string_view text,
+                                                const std::span<const markdown::Range> verbatim) const
+{
+    regex::Matcher matcher{this->program_};
+    std::vector<diff::Change> changes;
+    for_each_match(matcher, text, verbatim, [this, &text, &changes](const regex::Match &match) {
+        const std::string &replacement = this->rules_[match.pattern_index].replacement;
+        if (text.substr(match.begin, match.end - match.begin) != replacement) {
+            changes.push_back({.begin = match.begin, .end = match.end, .replacement = replacement});
+        }
+    });
+    return changes;
+}
+
+}  // namespace core::rules
@@ -0,0 +1,141 @@
+/**
+ * @file rules.hpp
+ *
+ * @brief Rewrite rules that are applied together in a single pass over the text.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <span>         // for std::span
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "core/diff.hpp"
+#include "core/markdown.hpp"
+#include "core/regex.hpp"
+
+namespace core::rules {
+
+/**
+ * @brief Single rewrite rule.
+ */
+struct Rule {
+    /**
+     * @brief Text or regular expression to find (e.g., "—" or "[ \t]+$").
+     */
+    std::string pattern;
+
+    /**
+     * @brief Text that replaces every match, taken literally (e.g., "-").
+     */
+    std::string replacement;
+
+    /**
+     * @brief Whether "pattern" is a regular expression (true) or literal text (false).
+     */
+    bool is_regex = false;
+};
+
+/**
+ * @brief Set of rules compiled once into a single program.
+ *
+ * Applying the set scans the text once, no matter how many rules it holds. At every position the earliest match wins; if several rules match at the same position, the rule listed first wins. Verbatim ranges (e.g., code found by "markdown::find_verbatim_ranges()") are skipped without being scanned, and a match that would overlap one is dropped.
+ */
+class RuleSet final {
+  public:
+    /**
+     * @brief Construct a new RuleSet object.
+     *
+     * @param rules Rules in priority order.
+     *
+     * @throws std::invalid_argument if a pattern is empty or is an invalid regular expression.
+     */
+    explicit RuleSet(std::vector<Rule> rules);
+
+    /**
+     * @brief Apply all rules to the text in place.
+     *
+     * The output is built in a single pass into a new buffer, and the text is left untouched if nothing matches. Replacements are not scanned again.
+     *
+     * @param text String to modify in place (e.g., "Hello — world   ").
+     * @param verbatim Sorted, non-overlapping ranges of the text that are copied unchanged (e.g., {{.begin = 0, .end = 5}}).
+     *
+     * @return Number of replacements made (e.g., "2").
+     */
+    std::size_t apply(std::string &text,
+                      const std::span<const markdown::Range> verbatim = {}) const;
+
+    /**
+     * @brief Apply all rules to the input and write the result into a caller-provided buffer.
+     *
+     * @param input Text to rewrite (e.g., "Hello — world").
+     * @param output Buffer that receives the result, not null-terminated; it must not overlap the input. May be null if "capacity" is 0.
+     * @param capacity Size of the output buffer, in bytes (e.g., "64").
+     * @param matcher Matcher created for "program()", reused across calls to avoid allocating.
+     * @param verbatim Sorted, non-overlapping ranges of the input that are copied unchanged (e.g., {{.begin = 0, .end = 5}}).
+     *
+     * @return Size of the full result, in bytes (e.g., "13"). If this exceeds "capacity", only the first "capacity" bytes were written.
+     */
+    [[nodiscard]] std::size_t apply_to(const std::string_view input,
+                                       char *output,
+                                       const std::size_t capacity,
+                                       regex::Matcher &matcher,
+                                       const std::span<const markdown::Range> verbatim = {}) const;
+
+    /**
+     * @brief List the replacements that "apply()" would make, without modifying the text.
+     *
+     * Matches whose replacement equals the matched text are left out, as they would not change anything.
+     *
+     * @param text Text to scan (e.g., "Hello — world").
+     * @param verbatim Sorted, non-overlapping ranges of the text that are left alone (e.g., {{.begin = 0, .end = 5}}).
+     *
+     * @return Changes sorted by position (e.g., {{.begin = 6, .end = 9, .replacement = "-"}}).
+     */
+    [[nodiscard]] std::vector<diff::Change> find_changes(const std::string_view text,
+                                                         const std::span<const markdown::Range> verbatim = {}) const;
+
+    /**
+     * @brief Return the compiled program, e.g., to create a matcher for "apply_to()".
+     *
+     * @return Compiled program.
+     */
+    [[nodiscard]] const regex::Program &program() const
+    {
+        return this->program_;
+    }
+
+    /**
+     * @brief Return the number of rules.
+     *
+     * @return Number of rules (e.g., "48").
+     */
+    [[nodiscard]] std::size_t size() const
+    {
+        return this->rules_.size();
+    }
+
+  private:
+    /**
+     * @brief Build the patterns that are compiled into the program.
+     *
+     * @param rules Rules to convert.
+     *
+     * @return One pattern per rule, referencing the rules' strings.
+     */
+    [[nodiscard]] static std::vector<regex::Pattern> to_patterns(const std::vector<Rule> &rules);
+
+    /**
+     * @brief Rules in priority order.
+     */
+    std::vector<Rule> rules_;
+
+    /**
+     * @brief All rules compiled into one program, the pattern index of a match is the rule index.
+     */
+    regex::Program program_;
+};
+
+}  // namespace core::rules
@@ -0,0 +1,240 @@
+/**
+ * @file search.cpp
+ */
+
+#include <bit>          // for std::countr_zero
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <cstring>      // for std::memchr, std::memcmp
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define UNGPT_SEARCH_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define UNGPT_SEARCH_NEON
+#include <arm_neon.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "core/search.hpp"
+
+namespace core::search {
+
+namespace {
+
+/**
+ * @brief Convert an ASCII uppercase letter to lowercase, leaving every other byte unchanged.
+ *
+ * @param character Byte to convert (e.g., 'A').
+ *
+ * @return Converted byte (e.g., 'a').
+ */
+[[nodiscard]] constexpr unsigned char to_lower_ascii(const unsigned char character)
+{
+    return (character >= 'A' && character <= 'Z') ? static_cast<unsigned char>(character + ('a' - 'A')) : character;
+}
+
+/**
+ * @brief Convert an ASCII lowercase letter to uppercase, leaving every other byte unchanged.
+ *
+ * @param character Byte to convert (e.g., 'a').
+ *
+ * @return Converted byte (e.g., 'A').
+ */
+[[nodiscard]] constexpr unsigned char to_upper_ascii(const unsigned char character)
+{
+    return (character >= 'a' && character <= 'z') ? static_cast<unsigned char>(character - ('a' - 'A')) : character;
+}
+
+#if defined(UNGPT_SEARCH_SSE2)
+/**
+ * @brief Load 16 bytes from an address without any alignment requirement.
+ *
+ * @param address Address of the first byte.
+ *
+ * @return Loaded vector.
+ */
+[[nodiscard]] inline __m128i load_unaligned(const char *address)
+{
+    return _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(address)));
+}
+#endif
+
+}  // namespace
+
+Searcher::Searcher(const std::string_view pattern,
+                   const bool case_sensitive)
+    : pattern_(pattern),
+      case_sensitive_(case_sensitive)
+{
+}
+
+bool Searcher::matches_at(const char *candidate) const
+{
+    if (this->case_sensitive_) {
+        return std::memcmp(candidate, this->pattern_.data(), this->pattern_.size()) == 0;
+    }
+    for (std::size_t i = 0; i < this->pattern_.size(); ++i) {
+        if (to_lower_ascii(static_cast<unsigned char>(candidate[i])) != to_lower_ascii(static_cast<unsigned char>(this->pattern_[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t Searcher::find(const std::string_view text,
+                           const std::size_t start) const
+{
+    const std::size_t pattern_size = this->pattern_.size();
+    if (pattern_size == 0 || start > text.size() || text.size() - start < pattern_size) {
+        return std::string_view::npos;
+    }
+
+    const char *data = text.data();
+    const std::size_t last_start = text.size() - pattern_size;  // Last position where a match still fits
+    std::size_t i = start;
+
+    // Both spellings of the first and last byte; identical when searching case-sensitively or for non-letters
+    const auto first = static_cast<unsigned char>(this->pattern_.front());
+    const auto last = static_cast<unsigned char>(this->pattern_.back());
+    const unsigned char first_a = this->case_sensitive_ ? first : to_lower_ascii(first);
+    const unsigned char first_b = this->case_sensitive_ ? first : to_upper_ascii(first);
+    const unsigned char last_a = this->case_sensitive_ ? last : to_lower_ascii(last);
+    const unsigned char last_b = this->case_sensitive_ ? last : to_upper_ascii(last);
+
+#if defined(UNGPT_SEARCH_SSE2)
+    // Filter 16 candidate positions at once: a candidate survives only if both its first and last byte match
+    const __m128i first_a_vector = _mm_set1_epi8(static_cast<char>(first_a));
+    const __m128i first_b_vector = _mm_set1_epi8(static_cast<char>(first_b));
+    const __m128i last_a_vector = _mm_set1_epi8(static_cast<char>(last_a));
+    const __m128i last_b_vector = _mm_set1_epi8(static_cast<char>(last_b));
+    while (i + 15 <= last_start) {
+        const __m128i block_first = load_unaligned(data + i);
+        const __m128i block_last = load_unaligned(data + i + pattern_size - 1);
+        const __m128i first_equal = _mm_or_si128(_mm_cmpeq_epi8(block_first, first_a_vector),
+                                                 _mm_cmpeq_epi8(block_first, first_b_vector));
+        const __m128i last_equal = _mm_or_si128(_mm_cmpeq_epi8(block_last, last_a_vector),
+                                                _mm_cmpeq_epi8(block_last, last_b_vector));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(first_equal, last_equal)));
+        while (mask != 0) {
+            const auto offset = static_cast<std::size_t>(std::countr_zero(mask));
+            if (this->matches_at(data + i + offset)) {
+                return i + offset;
+            }
+            mask &= mask - 1;  // Clear the lowest set bit
+        }
+        i += 16;
+    }
+#elif defined(UNGPT_SEARCH_NEON)
+    // Same filter as the SSE2 path; NEON has no movemask, so each lane is narrowed to a nibble of a 64-bit mask
+    const uint8x16_t first_a_vector = vdupq_n_u8(first_a);
+    const uint8x16_t first_b_vector = vdupq_n_u8(first_b);
+    const uint8x16_t last_a_vector = vdupq_n_u8(last_a);
+    const uint8x16_t last_b_vector = vdupq_n_u8(last_b);
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(data);
+    while (i + 15 <= last_start) {
+        const uint8x16_t block_first = vld1q_u8(bytes + i);
+        const uint8x16_t block_last = vld1q_u8(bytes + i + pattern_size - 1);
+        const uint8x16_t first_equal = vorrq_u8(vceqq_u8(block_first, first_a_vector), vceqq_u8(block_first, first_b_vector));
+        const uint8x16_t last_equal = vorrq_u8(vceqq_u8(block_last, last_a_vector), vceqq_u8(block_last, last_b_vector));
+        const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(vandq_u8(first_equal, last_equal)), 4);
+        std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ULL;
+        while (mask != 0) {
+            const auto offset = static_cast<std::size_t>(std::countr_zero(mask)) / 4;
+            if (this->matches_at(data + i + offset)) {
+                return i + offset;
+            }
+            mask &= mask - 1;  // Clear the lowest set bit
+        }
+        i += 16;
+    }
+#endif
+
+    // Handle the tail (or everything, without SIMD); memchr is vectorized by the C library for the case-sensitive path
+    if (first_a == first_b) {
+        while (i <= last_start) {
+            const void *found = std::memchr(data + i, first_a, last_start - i + 1);
+            if (found == nullptr) {
+                break;
+            }
+            i = static_cast<std::size_t>(static_cast<const char *>(found) - data);
+            if (this->matches_at(data + i)) {
+                return i;
+            }
+            ++i;
+        }
+    }
+    else {
+        for (; i <= last_start; ++i) {
+            const auto first_character = static_cast<unsigned char>(data[i]);
+            const auto last_character = static_cast<unsigned char>(data[i + pattern_size - 1]);
+            if ((first_character == first_a || first_character == first_b) &&
+                (last_character == last_a || last_character == last_b) &&
+                this->matches_at(data + i)) {
+                return i;
+            }
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+std::vector<std::size_t> find_all(const std::string_view text,
+                                  const std::string_view pattern,
+                                  const bool case_sensitive)
+{
+    std::vector<std::size_t> matches;
+    const Searcher searcher{pattern, case_sensitive};
+    for (std::size_t pos = searcher.find(text); pos != std::string_view::npos; pos = searcher.find(text, pos + pattern.size())) {
+        matches.push_back(pos);
+    }
+    return matches;
+}
+
+std::size_t count_matches(const std::string_view text,
+                          const std::string_view pattern,
+                          const bool case_sensitive)
+{
+    std::size_t count = 0;
+    const Searcher searcher{pattern, case_sensitive};
+    for (std::size_t pos = searcher.find(text); pos != std::string_view::npos; pos = searcher.find(text, pos + pattern.size())) {
+        ++count;
+    }
+    return count;
+}
+
+std::size_t replace_all(std::string &text,
+                        const std::string_view pattern,
+                        const std::string_view replacement,
+                        const bool case_sensitive)
+{
+    const Searcher searcher{pattern, case_sensitive};
+    std::size_t pos = searcher.find(text);
+    if (pos == std::string_view::npos) {
+        return 0;
+    }
+
+    // Copy the unchanged spans and the replacements into a fresh buffer, so every byte is moved exactly once
+    std::string result;
+    result.reserve(text.size());
+    std::size_t copied_until = 0;
+    std::size_t count = 0;
+    while (pos != std::string_view::npos) {
+        result.append(text, copied_until, pos - copied_until);
+        result.append(replacement);
+        copied_until = pos + pattern.size();
+        ++count;
+        pos = searcher.find(text, copied_until);
+    }
+    result.append(text, copied_until);
+    text.swap(result);
+
+    SPDLOG_DEBUG("Replaced '{}' occurrences, resulting length: {}", count, text.size());
+    return count;
+}
+
+}  // namespace core::search
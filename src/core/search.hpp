@@ -0,0 +1,118 @@
+/**
+ * @file search.hpp
+ *
+ * @brief Fast substring search and single-pass replacement for large texts.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+namespace core::search {
+
+/**
+ * @brief Reusable substring searcher for a single pattern.
+ *
+ * Candidates are found by comparing the first and last byte of the pattern against 16 text positions at once (SSE2 on x86-64, NEON on ARM64, scalar elsewhere), and only candidates where both match are verified byte by byte.
+ * Case-insensitive search folds ASCII letters only; all other bytes, including UTF-8 sequences, must match exactly.
+ */
+class Searcher final {
+  public:
+    /**
+     * @brief Construct a new Searcher object.
+     *
+     * @param pattern Pattern to search for (e.g., "As an AI"). The searcher keeps a copy.
+     * @param case_sensitive Whether ASCII letters must match case exactly (true) or case is ignored (false).
+     */
+    explicit Searcher(const std::string_view pattern,
+                      const bool case_sensitive = true);
+
+    /**
+     * @brief Find the next occurrence of the pattern.
+     *
+     * @param text Text to search in (e.g., "hello world").
+     * @param start Byte offset where the search starts (e.g., "0").
+     *
+     * @return Byte offset of the match, or "std::string_view::npos" if there is none or the pattern is empty.
+     */
+    [[nodiscard]] std::size_t find(const std::string_view text,
+                                   const std::size_t start = 0) const;
+
+    /**
+     * @brief Return the pattern being searched for.
+     *
+     * @return Pattern passed to the constructor.
+     */
+    [[nodiscard]] std::string_view pattern() const
+    {
+        return this->pattern_;
+    }
+
+  private:
+    /**
+     * @brief Check whether the pattern matches the text at the given position.
+     *
+     * @param candidate Pointer to the first byte of the candidate match, at least "pattern_.size()" bytes must be readable.
+     *
+     * @return True if the pattern matches, false otherwise.
+     */
+    [[nodiscard]] bool matches_at(const char *candidate) const;
+
+    /**
+     * @brief Pattern being searched for.
+     */
+    std::string pattern_;
+
+    /**
+     * @brief Whether ASCII letters must match case exactly.
+     */
+    bool case_sensitive_;
+};
+
+/**
+ * @brief Find all non-overlapping occurrences of a pattern, scanning left to right.
+ *
+ * @param text Text to search in (e.g., "aaaa").
+ * @param pattern Pattern to search for (e.g., "aa").
+ * @param case_sensitive Whether ASCII letters must match case exactly.
+ *
+ * @return Byte offsets of all matches (e.g., {0, 2}), or an empty vector if the pattern is empty.
+ */
+[[nodiscard]] std::vector<std::size_t> find_all(const std::string_view text,
+                                                const std::string_view pattern,
+                                                const bool case_sensitive = true);
+
+/**
+ * @brief Count all non-overlapping occurrences of a pattern, without storing their offsets.
+ *
+ * @param text Text to search in (e.g., "aaaa").
+ * @param pattern Pattern to search for (e.g., "aa").
+ * @param case_sensitive Whether ASCII letters must match case exactly.
+ *
+ * @return Number of matches (e.g., "2").
+ */
+[[nodiscard]] std::size_t count_matches(const std::string_view text,
+                                        const std::string_view pattern,
+                                        const bool case_sensitive = true);
+
+/**
+ * @brief Replace all non-overlapping occurrences of a pattern in place.
+ *
+ * The result is built in a single pass into a new buffer, which then replaces the text, instead of shifting the tail of the text once per match.
+ *
+ * @param text String to modify in place (e.g., "As an AI, as an AI").
+ * @param pattern Pattern to replace (e.g., "as an ai").
+ * @param replacement Replacement for every match (e.g., "I").
+ * @param case_sensitive Whether ASCII letters must match case exactly.
+ *
+ * @return Number of replacements (e.g., "2").
+ */
+std::size_t replace_all(std::string &text,
+                        const std::string_view pattern,
+                        const std::string_view replacement,
+                        const bool case_sensitive = true);
+
+}  // namespace core::search
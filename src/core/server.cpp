@@ -0,0 +1,501 @@
+/**
+ * @file server.cpp
+ */
+
+#include <cerrno>        // for errno, EAGAIN, EINTR
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint8_t, std::uint32_t, std::uint64_t
+#include <cstring>       // for std::memcpy
+#include <exception>     // for std::exception
+#include <filesystem>    // for std::filesystem
+#include <format>        // for std::format
+#include <mutex>         // for std::lock_guard
+#include <optional>      // for std::optional
+#include <stdexcept>     // for std::invalid_argument, std::runtime_error
+#include <string>        // for std::string
+#include <system_error>  // for std::error_code, std::system_category
+#include <utility>       // for std::move
+#include <vector>        // for std::vector
+
+#if defined(__linux__)
+#include <sys/epoll.h>    // for epoll_create1, epoll_ctl, epoll_wait
+#include <sys/eventfd.h>  // for eventfd
+#include <sys/socket.h>   // for socket, bind, listen, accept4, send, recv
+#include <sys/un.h>       // for sockaddr_un
+#include <unistd.h>       // for close, read, write
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "core/posix.hpp"
+#include "core/protocol.hpp"
+#include "core/server.hpp"
+#include "core/text.hpp"
+
+namespace core::server {
+
+namespace {
+
+/**
+ * @brief Identifier of the first accepted connection; lower values are reserved for the epoll tags of the listening socket and the eventfd.
+ */
+constexpr std::uint64_t FIRST_CONNECTION_ID = 2;
+
+#if defined(__linux__)
+
+/**
+ * @brief Epoll tag of the listening socket.
+ */
+constexpr std::uint64_t LISTEN_ID = 0;
+
+/**
+ * @brief Epoll tag of the wake-up eventfd.
+ */
+constexpr std::uint64_t WAKE_ID = 1;
+
+/**
+ * @brief Maximum number of unanswered requests per connection; reading pauses beyond that, so one client cannot queue unbounded work.
+ */
+constexpr std::uint64_t MAX_PIPELINED_REQUESTS = 1024;
+
+/**
+ * @brief Size of the buffer used for a single read.
+ */
+constexpr std::size_t READ_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * @brief Execute a request and encode its response.
+ *
+ * @param request Decoded request frame.
+ * @param cleanup_options Cleanup rules applied to "Normalize" requests.
+ *
+ * @return Encoded response frame; failures are reported with "Status::Error" rather than thrown.
+ */
+[[nodiscard]] std::string execute(protocol::Frame &request,
+                                  const text::CleanupOptions &cleanup_options)
+{
+    std::string response;
+    try {
+        switch (static_cast<protocol::Opcode>(request.kind)) {
+        case protocol::Opcode::Normalize:
+            text::remove_unwanted_characters(request.body, cleanup_options);
+            protocol::append_frame(response, static_cast<std::uint8_t>(protocol::Status::Ok), request.body);
+            break;
+        case protocol::Opcode::Count: {
+            std::string body;
+            protocol::append_u64(body, text::count_words(request.body));
+            protocol::append_u64(body, text::count_characters(request.body));
+            protocol::append_frame(response, static_cast<std::uint8_t>(protocol::Status::Ok), body);
+            break;
+        }
+        case protocol::Opcode::EstimateTokens: {
+            std::string body;
+            protocol::append_u64(body, text::estimate_tokens(request.body));
+            protocol::append_frame(response, static_cast<std::uint8_t>(protocol::Status::Ok), body);
+            break;
+        }
+        default:
+            protocol::append_frame(response, static_cast<std::uint8_t>(protocol::Status::Error), std::format("Unknown opcode '{}'", request.kind));
+            break;
+        }
+    }
+    catch (const std::exception &e) {
+        response.clear();
+        protocol::append_frame(response, static_cast<std::uint8_t>(protocol::Status::Error), e.what());
+    }
+    return response;
+}
+
+/**
+ * @brief Register, modify or remove the events of a file descriptor.
+ *
+ * @param epoll_fd Epoll instance.
+ * @param operation EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL.
+ * @param fd File descriptor to watch.
+ * @param events Events to watch for.
+ * @param id Tag returned by "epoll_wait" for this descriptor.
+ *
+ * @throws std::runtime_error if "epoll_ctl" fails.
+ */
+void control(const int epoll_fd,
+             const int operation,
+             const int fd,
+             const std::uint32_t events,
+             const std::uint64_t id)
+{
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = id;
+    if (epoll_ctl(epoll_fd, operation, fd, &event) != 0) [[unlikely]] {
+        posix::throw_errno("update epoll registration");
+    }
+}
+
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+
+Server::Server(const std::filesystem::path &socket_path,
+               const std::size_t thread_count,
+               const text::CleanupOptions &cleanup_options)
+    : socket_path_(socket_path),
+      cleanup_options_(cleanup_options),
+      next_connection_id_(FIRST_CONNECTION_ID),
+      pool_(thread_count)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = socket_path.string();
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument(std::format("Socket path '{}' must be between 1 and {} bytes long", path, sizeof(address.sun_path) - 1));
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    // Replace a socket left behind by a previous run that was killed before it could clean up
+    if (std::filesystem::is_socket(socket_path)) {
+        std::filesystem::remove(socket_path);
+    }
+
+    // From here on, the destructor will not run if anything throws, so release the descriptors by hand
+    try {
+        this->listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (this->listen_fd_ < 0) [[unlikely]] {
+            posix::throw_errno("create socket");
+        }
+        if (bind(this->listen_fd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) [[unlikely]] {
+            posix::throw_errno(std::format("bind '{}'", path));
+        }
+        if (listen(this->listen_fd_, SOMAXCONN) != 0) [[unlikely]] {
+            posix::throw_errno("listen");
+        }
+
+        this->epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (this->epoll_fd_ < 0) [[unlikely]] {
+            posix::throw_errno("create epoll instance");
+        }
+        this->wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (this->wake_fd_ < 0) [[unlikely]] {
+            posix::throw_errno("create eventfd");
+        }
+
+        control(this->epoll_fd_, EPOLL_CTL_ADD, this->listen_fd_, EPOLLIN, LISTEN_ID);
+        control(this->epoll_fd_, EPOLL_CTL_ADD, this->wake_fd_, EPOLLIN, WAKE_ID);
+    }
+    catch (...) {
+        for (const int fd : {this->wake_fd_, this->epoll_fd_, this->listen_fd_}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        throw;
+    }
+
+    SPDLOG_INFO("Listening on '{}' with '{}' workers", path, this->pool_.size());
+}
+
+Server::~Server()
+{
+    // Let in-flight requests finish first, they post to "completions_" and signal "wake_fd_"
+    this->pool_.wait();
+
+    for (const auto &[id, connection] : this->connections_) {
+        close(connection.fd);
+    }
+    close(this->wake_fd_);
+    close(this->epoll_fd_);
+    close(this->listen_fd_);
+
+    std::error_code ec;
+    std::filesystem::remove(this->socket_path_, ec);
+
+    SPDLOG_DEBUG("Closed socket '{}'", this->socket_path_.string());
+}
+
+void Server::run()
+{
+    std::vector<epoll_event> events(64);
+
+    while (!this->is_stopping_.load()) {
+        const int count = epoll_wait(this->epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            posix::throw_errno("wait for events");
+        }
+
+        for (std::size_t i = 0; i < static_cast<std::size_t>(count); ++i) {
+            const std::uint64_t id = events[i].data.u64;
+            const std::uint32_t flags = events[i].events;
+
+            if (id == LISTEN_ID) {
+                this->accept_connections();
+                continue;
+            }
+            if (id == WAKE_ID) {
+                std::uint64_t value = 0;
+                static_cast<void>(read(this->wake_fd_, &value, sizeof(value)));
+                this->collect_completions();
+                continue;
+            }
+
+            // An earlier event in this batch may already have closed the connection
+            const auto it = this->connections_.find(id);
+            if (it == this->connections_.end()) {
+                continue;
+            }
+            Connection &connection = it->second;
+
+            // A hang-up means the client is gone entirely, so its remaining responses have nowhere to go
+            bool is_healthy = (flags & (EPOLLERR | EPOLLHUP)) == 0;
+            if (is_healthy && (flags & EPOLLIN) != 0) {
+                is_healthy = this->read_requests(id, connection);
+            }
+            if (is_healthy && (flags & EPOLLOUT) != 0) {
+                is_healthy = this->write_responses(connection);
+            }
+
+            if (is_healthy) {
+                this->update_connection(id, connection);
+            }
+            else {
+                this->close_connection(id);
+            }
+        }
+    }
+
+    SPDLOG_INFO("Stopped serving '{}'", this->socket_path_.string());
+}
+
+void Server::stop() noexcept
+{
+    // Only async-signal-safe operations here: a lock-free store and "write"
+    this->is_stopping_.store(true);
+    const std::uint64_t value = 1;
+    static_cast<void>(write(this->wake_fd_, &value, sizeof(value)));
+}
+
+void Server::accept_connections()
+{
+    while (true) {
+        const int fd = accept4(this->listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EAGAIN) {
+                return;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            // Running out of descriptors must not take the whole daemon down; the client will see the connection fail
+            SPDLOG_WARN("Failed to accept connection: {}", std::error_code{errno, std::system_category()}.message());
+            return;
+        }
+
+        const std::uint64_t id = this->next_connection_id_++;
+        Connection &connection = this->connections_[id];
+        connection.fd = fd;
+        connection.events = EPOLLIN;
+        control(this->epoll_fd_, EPOLL_CTL_ADD, fd, connection.events, id);
+        SPDLOG_DEBUG("Accepted connection '{}'", id);
+    }
+}
+
+bool Server::read_requests(const std::uint64_t id,
+                           Connection &connection)
+{
+    char buffer[READ_CHUNK_SIZE];
+    const ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+    if (received < 0) {
+        return errno == EAGAIN || errno == EINTR;
+    }
+    if (received == 0) {
+        connection.is_read_closed = true;
+        return true;
+    }
+    connection.decoder.feed({buffer, static_cast<std::size_t>(received)});
+    return this->submit_requests(id, connection);
+}
+
+bool Server::submit_requests(const std::uint64_t id,
+                             Connection &connection)
+{
+    // Decode every complete frame; a malformed stream cannot be resynchronized, so it ends the connection
+    try {
+        while (connection.next_sequence - connection.next_to_send < MAX_PIPELINED_REQUESTS) {
+            std::optional<protocol::Frame> frame = connection.decoder.next();
+            if (!frame) {
+                break;
+            }
+            const std::uint64_t sequence = connection.next_sequence++;
+            this->pool_.submit([this, id, sequence, request = std::move(*frame)]() mutable {
+                std::string response = execute(request, this->cleanup_options_);
+                {
+                    const std::lock_guard lock{this->completions_mutex_};
+                    this->completions_.push_back({.connection_id = id, .sequence = sequence, .response = std::move(response)});
+                }
+                const std::uint64_t value = 1;
+                static_cast<void>(write(this->wake_fd_, &value, sizeof(value)));
+            });
+        }
+    }
+    catch (const std::exception &e) {
+        SPDLOG_WARN("Closing connection '{}': {}", id, e.what());
+        return false;
+    }
+    return true;
+}
+
+bool Server::write_responses(Connection &connection)
+{
+    while (connection.output_offset < connection.output.size()) {
+        const ssize_t sent = send(connection.fd, connection.output.data() + connection.output_offset, connection.output.size() - connection.output_offset, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EAGAIN) {
+                return true;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        connection.output_offset += static_cast<std::size_t>(sent);
+    }
+    connection.output.clear();
+    connection.output_offset = 0;
+    return true;
+}
+
+void Server::collect_completions()
+{
+    std::vector<Completion> completions;
+    {
+        const std::lock_guard lock{this->completions_mutex_};
+        completions.swap(this->completions_);
+    }
+
+    for (Completion &completion : completions) {
+        const auto it = this->connections_.find(completion.connection_id);
+        if (it == this->connections_.end()) {
+            continue;
+        }
+        Connection &connection = it->second;
+        connection.finished.emplace(completion.sequence, std::move(completion.response));
+
+        // Release responses in request order; a later one waits for every earlier one
+        for (auto next = connection.finished.find(connection.next_to_send); next != connection.finished.end(); next = connection.finished.find(connection.next_to_send)) {
+            connection.output.append(next->second);
+            connection.finished.erase(next);
+            ++connection.next_to_send;
+        }
+    }
+
+    // Every released response frees a pipeline slot, so requests held back by the limit can go to the workers now
+    for (Completion &completion : completions) {
+        const auto it = this->connections_.find(completion.connection_id);
+        if (it != this->connections_.end() && !this->submit_requests(completion.connection_id, it->second)) {
+            this->close_connection(completion.connection_id);
+        }
+    }
+
+    // Write eagerly instead of waiting for EPOLLOUT, which saves a round trip through the event loop for every response
+    for (Completion &completion : completions) {
+        const auto it = this->connections_.find(completion.connection_id);
+        if (it == this->connections_.end()) {
+            continue;
+        }
+        if (this->write_responses(it->second)) {
+            this->update_connection(completion.connection_id, it->second);
+        }
+        else {
+            this->close_connection(completion.connection_id);
+        }
+    }
+}
+
+void Server::update_connection(const std::uint64_t id,
+                               Connection &connection)
+{
+    const bool has_output = connection.output_offset < connection.output.size();
+    const bool has_pending_requests = connection.next_to_send != connection.next_sequence;
+
+    // Once the client stopped sending and got every answer, the connection is done
+    if (connection.is_read_closed && !has_output && !has_pending_requests) {
+        this->close_connection(id);
+        return;
+    }
+
+    std::uint32_t events = 0;
+    if (!connection.is_read_closed && connection.next_sequence - connection.next_to_send < MAX_PIPELINED_REQUESTS) {
+        events |= EPOLLIN;
+    }
+    if (has_output) {
+        events |= EPOLLOUT;
+    }
+    if (events != connection.events) {
+        connection.events = events;
+        control(this->epoll_fd_, EPOLL_CTL_MOD, connection.fd, events, id);
+    }
+}
+
+void Server::close_connection(const std::uint64_t id)
+{
+    const auto it = this->connections_.find(id);
+    if (it == this->connections_.end()) {
+        return;
+    }
+    // Closing the descriptor also removes it from the epoll set
+    close(it->second.fd);
+    this->connections_.erase(it);
+    SPDLOG_DEBUG("Closed connection '{}'", id);
+}
+
+#else
+
+Server::Server(const std::filesystem::path &socket_path,
+               const std::size_t thread_count,
+               const text::CleanupOptions &cleanup_options)
+    : socket_path_(socket_path),
+      cleanup_options_(cleanup_options),
+      next_connection_id_(FIRST_CONNECTION_ID),
+      pool_(thread_count)
+{
+    throw std::runtime_error("The normalization daemon is only supported on Linux");
+}
+
+Server::~Server() = default;
+
+void Server::run() {}
+
+void Server::stop() noexcept {}
+
+void Server::accept_connections() {}
+
+bool Server::read_requests(const std::uint64_t,
+                           Connection &)
+{
+    return false;
+}
+
+bool Server::submit_requests(const std::uint64_t,
+                             Connection &)
+{
+    return false;
+}
+
+bool Server::write_responses(Connection &)
+{
+    return false;
+}
+
+void Server::collect_completions() {}
+
+void Server::update_connection(const std::uint64_t,
+                               Connection &) {}
+
+void Server::close_connection(const std::uint64_t) {}
+
+#endif
+
+}  // namespace core::server
@@ -0,0 +1,252 @@
+/**
+ * @file server.hpp
+ *
+ * @brief Long-lived normalization daemon listening on a Unix domain socket (Linux only).
+ */
+
+#pragma once
+
+#include <atomic>         // for std::atomic
+#include <cstddef>        // for std::size_t
+#include <cstdint>        // for std::uint64_t
+#include <filesystem>     // for std::filesystem::path
+#include <map>            // for std::map
+#include <mutex>          // for std::mutex
+#include <string>         // for std::string
+#include <unordered_map>  // for std::unordered_map
+#include <vector>         // for std::vector
+
+#include "core/protocol.hpp"
+#include "core/text.hpp"
+#include "core/thread_pool.hpp"
+
+namespace core::server {
+
+/**
+ * @brief Daemon that answers requests in the "core::protocol" format.
+ *
+ * A single thread runs an epoll event loop that accepts connections, decodes frames and writes responses; the text work itself runs on a fixed worker pool. Clients may pipeline requests: every request gets a sequence number and responses are written back strictly in that order, even when the workers finish them out of order.
+ */
+class Server final {
+  public:
+    /**
+     * @brief Construct a new Server object and start listening.
+     *
+     * A stale socket file left behind by a previous run is replaced.
+     *
+     * @param socket_path Path of the Unix domain socket (e.g., "/tmp/ungpt.sock").
+     * @param thread_count Number of workers (e.g., "8"), or 0 to use the number of hardware threads.
+     * @param cleanup_options Optional cleanup rules applied to "Normalize" requests.
+     *
+     * @throws std::invalid_argument if the socket path is too long.
+     * @throws std::runtime_error if the socket cannot be created, or the platform is not Linux.
+     */
+    explicit Server(const std::filesystem::path &socket_path,
+                    const std::size_t thread_count = 0,
+                    const text::CleanupOptions &cleanup_options = {});
+
+    /**
+     * @brief Close every connection and remove the socket file.
+     */
+    ~Server();
+
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    /**
+     * @brief Serve requests until "stop()" is called.
+     *
+     * @throws std::runtime_error if the event loop fails.
+     */
+    void run();
+
+    /**
+     * @brief Ask "run()" to return; safe to call from any thread and from a signal handler.
+     */
+    void stop() noexcept;
+
+  private:
+    /**
+     * @brief State of a single client connection.
+     */
+    struct Connection {
+        /**
+         * @brief Socket of the connection.
+         */
+        int fd = -1;
+
+        /**
+         * @brief Splits received bytes into request frames.
+         */
+        protocol::FrameDecoder decoder{};
+
+        /**
+         * @brief Encoded responses waiting to be written.
+         */
+        std::string output{};
+
+        /**
+         * @brief Number of bytes of "output" that were already written.
+         */
+        std::size_t output_offset = 0;
+
+        /**
+         * @brief Sequence number of the next request.
+         */
+        std::uint64_t next_sequence = 0;
+
+        /**
+         * @brief Sequence number of the next response to write.
+         */
+        std::uint64_t next_to_send = 0;
+
+        /**
+         * @brief Responses that finished ahead of an earlier request, by sequence number.
+         */
+        std::map<std::uint64_t, std::string> finished{};
+
+        /**
+         * @brief Whether the client closed its side of the connection.
+         */
+        bool is_read_closed = false;
+
+        /**
+         * @brief Events currently registered with epoll.
+         */
+        std::uint32_t events = 0;
+    };
+
+    /**
+     * @brief Response produced by a worker.
+     */
+    struct Completion {
+        /**
+         * @brief Connection that sent the request.
+         */
+        std::uint64_t connection_id = 0;
+
+        /**
+         * @brief Sequence number of the request.
+         */
+        std::uint64_t sequence = 0;
+
+        /**
+         * @brief Encoded response frame.
+         */
+        std::string response{};
+    };
+
+    /**
+     * @brief Accept every pending connection.
+     */
+    void accept_connections();
+
+    /**
+     * @brief Read from a connection and submit the complete requests to the workers.
+     *
+     * @param id Identifier of the connection.
+     * @param connection Connection to read from.
+     *
+     * @return False if the connection failed and must be closed, true otherwise.
+     */
+    bool read_requests(const std::uint64_t id,
+                       Connection &connection);
+
+    /**
+     * @brief Submit buffered complete requests to the workers, up to the pipelining limit.
+     *
+     * @param id Identifier of the connection.
+     * @param connection Connection whose requests to submit.
+     *
+     * @return False if the connection sent a malformed frame and must be closed, true otherwise.
+     */
+    bool submit_requests(const std::uint64_t id,
+                         Connection &connection);
+
+    /**
+     * @brief Write as much pending output as the socket accepts.
+     *
+     * @param connection Connection to write to.
+     *
+     * @return False if the connection failed and must be closed, true otherwise.
+     */
+    bool write_responses(Connection &connection);
+
+    /**
+     * @brief Move responses finished by the workers into their connections, in request order.
+     */
+    void collect_completions();
+
+    /**
+     * @brief Register the events a connection is currently interested in, or close it once it is done.
+     *
+     * @param id Identifier of the connection.
+     * @param connection Connection to update.
+     */
+    void update_connection(const std::uint64_t id,
+                           Connection &connection);
+
+    /**
+     * @brief Close a connection and forget it; responses still being computed for it are dropped.
+     *
+     * @param id Identifier of the connection.
+     */
+    void close_connection(const std::uint64_t id);
+
+    /**
+     * @brief Path of the Unix domain socket.
+     */
+    std::filesystem::path socket_path_;
+
+    /**
+     * @brief Cleanup rules applied to "Normalize" requests.
+     */
+    text::CleanupOptions cleanup_options_;
+
+    /**
+     * @brief Listening socket.
+     */
+    int listen_fd_ = -1;
+
+    /**
+     * @brief Epoll instance of the event loop.
+     */
+    int epoll_fd_ = -1;
+
+    /**
+     * @brief Eventfd used by the workers and "stop()" to wake up the event loop.
+     */
+    int wake_fd_ = -1;
+
+    /**
+     * @brief Whether "run()" should return.
+     */
+    std::atomic<bool> is_stopping_{false};
+
+    /**
+     * @brief Open connections by identifier; identifiers are never reused, so late responses for a closed connection cannot reach a new one.
+     */
+    std::unordered_map<std::uint64_t, Connection> connections_;
+
+    /**
+     * @brief Identifier of the next accepted connection.
+     */
+    std::uint64_t next_connection_id_;
+
+    /**
+     * @brief Guards "completions_".
+     */
+    std::mutex completions_mutex_;
+
+    /**
+     * @brief Responses finished by the workers that the event loop has not picked up yet.
+     */
+    std::vector<Completion> completions_;
+
+    /**
+     * @brief Workers, declared last so they are joined before anything they touch is destroyed.
+     */
+    thread_pool::ThreadPool pool_;
+};
+
+}  // namespace core::server
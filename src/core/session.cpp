@@ -0,0 +1,844 @@
+/**
+ * @file session.cpp
+ */
+
+#include <algorithm>     // for std::max, std::min, std::mismatch, std::sort
+#include <cerrno>        // for errno, EINTR, EWOULDBLOCK, EACCES
+#include <charconv>      // for std::from_chars
+#include <cstddef>       // for std::size_t, std::ptrdiff_t
+#include <cstdint>       // for std::uint64_t
+#include <cstdio>        // for SEEK_END
+#include <exception>     // for std::exception
+#include <filesystem>    // for std::filesystem
+#include <format>        // for std::format
+#include <fstream>       // for std::ifstream
+#include <iterator>      // for std::istreambuf_iterator
+#include <mutex>         // for std::lock_guard, std::unique_lock
+#include <memory>        // for std::make_unique
+#include <stdexcept>     // for std::runtime_error, std::out_of_range
+#include <string>        // for std::string, std::to_string
+#include <string_view>   // for std::string_view
+#include <system_error>  // for std::error_code, std::system_category
+#include <utility>       // for std::move, std::swap
+#include <vector>        // for std::vector
+
+#if defined(_WIN32)
+#include <fcntl.h>     // for _O_* flags
+#include <io.h>        // for _wopen, _wsopen_s, _write, _commit, _chsize_s, _lseeki64, _close
+#include <share.h>     // for _SH_DENYRW
+#include <sys/stat.h>  // for _S_IREAD, _S_IWRITE
+#else
+#include <fcntl.h>     // for open, O_* flags
+#include <sys/file.h>  // for flock, LOCK_EX, LOCK_NB
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for write, fsync, ftruncate, lseek, close
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "core/posix.hpp"
+#include "core/protocol.hpp"
+#include "core/session.hpp"
+
+namespace core::session {
+
+namespace {
+
+/**
+ * @brief Magic bytes at the start of a snapshot file.
+ */
+constexpr std::string_view SNAPSHOT_MAGIC = "UNGPTSNP";
+
+/**
+ * @brief Magic bytes at the start of a journal file.
+ */
+constexpr std::string_view JOURNAL_MAGIC = "UNGPTJNL";
+
+/**
+ * @brief Size of the snapshot header: magic, generation, and text size.
+ */
+constexpr std::size_t SNAPSHOT_HEADER_SIZE = 24;
+
+/**
+ * @brief Size of the journal header: magic and generation.
+ */
+constexpr std::size_t JOURNAL_HEADER_SIZE = 16;
+
+/**
+ * @brief Size of a journal record without the inserted bytes: offset, erased size, and inserted size before them, checksum after them.
+ */
+constexpr std::size_t RECORD_OVERHEAD = 32;
+
+/**
+ * @brief Name of the snapshot file inside the session directory.
+ */
+constexpr std::string_view SNAPSHOT_NAME = "snapshot";
+
+/**
+ * @brief Name of the journal file inside the session directory.
+ */
+constexpr std::string_view JOURNAL_NAME = "journal";
+
+/**
+ * @brief Name of the lock file inside the session directory.
+ */
+constexpr std::string_view LOCK_NAME = "lock";
+
+/**
+ * @brief Compute the 64-bit FNV-1a hash of bytes, used to detect journal records torn by a crash.
+ *
+ * @param bytes Bytes to hash (e.g., "hello").
+ *
+ * @return Hash of the bytes.
+ */
+[[nodiscard]] std::uint64_t fnv1a(const std::string_view bytes)
+{
+    std::uint64_t hash = 0xCBF29CE484222325ULL;  // FNV-1a offset basis
+    for (const char byte : bytes) {
+        hash ^= static_cast<unsigned char>(byte);
+        hash *= 0x100000001B3ULL;  // FNV-1a prime
+    }
+    return hash;
+}
+
+/**
+ * @brief Append an encoded journal record to a buffer.
+ *
+ * @param buffer Buffer to append to.
+ * @param edit Edit to encode.
+ */
+void append_record(std::string &buffer,
+                   const Edit &edit)
+{
+    const std::size_t begin = buffer.size();
+    protocol::append_u64(buffer, edit.offset);
+    protocol::append_u64(buffer, edit.erased);
+    protocol::append_u64(buffer, edit.inserted.size());
+    buffer += edit.inserted;
+    protocol::append_u64(buffer, fnv1a(std::string_view{buffer}.substr(begin)));
+}
+
+/**
+ * @brief Write-only file opened with the platform API, so its contents can be synced to disk.
+ */
+class File final {
+  public:
+    /**
+     * @brief Construct a closed File object.
+     */
+    File() = default;
+
+    /**
+     * @brief Open a file for writing, creating it if it does not exist.
+     *
+     * @param path Path to the file (e.g., "journal").
+     * @param truncate Whether to discard the existing contents.
+     *
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    File(const std::filesystem::path &path,
+         const bool truncate)
+    {
+#if defined(_WIN32)
+        this->fd_ = _wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : 0), _S_IREAD | _S_IWRITE);
+#else
+        this->fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0600);
+#endif
+        if (this->fd_ == -1) [[unlikely]] {
+            posix::throw_errno(std::format("open '{}'", path.string()));
+        }
+    }
+
+    ~File()
+    {
+        this->close();
+    }
+
+    File(const File &) = delete;
+    File &operator=(const File &) = delete;
+
+    File(File &&other) noexcept
+        : fd_(other.fd_)
+    {
+        other.fd_ = -1;
+    }
+
+    File &operator=(File &&other) noexcept
+    {
+        std::swap(this->fd_, other.fd_);
+        return *this;
+    }
+
+    /**
+     * @brief Write all bytes at the current position.
+     *
+     * @param bytes Bytes to write.
+     *
+     * @throws std::runtime_error if writing fails.
+     */
+    void write_all(std::string_view bytes)
+    {
+        while (!bytes.empty()) {
+#if defined(_WIN32)
+            const int written = _write(this->fd_, bytes.data(), static_cast<unsigned int>(std::min<std::size_t>(bytes.size(), 1 << 30)));
+#else
+            const ssize_t written = ::write(this->fd_, bytes.data(), bytes.size());
+#endif
+            if (written < 0) [[unlikely]] {
+                if (errno == EINTR) {
+                    continue;
+                }
+                posix::throw_errno("write the session");
+            }
+            bytes.remove_prefix(static_cast<std::size_t>(written));
+        }
+    }
+
+    /**
+     * @brief Flush the written bytes to the disk.
+     *
+     * @throws std::runtime_error if syncing fails.
+     */
+    void sync()
+    {
+#if defined(_WIN32)
+        if (_commit(this->fd_) != 0) [[unlikely]] {
+#else
+        if (fsync(this->fd_) != 0) [[unlikely]] {
+#endif
+            posix::throw_errno("sync the session");
+        }
+    }
+
+    /**
+     * @brief Cut the file to a size and move the position to its end.
+     *
+     * @param size New size of the file, in bytes.
+     *
+     * @throws std::runtime_error if the file cannot be resized.
+     */
+    void truncate_and_seek_end(const std::uint64_t size)
+    {
+#if defined(_WIN32)
+        if (_chsize_s(this->fd_, static_cast<long long>(size)) != 0 || _lseeki64(this->fd_, 0, SEEK_END) == -1) [[unlikely]] {
+#else
+        if (ftruncate(this->fd_, static_cast<off_t>(size)) != 0 || lseek(this->fd_, 0, SEEK_END) == -1) [[unlikely]] {
+#endif
+            posix::throw_errno("truncate the journal");
+        }
+    }
+
+  private:
+    /**
+     * @brief Close the file, if it is open.
+     */
+    void close() noexcept
+    {
+        if (this->fd_ != -1) {
+#if defined(_WIN32)
+            _close(this->fd_);
+#else
+            ::close(this->fd_);
+#endif
+            this->fd_ = -1;
+        }
+    }
+
+    /**
+     * @brief File descriptor, or -1 if closed.
+     */
+    int fd_ = -1;
+};
+
+/**
+ * @brief Sync a directory, so a file renamed into it survives a crash (no-op on Windows).
+ *
+ * @param directory Directory to sync.
+ */
+void sync_directory([[maybe_unused]] const std::filesystem::path &directory)
+{
+#if !defined(_WIN32)
+    const int fd = open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd != -1) {
+        fsync(fd);
+        ::close(fd);
+    }
+#endif
+}
+
+/**
+ * @brief Write a file atomically and durably: write and sync a temporary file, then rename it over the destination.
+ *
+ * @param path Destination (e.g., "snapshot").
+ * @param chunks Contents, written in order.
+ *
+ * @throws std::runtime_error if the file cannot be written or renamed.
+ */
+void write_durably(const std::filesystem::path &path,
+                   const std::vector<std::string_view> &chunks)
+{
+    const std::filesystem::path temporary_path = std::filesystem::path{path}.concat(".tmp");
+    {
+        File file{temporary_path, true};
+        for (const std::string_view chunk : chunks) {
+            file.write_all(chunk);
+        }
+        file.sync();
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary_path, path, ec);
+    if (ec) [[unlikely]] {
+        std::filesystem::remove(temporary_path, ec);
+        throw std::runtime_error(std::format("Failed to rename '{}' to '{}'", temporary_path.string(), path.string()));
+    }
+    sync_directory(path.parent_path());
+}
+
+/**
+ * @brief Create an empty journal for a snapshot generation, replacing the existing one, and open it for appending.
+ *
+ * @param directory Session directory.
+ * @param generation Generation of the snapshot the journal follows (e.g., "3").
+ *
+ * @return Journal positioned at its end.
+ *
+ * @throws std::runtime_error if the journal cannot be written.
+ */
+[[nodiscard]] File create_journal(const std::filesystem::path &directory,
+                                  const std::uint64_t generation)
+{
+    std::string header{JOURNAL_MAGIC};
+    protocol::append_u64(header, generation);
+    const std::filesystem::path path = directory / JOURNAL_NAME;
+    write_durably(path, {header});
+    File journal{path, false};
+    journal.truncate_and_seek_end(header.size());
+    return journal;
+}
+
+/**
+ * @brief Read a whole file into memory, memory-mapping it where supported.
+ *
+ * @param path Path to the file (e.g., "snapshot").
+ * @param text Receives the bytes after the first "skip" bytes.
+ * @param skip Number of leading bytes (the header) to validate separately and leave out of "text".
+ * @param header Receives the first "skip" bytes.
+ *
+ * @return False if the file does not exist, true otherwise.
+ *
+ * @throws std::runtime_error if the file exists but cannot be read.
+ */
+[[nodiscard]] bool read_file(const std::filesystem::path &path,
+                             std::string &text,
+                             const std::size_t skip,
+                             std::string &header)
+{
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+#if defined(_WIN32)
+    std::ifstream stream{path, std::ios::binary};
+    if (!stream) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to open '{}' for reading", path.string()));
+    }
+    std::string bytes{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    const std::size_t header_size = std::min(skip, bytes.size());
+    header.assign(bytes, 0, header_size);
+    bytes.erase(0, header_size);
+    text = std::move(bytes);
+#else
+    // Map the file instead of reading it through a stream, so it is copied exactly once, straight into the text
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) [[unlikely]] {
+        posix::throw_errno(std::format("open '{}'", path.string()));
+    }
+    struct stat status{};
+    if (fstat(fd, &status) != 0) [[unlikely]] {
+        ::close(fd);
+        posix::throw_errno(std::format("stat '{}'", path.string()));
+    }
+    const auto size = static_cast<std::size_t>(status.st_size);
+    if (size == 0) {
+        ::close(fd);
+        header.clear();
+        text.clear();
+        return true;
+    }
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) [[unlikely]] {
+        posix::throw_errno(std::format("map '{}'", path.string()));
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    const std::string_view bytes{static_cast<const char *>(mapping), size};
+    const std::size_t header_size = std::min(skip, bytes.size());
+    header.assign(bytes.substr(0, header_size));
+    text.assign(bytes.substr(header_size));
+    munmap(mapping, size);
+#endif
+    return true;
+}
+
+/**
+ * @brief State of a session directory after restoring it.
+ */
+struct Restored {
+    /**
+     * @brief Restored text.
+     */
+    std::string text{};
+
+    /**
+     * @brief Generation of the snapshot, or 0 if there is none.
+     */
+    std::uint64_t generation = 0;
+
+    /**
+     * @brief Size of the snapshot text, in bytes.
+     */
+    std::size_t snapshot_size = 0;
+
+    /**
+     * @brief Size of the valid part of the journal, including its header, or 0 if it is missing or belongs to another generation.
+     */
+    std::uint64_t journal_end = 0;
+
+    /**
+     * @brief Number of record bytes replayed from the journal.
+     */
+    std::size_t journal_size = 0;
+};
+
+/**
+ * @brief Restore the snapshot and replay the journal of a session directory.
+ *
+ * @param directory Session directory.
+ *
+ * @return Restored state.
+ *
+ * @throws std::runtime_error if the snapshot is corrupt or cannot be read.
+ */
+[[nodiscard]] Restored restore_session(const std::filesystem::path &directory)
+{
+    Restored restored;
+    std::string header;
+
+    // Snapshot, which is always complete because it is renamed into place
+    if (read_file(directory / SNAPSHOT_NAME, restored.text, SNAPSHOT_HEADER_SIZE, header)) {
+        if (header.size() != SNAPSHOT_HEADER_SIZE || !header.starts_with(SNAPSHOT_MAGIC) ||
+            protocol::read_u64(header, 16) != restored.text.size()) [[unlikely]] {
+            throw std::runtime_error(std::format("Session snapshot in '{}' is corrupt", directory.string()));
+        }
+        restored.generation = protocol::read_u64(header, 8);
+        restored.snapshot_size = restored.text.size();
+    }
+
+    // Journal, which is only valid if it follows this exact snapshot; a crash between writing a snapshot and resetting the journal leaves an older one behind
+    std::string journal;
+    if (!read_file(directory / JOURNAL_NAME, journal, JOURNAL_HEADER_SIZE, header) ||
+        header.size() != JOURNAL_HEADER_SIZE || !header.starts_with(JOURNAL_MAGIC) ||
+        protocol::read_u64(header, 8) != restored.generation) {
+        return restored;
+    }
+
+    // Replay the records up to the first one that is incomplete or does not match its checksum, which is where a crash cut the journal
+    std::size_t position = 0;
+    while (journal.size() - position >= RECORD_OVERHEAD) {
+        const std::uint64_t offset = protocol::read_u64(journal, position);
+        const std::uint64_t erased = protocol::read_u64(journal, position + 8);
+        const std::uint64_t inserted_size = protocol::read_u64(journal, position + 16);
+        if (inserted_size > journal.size() - position - RECORD_OVERHEAD) {
+            break;
+        }
+        const std::size_t record_size = RECORD_OVERHEAD + static_cast<std::size_t>(inserted_size);
+        const std::string_view record = std::string_view{journal}.substr(position, record_size - 8);
+        if (protocol::read_u64(journal, position + record_size - 8) != fnv1a(record)) {
+            break;
+        }
+        if (offset > restored.text.size() || erased > restored.text.size() - offset) {
+            break;
+        }
+        restored.text.replace(static_cast<std::size_t>(offset), static_cast<std::size_t>(erased), record.substr(24));
+        position += record_size;
+    }
+    if (position != journal.size()) {
+        SPDLOG_WARN("Discarded '{}' bytes of a torn session journal", journal.size() - position);
+    }
+    restored.journal_end = JOURNAL_HEADER_SIZE + position;
+    restored.journal_size = position;
+    return restored;
+}
+
+/**
+ * @brief Lock a session directory, so no other instance writes to it at the same time.
+ *
+ * @param directory Session directory.
+ *
+ * @return File descriptor of the lock file, which holds the lock until it is closed.
+ *
+ * @throws std::runtime_error if another instance holds the lock, or the lock file cannot be opened.
+ */
+[[nodiscard]] int lock_directory(const std::filesystem::path &directory)
+{
+    const std::filesystem::path path = directory / LOCK_NAME;
+#if defined(_WIN32)
+    // Denying every other open of the file is the closest to an advisory lock
+    int fd = -1;
+    if (_wsopen_s(&fd, path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _SH_DENYRW, _S_IREAD | _S_IWRITE) != 0) {
+        if (errno == EACCES) {
+            throw std::runtime_error(std::format("Session in '{}' is used by another instance", directory.string()));
+        }
+        posix::throw_errno(std::format("open '{}'", path.string()));
+    }
+#else
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd == -1) [[unlikely]] {
+        posix::throw_errno(std::format("open '{}'", path.string()));
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        const std::error_code ec{errno, std::system_category()};
+        ::close(fd);
+        if (ec.value() == EWOULDBLOCK) {
+            throw std::runtime_error(std::format("Session in '{}' is used by another instance", directory.string()));
+        }
+        throw std::runtime_error(std::format("Failed to lock '{}': {}", path.string(), ec.message()));
+    }
+#endif
+    return fd;
+}
+
+/**
+ * @brief Release the lock of a session directory.
+ *
+ * @param fd File descriptor returned by "lock_directory()".
+ */
+void unlock_directory(const int fd) noexcept
+{
+#if defined(_WIN32)
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+/**
+ * @brief Parse the name of a document subdirectory.
+ *
+ * @param name Name of the subdirectory (e.g., "3").
+ *
+ * @return Number of the subdirectory, or 0 if the name is not a positive decimal number (e.g., "lock").
+ */
+[[nodiscard]] std::size_t parse_slot(const std::string &name)
+{
+    std::size_t slot = 0;
+    const auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), slot);
+    return ec == std::errc{} && end == name.data() + name.size() ? slot : 0;
+}
+
+}  // namespace
+
+Edit find_edit(const std::string_view before,
+               const std::string_view after)
+{
+    // Common prefix, then the common suffix of what is left, so the two never overlap
+    const std::size_t shorter = std::min(before.size(), after.size());
+    const std::size_t prefix = static_cast<std::size_t>(std::mismatch(before.cbegin(), before.cbegin() + static_cast<std::ptrdiff_t>(shorter), after.cbegin()).first - before.cbegin());
+    const std::size_t suffix_limit = shorter - prefix;
+    const std::size_t suffix = static_cast<std::size_t>(std::mismatch(before.crbegin(), before.crbegin() + static_cast<std::ptrdiff_t>(suffix_limit), after.crbegin()).first - before.crbegin());
+
+    return {
+        .offset = prefix,
+        .erased = before.size() - prefix - suffix,
+        .inserted = std::string{after.substr(prefix, after.size() - prefix - suffix)},
+    };
+}
+
+void apply_edit(std::string &text,
+                const Edit &edit)
+{
+    if (edit.offset > text.size() || edit.erased > text.size() - edit.offset) [[unlikely]] {
+        throw std::out_of_range(std::format("Edit at '{}' erasing '{}' bytes does not fit a text of '{}' bytes", edit.offset, edit.erased, text.size()));
+    }
+    text.replace(edit.offset, edit.erased, edit.inserted);
+}
+
+std::string restore(const std::filesystem::path &directory)
+{
+    return restore_session(directory).text;
+}
+
+Journal::Journal(const std::filesystem::path &directory)
+    : directory_(directory)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(this->directory_, ec);
+    if (ec) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to create directory '{}': {}", this->directory_.string(), ec.message()));
+    }
+
+    Restored restored = restore_session(this->directory_);
+    this->shadow_ = std::move(restored.text);
+    this->snapshot_size_ = restored.snapshot_size;
+    this->journal_size_ = restored.journal_size;
+    SPDLOG_DEBUG("Restored '{}' bytes from the session (snapshot generation '{}', '{}' journal bytes)", this->shadow_.size(), restored.generation, this->journal_size_);
+
+    this->thread_ = std::jthread{[this, generation = restored.generation, journal_end = restored.journal_end] {
+        this->run(generation, journal_end);
+    }};
+}
+
+Journal::~Journal()
+{
+    // Compact on a clean exit, so the next start only has to map the snapshot
+    try {
+        if (this->journal_size_ != 0) {
+            this->request_snapshot();
+        }
+    }
+    catch (const std::exception &e) {
+        SPDLOG_ERROR("Failed to compact the session: {}", e.what());
+    }
+    {
+        const std::lock_guard lock{this->mutex_};
+        this->is_stopping_ = true;
+    }
+    this->condition_.notify_all();
+    this->thread_.join();
+}
+
+void Journal::record(const std::string_view text)
+{
+    Edit edit = find_edit(this->shadow_, text);
+    if (edit.erased == 0 && edit.inserted.empty()) {
+        return;
+    }
+    apply_edit(this->shadow_, edit);
+    this->journal_size_ += RECORD_OVERHEAD + edit.inserted.size();
+    {
+        const std::lock_guard lock{this->mutex_};
+        if (!this->error_.empty()) [[unlikely]] {
+            return;
+        }
+        this->queue_.push_back({.is_snapshot = false, .edit = std::move(edit), .text = {}});
+        ++this->queued_count_;
+    }
+    this->condition_.notify_all();
+
+    // Compact once replaying the journal would cost more than reading the snapshot, which keeps restoring proportional to the text size
+    if (this->journal_size_ > std::max(MIN_COMPACTION_SIZE, this->snapshot_size_)) {
+        this->request_snapshot();
+    }
+}
+
+void Journal::flush()
+{
+    std::unique_lock lock{this->mutex_};
+    const std::uint64_t target = this->queued_count_;
+    this->is_flush_requested_ = true;
+    this->condition_.notify_all();
+    this->condition_.wait(lock, [this, target] { return this->synced_count_ >= target || !this->error_.empty(); });
+    this->is_flush_requested_ = false;
+    if (!this->error_.empty()) [[unlikely]] {
+        throw std::runtime_error(this->error_);
+    }
+}
+
+void Journal::discard()
+{
+    this->journal_size_ = 0;
+    const std::lock_guard lock{this->mutex_};
+    this->queue_.clear();
+}
+
+void Journal::request_snapshot()
+{
+    // Copying the text here is amortized, as it happens only after at least as many bytes were journaled
+    std::string text = this->shadow_;
+    this->snapshot_size_ = text.size();
+    this->journal_size_ = 0;
+    {
+        const std::lock_guard lock{this->mutex_};
+        if (!this->error_.empty()) [[unlikely]] {
+            return;
+        }
+        this->queue_.push_back({.is_snapshot = true, .edit = {}, .text = std::move(text)});
+        ++this->queued_count_;
+    }
+    this->condition_.notify_all();
+}
+
+void Journal::run(std::uint64_t generation,
+                  const std::uint64_t journal_end)
+{
+    try {
+        // Resume after the last valid record, which drops a torn tail, or start a journal for the current snapshot
+        File journal;
+        if (journal_end != 0) {
+            journal = File{this->directory_ / JOURNAL_NAME, false};
+            journal.truncate_and_seek_end(journal_end);
+        }
+        else {
+            journal = create_journal(this->directory_, generation);
+        }
+
+        std::vector<Entry> batch;
+        std::string buffer;
+        std::unique_lock lock{this->mutex_};
+        while (true) {
+            this->condition_.wait(lock, [this] { return !this->queue_.empty() || this->is_stopping_; });
+            if (this->queue_.empty()) {
+                break;
+            }
+            std::swap(batch, this->queue_);
+            const std::uint64_t batch_end = this->queued_count_;
+            lock.unlock();
+
+            // Encode every edit of the batch into a single write, a snapshot supersedes the edits before it
+            buffer.clear();
+            for (Entry &entry : batch) {
+                if (entry.is_snapshot) {
+                    buffer.clear();
+                    ++generation;
+                    std::string header{SNAPSHOT_MAGIC};
+                    protocol::append_u64(header, generation);
+                    protocol::append_u64(header, entry.text.size());
+                    write_durably(this->directory_ / SNAPSHOT_NAME, {header, entry.text});
+                    journal = create_journal(this->directory_, generation);
+                    SPDLOG_DEBUG("Compacted the session into a '{}' byte snapshot (generation '{}')", entry.text.size(), generation);
+                }
+                else {
+                    append_record(buffer, entry.edit);
+                }
+            }
+            journal.write_all(buffer);
+            journal.sync();
+            batch.clear();
+
+            lock.lock();
+            this->synced_count_ = batch_end;
+            this->condition_.notify_all();
+
+            // Let edits accumulate for a while, so a burst of keystrokes shares the next fsync
+            this->condition_.wait_for(lock, SYNC_INTERVAL, [this] { return this->is_stopping_ || this->is_flush_requested_; });
+        }
+    }
+    catch (const std::exception &e) {
+        SPDLOG_ERROR("Session persistence stopped: {}", e.what());
+        const std::lock_guard lock{this->mutex_};
+        this->error_ = e.what();
+        this->queue_.clear();
+        this->condition_.notify_all();
+    }
+}
+
+Session::Session(const std::filesystem::path &directory)
+    : directory_(directory)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(this->directory_, ec);
+    if (ec) [[unlikely]] {
+        throw std::runtime_error(std::format("Failed to create directory '{}': {}", this->directory_.string(), ec.message()));
+    }
+    this->lock_fd_ = lock_directory(this->directory_);
+
+    // Restore the documents in the order they were created, which is the order of their tabs
+    std::vector<std::size_t> slots;
+    for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator{this->directory_, ec}) {
+        const std::size_t slot = parse_slot(entry.path().filename().string());
+        if (slot != 0 && entry.is_directory(ec)) {
+            slots.push_back(slot);
+        }
+    }
+    std::sort(slots.begin(), slots.end());
+    for (const std::size_t slot : slots) {
+        this->next_slot_ = slot + 1;
+        const std::filesystem::path path = this->directory_ / std::to_string(slot);
+        try {
+            auto journal = std::make_unique<Journal>(path);
+            if (journal->restored_text().empty()) {
+                journal->discard();
+                journal.reset();
+                std::filesystem::remove_all(path, ec);
+                continue;
+            }
+            this->restored_.push_back({.slot = slot, .journal = std::move(journal)});
+        }
+        catch (const std::exception &e) {
+            SPDLOG_ERROR("Failed to restore the session document in '{}': {}", path.string(), e.what());
+        }
+    }
+    SPDLOG_DEBUG("Restored '{}' documents from the session", this->restored_.size());
+}
+
+Session::~Session()
+{
+    // Every journal writes its remaining edits while the directory is still locked
+    this->restored_.clear();
+    this->documents_.clear();
+    unlock_directory(this->lock_fd_);
+}
+
+const std::string &Session::restored_text(const std::size_t index) const
+{
+    if (index >= this->restored_.size() || !this->restored_[index].journal) [[unlikely]] {
+        throw std::out_of_range(std::format("Restored document '{}' does not exist", index));
+    }
+    return this->restored_[index].journal->restored_text();
+}
+
+void Session::adopt(const std::size_t index,
+                    const std::size_t document)
+{
+    if (index >= this->restored_.size() || !this->restored_[index].journal) [[unlikely]] {
+        throw std::out_of_range(std::format("Restored document '{}' does not exist", index));
+    }
+    this->remove(document);
+    this->documents_[document] = std::move(this->restored_[index]);
+}
+
+void Session::record(const std::size_t document,
+                     const std::string_view text)
+{
+    auto it = this->documents_.find(document);
+    if (it == this->documents_.end()) {
+        // An empty document has nothing worth restoring yet
+        if (text.empty()) {
+            return;
+        }
+        const std::size_t slot = this->next_slot_++;
+        it = this->documents_.emplace(document, Document{.slot = slot, .journal = std::make_unique<Journal>(this->directory_ / std::to_string(slot))}).first;
+    }
+    it->second.journal->record(text);
+}
+
+void Session::remove(const std::size_t document)
+{
+    const auto it = this->documents_.find(document);
+    if (it == this->documents_.end()) {
+        return;
+    }
+    const std::size_t slot = it->second.slot;
+    it->second.journal->discard();
+    this->documents_.erase(it);
+
+    std::error_code ec;
+    std::filesystem::remove_all(this->directory_ / std::to_string(slot), ec);
+    if (ec) [[unlikely]] {
+        SPDLOG_ERROR("Failed to delete the session document '{}': {}", slot, ec.message());
+    }
+}
+
+void Session::flush()
+{
+    for (const Document &restored : this->restored_) {
+        if (restored.journal) {
+            restored.journal->flush();
+        }
+    }
+    for (const auto &[document, journaled] : this->documents_) {
+        journaled.journal->flush();
+    }
+}
+
+}  // namespace core::session
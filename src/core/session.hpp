@@ -0,0 +1,372 @@
+/**
+ * @file session.hpp
+ *
+ * @brief Crash-safe persistence of the open documents, using compacted snapshots and an append-only edit journal per document.
+ */
+
+#pragma once
+
+#include <chrono>              // for std::chrono::milliseconds
+#include <condition_variable>  // for std::condition_variable
+#include <cstddef>             // for std::size_t
+#include <cstdint>             // for std::uint64_t
+#include <filesystem>          // for std::filesystem::path
+#include <memory>              // for std::unique_ptr
+#include <mutex>               // for std::mutex
+#include <string>              // for std::string
+#include <string_view>         // for std::string_view
+#include <thread>              // for std::jthread
+#include <unordered_map>       // for std::unordered_map
+#include <vector>              // for std::vector
+
+namespace core::session {
+
+/**
+ * @brief Longest time between an edit being recorded and it being synced to disk; edits recorded within it share a single fsync.
+ */
+inline constexpr std::chrono::milliseconds SYNC_INTERVAL{100};
+
+/**
+ * @brief Journal size below which it is never compacted into a snapshot, in bytes (1 MiB), so small documents are not snapshotted on every few keystrokes.
+ */
+inline constexpr std::size_t MIN_COMPACTION_SIZE = 1024 * 1024;
+
+/**
+ * @brief Single contiguous edit: "erased" bytes at "offset" were replaced with "inserted".
+ */
+struct Edit {
+    /**
+     * @brief Byte offset where the edit starts.
+     */
+    std::size_t offset = 0;
+
+    /**
+     * @brief Number of bytes removed at the offset.
+     */
+    std::size_t erased = 0;
+
+    /**
+     * @brief Bytes inserted at the offset.
+     */
+    std::string inserted{};
+};
+
+/**
+ * @brief Find the smallest single edit that turns one text into another.
+ *
+ * Compares the common prefix and suffix, so typing, deleting, and pasting produce an edit about as large as what was typed, deleted, or pasted.
+ *
+ * @param before Text before the edit (e.g., "hello world").
+ * @param after Text after the edit (e.g., "hello brave world").
+ *
+ * @return Edit that turns "before" into "after" (e.g., {6, 0, "brave "}); empty if the texts are equal.
+ */
+[[nodiscard]] Edit find_edit(const std::string_view before,
+                             const std::string_view after);
+
+/**
+ * @brief Apply an edit to a text in place.
+ *
+ * @param text Text to modify (e.g., "hello world").
+ * @param edit Edit to apply (e.g., {6, 0, "brave "}).
+ *
+ * @throws std::out_of_range if the edit does not fit inside the text.
+ */
+void apply_edit(std::string &text,
+                const Edit &edit);
+
+/**
+ * @brief Restore the text of the last session from a session directory.
+ *
+ * The snapshot is memory-mapped and copied, then the journal records written after it are replayed. Because the journal is compacted into a new snapshot once it outgrows the snapshot, this takes time proportional to the snapshot size, not to the edit history. A record torn by a crash ends the replay, everything before it is kept.
+ *
+ * @param directory Session directory (e.g., "/home/user/.local/state/ungpt/session").
+ *
+ * @return Restored text, or an empty string if there is no session.
+ *
+ * @throws std::runtime_error if the snapshot exists but is corrupt or cannot be read.
+ */
+[[nodiscard]] std::string restore(const std::filesystem::path &directory);
+
+/**
+ * @brief Records every change of the editor text into a session directory, so it survives closing and crashing.
+ *
+ * The UI thread only computes the edit against a shadow copy of the text and queues it; a background thread appends the queued edits to the journal and syncs them to disk at most every "SYNC_INTERVAL", so a burst of keystrokes costs a single fsync. Once the journal outgrows the snapshot, a new snapshot is written and the journal starts over.
+ */
+class Journal final {
+  public:
+    /**
+     * @brief Construct a new Journal object, restore the last session from the directory, and start the background writer.
+     *
+     * @param directory Session directory, created if it does not exist (e.g., "/home/user/.local/state/ungpt/session").
+     *
+     * @throws std::runtime_error if the directory cannot be created, the last session is corrupt, or the journal cannot be opened.
+     */
+    explicit Journal(const std::filesystem::path &directory);
+
+    /**
+     * @brief Write the remaining edits, compact them into a snapshot, and stop the background writer.
+     */
+    ~Journal();
+
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    /**
+     * @brief Return the text restored from the last session.
+     *
+     * @return Restored text, or an empty string if there was no session.
+     */
+    [[nodiscard]] const std::string &restored_text() const
+    {
+        return this->shadow_;
+    }
+
+    /**
+     * @brief Record the current text, journaling the difference from the previously recorded one.
+     *
+     * @param text Current editor text (e.g., "hello brave world").
+     */
+    void record(const std::string_view text);
+
+    /**
+     * @brief Block until every recorded edit is written and synced to disk.
+     *
+     * @throws std::runtime_error if the background writer failed.
+     */
+    void flush();
+
+    /**
+     * @brief Drop the edits that were not written yet and skip the compaction on destruction, because the session directory is about to be deleted.
+     */
+    void discard();
+
+  private:
+    /**
+     * @brief Work item for the background writer: an edit to append, or a full text to snapshot.
+     */
+    struct Entry {
+        /**
+         * @brief Whether "text" is a full snapshot rather than "edit" being a journal record.
+         */
+        bool is_snapshot = false;
+
+        /**
+         * @brief Edit to append to the journal.
+         */
+        Edit edit{};
+
+        /**
+         * @brief Full text to write as the new snapshot.
+         */
+        std::string text{};
+    };
+
+    /**
+     * @brief Write queued entries until the journal is destroyed; runs on the background thread.
+     *
+     * @param generation Generation of the restored snapshot, which the journal must carry (e.g., "3").
+     * @param journal_end Size of the valid part of the existing journal, where appending resumes, or 0 to start a new journal.
+     */
+    void run(std::uint64_t generation,
+             const std::uint64_t journal_end);
+
+    /**
+     * @brief Queue a snapshot of the shadow text, which also starts a new, empty journal.
+     */
+    void request_snapshot();
+
+    /**
+     * @brief Session directory.
+     */
+    std::filesystem::path directory_;
+
+    /**
+     * @brief Copy of the last recorded text, only used by the UI thread.
+     */
+    std::string shadow_;
+
+    /**
+     * @brief Size of the last snapshot, in bytes; only used by the UI thread.
+     */
+    std::size_t snapshot_size_ = 0;
+
+    /**
+     * @brief Number of edit bytes queued since the last snapshot; only used by the UI thread.
+     */
+    std::size_t journal_size_ = 0;
+
+    /**
+     * @brief Guards everything below.
+     */
+    std::mutex mutex_;
+
+    /**
+     * @brief Signals the background writer that entries were queued or it should stop, and "flush()" that a batch was synced.
+     */
+    std::condition_variable condition_;
+
+    /**
+     * @brief Entries waiting to be written.
+     */
+    std::vector<Entry> queue_;
+
+    /**
+     * @brief Number of entries queued so far.
+     */
+    std::uint64_t queued_count_ = 0;
+
+    /**
+     * @brief Number of entries written and synced so far.
+     */
+    std::uint64_t synced_count_ = 0;
+
+    /**
+     * @brief Whether "flush()" is waiting, so the writer skips its batching delay.
+     */
+    bool is_flush_requested_ = false;
+
+    /**
+     * @brief Whether the background writer should finish the queue and stop.
+     */
+    bool is_stopping_ = false;
+
+    /**
+     * @brief Error that stopped the background writer, or empty if it is healthy.
+     */
+    std::string error_;
+
+    /**
+     * @brief Background writer, declared last so it starts after, and is joined before, everything above is destroyed.
+     */
+    std::jthread thread_;
+};
+
+/**
+ * @brief Journals every open document into its own numbered subdirectory of a session directory (e.g., "session/3"), and restores all of them on the next start.
+ *
+ * The session directory is locked for as long as the object lives, so a second instance (e.g., one started with "--new-instance") cannot interleave its writes with this one; it has to run without a session instead. Documents are identified by the caller (e.g., by their tab), the subdirectories are numbered independently, so restored documents keep theirs.
+ */
+class Session final {
+  public:
+    /**
+     * @brief Construct a new Session object: create and lock the session directory, and restore every document of the last session.
+     *
+     * Documents that were left empty are deleted. A document whose snapshot is corrupt is logged and left on disk, without affecting the others.
+     *
+     * @param directory Session directory, created if it does not exist (e.g., "/home/user/.local/state/ungpt/session").
+     *
+     * @throws std::runtime_error if the directory cannot be created, or another instance holds its lock.
+     */
+    explicit Session(const std::filesystem::path &directory);
+
+    /**
+     * @brief Write and compact every journal, then release the lock.
+     */
+    ~Session();
+
+    Session(const Session &) = delete;
+    Session &operator=(const Session &) = delete;
+
+    /**
+     * @brief Return the number of documents restored from the last session.
+     *
+     * @return Number of restored documents, none of them empty (e.g., "3").
+     */
+    [[nodiscard]] std::size_t restored_count() const
+    {
+        return this->restored_.size();
+    }
+
+    /**
+     * @brief Return the text of a restored document.
+     *
+     * @param index Index of the restored document, in the order the documents were created (e.g., "0").
+     *
+     * @return Restored text.
+     *
+     * @throws std::out_of_range if the index is too large or the document was already adopted.
+     */
+    [[nodiscard]] const std::string &restored_text(const std::size_t index) const;
+
+    /**
+     * @brief Continue journaling a restored document under the identifier the caller gave it.
+     *
+     * @param index Index of the restored document (e.g., "0").
+     * @param document Identifier of the document, as passed to "record()" (e.g., "1").
+     *
+     * @throws std::out_of_range if the index is too large or the document was already adopted.
+     */
+    void adopt(const std::size_t index,
+               const std::size_t document);
+
+    /**
+     * @brief Record the current text of a document, journaling the difference from the previously recorded one.
+     *
+     * A document that was never recorded gets a new journal once it is not empty.
+     *
+     * @param document Identifier of the document (e.g., "1").
+     * @param text Current text of the document (e.g., "hello brave world").
+     *
+     * @throws std::runtime_error if the journal of a new document cannot be created.
+     */
+    void record(const std::size_t document,
+                const std::string_view text);
+
+    /**
+     * @brief Stop journaling a document and delete it from the session, because it was closed.
+     *
+     * @param document Identifier of the document (e.g., "1"); unknown identifiers are ignored.
+     */
+    void remove(const std::size_t document);
+
+    /**
+     * @brief Block until every recorded edit of every document is written and synced to disk.
+     *
+     * @throws std::runtime_error if a background writer failed.
+     */
+    void flush();
+
+  private:
+    /**
+     * @brief Journal of a document, with the subdirectory it writes to.
+     */
+    struct Document {
+        /**
+         * @brief Number of the subdirectory (e.g., "3" for "session/3").
+         */
+        std::size_t slot = 0;
+
+        /**
+         * @brief Journal writing to the subdirectory, or nullptr once a restored document was adopted.
+         */
+        std::unique_ptr<Journal> journal{};
+    };
+
+    /**
+     * @brief Session directory.
+     */
+    std::filesystem::path directory_;
+
+    /**
+     * @brief Lock file held for as long as the session lives, or -1 once it is released.
+     */
+    int lock_fd_ = -1;
+
+    /**
+     * @brief Number of the next subdirectory, above every existing one.
+     */
+    std::size_t next_slot_ = 1;
+
+    /**
+     * @brief Documents restored from the last session and not adopted yet, in the order they were created.
+     */
+    std::vector<Document> restored_;
+
+    /**
+     * @brief Journaled documents, by the identifier the caller gave them.
+     */
+    std::unordered_map<std::size_t, Document> documents_;
+};
+
+}  // namespace core::session
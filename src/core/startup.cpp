@@ -0,0 +1,91 @@
+/**
+ * @file startup.cpp
+ */
+
+#include <chrono>    // for std::chrono::steady_clock, std::chrono::duration
+#include <format>    // for std::format_to
+#include <iterator>  // for std::back_inserter
+#include <string>    // for std::string
+
+#include <spdlog/spdlog.h>
+
+#include "core/startup.hpp"
+
+namespace core::startup {
+
+namespace {
+
+/**
+ * @brief Approximation of the process start time, captured during static initialization (before "main()").
+ */
+const std::chrono::steady_clock::time_point process_start = std::chrono::steady_clock::now();
+
+/**
+ * @brief Convert a time point to milliseconds elapsed since process start.
+ *
+ * @param time Time point to convert.
+ *
+ * @return Milliseconds since process start (e.g., "12.41").
+ */
+[[nodiscard]] double milliseconds_since_start(const std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration<double, std::milli>(time - process_start).count();
+}
+
+}  // namespace
+
+Trace::Trace(const bool enabled)
+    : enabled_(enabled)
+{
+    this->milestones_.reserve(8);
+}
+
+void Trace::mark(const std::string_view label)
+{
+    this->milestones_.push_back({std::string{label}, std::chrono::steady_clock::now()});
+}
+
+void Trace::finish(const std::string_view label)
+{
+    if (this->finished_) [[likely]] {
+        return;
+    }
+    this->finished_ = true;
+    this->mark(label);
+
+    const double first_paint_ms = milliseconds_since_start(this->milestones_.back().time);
+    SPDLOG_DEBUG("First frame presented after {:.2f} ms", first_paint_ms);
+
+    if (!this->enabled_) {
+        return;
+    }
+
+    SPDLOG_INFO("Startup trace:\n{}", this->report());
+    if (first_paint_ms > FIRST_PAINT_BUDGET_MS) [[unlikely]] {
+        SPDLOG_WARN("First paint took {:.2f} ms, which exceeds the {:.0f} ms budget", first_paint_ms, FIRST_PAINT_BUDGET_MS);
+    }
+    else {
+        SPDLOG_INFO("First paint took {:.2f} ms, which is within the {:.0f} ms budget", first_paint_ms, FIRST_PAINT_BUDGET_MS);
+    }
+}
+
+std::string Trace::report() const
+{
+    std::string result;
+    double previous_ms = 0.0;
+
+    for (const Milestone &milestone : this->milestones_) {
+        const double elapsed_ms = milliseconds_since_start(milestone.time);
+        std::format_to(std::back_inserter(result), "  {:8.2f} ms (+{:7.2f} ms)  {}\n", elapsed_ms, elapsed_ms - previous_ms, milestone.label);
+        previous_ms = elapsed_ms;
+    }
+
+    // Drop the trailing newline, the logger adds its own
+    if (!result.empty()) {
+        result.pop_back();
+    }
+
+    return result;
+}
+
+}  // namespace core::startup
@@ -0,0 +1,83 @@
+/**
+ * @file startup.hpp
+ *
+ * @brief Timing of the startup path, from process start to the first frame on screen.
+ */
+
+#pragma once
+
+#include <chrono>       // for std::chrono::steady_clock
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+namespace core::startup {
+
+/**
+ * @brief Time budget for the first frame to be presented, measured from process start.
+ */
+inline constexpr double FIRST_PAINT_BUDGET_MS = 50.0;
+
+/**
+ * @brief Records named milestones of the startup path.
+ *
+ * All timestamps are measured relative to the static initialization of this module, which happens before "main()" is entered.
+ */
+class Trace final {
+  public:
+    /**
+     * @brief Construct a new Trace object.
+     *
+     * @param enabled Whether "finish()" should log the full report (true) or only a one-line debug summary (false).
+     */
+    explicit Trace(const bool enabled);
+
+    /**
+     * @brief Record a milestone at the current time.
+     *
+     * @param label Short description of what just finished (e.g., "Window created").
+     */
+    void mark(const std::string_view label);
+
+    /**
+     * @brief Record the final milestone and log the report.
+     *
+     * @param label Short description of the final milestone (e.g., "First frame presented").
+     *
+     * @note Subsequent calls are ignored, so this can be called unconditionally from the main loop.
+     */
+    void finish(const std::string_view label);
+
+    /**
+     * @brief Format all recorded milestones into a human-readable table.
+     *
+     * @return Multi-line report with per-step and cumulative timings (e.g., "  12.41 ms (+ 9.80 ms)  Window created").
+     */
+    [[nodiscard]] std::string report() const;
+
+  private:
+    /**
+     * @brief Single recorded milestone.
+     */
+    struct Milestone {
+        std::string label;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    /**
+     * @brief Milestones in the order they were recorded.
+     */
+    std::vector<Milestone> milestones_;
+
+    /**
+     * @brief Whether the full report is logged on "finish()".
+     */
+    bool enabled_;
+
+    /**
+     * @brief Whether "finish()" was already called.
+     */
+    bool finished_ = false;
+};
+
+}  // namespace core::startup
@@ -2,18 +2,45 @@
  * @file text.cpp
  */
 
-#include <cstddef>  // for std::size_t
-#include <string>   // for std::string
-#include <utility>  // for std::pair
+#include <algorithm>    // for std::max, std::min
+#include <array>        // for std::array
+#include <bit>          // for std::popcount, std::countr_zero
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <cstring>      // for std::memcpy
+#include <iterator>     // for std::size
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <thread>       // for std::jthread
+#include <utility>      // for std::move, std::pair
+#include <vector>       // for std::vector
 
-#include <SFML/System/Utf.hpp>
-#include <spdlog/spdlog.h>
+#if defined(__SSE2__) || defined(_M_X64)
+#define UNGPT_TEXT_SSE2
+#include <emmintrin.h>
+#endif
 
+#include "core/diff.hpp"
+#include "core/markdown.hpp"
+#include "core/pipeline.hpp"
+#include "core/regex.hpp"
+#include "core/rules.hpp"
 #include "core/text.hpp"
+#include "core/utf8.hpp"
 
 namespace core::text {
 
-void remove_unwanted_characters(std::string &text)
+namespace {
+
+/**
+ * @brief Build the rule set for a combination of cleanup options.
+ *
+ * @param options Optional rules to include after the character replacements.
+ *
+ * @return Compiled rule set.
+ */
+[[nodiscard]] rules::RuleSet build_rule_set(const CleanupOptions &options)
 {
     // NOTE: This array cannot be `constexpr` because `std::string` is not a literal type in C++20 so GCC will reject it
     static const std::pair<std::string, std::string> replacements[] = {
@@ -74,31 +101,600 @@ void remove_unwanted_characters(std::string &text)
         {"⋅", "*"},  // U+22C5 dot operator
     };
 
+    std::vector<rules::Rule> rule_list;
+    rule_list.reserve(std::size(replacements) + 4);
+
+    // Remove spaces and tabs before every line break and at the end of the text
+    // The run also takes the characters that become a space or vanish (e.g., a no-break space), and the rule comes first, so it wins over their own rules at the same position
+    if (options.trim_trailing_whitespace) {
+        std::string pattern = "(?:[ \t]";
+        for (const auto &[from, to] : replacements) {
+            if (to.empty() || to == " ") {
+                pattern += '|';
+                pattern += from;
+            }
+        }
+        pattern += ")+$";
+        rule_list.push_back({.pattern = std::move(pattern), .replacement = "", .is_regex = true});
+    }
+
     for (const auto &[from, to] : replacements) {
+        rule_list.push_back({.pattern = from, .replacement = to});
+    }
+
+    // Remove the disclaimer and the whitespace after it, so the sentence continues naturally
+    if (options.remove_ai_disclaimers) {
+        rule_list.push_back({.pattern = "[Aa]s an AI(?: language model)?,[ \t]*", .replacement = "", .is_regex = true});
+        rule_list.push_back({.pattern = "[Aa]s a large language model,[ \t]*", .replacement = "", .is_regex = true});
+    }
+
+    // Remove bold markers but keep the emphasized text
+    if (options.remove_markdown_bold) {
+        rule_list.push_back({.pattern = "**", .replacement = ""});
+    }
+
+    return rules::RuleSet{std::move(rule_list)};
+}
+
+/**
+ * @brief Return the index of a combination of cleanup options, one bit per option.
+ *
+ * @param options Optional rules to include.
+ *
+ * @return Index between 0 and 7 (e.g., "5").
+ */
+[[nodiscard]] std::size_t get_rule_set_index(const CleanupOptions &options)
+{
+    return (options.remove_ai_disclaimers ? 1u : 0u) |
+           (options.remove_markdown_bold ? 2u : 0u) |
+           (options.trim_trailing_whitespace ? 4u : 0u);
+}
+
+/**
+ * @brief Return the compiled rule set for a combination of cleanup options.
+ *
+ * Every combination is compiled once, on first use, and shared afterwards.
+ *
+ * @param options Optional rules to include.
+ *
+ * @return Reference to the compiled rule set.
+ */
+[[nodiscard]] const rules::RuleSet &get_rule_set(const CleanupOptions &options)
+{
+    static const std::array<rules::RuleSet, 8> rule_sets = [] {
+        const auto options_for = [](const std::size_t index) {
+            return CleanupOptions{
+                .remove_ai_disclaimers = (index & 1u) != 0,
+                .remove_markdown_bold = (index & 2u) != 0,
+                .trim_trailing_whitespace = (index & 4u) != 0,
+            };
+        };
+        return std::array<rules::RuleSet, 8>{
+            build_rule_set(options_for(0)),
+            build_rule_set(options_for(1)),
+            build_rule_set(options_for(2)),
+            build_rule_set(options_for(3)),
+            build_rule_set(options_for(4)),
+            build_rule_set(options_for(5)),
+            build_rule_set(options_for(6)),
+            build_rule_set(options_for(7)),
+        };
+    }();
+
+    return rule_sets[get_rule_set_index(options)];
+}
+
+/**
+ * @brief Return whether a combination of cleanup options enables a stage of the fused pipeline, i.e., a cleanup that the rule set does not cover.
+ *
+ * @param options Cleanup options.
+ *
+ * @return True if line endings or whitespace are normalized, false otherwise.
+ */
+[[nodiscard]] bool has_pipeline_stages(const CleanupOptions &options)
+{
+    return options.normalize_line_endings || options.collapse_whitespace;
+}
+
+/**
+ * @brief Run the enabled pipeline stages over a text that the rule set already rewrote, leaving code and URLs unchanged if requested.
+ *
+ * The stages run after the rules, so whitespace that a rule produced (e.g., a space from U+00A0, or two spaces around a removed zero-width space) is collapsed as well.
+ *
+ * @param text Text rewritten by the rule set (e.g., "a  b\r\n").
+ * @param options Cleanup options, which select the stages.
+ * @param output String that receives the transformed text (e.g., "a b\n"); its contents are replaced.
+ *
+ * @return Number of changes made (e.g., "2").
+ */
+std::size_t run_pipeline(const std::string_view text,
+                         const CleanupOptions &options,
+                         std::string &output)
+{
+    const pipeline::PipelineOptions stages = {
+        .normalize_line_endings = options.normalize_line_endings,
+        .collapse_spaces = options.collapse_whitespace,
+    };
+    if (!options.preserve_code) {
+        return pipeline::run(text, stages, output);
+    }
+
+    // Every part between two verbatim ranges is a pipeline of its own, the ranges are copied as they are
+    thread_local std::vector<markdown::Range> verbatim;
+    thread_local std::string part;
+    markdown::find_verbatim_ranges(text, verbatim);
+    output.clear();
+    std::size_t changes = 0;
+    std::size_t position = 0;
+    for (const markdown::Range &range : verbatim) {
+        changes += pipeline::run(text.substr(position, range.begin - position), stages, part);
+        output += part;
+        output += text.substr(range.begin, range.end - range.begin);
+        position = range.end;
+    }
+    changes += pipeline::run(text.substr(position), stages, part);
+    output += part;
+    return changes;
+}
+
+/**
+ * @brief Number of bytes classified at once by "compute_stats()", one per bit of a 64-bit mask.
+ */
+constexpr std::size_t BLOCK_SIZE = 64;
+
+/**
+ * @brief Classes of the bytes of a 64-byte block, one bit per byte, with the first byte in the lowest bit.
+ */
+struct BlockMasks {
+    /**
+     * @brief Whitespace bytes, i.e., " ", "\t", "\n", "\v", "\f", and "\r".
+     */
+    std::uint64_t whitespace = 0;
+
+    /**
+     * @brief UTF-8 continuation bytes (10xxxxxx).
+     */
+    std::uint64_t continuation = 0;
+
+    /**
+     * @brief UTF-8 lead bytes of multi-byte characters (11xxxxxx).
+     */
+    std::uint64_t lead = 0;
+
+    /**
+     * @brief Line feeds.
+     */
+    std::uint64_t newline = 0;
+
+    /**
+     * @brief Carriage returns.
+     */
+    std::uint64_t carriage_return = 0;
+
+    /**
+     * @brief ASCII sentence terminators, i.e., ".", "!", and "?".
+     */
+    std::uint64_t terminator = 0;
+
+    /**
+     * @brief Last bytes of the fullwidth sentence terminators "。", "！", and "？", to be verified against the preceding bytes.
+     */
+    std::uint64_t cjk_candidate = 0;
+};
+
+#if defined(UNGPT_TEXT_SSE2)
+/**
+ * @brief Classify 64 bytes with SSE2, 16 bytes at a time.
+ *
+ * @param block Address of the first byte; no alignment is required.
+ *
+ * @return Masks of the block.
+ */
+[[nodiscard]] BlockMasks classify_block(const char *block)
+{
+    const __m128i tab_minus_one = _mm_set1_epi8(8);
+    const __m128i carriage_return_plus_one = _mm_set1_epi8(14);
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i top_bits = _mm_set1_epi8(static_cast<char>(0xC0));
+    const __m128i continuation = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriage_return = _mm_set1_epi8('\r');
+    const __m128i period = _mm_set1_epi8('.');
+    const __m128i exclamation = _mm_set1_epi8('!');
+    const __m128i question = _mm_set1_epi8('?');
+    const __m128i ideographic_period = _mm_set1_epi8(static_cast<char>(0x82));
+    const __m128i fullwidth_exclamation = _mm_set1_epi8(static_cast<char>(0x81));
+    const __m128i fullwidth_question = _mm_set1_epi8(static_cast<char>(0x9F));
+
+    // Each 16-bit movemask lands in its own quarter of the 64-bit masks
+    const auto movemask = [](const __m128i vector, const std::size_t quarter) {
+        return static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(vector))) << (quarter * 16);
+    };
+
+    BlockMasks masks;
+    for (std::size_t quarter = 0; quarter < BLOCK_SIZE / 16; ++quarter) {
+        const __m128i bytes = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(block + quarter * 16)));
+
+        // Bytes 0x80 and above are negative in signed comparisons, so they never fall into the control range 9..13
+        const __m128i is_control_space = _mm_and_si128(_mm_cmpgt_epi8(bytes, tab_minus_one), _mm_cmplt_epi8(bytes, carriage_return_plus_one));
+        const __m128i high_bits = _mm_and_si128(bytes, top_bits);
+        masks.whitespace |= movemask(_mm_or_si128(is_control_space, _mm_cmpeq_epi8(bytes, space)), quarter);
+        masks.continuation |= movemask(_mm_cmpeq_epi8(high_bits, continuation), quarter);
+        masks.lead |= movemask(_mm_cmpeq_epi8(high_bits, top_bits), quarter);
+        masks.newline |= movemask(_mm_cmpeq_epi8(bytes, newline), quarter);
+        masks.carriage_return |= movemask(_mm_cmpeq_epi8(bytes, carriage_return), quarter);
+        masks.terminator |= movemask(_mm_or_si128(_mm_cmpeq_epi8(bytes, period),
+                                                  _mm_or_si128(_mm_cmpeq_epi8(bytes, exclamation), _mm_cmpeq_epi8(bytes, question))),
+                                     quarter);
+        masks.cjk_candidate |= movemask(_mm_or_si128(_mm_cmpeq_epi8(bytes, ideographic_period),
+                                                     _mm_or_si128(_mm_cmpeq_epi8(bytes, fullwidth_exclamation), _mm_cmpeq_epi8(bytes, fullwidth_question))),
+                                        quarter);
+    }
+    return masks;
+}
+#else
+/**
+ * @brief Classify 64 bytes one at a time.
+ *
+ * @param block Address of the first byte.
+ *
+ * @return Masks of the block.
+ */
+[[nodiscard]] BlockMasks classify_block(const char *block)
+{
+    BlockMasks masks;
+    for (std::size_t i = 0; i < BLOCK_SIZE; ++i) {
+        const auto byte = static_cast<unsigned char>(block[i]);
+        const std::uint64_t bit = std::uint64_t{1} << i;
+        masks.whitespace |= (byte == ' ' || (byte >= '\t' && byte <= '\r')) ? bit : 0;
+        masks.continuation |= (byte & 0xC0) == 0x80 ? bit : 0;
+        masks.lead |= (byte & 0xC0) == 0xC0 ? bit : 0;
+        masks.newline |= byte == '\n' ? bit : 0;
+        masks.carriage_return |= byte == '\r' ? bit : 0;
+        masks.terminator |= (byte == '.' || byte == '!' || byte == '?') ? bit : 0;
+        masks.cjk_candidate |= (byte == 0x82 || byte == 0x81 || byte == 0x9F) ? bit : 0;
+    }
+    return masks;
+}
+#endif
+
+/**
+ * @brief Check whether a fullwidth sentence terminator ("。", "！", or "？") ends at a position of a part of the text.
+ *
+ * @param part Part of the text to check.
+ * @param position Byte offset of the last byte of the candidate in the part.
+ * @param tail Last two bytes before the part, used when the terminator starts in the previous part.
+ * @param tail_size Number of valid bytes in "tail", counted from its end (e.g., "0" at the start of the text).
+ *
+ * @return True if the three bytes up to and including "position" are a fullwidth terminator, false otherwise.
+ */
+[[nodiscard]] bool is_cjk_terminator_at(const std::string_view part,
+                                        const std::size_t position,
+                                        const std::array<char, 2> &tail,
+                                        const std::size_t tail_size)
+{
+    if (position >= 2) [[likely]] {
+        const std::string_view candidate = part.substr(position - 2, 3);
+        return candidate == "。" || candidate == "！" || candidate == "？";
+    }
+    if (position + tail_size < 2) {
+        return false;
+    }
+    std::array<char, 3> candidate = {};
+    for (std::size_t i = 0; i < 3; ++i) {
+        candidate[i] = i + position >= 2 ? part[i + position - 2] : tail[i + position];
+    }
+    const std::string_view bytes{candidate.data(), candidate.size()};
+    return bytes == "。" || bytes == "！" || bytes == "？";
+}
+
+}  // namespace
 
-        // Used for keeping track of where we are in the string as we perform replacements
-        std::size_t pos = 0;
+std::size_t remove_unwanted_characters(std::string &text,
+                                       const CleanupOptions &options)
+{
+    // Repair first, so no rule ever matches half of a broken character
+    const std::size_t repaired = options.repair_invalid_utf8 ? utf8::repair(text) : 0;
 
-        // Continuously search the text for the next occurrence of the substring 'from', starting from the current position 'pos'
-        // Stop when no more matches are found
-        while ((pos = text.find(from, pos)) != std::string::npos) {
+    // All replacements are fused into one program, so the text is scanned once no matter how many rules are enabled
+    const std::size_t replaced = options.preserve_code ? get_rule_set(options).apply(text, markdown::find_verbatim_ranges(text))
+                                                       : get_rule_set(options).apply(text);
+    if (!has_pipeline_stages(options)) [[likely]] {
+        return repaired + replaced;
+    }
 
-            // Replace the found substring starting at 'pos' with the replacement string 'to'
-            // The number of characters replaced is equal to the size of the substring 'from'
-            text.replace(pos, from.size(), to);
+    // The stages the rules cannot express are fused into one more pass
+    std::string output;
+    const std::size_t changed = run_pipeline(text, options, output);
+    text = std::move(output);
+    return repaired + replaced + changed;
+}
+
+std::vector<diff::Change> find_changes(const std::string_view text,
+                                       const CleanupOptions &options)
+{
+    // The pipeline stages do not report where they changed the text, so the changes are recovered from the result
+    if (has_pipeline_stages(options)) [[unlikely]] {
+        std::string normalized{text};
+        remove_unwanted_characters(normalized, options);
+        return diff::compute_changes(text, normalized);
+    }
 
-            // Move the search index forward by the length of the replacement text
-            // This ensures that the next call to `find()` starts after the part of the string we just modified
-            pos += to.size();
+    std::vector<diff::Change> rule_changes = options.preserve_code ? get_rule_set(options).find_changes(text, markdown::find_verbatim_ranges(text))
+                                                                   : get_rule_set(options).find_changes(text);
+    if (!options.repair_invalid_utf8) [[likely]] {
+        return rule_changes;
+    }
+    const std::vector<std::size_t> invalid_offsets = utf8::find_invalid_sequences(text);
+    if (invalid_offsets.empty()) [[likely]] {
+        return rule_changes;
+    }
 
-            SPDLOG_DEBUG("Replaced '{}' with '{}' at position {}", from, to, pos);
+    // Merge both sorted lists, dropping rule matches that overlap an invalid sequence
+    std::vector<diff::Change> changes;
+    changes.reserve(rule_changes.size() + invalid_offsets.size());
+    std::size_t next_rule = 0;
+    for (const std::size_t offset : invalid_offsets) {
+        const std::size_t end = offset + utf8::invalid_sequence_length(text, offset);
+        for (; next_rule < rule_changes.size() && rule_changes[next_rule].begin < end; ++next_rule) {
+            if (rule_changes[next_rule].end <= offset) {
+                changes.push_back(std::move(rule_changes[next_rule]));
+            }
         }
+        changes.push_back({.begin = offset, .end = end, .replacement = std::string{utf8::REPLACEMENT_CHARACTER}});
+    }
+    for (; next_rule < rule_changes.size(); ++next_rule) {
+        changes.push_back(std::move(rule_changes[next_rule]));
+    }
+    return changes;
+}
+
+std::size_t normalize_into(const std::string_view text,
+                           char *output,
+                           const std::size_t capacity,
+                           const CleanupOptions &options)
+{
+    const rules::RuleSet &rule_set = get_rule_set(options);
+
+    // Invalid input is repaired into a scratch buffer first; valid input, by far the common case, is read in place
+    std::string_view input = text;
+    if (options.repair_invalid_utf8 && !utf8::is_valid(text)) [[unlikely]] {
+        thread_local std::string repaired;
+        repaired.assign(text);
+        utf8::repair(repaired);
+        input = repaired;
+    }
+
+    // Matchers hold the scratch space of the scan; keeping one per thread and rule set makes repeated calls allocation-free
+    thread_local std::array<std::optional<regex::Matcher>, 8> matchers;
+    std::optional<regex::Matcher> &matcher = matchers[get_rule_set_index(options)];
+    if (!matcher) [[unlikely]] {
+        matcher.emplace(rule_set.program());
+    }
+
+    // Code and URLs are found in a separate, much cheaper scan, then copied as they are
+    thread_local std::vector<markdown::Range> verbatim;
+    verbatim.clear();
+    if (options.preserve_code) {
+        markdown::find_verbatim_ranges(input, verbatim);
+    }
+    if (!has_pipeline_stages(options)) [[likely]] {
+        return rule_set.apply_to(input, output, capacity, *matcher, verbatim);
     }
 
-    SPDLOG_DEBUG("Normalized text, resulting length: {}", text.size());
+    // The rules write into a scratch buffer instead, which the pipeline stages read in one more fused pass
+    thread_local std::string rewritten;
+    thread_local std::string staged;
+    rewritten.resize(std::max(rewritten.capacity(), input.size()));
+    std::size_t size = rule_set.apply_to(input, rewritten.data(), rewritten.size(), *matcher, verbatim);
+    if (size > rewritten.size()) [[unlikely]] {
+        rewritten.resize(size);
+        size = rule_set.apply_to(input, rewritten.data(), rewritten.size(), *matcher, verbatim);
+    }
+    rewritten.resize(size);
+    static_cast<void>(run_pipeline(rewritten, options, staged));
+    if (capacity != 0) {
+        std::memcpy(output, staged.data(), std::min(capacity, staged.size()));
+    }
+    return staged.size();
+}
+
+StatsCounter::StatsCounter(const bool segment_words)
+    : segment_words_(segment_words)
+{
 }
 
-std::size_t count_words(const std::string &text)
+void StatsCounter::add(const std::string_view part)
+{
+    // The segmenter skips ASCII on its own, faster than the blocks are classified
+    if (this->segment_words_) {
+        this->segmenter_.add(part);
+    }
+
+    const std::size_t tail_size = std::min<std::size_t>(this->size_, 2);
+    for (std::size_t offset = 0; offset < part.size(); offset += BLOCK_SIZE) {
+        // The last partial block is padded, and every mask is limited to the valid bytes
+        const std::size_t block_size = std::min(BLOCK_SIZE, part.size() - offset);
+        std::uint64_t valid = ~std::uint64_t{0};
+        BlockMasks masks;
+        if (block_size == BLOCK_SIZE) [[likely]] {
+            masks = classify_block(part.data() + offset);
+        }
+        else {
+            std::array<char, BLOCK_SIZE> padded;
+            padded.fill(' ');
+            std::memcpy(padded.data(), part.data() + offset, block_size);
+            masks = classify_block(padded.data());
+            valid = (std::uint64_t{1} << block_size) - 1;
+        }
+        const std::uint64_t whitespace = masks.whitespace & valid;
+        const std::uint64_t text = ~masks.whitespace & valid;
+        const std::uint64_t characters = ~masks.continuation & valid;
+
+        // A word starts at non-whitespace after whitespace; a sentence ends at whitespace after a terminator
+        this->counts_.characters += static_cast<std::size_t>(std::popcount(characters));
+        this->counts_.non_ascii_characters += static_cast<std::size_t>(std::popcount(masks.lead & valid));
+        this->counts_.words += static_cast<std::size_t>(std::popcount(text & ((masks.whitespace << 1) | this->whitespace_carry_)));
+        this->counts_.word_characters += static_cast<std::size_t>(std::popcount(text & characters));
+        this->counts_.sentences += static_cast<std::size_t>(std::popcount(whitespace & ((masks.terminator << 1) | this->terminator_carry_)));
+        this->whitespace_carry_ = (masks.whitespace >> (block_size - 1)) & 1;
+        this->terminator_carry_ = (masks.terminator >> (block_size - 1)) & 1;
+        for (std::uint64_t candidates = masks.cjk_candidate & valid; candidates != 0; candidates &= candidates - 1) {
+            const std::size_t position = offset + static_cast<std::size_t>(std::countr_zero(candidates));
+            this->counts_.sentences += is_cjk_terminator_at(part, position, this->tail_, tail_size) ? 1u : 0u;
+        }
+
+        // Close a line at every line feed; line breaks are not part of the line length
+        std::uint64_t line_characters = characters & ~masks.newline & ~masks.carriage_return;
+        std::uint64_t line_text = text;
+        std::uint64_t newlines = masks.newline & valid;
+        this->counts_.lines += static_cast<std::size_t>(std::popcount(newlines));
+        for (; newlines != 0; newlines &= newlines - 1) {
+            const std::uint64_t before = (newlines & (~newlines + 1)) - 1;  // Bits below the lowest line feed
+            this->line_characters_ += static_cast<std::size_t>(std::popcount(line_characters & before));
+            this->line_has_text_ = this->line_has_text_ || (line_text & before) != 0;
+            line_characters &= ~before;
+            line_text &= ~before;
+
+            this->counts_.longest_line = std::max(this->counts_.longest_line, this->line_characters_);
+            this->counts_.paragraphs += this->line_has_text_ && this->previous_line_is_blank_ ? 1u : 0u;
+            if (!this->has_closed_line_) {
+                this->first_line_has_text_ = this->line_has_text_;
+                this->has_closed_line_ = true;
+            }
+            this->previous_line_is_blank_ = !this->line_has_text_;
+            this->line_characters_ = 0;
+            this->line_has_text_ = false;
+        }
+        this->line_characters_ += static_cast<std::size_t>(std::popcount(line_characters));
+        this->line_has_text_ = this->line_has_text_ || line_text != 0;
+    }
+
+    // Remember how the text ends, for the final sentence; the search stops at the first non-whitespace byte from the end
+    const std::size_t last_text = part.find_last_not_of(" \t\n\v\f\r");
+    if (last_text != std::string_view::npos) {
+        const char last = part[last_text];
+        this->has_text_ = true;
+        this->last_text_is_terminator_ = last == '.' || last == '!' || last == '?';
+        this->last_text_is_cjk_terminator_ = is_cjk_terminator_at(part, last_text, this->tail_, tail_size);
+        this->has_trailing_whitespace_ = last_text + 1 < part.size();
+    }
+    else if (!part.empty()) {
+        this->has_trailing_whitespace_ = true;
+    }
+
+    // Keep the last two bytes, for a terminator split across parts
+    if (part.size() >= 2) {
+        this->tail_ = {part[part.size() - 2], part.back()};
+    }
+    else if (part.size() == 1) {
+        this->tail_ = {this->tail_[1], part.back()};
+    }
+    this->size_ += part.size();
+}
+
+TextStats StatsCounter::stats() const
+{
+    TextStats stats = this->counts_;
+    if (this->segment_words_) {
+        stats.words = this->segmenter_.count_words(stats.words);
+    }
+
+    // Every line feed starts a new line, and a non-empty text has at least one; the last line is still open
+    stats.lines += this->size_ == 0 ? 0u : 1u;
+    stats.longest_line = std::max(stats.longest_line, this->line_characters_);
+    stats.paragraphs += this->line_has_text_ && this->previous_line_is_blank_ ? 1u : 0u;
+
+    // Text after the last terminator is a final sentence; a terminator at the very end of the text had no whitespace to end it
+    const bool is_counted = (this->last_text_is_terminator_ && this->has_trailing_whitespace_) || this->last_text_is_cjk_terminator_;
+    stats.sentences += this->has_text_ && !is_counted ? 1u : 0u;
+    return stats;
+}
+
+void StatsCounter::merge(const StatsCounter &next)
+{
+    this->counts_.characters += next.counts_.characters;
+    this->counts_.non_ascii_characters += next.counts_.non_ascii_characters;
+    this->counts_.words += next.counts_.words;
+    this->counts_.word_characters += next.counts_.word_characters;
+    this->counts_.lines += next.counts_.lines;
+    this->counts_.longest_line = std::max(this->counts_.longest_line, next.counts_.longest_line);
+    this->counts_.sentences += next.counts_.sentences;
+    this->counts_.paragraphs += next.counts_.paragraphs;
+
+    // This counter's text ends with a line feed, so its open line is empty and the next counter's lines simply follow
+    if (next.has_closed_line_) {
+        if (next.first_line_has_text_ && !this->previous_line_is_blank_) {
+            --this->counts_.paragraphs;  // A paragraph that continues across the boundary was counted by both counters
+        }
+        if (!this->has_closed_line_) {
+            this->first_line_has_text_ = next.first_line_has_text_;
+            this->has_closed_line_ = true;
+        }
+        this->previous_line_is_blank_ = next.previous_line_is_blank_;
+    }
+    this->line_characters_ = next.line_characters_;
+    this->line_has_text_ = next.line_has_text_;
+
+    // The end of the text is the end of the next counter's text, unless it is all whitespace
+    if (next.has_text_) {
+        this->has_text_ = true;
+        this->last_text_is_terminator_ = next.last_text_is_terminator_;
+        this->last_text_is_cjk_terminator_ = next.last_text_is_cjk_terminator_;
+        this->has_trailing_whitespace_ = next.has_trailing_whitespace_;
+    }
+    else if (next.size_ != 0) {
+        this->has_trailing_whitespace_ = true;
+    }
+    if (next.size_ >= 2) {
+        this->tail_ = next.tail_;
+    }
+    else if (next.size_ == 1) {
+        this->tail_ = {this->tail_[1], next.tail_[1]};
+    }
+    this->segmenter_.merge(next.segmenter_);
+    this->whitespace_carry_ = next.size_ != 0 ? next.whitespace_carry_ : this->whitespace_carry_;
+    this->terminator_carry_ = next.size_ != 0 ? next.terminator_carry_ : this->terminator_carry_;
+    this->size_ += next.size_;
+}
+
+TextStats compute_stats(const std::string_view text,
+                        const std::size_t thread_count,
+                        const bool segment_words)
+{
+    // Split large texts into chunks that start at the beginning of a line, so no line, word, or character crosses a chunk
+    std::vector<std::size_t> boundaries = {0};
+    const std::size_t threads = thread_count != 0 ? thread_count : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    if (text.size() >= STATS_PARALLEL_THRESHOLD && threads > 1) [[unlikely]] {
+        for (std::size_t chunk = 1; chunk < threads; ++chunk) {
+            const std::size_t newline = text.find('\n', std::max(boundaries.back(), text.size() * chunk / threads));
+            if (newline == std::string_view::npos || newline + 1 == text.size()) {
+                break;
+            }
+            boundaries.push_back(newline + 1);
+        }
+    }
+    boundaries.push_back(text.size());
+
+    // The calling thread takes the first chunk, the others are joined before merging
+    std::vector<StatsCounter> counters(boundaries.size() - 1, StatsCounter{segment_words});
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(counters.size() - 1);
+        for (std::size_t chunk = 1; chunk < counters.size(); ++chunk) {
+            workers.emplace_back([&text, &boundaries, &counters, chunk] {
+                counters[chunk].add(text.substr(boundaries[chunk], boundaries[chunk + 1] - boundaries[chunk]));
+            });
+        }
+        counters[0].add(text.substr(0, boundaries[1]));
+    }
+    for (std::size_t chunk = 1; chunk < counters.size(); ++chunk) {
+        counters[0].merge(counters[chunk]);
+    }
+    return counters[0].stats();
+}
+
+std::size_t count_words(const std::string_view text)
 {
     std::size_t word_count = 0;
 
@@ -131,9 +727,21 @@ std::size_t count_words(const std::string &text)
     return word_count;
 }
 
-std::size_t count_characters(const std::string &text)
+std::size_t count_characters(const std::string_view text)
+{
+    // Every code point has exactly one byte that is not a continuation byte (10xxxxxx)
+    std::size_t count = 0;
+    for (const char character : text) {
+        count += (static_cast<unsigned char>(character) & 0xC0) != 0x80 ? 1 : 0;
+    }
+    return count;
+}
+
+std::size_t estimate_tokens(const std::string_view text)
 {
-    return sf::Utf8::count(text.cbegin(), text.cend());
+    // Round up, so any non-empty text is at least one token
+    const std::size_t by_characters = (count_characters(text) + 3) / 4;
+    return std::max(by_characters, count_words(text));
 }
 
 }  // namespace core::text
@@ -6,17 +6,309 @@
 
 #pragma once
 
-#include <cstddef>  // for std::size_t
-#include <string>   // for std::string
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include "core/diff.hpp"
+#include "core/words.hpp"
 
 namespace core::text {
 
+/**
+ * @brief Text size from which "compute_stats()" splits the text across several threads, in bytes (8 MiB).
+ */
+inline constexpr std::size_t STATS_PARALLEL_THRESHOLD = 8 * 1024 * 1024;
+
+/**
+ * @brief Average silent reading speed of adults, in words per minute, used to estimate the reading time.
+ */
+inline constexpr std::size_t READING_WORDS_PER_MINUTE = 238;
+
+/**
+ * @brief Optional cleanup rules applied on top of the character replacements.
+ */
+struct CleanupOptions {
+    /**
+     * @brief Remove phrases such as "As an AI language model, " together with the whitespace that follows them.
+     */
+    bool remove_ai_disclaimers = false;
+
+    /**
+     * @brief Remove markdown bold markers ("**").
+     */
+    bool remove_markdown_bold = false;
+
+    /**
+     * @brief Remove spaces and tabs at the end of every line.
+     */
+    bool trim_trailing_whitespace = false;
+
+    /**
+     * @brief Replace invalid UTF-8 sequences with U+FFFD before anything else, so the rules never see broken characters.
+     */
+    bool repair_invalid_utf8 = false;
+
+    /**
+     * @brief Leave Markdown code (fenced code blocks and inline code spans) and URLs unchanged, so code samples are not corrupted.
+     */
+    bool preserve_code = false;
+
+    /**
+     * @brief Turn Windows ("\r\n") and classic Mac ("\r") line endings into "\n".
+     */
+    bool normalize_line_endings = false;
+
+    /**
+     * @brief Collapse every run of spaces and tabs into a single space, including the spaces that other replacements produce (e.g., from U+00A0).
+     */
+    bool collapse_whitespace = false;
+};
+
 /**
  * @brief Remove unwanted characters from the provided text in place.
  *
+ * All replacements and enabled rules are applied in a single pass over the text, after the optional UTF-8 repair. Line endings and runs of whitespace, which the rules cannot express, are then handled by "pipeline::run()" in one more fused pass, only if enabled.
+ *
  * @param text String to modify in place (e.g., "hello world").
+ * @param options Optional rules to apply as well (e.g., "{.trim_trailing_whitespace = true}").
+ *
+ * @return Number of replacements made, including repaired UTF-8 sequences (e.g., "3").
+ */
+std::size_t remove_unwanted_characters(std::string &text,
+                                       const CleanupOptions &options = {});
+
+/**
+ * @brief List the replacements that "remove_unwanted_characters()" would make, without modifying the text.
+ *
+ * @param text Text to scan (e.g., "a — b").
+ * @param options Optional rules to apply as well (e.g., "{.trim_trailing_whitespace = true}").
+ *
+ * @return Changes sorted by position, all accepted (e.g., {{.begin = 2, .end = 5, .replacement = "-"}}). With UTF-8 repair enabled, every invalid sequence is a change to U+FFFD, and rule matches that overlap one are left out. With line endings or whitespace normalized, the changes are computed by "diff::compute_changes()" from the normalized text, so applying them gives exactly what "remove_unwanted_characters()" does.
+ */
+[[nodiscard]] std::vector<diff::Change> find_changes(const std::string_view text,
+                                                     const CleanupOptions &options = {});
+
+/**
+ * @brief Write the normalized form of the provided text into a caller-provided buffer.
+ *
+ * This applies the same replacements and rules as "remove_unwanted_characters()", but reads the input without copying it and writes straight into the output buffer. After the first call on a thread, it does not allocate, unless invalid UTF-8 has to be repaired first.
+ *
+ * @param text Text to normalize (e.g., "“hello”").
+ * @param output Buffer that receives the normalized text, not null-terminated; it must not overlap the input. May be null if "capacity" is 0.
+ * @param capacity Size of the output buffer, in bytes (e.g., "64").
+ * @param options Optional rules to apply as well (e.g., "{.trim_trailing_whitespace = true}").
+ *
+ * @return Size of the normalized text, in bytes (e.g., "7"). If this exceeds "capacity", only the first "capacity" bytes were written and the call should be repeated with a larger buffer.
+ */
+[[nodiscard]] std::size_t normalize_into(const std::string_view text,
+                                         char *output,
+                                         const std::size_t capacity,
+                                         const CleanupOptions &options = {});
+
+/**
+ * @brief Statistics of a text, as shown by the editor's status bar.
+ */
+struct TextStats {
+    /**
+     * @brief Number of characters (code points), like "count_characters()".
+     */
+    std::size_t characters = 0;
+
+    /**
+     * @brief Number of characters outside of ASCII (e.g., "ż" or "東").
+     */
+    std::size_t non_ascii_characters = 0;
+
+    /**
+     * @brief Number of words, like "count_words()", or like "words::Segmenter" when words are segmented.
+     */
+    std::size_t words = 0;
+
+    /**
+     * @brief Number of characters inside words, including attached punctuation.
+     */
+    std::size_t word_characters = 0;
+
+    /**
+     * @brief Number of lines; a text that ends with a line break has an empty last line, and an empty text has none.
+     */
+    std::size_t lines = 0;
+
+    /**
+     * @brief Number of characters in the longest line, without its line break.
+     */
+    std::size_t longest_line = 0;
+
+    /**
+     * @brief Number of sentences: ".", "!", or "?" followed by whitespace, "。", "！", or "？", plus a final sentence without one.
+     */
+    std::size_t sentences = 0;
+
+    /**
+     * @brief Number of paragraphs, i.e., runs of non-blank lines.
+     */
+    std::size_t paragraphs = 0;
+
+    /**
+     * @brief Return the average number of characters per word.
+     *
+     * @return Average word length, or 0 if there are no words (e.g., "4.7").
+     */
+    [[nodiscard]] double average_word_length() const
+    {
+        return this->words == 0 ? 0.0 : static_cast<double>(this->word_characters) / static_cast<double>(this->words);
+    }
+
+    /**
+     * @brief Estimate how long it takes to read the text silently, at "READING_WORDS_PER_MINUTE".
+     *
+     * @return Reading time in seconds, rounded up (e.g., "76").
+     */
+    [[nodiscard]] std::size_t reading_time_seconds() const
+    {
+        return (this->words * 60 + READING_WORDS_PER_MINUTE - 1) / READING_WORDS_PER_MINUTE;
+    }
+};
+
+/**
+ * @brief Incremental counterpart of "compute_stats()", for text that arrives in parts (e.g., while a file is being read).
+ *
+ * The parts may be split anywhere, even inside a UTF-8 sequence; the statistics of all parts added so far are the same as those of their concatenation.
  */
-void remove_unwanted_characters(std::string &text);
+class StatsCounter final {
+  public:
+    /**
+     * @brief Construct a new StatsCounter object.
+     *
+     * @param segment_words Whether to split runs of scripts written without spaces into words, like "words::Segmenter".
+     */
+    explicit StatsCounter(const bool segment_words = false);
+
+    /**
+     * @brief Add the next part of the text.
+     *
+     * @param part Bytes that follow the previously added ones (e.g., "Hello wor").
+     */
+    void add(const std::string_view part);
+
+    /**
+     * @brief Return the statistics of the text added so far.
+     *
+     * @return Statistics, as returned by "compute_stats()" for the concatenated parts.
+     */
+    [[nodiscard]] TextStats stats() const;
+
+  private:
+    friend TextStats compute_stats(const std::string_view text,
+                                   const std::size_t thread_count,
+                                   const bool segment_words);
+
+    /**
+     * @brief Append the counts of another counter, whose text started at the beginning of a line right after this one's.
+     *
+     * @param next Counter of the text that follows; this counter's text must end with a line feed.
+     */
+    void merge(const StatsCounter &next);
+
+    /**
+     * @brief Counts of the closed lines and completed sentences; "lines" holds the number of line feeds, and "words" the number of runs of non-whitespace.
+     */
+    TextStats counts_;
+
+    /**
+     * @brief Segmenter of the runs, used only if "segment_words_" is true.
+     */
+    words::Segmenter segmenter_;
+
+    /**
+     * @brief Whether to split runs of scripts written without spaces into words.
+     */
+    bool segment_words_;
+
+    /**
+     * @brief Number of bytes added so far.
+     */
+    std::size_t size_ = 0;
+
+    /**
+     * @brief Last two bytes added, to recognize a fullwidth terminator split across parts.
+     */
+    std::array<char, 2> tail_ = {};
+
+    /**
+     * @brief Whether the byte before the next part is whitespace (1) or not (0); the start of the text counts as whitespace.
+     */
+    std::uint64_t whitespace_carry_ = 1;
+
+    /**
+     * @brief Whether the byte before the next part is an ASCII sentence terminator (1) or not (0).
+     */
+    std::uint64_t terminator_carry_ = 0;
+
+    /**
+     * @brief Number of characters of the current, not yet closed line.
+     */
+    std::size_t line_characters_ = 0;
+
+    /**
+     * @brief Whether the current line has any non-whitespace character.
+     */
+    bool line_has_text_ = false;
+
+    /**
+     * @brief Whether the line before the current one is blank, or there is none.
+     */
+    bool previous_line_is_blank_ = true;
+
+    /**
+     * @brief Whether at least one line was closed by a line feed.
+     */
+    bool has_closed_line_ = false;
+
+    /**
+     * @brief Whether the first closed line has any non-whitespace character.
+     */
+    bool first_line_has_text_ = false;
+
+    /**
+     * @brief Whether any non-whitespace byte was added.
+     */
+    bool has_text_ = false;
+
+    /**
+     * @brief Whether the last non-whitespace byte is an ASCII sentence terminator.
+     */
+    bool last_text_is_terminator_ = false;
+
+    /**
+     * @brief Whether the last non-whitespace bytes are a fullwidth sentence terminator.
+     */
+    bool last_text_is_cjk_terminator_ = false;
+
+    /**
+     * @brief Whether whitespace follows the last non-whitespace byte.
+     */
+    bool has_trailing_whitespace_ = false;
+};
+
+/**
+ * @brief Compute all statistics of the provided text in a single pass.
+ *
+ * The text is classified 64 bytes at a time into bit masks (whitespace, line breaks, continuation bytes, ...), with SSE2 where available, and every counter is derived from the masks with population counts. Texts larger than "STATS_PARALLEL_THRESHOLD" are split at line breaks, scanned on several threads by separate "StatsCounter" objects, and the partial results are merged.
+ *
+ * @param text String to analyze (e.g., "Hello world.\n\nBye.").
+ * @param thread_count Number of threads for large texts, or 0 to use the number of hardware threads.
+ * @param segment_words Whether to split runs of scripts written without spaces into words, like "words::Segmenter" (e.g., "東京タワー" is three words instead of one).
+ *
+ * @return Statistics (e.g., "{.words = 3, .lines = 3, .sentences = 2, .paragraphs = 2, ...}").
+ */
+[[nodiscard]] TextStats compute_stats(const std::string_view text,
+                                      const std::size_t thread_count = 0,
+                                      const bool segment_words = false);
 
 /**
  * @brief Count the number of words in the provided text.
@@ -25,7 +317,7 @@ void remove_unwanted_characters(std::string &text);
  *
  * @return Number of words in the text (e.g., "2").
  */
-[[nodiscard]] std::size_t count_words(const std::string &text);
+[[nodiscard]] std::size_t count_words(const std::string_view text);
 
 /**
  * @brief Count the number of characters in the provided text.
@@ -34,6 +326,17 @@ void remove_unwanted_characters(std::string &text);
  *
  * @return Number of characters in the text (e.g., "11").
  */
-[[nodiscard]] std::size_t count_characters(const std::string &text);
+[[nodiscard]] std::size_t count_characters(const std::string_view text);
+
+/**
+ * @brief Estimate the number of tokens a language model would split the provided text into.
+ *
+ * This uses the common rule of thumb of four characters per token, but never returns fewer tokens than there are words.
+ *
+ * @param text String to analyze (e.g., "hello world").
+ *
+ * @return Estimated number of tokens (e.g., "3").
+ */
+[[nodiscard]] std::size_t estimate_tokens(const std::string_view text);
 
 }  // namespace core::text
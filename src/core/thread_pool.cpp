@@ -0,0 +1,145 @@
+/**
+ * @file thread_pool.cpp
+ */
+
+#include <algorithm>  // for std::max
+#include <cstddef>    // for std::size_t
+#include <exception>  // for std::current_exception, std::exception_ptr, std::rethrow_exception
+#include <memory>     // for std::make_unique
+#include <mutex>      // for std::lock_guard, std::unique_lock
+#include <thread>     // for std::jthread, std::thread::hardware_concurrency
+#include <utility>    // for std::exchange, std::move
+
+#include <spdlog/spdlog.h>
+
+#include "core/thread_pool.hpp"
+
+namespace core::thread_pool {
+
+ThreadPool::ThreadPool(const std::size_t thread_count)
+{
+    const std::size_t count = thread_count != 0 ? thread_count : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+    this->queues_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        this->queues_.push_back(std::make_unique<Queue>());
+    }
+
+    this->threads_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        this->threads_.emplace_back([this, i] { this->run_worker(i); });
+    }
+
+    SPDLOG_DEBUG("Started thread pool with '{}' workers", count);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        const std::lock_guard lock{this->mutex_};
+        this->stopping_ = true;
+    }
+    this->work_available_.notify_all();
+    this->threads_.clear();  // Join every worker
+
+    SPDLOG_DEBUG("Stopped thread pool");
+}
+
+void ThreadPool::submit(task_t task)
+{
+    // Count the task before it becomes visible, so a worker can never finish it before it was counted
+    {
+        const std::lock_guard lock{this->mutex_};
+        ++this->queued_;
+        ++this->pending_;
+    }
+    const std::size_t index = this->next_queue_.fetch_add(1, std::memory_order_relaxed) % this->queues_.size();
+    {
+        Queue &queue = *this->queues_[index];
+        const std::lock_guard lock{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+    }
+    this->work_available_.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock lock{this->mutex_};
+    this->all_done_.wait(lock, [this] { return this->pending_ == 0; });
+
+    if (this->first_exception_) [[unlikely]] {
+        const std::exception_ptr exception = std::exchange(this->first_exception_, nullptr);
+        std::rethrow_exception(exception);
+    }
+}
+
+bool ThreadPool::try_take(const std::size_t index,
+                          task_t &task)
+{
+    // Own queue first, oldest task first
+    {
+        Queue &own = *this->queues_[index];
+        const std::lock_guard lock{own.mutex};
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Steal the newest task of another worker, starting with the next neighbour so thieves spread out
+    for (std::size_t offset = 1; offset < this->queues_.size(); ++offset) {
+        Queue &victim = *this->queues_[(index + offset) % this->queues_.size()];
+        const std::lock_guard lock{victim.mutex};
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::run_worker(const std::size_t index)
+{
+    while (true) {
+        task_t task;
+        if (this->try_take(index, task)) {
+            {
+                const std::lock_guard lock{this->mutex_};
+                --this->queued_;
+            }
+
+            std::exception_ptr exception;
+            try {
+                task();
+            }
+            catch (...) {
+                exception = std::current_exception();
+            }
+
+            bool is_last = false;
+            {
+                const std::lock_guard lock{this->mutex_};
+                if (exception && !this->first_exception_) [[unlikely]] {
+                    this->first_exception_ = exception;
+                }
+                is_last = --this->pending_ == 0;
+            }
+            if (is_last) {
+                this->all_done_.notify_all();
+            }
+            continue;
+        }
+
+        // Every queue is empty; sleep until something is queued or the pool stops
+        std::unique_lock lock{this->mutex_};
+        this->work_available_.wait(lock, [this] { return this->stopping_ || this->queued_ > 0; });
+        if (this->stopping_ && this->queued_ == 0) {
+            return;
+        }
+    }
+}
+
+}  // namespace core::thread_pool
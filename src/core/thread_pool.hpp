@@ -0,0 +1,155 @@
+/**
+ * @file thread_pool.hpp
+ *
+ * @brief Work-stealing thread pool for independent tasks.
+ */
+
+#pragma once
+
+#include <atomic>              // for std::atomic
+#include <condition_variable>  // for std::condition_variable
+#include <cstddef>             // for std::size_t
+#include <deque>               // for std::deque
+#include <exception>           // for std::exception_ptr
+#include <functional>          // for std::function
+#include <memory>              // for std::unique_ptr
+#include <mutex>               // for std::mutex
+#include <thread>              // for std::jthread
+#include <vector>              // for std::vector
+
+namespace core::thread_pool {
+
+/**
+ * @brief Fixed set of worker threads that execute submitted tasks.
+ *
+ * Every worker owns a queue. Submitted tasks are spread over the queues round-robin; a worker takes tasks from the front of its own queue and, once it runs dry, steals from the back of the other queues, so a few slow tasks do not leave the remaining workers idle.
+ */
+class ThreadPool final {
+  public:
+    using task_t = std::function<void()>;
+
+    /**
+     * @brief Construct a new ThreadPool object and start its workers.
+     *
+     * @param thread_count Number of workers (e.g., "8"), or 0 to use the number of hardware threads.
+     */
+    explicit ThreadPool(const std::size_t thread_count = 0);
+
+    /**
+     * @brief Finish all queued tasks, then stop and join the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Queue a task for execution.
+     *
+     * @param task Task to run on one of the workers.
+     */
+    void submit(task_t task);
+
+    /**
+     * @brief Block until every submitted task has finished.
+     *
+     * @throws Any exception thrown by a task; only the first one is kept, the remaining tasks still run.
+     */
+    void wait();
+
+    /**
+     * @brief Return the number of workers.
+     *
+     * @return Number of workers (e.g., "8").
+     */
+    [[nodiscard]] std::size_t size() const
+    {
+        return this->queues_.size();
+    }
+
+  private:
+    /**
+     * @brief Task queue owned by a single worker.
+     */
+    struct Queue {
+        /**
+         * @brief Guards "tasks".
+         */
+        std::mutex mutex;
+
+        /**
+         * @brief Tasks waiting to run.
+         */
+        std::deque<task_t> tasks;
+    };
+
+    /**
+     * @brief Main loop of a worker.
+     *
+     * @param index Index of the worker's own queue.
+     */
+    void run_worker(const std::size_t index);
+
+    /**
+     * @brief Take a task from the worker's own queue, or steal one from another queue.
+     *
+     * @param index Index of the worker's own queue.
+     * @param task Receives the task.
+     *
+     * @return True if a task was taken, false if every queue is empty.
+     */
+    bool try_take(const std::size_t index,
+                  task_t &task);
+
+    /**
+     * @brief One queue per worker; pointers keep the mutexes at stable addresses.
+     */
+    std::vector<std::unique_ptr<Queue>> queues_;
+
+    /**
+     * @brief Queue that receives the next submitted task.
+     */
+    std::atomic<std::size_t> next_queue_{0};
+
+    /**
+     * @brief Guards "queued_", "pending_", "stopping_" and "first_exception_".
+     */
+    std::mutex mutex_;
+
+    /**
+     * @brief Signalled when a task is queued or the pool stops.
+     */
+    std::condition_variable work_available_;
+
+    /**
+     * @brief Signalled when the last pending task finishes.
+     */
+    std::condition_variable all_done_;
+
+    /**
+     * @brief Number of tasks sitting in the queues.
+     */
+    std::size_t queued_ = 0;
+
+    /**
+     * @brief Number of tasks that were submitted but have not finished yet.
+     */
+    std::size_t pending_ = 0;
+
+    /**
+     * @brief Whether the workers should exit once the queues are empty.
+     */
+    bool stopping_ = false;
+
+    /**
+     * @brief First exception thrown by a task since the last "wait()".
+     */
+    std::exception_ptr first_exception_;
+
+    /**
+     * @brief Worker threads, declared last so they start after, and are joined before, everything above is destroyed.
+     */
+    std::vector<std::jthread> threads_;
+};
+
+}  // namespace core::thread_pool
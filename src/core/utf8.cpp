@@ -0,0 +1,507 @@
+/**
+ * @file utf8.cpp
+ */
+
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <cstring>      // for std::memcpy
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#define UNGPT_UTF8_SSSE3
+#include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define UNGPT_UTF8_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define UNGPT_UTF8_NEON
+#include <arm_neon.h>
+#endif
+
+#include "core/utf8.hpp"
+
+namespace core::utf8 {
+
+namespace {
+
+/**
+ * @brief Mask of the high bit of every byte in a 64-bit word; a byte with its high bit set is not ASCII.
+ */
+constexpr std::uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+/**
+ * @brief Number of bytes validated one sequence at a time before returning to the ASCII fast path.
+ */
+constexpr std::size_t SCALAR_STRIDE = 32;
+
+/**
+ * @brief Sequence that starts at a given byte.
+ */
+struct Sequence {
+    /**
+     * @brief Length of the sequence if valid; otherwise the length of its maximal subpart, at least 1.
+     */
+    std::size_t length = 0;
+
+    /**
+     * @brief Whether the sequence is a complete, well-formed UTF-8 sequence.
+     */
+    bool is_valid = false;
+};
+
+/**
+ * @brief Decode the sequence that starts at a byte, following table 3-7 of the Unicode Standard.
+ *
+ * @param data Bytes of the text.
+ * @param size Number of bytes in the text.
+ * @param position Offset of the first byte of the sequence.
+ *
+ * @return Length and validity of the sequence.
+ */
+[[nodiscard]] Sequence decode(const unsigned char *data,
+                              const std::size_t size,
+                              const std::size_t position)
+{
+    const unsigned char lead = data[position];
+    std::size_t length;
+
+    // Most leads allow any continuation byte next; a few narrow the second byte to rule out overlongs, surrogates, and code points above U+10FFFF
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (lead < 0x80) [[likely]] {
+        return {.length = 1, .is_valid = true};
+    }
+    else if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        low = lead == 0xE0 ? 0xA0 : low;
+        high = lead == 0xED ? 0x9F : high;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        low = lead == 0xF0 ? 0x90 : low;
+        high = lead == 0xF4 ? 0x8F : high;
+    }
+    else {
+        return {.length = 1, .is_valid = false};
+    }
+
+    for (std::size_t matched = 1; matched < length; ++matched) {
+        if (position + matched >= size || data[position + matched] < low || data[position + matched] > high) {
+            return {.length = matched, .is_valid = false};
+        }
+        low = 0x80;
+        high = 0xBF;
+    }
+    return {.length = length, .is_valid = true};
+}
+
+#if defined(UNGPT_UTF8_SSSE3) || defined(UNGPT_UTF8_NEON)
+
+/**
+ * @brief Return the start of a sequence cut in half by a block boundary, so the scalar code sees it whole.
+ *
+ * @param data Bytes of the text.
+ * @param start Offset before which nothing is inspected.
+ * @param position Offset of the block boundary.
+ *
+ * @return Offset of the lead byte of the sequence that spans the boundary, or "position" if none does.
+ */
+[[nodiscard]] std::size_t back_to_sequence_start(const unsigned char *data,
+                                                 const std::size_t start,
+                                                 const std::size_t position)
+{
+    for (std::size_t back = 1; back <= 3 && back <= position - start; ++back) {
+        const unsigned char byte = data[position - back];
+        if (byte >= 0xC0) {
+            const std::size_t length = byte >= 0xF0 ? 4 : (byte >= 0xE0 ? 3 : 2);
+            return back < length ? position - back : position;
+        }
+        if (byte < 0x80) {
+            break;
+        }
+    }
+    return position;
+}
+
+// Validate 16 bytes at a time with three table lookups per block, following Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte" (2021)
+// Each table maps a nibble to the set of errors it could take part in; an error is real only if all three nibbles agree on it
+
+constexpr std::uint8_t TOO_SHORT = 1 << 0;       // Lead byte followed by a lead byte or ASCII
+constexpr std::uint8_t TOO_LONG = 1 << 1;        // ASCII followed by a continuation byte
+constexpr std::uint8_t OVERLONG_3 = 1 << 2;      // E0 followed by 80..9F
+constexpr std::uint8_t TOO_LARGE = 1 << 3;       // F4 followed by 90..BF, or F5..FF
+constexpr std::uint8_t SURROGATE = 1 << 4;       // ED followed by A0..BF
+constexpr std::uint8_t OVERLONG_2 = 1 << 5;      // C0 or C1
+constexpr std::uint8_t TOO_LARGE_1000 = 1 << 6;  // F5..FF followed by 80..8F
+constexpr std::uint8_t OVERLONG_4 = 1 << 6;      // F0 followed by 80..8F
+constexpr std::uint8_t TWO_CONTS = 1 << 7;       // Continuation byte followed by a continuation byte
+constexpr std::uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+/**
+ * @brief Errors indexed by the high nibble of the first byte of a pair.
+ */
+alignas(16) constexpr std::uint8_t BYTE_1_HIGH[16] = {
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+};
+
+/**
+ * @brief Errors indexed by the low nibble of the first byte of a pair.
+ */
+alignas(16) constexpr std::uint8_t BYTE_1_LOW[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    CARRY | OVERLONG_2,
+    CARRY,
+    CARRY,
+    CARRY | TOO_LARGE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+};
+
+/**
+ * @brief Errors indexed by the high nibble of the second byte of a pair.
+ */
+alignas(16) constexpr std::uint8_t BYTE_2_HIGH[16] = {
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+};
+
+/**
+ * @brief Largest value each of the last three bytes of a block may have without starting a sequence that continues into the next block.
+ */
+alignas(16) constexpr std::uint8_t INCOMPLETE_LIMITS[16] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+
+// Thin wrappers over the 16-byte vector instructions, so the validation below is written once for both instruction sets
+#if defined(UNGPT_UTF8_SSSE3)
+using vector_t = __m128i;
+
+[[nodiscard]] inline vector_t load(const unsigned char *address)
+{
+    return _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(address)));
+}
+
+[[nodiscard]] inline vector_t splat(const std::uint8_t value)
+{
+    return _mm_set1_epi8(static_cast<char>(value));
+}
+
+[[nodiscard]] inline vector_t lookup(const std::uint8_t (&table)[16], const vector_t nibbles)
+{
+    return _mm_shuffle_epi8(load(table), nibbles);
+}
+
+[[nodiscard]] inline vector_t high_nibbles(const vector_t input)
+{
+    return _mm_and_si128(_mm_srli_epi16(input, 4), splat(0x0F));
+}
+
+[[nodiscard]] inline vector_t low_nibbles(const vector_t input)
+{
+    return _mm_and_si128(input, splat(0x0F));
+}
+
+template <int N>
+[[nodiscard]] inline vector_t previous_bytes(const vector_t input, const vector_t previous)
+{
+    return _mm_alignr_epi8(input, previous, 16 - N);
+}
+
+[[nodiscard]] inline vector_t saturating_sub(const vector_t a, const vector_t b)
+{
+    return _mm_subs_epu8(a, b);
+}
+
+[[nodiscard]] inline vector_t bitwise_and(const vector_t a, const vector_t b)
+{
+    return _mm_and_si128(a, b);
+}
+
+[[nodiscard]] inline vector_t bitwise_or(const vector_t a, const vector_t b)
+{
+    return _mm_or_si128(a, b);
+}
+
+[[nodiscard]] inline vector_t bitwise_xor(const vector_t a, const vector_t b)
+{
+    return _mm_xor_si128(a, b);
+}
+
+[[nodiscard]] inline bool is_zero(const vector_t input)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(input, _mm_setzero_si128())) == 0xFFFF;
+}
+
+[[nodiscard]] inline bool is_ascii(const vector_t input)
+{
+    return _mm_movemask_epi8(input) == 0;
+}
+#else
+using vector_t = uint8x16_t;
+
+[[nodiscard]] inline vector_t load(const unsigned char *address)
+{
+    return vld1q_u8(address);
+}
+
+[[nodiscard]] inline vector_t splat(const std::uint8_t value)
+{
+    return vdupq_n_u8(value);
+}
+
+[[nodiscard]] inline vector_t lookup(const std::uint8_t (&table)[16], const vector_t nibbles)
+{
+    return vqtbl1q_u8(vld1q_u8(table), nibbles);
+}
+
+[[nodiscard]] inline vector_t high_nibbles(const vector_t input)
+{
+    return vshrq_n_u8(input, 4);
+}
+
+[[nodiscard]] inline vector_t low_nibbles(const vector_t input)
+{
+    return vandq_u8(input, splat(0x0F));
+}
+
+template <int N>
+[[nodiscard]] inline vector_t previous_bytes(const vector_t input, const vector_t previous)
+{
+    return vextq_u8(previous, input, 16 - N);
+}
+
+[[nodiscard]] inline vector_t saturating_sub(const vector_t a, const vector_t b)
+{
+    return vqsubq_u8(a, b);
+}
+
+[[nodiscard]] inline vector_t bitwise_and(const vector_t a, const vector_t b)
+{
+    return vandq_u8(a, b);
+}
+
+[[nodiscard]] inline vector_t bitwise_or(const vector_t a, const vector_t b)
+{
+    return vorrq_u8(a, b);
+}
+
+[[nodiscard]] inline vector_t bitwise_xor(const vector_t a, const vector_t b)
+{
+    return veorq_u8(a, b);
+}
+
+[[nodiscard]] inline bool is_zero(const vector_t input)
+{
+    return vmaxvq_u8(input) == 0;
+}
+
+[[nodiscard]] inline bool is_ascii(const vector_t input)
+{
+    return vmaxvq_u8(input) < 0x80;
+}
+#endif
+
+/**
+ * @brief Find the errors in a block that is not pure ASCII.
+ *
+ * @param input Block to check.
+ * @param previous Block before it, whose last three bytes may start sequences that continue into this block.
+ *
+ * @return Non-zero bytes where the block is invalid.
+ */
+[[nodiscard]] inline vector_t check_block(const vector_t input,
+                                          const vector_t previous)
+{
+    // Pairs of adjacent bytes catch everything except missing or excess third and fourth bytes
+    const vector_t previous_1 = previous_bytes<1>(input, previous);
+    const vector_t special_cases = bitwise_and(bitwise_and(lookup(BYTE_1_HIGH, high_nibbles(previous_1)),
+                                                           lookup(BYTE_1_LOW, low_nibbles(previous_1))),
+                                               lookup(BYTE_2_HIGH, high_nibbles(input)));
+
+    // A byte two after a three- or four-byte lead, or three after a four-byte lead, must be a continuation byte; that is exactly where TWO_CONTS is expected
+    const vector_t is_third_byte = saturating_sub(previous_bytes<2>(input, previous), splat(0xE0 - 0x80));
+    const vector_t is_fourth_byte = saturating_sub(previous_bytes<3>(input, previous), splat(0xF0 - 0x80));
+    const vector_t must_be_continuation = bitwise_and(bitwise_or(is_third_byte, is_fourth_byte), splat(0x80));
+
+    return bitwise_xor(must_be_continuation, special_cases);
+}
+
+/**
+ * @brief Skip blocks of valid UTF-8.
+ *
+ * @param data Bytes of the text.
+ * @param size Number of bytes in the text.
+ * @param position Offset where skipping starts, at the start of a sequence.
+ *
+ * @return Offset at the start of a sequence, before which the text is valid; the scalar code takes over from there.
+ */
+[[nodiscard]] std::size_t skip_valid(const unsigned char *data,
+                                     const std::size_t size,
+                                     std::size_t position)
+{
+    const std::size_t start = position;
+    vector_t previous = splat(0);
+    vector_t previous_incomplete = splat(0);
+    while (position + 16 <= size) {
+        const vector_t input = load(data + position);
+        if (is_ascii(input)) [[likely]] {
+            // Only a sequence left unfinished by the previous block can make an ASCII block invalid
+            if (!is_zero(previous_incomplete)) [[unlikely]] {
+                break;
+            }
+            previous_incomplete = splat(0);
+        }
+        else {
+            if (!is_zero(check_block(input, previous))) [[unlikely]] {
+                break;
+            }
+            previous_incomplete = saturating_sub(input, load(INCOMPLETE_LIMITS));
+        }
+        previous = input;
+        position += 16;
+    }
+    return back_to_sequence_start(data, start, position);
+}
+
+#else
+
+/**
+ * @brief Skip bytes as long as they are ASCII, which is most of the text in practice.
+ *
+ * @param data Bytes of the text.
+ * @param size Number of bytes in the text.
+ * @param position Offset where skipping starts.
+ *
+ * @return Offset of the first block that may contain a non-ASCII byte; the byte itself can be a few bytes further.
+ */
+[[nodiscard]] std::size_t skip_valid(const unsigned char *data,
+                                     const std::size_t size,
+                                     std::size_t position)
+{
+#if defined(UNGPT_UTF8_SSE2)
+    // Test 64 bytes per iteration: OR the four blocks together, a set high bit anywhere ends the run
+    const auto load = [data](const std::size_t offset) {
+        return _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(data + offset)));
+    };
+    while (position + 64 <= size) {
+        const __m128i combined = _mm_or_si128(_mm_or_si128(load(position), load(position + 16)),
+                                              _mm_or_si128(load(position + 32), load(position + 48)));
+        if (_mm_movemask_epi8(combined) != 0) {
+            break;
+        }
+        position += 64;
+    }
+#else
+    static_cast<void>(data);
+    static_cast<void>(size);
+#endif
+    return position;
+}
+
+#endif
+
+}  // namespace
+
+std::size_t find_invalid(const std::string_view text,
+                         const std::size_t start)
+{
+    const auto *data = reinterpret_cast<const unsigned char *>(text.data());
+    const std::size_t size = text.size();
+    std::size_t position = start;
+
+    while (position < size) {
+        position = skip_valid(data, size, position);
+
+        // Skip whatever ASCII the vector code left, one 64-bit word at a time
+        while (position + 8 <= size) {
+            std::uint64_t word;
+            std::memcpy(&word, data + position, sizeof(word));
+            if ((word & HIGH_BITS) != 0) {
+                break;
+            }
+            position += 8;
+        }
+
+        // Validate sequence by sequence for a short stretch, then try the fast path again
+        const std::size_t scalar_end = std::min(size, position + SCALAR_STRIDE);
+        while (position < scalar_end) {
+            const Sequence sequence = decode(data, size, position);
+            if (!sequence.is_valid) [[unlikely]] {
+                return position;
+            }
+            position += sequence.length;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+std::size_t invalid_sequence_length(const std::string_view text,
+                                    const std::size_t position)
+{
+    return decode(reinterpret_cast<const unsigned char *>(text.data()), text.size(), position).length;
+}
+
+std::vector<std::size_t> find_invalid_sequences(const std::string_view text)
+{
+    std::vector<std::size_t> offsets;
+    for (std::size_t position = find_invalid(text); position != std::string_view::npos; position = find_invalid(text, position + invalid_sequence_length(text, position))) {
+        offsets.push_back(position);
+    }
+    return offsets;
+}
+
+std::size_t repair(std::string &text,
+                   std::vector<std::size_t> *offsets)
+{
+    std::size_t position = find_invalid(text);
+    if (position == std::string_view::npos) [[likely]] {
+        return 0;
+    }
+
+    // Copy the valid spans and one replacement character per invalid sequence into a fresh buffer
+    std::string result;
+    result.reserve(text.size() + REPLACEMENT_CHARACTER.size());
+    std::size_t copied_until = 0;
+    std::size_t count = 0;
+    while (position != std::string_view::npos) {
+        result.append(text, copied_until, position - copied_until);
+        if (offsets != nullptr) {
+            offsets->push_back(result.size());
+        }
+        result.append(REPLACEMENT_CHARACTER);
+        copied_until = position + invalid_sequence_length(text, position);
+        ++count;
+        position = find_invalid(text, copied_until);
+    }
+    result.append(text, copied_until);
+    text.swap(result);
+
+    return count;
+}
+
+}  // namespace core::utf8
@@ -0,0 +1,79 @@
+/**
+ * @file utf8.hpp
+ *
+ * @brief Fast UTF-8 validation and lossy repair.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+namespace core::utf8 {
+
+/**
+ * @brief UTF-8 encoding of U+FFFD REPLACEMENT CHARACTER, which replaces invalid sequences.
+ */
+inline constexpr std::string_view REPLACEMENT_CHARACTER = "\xEF\xBF\xBD";
+
+/**
+ * @brief Find the first byte that is not part of a valid UTF-8 sequence.
+ *
+ * ASCII runs are skipped 64 bytes at a time with SIMD (SSE2 or NEON, 8 bytes at a time otherwise); overlong encodings, surrogates, and code points above U+10FFFF are rejected.
+ *
+ * @param text Text to check (e.g., "caf\xC3").
+ * @param start Byte offset where the check starts; must be at the start of a sequence (e.g., "0").
+ *
+ * @return Byte offset of the first invalid sequence (e.g., "3"), or std::string_view::npos if the rest of the text is valid.
+ */
+[[nodiscard]] std::size_t find_invalid(const std::string_view text,
+                                       const std::size_t start = 0);
+
+/**
+ * @brief Check whether the provided text is valid UTF-8.
+ *
+ * @param text Text to check (e.g., "café").
+ *
+ * @return True if the text is valid UTF-8, false otherwise.
+ */
+[[nodiscard]] inline bool is_valid(const std::string_view text)
+{
+    return find_invalid(text) == std::string_view::npos;
+}
+
+/**
+ * @brief Return the length of the invalid sequence at an offset, i.e., its maximal subpart as defined by the Unicode Standard (section 3.9).
+ *
+ * @param text Text that contains the invalid sequence (e.g., "\xE2\x80x").
+ * @param position Byte offset of the invalid sequence, as returned by "find_invalid()" (e.g., "0").
+ *
+ * @return Number of bytes that one U+FFFD replaces, between 1 and 3 (e.g., "2").
+ */
+[[nodiscard]] std::size_t invalid_sequence_length(const std::string_view text,
+                                                  const std::size_t position);
+
+/**
+ * @brief Find every invalid sequence in the provided text.
+ *
+ * @param text Text to check (e.g., "a\xFF" "b\xFF").
+ *
+ * @return Byte offsets of the invalid sequences, in order (e.g., {1, 3}); empty if the text is valid.
+ */
+[[nodiscard]] std::vector<std::size_t> find_invalid_sequences(const std::string_view text);
+
+/**
+ * @brief Replace every invalid sequence in the provided text with U+FFFD, in place.
+ *
+ * Valid text is left untouched without copying it.
+ *
+ * @param text String to repair in place (e.g., "caf\xC3").
+ * @param offsets If not null, receives the byte offsets of the inserted U+FFFD characters in the repaired text (e.g., {3}).
+ *
+ * @return Number of invalid sequences that were replaced (e.g., "1").
+ */
+std::size_t repair(std::string &text,
+                   std::vector<std::size_t> *offsets = nullptr);
+
+}  // namespace core::utf8
@@ -0,0 +1,315 @@
+/**
+ * @file words.cpp
+ */
+
+#include <array>             // for std::array
+#include <cstddef>           // for std::size_t
+#include <cstdint>           // for std::uint64_t
+#include <cstring>           // for std::memcpy
+#include <initializer_list>  // for std::initializer_list
+#include <string_view>       // for std::string_view
+
+#include "core/word_break_table.hpp"
+#include "core/words.hpp"
+
+namespace core::words {
+
+namespace {
+
+/**
+ * @brief Number of code points in Unicode.
+ */
+constexpr char32_t CODE_POINT_COUNT = 0x110000;
+
+/**
+ * @brief Look up the class of a code point in the generated two-stage table.
+ *
+ * @param code_point Code point below "CODE_POINT_COUNT".
+ *
+ * @return Class of the code point.
+ */
+[[nodiscard]] constexpr WordBreak lookup(const char32_t code_point)
+{
+    const std::size_t block = table::BLOCK_INDICES[code_point >> table::BLOCK_SHIFT];
+    const std::size_t index = (block << table::BLOCK_SHIFT | (code_point & ((char32_t{1} << table::BLOCK_SHIFT) - 1))) / 2;
+    return static_cast<WordBreak>((table::BLOCKS[index] >> ((code_point & 1) * 4)) & 0x0F);
+}
+
+/**
+ * @brief Classes of the ASCII characters, flattened out of the table for the fast path.
+ */
+constexpr std::array<WordBreak, 128> ASCII_WORD_BREAKS = [] {
+    std::array<WordBreak, 128> word_breaks{};
+    for (char32_t code_point = 0; code_point < word_breaks.size(); ++code_point) {
+        word_breaks[code_point] = lookup(code_point);
+    }
+    return word_breaks;
+}();
+
+static_assert(ASCII_WORD_BREAKS['a'] == WordBreak::ALetter && ASCII_WORD_BREAKS['7'] == WordBreak::Numeric && ASCII_WORD_BREAKS['.'] == WordBreak::MidNumLet,
+              "word_break_table.hpp does not match WordBreak; regenerate it with tools/generate_word_break.py");
+
+/**
+ * @brief Check whether a byte is whitespace, like "text::count_words()".
+ *
+ * @param byte Byte to check.
+ *
+ * @return True for " ", "\t", "\n", "\v", "\f", and "\r", false otherwise.
+ */
+[[nodiscard]] constexpr bool is_whitespace(const unsigned char byte)
+{
+    return byte == ' ' || (byte >= '\t' && byte <= '\r');
+}
+
+/**
+ * @brief Check whether a class is a letter of UAX #29 ("AHLetter").
+ *
+ * @param word_break Class to check.
+ *
+ * @return True for "WordBreak::ALetter" and "WordBreak::HebrewLetter", false otherwise.
+ */
+[[nodiscard]] constexpr bool is_letter(const WordBreak word_break)
+{
+    return word_break == WordBreak::ALetter || word_break == WordBreak::HebrewLetter;
+}
+
+/**
+ * @brief Check whether a character continues the segment of the characters before it, i.e., there is no word boundary in front of it.
+ *
+ * @param before_previous Class of the character before "previous", ignoring "WordBreak::Extend".
+ * @param previous Class of the character before "current", ignoring "WordBreak::Extend".
+ * @param current Class of the character to check.
+ *
+ * @return True if the character joins the segment, false if it starts a new one.
+ */
+[[nodiscard]] constexpr bool joins_segment(const WordBreak before_previous,
+                                           const WordBreak previous,
+                                           const WordBreak current)
+{
+    switch (current) {
+    case WordBreak::ALetter:
+    case WordBreak::HebrewLetter:
+        // WB5, WB9, WB13b, and across punctuation, WB6/WB7 (e.g., "can't") and WB7b/WB7c (e.g., Hebrew abbreviations)
+        return is_letter(previous) ||
+               previous == WordBreak::Numeric ||
+               previous == WordBreak::ExtendNumLet ||
+               (is_letter(before_previous) && (previous == WordBreak::MidLetter || previous == WordBreak::MidNumLet || previous == WordBreak::SingleQuote)) ||
+               (current == WordBreak::HebrewLetter && before_previous == WordBreak::HebrewLetter && previous == WordBreak::DoubleQuote);
+    case WordBreak::Numeric:
+        // WB8, WB10, WB13b, and across punctuation, WB11/WB12 (e.g., "3.14")
+        return previous == WordBreak::Numeric ||
+               is_letter(previous) ||
+               previous == WordBreak::ExtendNumLet ||
+               (before_previous == WordBreak::Numeric && (previous == WordBreak::MidNum || previous == WordBreak::MidNumLet || previous == WordBreak::SingleQuote));
+    case WordBreak::Katakana:
+        // WB13, WB13b
+        return previous == WordBreak::Katakana || previous == WordBreak::ExtendNumLet;
+    case WordBreak::ExtendNumLet:
+        // WB13a
+        return is_letter(previous) || previous == WordBreak::Numeric || previous == WordBreak::Katakana || previous == WordBreak::ExtendNumLet;
+    case WordBreak::MidLetter:
+    case WordBreak::MidNum:
+    case WordBreak::MidNumLet:
+    case WordBreak::SingleQuote:
+    case WordBreak::DoubleQuote:
+        // Whether punctuation stays inside a word depends on the next character, which checks it as "previous"
+        return true;
+    case WordBreak::Other:
+    case WordBreak::Space:
+    case WordBreak::Extend:
+    case WordBreak::Ideographic:
+        // WB999: a boundary everywhere else, so every ideograph is a word of its own
+        return false;
+    }
+    return false;
+}
+
+/**
+ * @brief Number of word break classes.
+ */
+constexpr std::size_t WORD_BREAK_COUNT = static_cast<std::size_t>(WordBreak::DoubleQuote) + 1;
+
+/**
+ * @brief "joins_segment()" for every combination of classes, indexed by "before_previous", "previous", and "current", so that adding a character takes no branches.
+ */
+constexpr auto JOINS = [] {
+    std::array<std::array<std::array<bool, WORD_BREAK_COUNT>, WORD_BREAK_COUNT>, WORD_BREAK_COUNT> joins{};
+    for (std::size_t before_previous = 0; before_previous < WORD_BREAK_COUNT; ++before_previous) {
+        for (std::size_t previous = 0; previous < WORD_BREAK_COUNT; ++previous) {
+            for (std::size_t current = 0; current < WORD_BREAK_COUNT; ++current) {
+                joins[before_previous][previous][current] = joins_segment(static_cast<WordBreak>(before_previous), static_cast<WordBreak>(previous), static_cast<WordBreak>(current));
+            }
+        }
+    }
+    return joins;
+}();
+
+/**
+ * @brief Whether a segment with a character of each class is a word, i.e., the class is a letter or digit.
+ */
+constexpr auto IS_WORD = [] {
+    std::array<bool, WORD_BREAK_COUNT> is_word{};
+    for (const WordBreak word_break : {WordBreak::ALetter, WordBreak::HebrewLetter, WordBreak::Numeric, WordBreak::Katakana, WordBreak::Ideographic}) {
+        is_word[static_cast<std::size_t>(word_break)] = true;
+    }
+    return is_word;
+}();
+
+/**
+ * @brief Whether a character of each class splits its run into words, i.e., it belongs to a script written without spaces or is a non-ASCII space.
+ */
+constexpr auto SPLITS_RUN = [] {
+    std::array<bool, WORD_BREAK_COUNT> splits_run{};
+    for (const WordBreak word_break : {WordBreak::Space, WordBreak::Katakana, WordBreak::Ideographic}) {
+        splits_run[static_cast<std::size_t>(word_break)] = true;
+    }
+    return splits_run;
+}();
+
+/**
+ * @brief Find where the run of ASCII bytes that starts at an offset ends, eight bytes at a time.
+ *
+ * @param part Bytes to search.
+ * @param offset Offset to start at.
+ *
+ * @return Offset of the first byte that is not ASCII, or the size of the part.
+ */
+[[nodiscard]] std::size_t find_ascii_end(const std::string_view part,
+                                         std::size_t offset)
+{
+    for (; offset + 8 <= part.size(); offset += 8) {
+        std::uint64_t bytes;
+        std::memcpy(&bytes, part.data() + offset, sizeof(bytes));
+        if ((bytes & 0x8080808080808080) != 0) {
+            break;
+        }
+    }
+    while (offset < part.size() && static_cast<unsigned char>(part[offset]) < 0x80) {
+        ++offset;
+    }
+    return offset;
+}
+
+}  // namespace
+
+WordBreak get_word_break(const char32_t code_point)
+{
+    return code_point < CODE_POINT_COUNT ? lookup(code_point) : WordBreak::Other;
+}
+
+void Segmenter::add(const std::string_view part)
+{
+    std::size_t offset = 0;
+    while (offset < part.size()) {
+        // ASCII never splits a run, so outside of a split run only the run still open after the ASCII bytes needs classifying
+        if (this->pending_bytes_ == 0 && !this->is_split_) {
+            const std::size_t end = find_ascii_end(part, offset);
+            if (end != offset) {
+                std::size_t start = end;
+                while (start > offset && !is_whitespace(static_cast<unsigned char>(part[start - 1]))) {
+                    --start;
+                }
+                if (start != offset) {
+                    this->close_run();
+                }
+                for (; start < end; ++start) {
+                    this->add_character(ASCII_WORD_BREAKS[static_cast<unsigned char>(part[start])]);
+                }
+                offset = end;
+                continue;
+            }
+        }
+
+        // Otherwise, decode one byte at a time; invalid and truncated sequences are classified like U+FFFD
+        const auto byte = static_cast<unsigned char>(part[offset++]);
+        if (this->pending_bytes_ != 0) {
+            if ((byte & 0xC0) == 0x80) [[likely]] {
+                this->code_point_ = (this->code_point_ << 6) | (byte & 0x3Fu);
+                if (--this->pending_bytes_ == 0) {
+                    this->add_character(get_word_break(this->code_point_));
+                }
+                continue;
+            }
+            this->pending_bytes_ = 0;
+            this->add_character(WordBreak::Other);
+        }
+        if (byte < 0x80) {
+            if (is_whitespace(byte)) {
+                this->close_run();
+            }
+            else {
+                this->add_character(ASCII_WORD_BREAKS[byte]);
+            }
+        }
+        else if (byte >= 0xC2 && byte <= 0xF4) {
+            this->pending_bytes_ = byte >= 0xF0 ? 3 : (byte >= 0xE0 ? 2 : 1);
+            this->code_point_ = byte & (0x3Fu >> this->pending_bytes_);
+
+            // Take the continuation bytes right away when the sequence is complete in this part, the common case
+            while (this->pending_bytes_ != 0 && offset < part.size() && (static_cast<unsigned char>(part[offset]) & 0xC0) == 0x80) {
+                this->code_point_ = (this->code_point_ << 6) | (static_cast<unsigned char>(part[offset++]) & 0x3Fu);
+                --this->pending_bytes_;
+            }
+            if (this->pending_bytes_ == 0) {
+                this->add_character(get_word_break(this->code_point_));
+            }
+        }
+        else {
+            this->add_character(WordBreak::Other);
+        }
+    }
+}
+
+std::size_t Segmenter::count_words(const std::size_t run_count) const
+{
+    // Every split run was counted as one word by the run count; the open run too, once it has a character
+    const std::size_t split_runs = this->split_runs_ + (this->is_split_ ? 1u : 0u);
+    const std::size_t split_words = this->split_words_ + (this->is_split_ ? this->run_words_ : 0u);
+    return run_count - split_runs + split_words;
+}
+
+void Segmenter::merge(const Segmenter &next)
+{
+    // This segmenter's text ends with whitespace, so its run is closed and the next segmenter's open run continues
+    this->split_runs_ += next.split_runs_;
+    this->split_words_ += next.split_words_;
+    this->run_words_ = next.run_words_;
+    this->code_point_ = next.code_point_;
+    this->pending_bytes_ = next.pending_bytes_;
+    this->previous_ = next.previous_;
+    this->before_previous_ = next.before_previous_;
+    this->segment_has_word_ = next.segment_has_word_;
+    this->is_split_ = next.is_split_;
+}
+
+void Segmenter::add_character(const WordBreak word_break)
+{
+    // WB4: combining marks and joiners belong to the character before them
+    if (word_break == WordBreak::Extend) {
+        return;
+    }
+
+    // A letter or digit adds a word unless it joins a segment that already has one
+    const bool is_word = IS_WORD[static_cast<std::size_t>(word_break)];
+    this->segment_has_word_ = this->segment_has_word_ && JOINS[static_cast<std::size_t>(this->before_previous_)][static_cast<std::size_t>(this->previous_)][static_cast<std::size_t>(word_break)];
+    this->run_words_ += is_word && !this->segment_has_word_ ? 1u : 0u;
+    this->segment_has_word_ = this->segment_has_word_ || is_word;
+    this->is_split_ = this->is_split_ || SPLITS_RUN[static_cast<std::size_t>(word_break)];
+    this->before_previous_ = this->previous_;
+    this->previous_ = word_break;
+}
+
+void Segmenter::close_run()
+{
+    if (this->is_split_) {
+        ++this->split_runs_;
+        this->split_words_ += this->run_words_;
+    }
+    this->run_words_ = 0;
+    this->previous_ = WordBreak::Space;
+    this->before_previous_ = WordBreak::Space;
+    this->segment_has_word_ = false;
+    this->is_split_ = false;
+}
+
+}  // namespace core::words
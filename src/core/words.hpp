@@ -0,0 +1,192 @@
+/**
+ * @file words.hpp
+ *
+ * @brief Word counting for scripts written without spaces, using the word boundaries of UAX #29.
+ */
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint32_t
+#include <string_view>  // for std::string_view
+
+namespace core::words {
+
+/**
+ * @brief Word break classes of UAX #29 (https://www.unicode.org/reports/tr29/), as stored in "word_break_table.hpp".
+ *
+ * @note The order must match "tools/generate_word_break.py".
+ */
+enum class WordBreak : std::uint8_t {
+    /**
+     * @brief Punctuation, symbols, and regional indicators.
+     */
+    Other,
+
+    /**
+     * @brief Line breaks and spaces (e.g., "\n" or U+3000).
+     */
+    Space,
+
+    /**
+     * @brief Combining marks, format characters, and joiners, which belong to the character before them.
+     */
+    Extend,
+
+    /**
+     * @brief Letters of alphabetic scripts, including scripts that need a dictionary to split (e.g., Thai).
+     */
+    ALetter,
+
+    /**
+     * @brief Hebrew letters.
+     */
+    HebrewLetter,
+
+    /**
+     * @brief Digits.
+     */
+    Numeric,
+
+    /**
+     * @brief Katakana.
+     */
+    Katakana,
+
+    /**
+     * @brief Wide letters that UAX #29 keeps apart (e.g., Han or Hiragana), one word each.
+     */
+    Ideographic,
+
+    /**
+     * @brief Connectors (e.g., "_").
+     */
+    ExtendNumLet,
+
+    /**
+     * @brief Punctuation inside words (e.g., ":" or "·").
+     */
+    MidLetter,
+
+    /**
+     * @brief Punctuation inside numbers (e.g., "," or ";").
+     */
+    MidNum,
+
+    /**
+     * @brief Punctuation inside both (e.g., "." or "’").
+     */
+    MidNumLet,
+
+    /**
+     * @brief Apostrophe (U+0027).
+     */
+    SingleQuote,
+
+    /**
+     * @brief Quotation mark (U+0022).
+     */
+    DoubleQuote,
+};
+
+/**
+ * @brief Return the word break class of a code point.
+ *
+ * @param code_point Code point to look up (e.g., "U+6771").
+ *
+ * @return Class (e.g., "WordBreak::Ideographic"), or "WordBreak::Other" outside of Unicode.
+ */
+[[nodiscard]] WordBreak get_word_break(const char32_t code_point);
+
+/**
+ * @brief Incremental word segmenter that refines a whitespace word count.
+ *
+ * Words are the runs of non-whitespace, like "text::count_words()", except that runs containing characters of scripts written without spaces (e.g., "東京タワー") or non-ASCII spaces are split at the word boundaries of UAX #29, and count one word per segment with a letter or digit (e.g., "東", "京", and "タワー"). Without a dictionary, every Han and Hiragana character is a segment of its own. Other runs are never split, so Latin text counts exactly as before.
+ *
+ * Runs of ASCII outside of such a run are skipped eight bytes at a time, and only the tail of the last run is classified, so the cost on Latin text stays close to that of the whitespace count.
+ */
+class Segmenter final {
+  public:
+    /**
+     * @brief Add the next part of the text.
+     *
+     * @param part Bytes that follow the previously added ones; the parts may be split anywhere, even inside a UTF-8 sequence (e.g., "東京タ").
+     */
+    void add(const std::string_view part);
+
+    /**
+     * @brief Return the number of words of the text added so far.
+     *
+     * @param run_count Number of runs of non-whitespace of the same text (e.g., from "text::count_words()").
+     *
+     * @return Number of words (e.g., "3" for "東京タワー", which is a single run).
+     */
+    [[nodiscard]] std::size_t count_words(const std::size_t run_count) const;
+
+    /**
+     * @brief Append the counts of another segmenter, whose text followed this one's after whitespace.
+     *
+     * @param next Segmenter of the text that follows; this segmenter's text must end with whitespace.
+     */
+    void merge(const Segmenter &next);
+
+  private:
+    /**
+     * @brief Classify a complete character of the current run.
+     *
+     * @param word_break Class of the character.
+     */
+    void add_character(const WordBreak word_break);
+
+    /**
+     * @brief Close the current run at whitespace, adding its words if it was split.
+     */
+    void close_run();
+
+    /**
+     * @brief Number of closed runs that were split.
+     */
+    std::size_t split_runs_ = 0;
+
+    /**
+     * @brief Number of words of the closed runs that were split.
+     */
+    std::size_t split_words_ = 0;
+
+    /**
+     * @brief Number of words of the current run so far.
+     */
+    std::size_t run_words_ = 0;
+
+    /**
+     * @brief Code point bits of the UTF-8 sequence being decoded.
+     */
+    std::uint32_t code_point_ = 0;
+
+    /**
+     * @brief Number of continuation bytes still expected by the UTF-8 sequence being decoded.
+     */
+    std::uint8_t pending_bytes_ = 0;
+
+    /**
+     * @brief Class of the last character of the current run, ignoring "WordBreak::Extend"; "WordBreak::Space" at the start of a run.
+     */
+    WordBreak previous_ = WordBreak::Space;
+
+    /**
+     * @brief Class of the character before "previous_", for the rules that look across punctuation (e.g., "can't" or "3.14").
+     */
+    WordBreak before_previous_ = WordBreak::Space;
+
+    /**
+     * @brief Whether the current segment already has a letter or digit, so the characters that join it add no word.
+     */
+    bool segment_has_word_ = false;
+
+    /**
+     * @brief Whether the current run has a character that splits it into words.
+     */
+    bool is_split_ = false;
+};
+
+}  // namespace core::words
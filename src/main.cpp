@@ -2,8 +2,11 @@
  * @file main.cpp
  */
 
+#include <csignal>    // for std::signal, SIGINT, SIGTERM
+#include <cstddef>    // for std::size_t
 #include <cstdlib>    // for EXIT_FAILURE, EXIT_SUCCESS
 #include <exception>  // for std::exception
+#include <span>       // for std::span
 
 #if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN  // Exclude rarely-used stuff from Windows headers
@@ -14,16 +17,44 @@
 #include <spdlog/spdlog.h>
 
 #include "app.hpp"
+#include "core/args.hpp"
+#include "core/batch.hpp"
+#include "core/server.hpp"
 #include "generated.hpp"
 
+namespace {
+
+/**
+ * @brief Daemon stopped by "handle_stop_signal()", or nullptr if none is running.
+ */
+core::server::Server *running_server = nullptr;
+
+/**
+ * @brief Stop the running daemon when the process is asked to terminate, so it can remove its socket file.
+ *
+ * @param signal Received signal (e.g., "SIGINT").
+ */
+void handle_stop_signal(int signal)
+{
+    static_cast<void>(signal);
+    if (running_server != nullptr) {
+        running_server->stop();
+    }
+}
+
+}  // namespace
+
 /**
  * @brief Entry-point of the application.
  *
- * This sets up basic boilerplate, then calls "app::run()" to start the application.
+ * This sets up basic boilerplate, parses the command-line arguments, then either normalizes a directory tree headlessly ("--batch"), serves normalization requests on a socket ("--serve"), or calls "app::run()" to start the application.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments, starting with the program name.
  *
- * @return EXIT_SUCCESS if the application ran successfully, EXIT_FAILURE otherwise.
+ * @return EXIT_SUCCESS if the application ran successfully, EXIT_FAILURE otherwise (including any file failing in batch mode).
  */
-int main()
+int main(int argc, char *argv[])
 {
     try {
         // Set compile-time log level based on the build type
@@ -33,25 +64,26 @@ int main()
         spdlog::set_level(spdlog::level::debug);
 #endif
         // Log low-level debug information
-        SPDLOG_INFO("Build - Version: {}, Config: {}, Date: {}, Time: {}",
-                    generated::PROJECT_VERSION,
-                    generated::BUILD_CONFIGURATION,
-                    generated::BUILD_DATE,
-                    generated::BUILD_TIME);
-
-        SPDLOG_INFO("Compiler - {}, C++ standard: {}",
-                    generated::COMPILER_INFO,
-                    generated::CPP_STANDARD);
-
-        SPDLOG_INFO("Platform - OS: {} ({}), Shared Libs: {}, Strip: {}, LTO: {}",
-                    generated::OPERATING_SYSTEM,
-                    generated::ARCHITECTURE,
-                    generated::BUILD_SHARED_LIBS,
-                    generated::STRIP_ENABLED,
-                    generated::LTO_ENABLED);
-
-        SPDLOG_INFO("Logging - Level: {}",
-                    spdlog::level::to_string_view(spdlog::get_level()));
+        // These are debug-level, so Release builds skip formatting them on the startup path
+        SPDLOG_DEBUG("Build - Version: {}, Config: {}, Date: {}, Time: {}",
+                     generated::PROJECT_VERSION,
+                     generated::BUILD_CONFIGURATION,
+                     generated::BUILD_DATE,
+                     generated::BUILD_TIME);
+
+        SPDLOG_DEBUG("Compiler - {}, C++ standard: {}",
+                     generated::COMPILER_INFO,
+                     generated::CPP_STANDARD);
+
+        SPDLOG_DEBUG("Platform - OS: {} ({}), Shared Libs: {}, Strip: {}, LTO: {}",
+                     generated::OPERATING_SYSTEM,
+                     generated::ARCHITECTURE,
+                     generated::BUILD_SHARED_LIBS,
+                     generated::STRIP_ENABLED,
+                     generated::LTO_ENABLED);
+
+        SPDLOG_DEBUG("Logging - Level: {}",
+                     spdlog::level::to_string_view(spdlog::get_level()));
 
 #if defined(_WIN32)  // Setup UTF-8 input/output
         SPDLOG_DEBUG("Windows platform detected, setting console to UTF-8...");
@@ -59,9 +91,31 @@ int main()
         SetConsoleOutputCP(CP_UTF8);
         SPDLOG_DEBUG("Set console to UTF-8!");
 #endif
+        // Parse the command-line arguments, skipping the program name
+        const std::span<const char *const> all_arguments{argv, static_cast<std::size_t>(argc)};
+        const core::args::Arguments arguments = core::args::parse_arguments(all_arguments.empty() ? all_arguments : all_arguments.subspan(1));
+
+        // Normalize a directory tree without opening a window, so this also runs on headless machines
+        if (!arguments.batch_directory.empty()) {
+            const core::batch::BatchReport report = core::batch::run_batch(core::batch::make_options(arguments));
+            SPDLOG_INFO("{}", report.summary());
+            return report.files_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        // Keep the text engine warm in a long-lived daemon, which also runs on headless machines
+        if (!arguments.serve_socket.empty()) {
+            core::server::Server server{arguments.serve_socket, arguments.jobs, arguments.cleanup_options};
+            running_server = &server;
+            std::signal(SIGINT, handle_stop_signal);
+            std::signal(SIGTERM, handle_stop_signal);
+            server.run();
+            running_server = nullptr;
+            return EXIT_SUCCESS;
+        }
+
         // Call the application entry point
         SPDLOG_INFO("Starting application...");
-        app::run();
+        app::run(arguments);
     }
     catch (const std::exception &e) {
         SPDLOG_CRITICAL("{}", e.what());
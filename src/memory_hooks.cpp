@@ -0,0 +1,123 @@
+/**
+ * @file memory_hooks.cpp
+ *
+ * @brief Replacements of the global "operator new" and "operator delete" that charge every heap allocation of the application to the tag of the calling thread.
+ *
+ * @note Only linked into the executable (see "ENABLE_MEMORY_ACCOUNTING"), so the tests and benchmarks keep the default allocator. The nothrow forms call these.
+ */
+
+#include <cstddef>  // for std::size_t
+#include <new>      // for std::bad_alloc, std::align_val_t
+
+#include "core/memory.hpp"
+
+namespace {
+
+/**
+ * @brief Tells the memory module that every allocation is accounted, during static initialization.
+ */
+struct GlobalAccounting {
+    GlobalAccounting() noexcept
+    {
+        core::memory::enable_global_accounting();
+    }
+} const global_accounting;
+
+/**
+ * @brief Allocate memory charged to the tag of the calling thread.
+ *
+ * @param size Number of bytes to allocate.
+ * @param alignment Alignment of the memory.
+ *
+ * @return Pointer to the memory.
+ *
+ * @throws std::bad_alloc if the memory could not be allocated.
+ */
+[[nodiscard]] void *allocate_or_throw(const std::size_t size,
+                                      const std::size_t alignment)
+{
+    if (void *pointer = core::memory::allocate(size, alignment, core::memory::current_tag())) [[likely]] {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+}  // namespace
+
+void *operator new(const std::size_t size)
+{
+    return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](const std::size_t size)
+{
+    return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(const std::size_t size,
+                   const std::align_val_t alignment)
+{
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](const std::size_t size,
+                     const std::align_val_t alignment)
+{
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept
+{
+    core::memory::deallocate(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    core::memory::deallocate(pointer);
+}
+
+void operator delete(void *pointer,
+                     const std::size_t size) noexcept
+{
+    static_cast<void>(size);
+    core::memory::deallocate(pointer);
+}
+
+void operator delete[](void *pointer,
+                       const std::size_t size) noexcept
+{
+    static_cast<void>(size);
+    core::memory::deallocate(pointer);
+}
+
+void operator delete(void *pointer,
+                     const std::align_val_t alignment) noexcept
+{
+    static_cast<void>(alignment);
+    core::memory::deallocate(pointer);
+}
+
+void operator delete[](void *pointer,
+                       const std::align_val_t alignment) noexcept
+{
+    static_cast<void>(alignment);
+    core::memory::deallocate(pointer);
+}
+
+void operator delete(void *pointer,
+                     const std::size_t size,
+                     const std::align_val_t alignment) noexcept
+{
+    static_cast<void>(size);
+    static_cast<void>(alignment);
+    core::memory::deallocate(pointer);
+}
+
+void operator delete[](void *pointer,
+                       const std::size_t size,
+                       const std::align_val_t alignment) noexcept
+{
+    static_cast<void>(size);
+    static_cast<void>(alignment);
+    core::memory::deallocate(pointer);
+}
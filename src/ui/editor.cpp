@@ -2,24 +2,192 @@
  * @file editor.cpp
  */
 
-#include <algorithm>  // for std::max
-#include <array>      // for std::array
-#include <format>     // for std::format
-#include <span>       // for std::span
-#include <string>     // for std::string
+#include <algorithm>    // for std::max, std::min, std::count
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t, std::ptrdiff_t
+#include <exception>    // for std::exception
+#include <filesystem>   // for std::filesystem::path
+#include <format>       // for std::format, std::format_to
+#include <iterator>     // for std::back_inserter
+#include <memory>       // for std::make_unique
+#include <span>         // for std::span
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::move
+#include <vector>       // for std::vector
 
 #include <imgui.h>
 #include <misc/cpp/imgui_stdlib.h>  // for std::string with InputText
 #include <spdlog/spdlog.h>
 
 #include "core/clipboard.hpp"
+#include "core/clipboard_watch.hpp"
+#include "core/dedupe.hpp"
+#include "core/diff.hpp"
+#include "core/documents.hpp"
+#include "core/encoding.hpp"
+#include "core/loader.hpp"
+#include "core/memory.hpp"
+#include "core/search.hpp"
 #include "core/text.hpp"
+#include "core/utf8.hpp"
 #include "ui/editor.hpp"
 
 namespace ui::editor {
 
+namespace {
+
+/**
+ * @brief Maximum number of bytes of unchanged text shown on either side of a change in the preview.
+ */
+constexpr std::size_t PREVIEW_CONTEXT_SIZE = 24;
+
+/**
+ * @brief Return the unchanged text on the same line before a position, cut to whole UTF-8 sequences.
+ *
+ * @param text Text the position refers to (e.g., "hello world").
+ * @param position Byte offset where the context ends (e.g., "6").
+ *
+ * @return At most "PREVIEW_CONTEXT_SIZE" bytes before the position (e.g., "hello ").
+ */
+[[nodiscard]] std::string_view context_before(const std::string_view text,
+                                              const std::size_t position)
+{
+    std::size_t begin = position > PREVIEW_CONTEXT_SIZE ? position - PREVIEW_CONTEXT_SIZE : 0;
+    const std::size_t newline = text.rfind('\n', position == 0 ? 0 : position - 1);
+    if (newline != std::string_view::npos && newline < position && newline + 1 > begin) {
+        begin = newline + 1;
+    }
+    while (begin < position && (static_cast<unsigned char>(text[begin]) & 0xC0) == 0x80) {
+        ++begin;
+    }
+    return text.substr(begin, position - begin);
+}
+
+/**
+ * @brief Return the unchanged text on the same line after a position, cut to whole UTF-8 sequences.
+ *
+ * @param text Text the position refers to (e.g., "hello world").
+ * @param position Byte offset where the context starts (e.g., "5").
+ *
+ * @return At most "PREVIEW_CONTEXT_SIZE" bytes after the position (e.g., " world").
+ */
+[[nodiscard]] std::string_view context_after(const std::string_view text,
+                                             const std::size_t position)
+{
+    std::size_t end = std::min(text.size(), position + PREVIEW_CONTEXT_SIZE);
+    const std::size_t newline = text.find('\n', position);
+    if (newline < end) {
+        end = newline;
+    }
+    while (end > position && end < text.size() && (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+        --end;
+    }
+    return text.substr(position, end - position);
+}
+
+/**
+ * @brief Maximum number of byte offsets listed in the status bar before the rest are only counted.
+ */
+constexpr std::size_t STATUS_OFFSET_LIMIT = 3;
+
+/**
+ * @brief Number of the last loaded bytes used to find the insertion point of the next loaded text again.
+ */
+constexpr std::size_t LOAD_ANCHOR_SIZE = 64;
+
+/**
+ * @brief Interval between two recomputations of the allocation rates shown in the memory panel, in seconds.
+ */
+constexpr double MEMORY_RATE_INTERVAL_SECONDS = 0.5;
+
+/**
+ * @brief Number of bytes in a mebibyte, for the memory panel.
+ */
+constexpr double BYTES_PER_MIB = 1024.0 * 1024.0;
+
+/**
+ * @brief Format byte offsets for the status bar, listing only the first few.
+ *
+ * @param label What the offsets point at (e.g., "Invalid UTF-8").
+ * @param offsets Byte offsets in ascending order (e.g., {12, 40, 97, 120}).
+ *
+ * @return Status segment (e.g., "Invalid UTF-8: 4 at byte 12, 40, 97, ...").
+ */
+[[nodiscard]] std::string format_offsets(const std::string_view label,
+                                         const std::vector<std::size_t> &offsets)
+{
+    std::string result = std::format("{}: {} at byte ", label, offsets.size());
+    for (std::size_t i = 0; i < std::min(offsets.size(), STATUS_OFFSET_LIMIT); ++i) {
+        result += std::format("{}{}", i == 0 ? "" : ", ", offsets[i]);
+    }
+    if (offsets.size() > STATUS_OFFSET_LIMIT) {
+        result += ", ...";
+    }
+    return result;
+}
+
+/**
+ * @brief Render a changed span in a color, making whitespace visible so removed spaces and line breaks can be seen.
+ *
+ * @param span Changed text (e.g., "  ").
+ * @param color Text color.
+ */
+void draw_changed_span(const std::string_view span,
+                       const ImVec4 &color)
+{
+    std::string visible;
+    visible.reserve(span.size());
+    for (const char character : span) {
+        switch (character) {
+        case ' ':
+            visible += "\u00B7";
+            break;
+        case '\t':
+            visible += "\u00BB";
+            break;
+        case '\n':
+            visible += "\u00B6";
+            break;
+        default:
+            visible += character;
+        }
+    }
+    ImGui::PushStyleColor(ImGuiCol_Text, color);
+    ImGui::TextUnformatted(visible.data(), visible.data() + visible.size());
+    ImGui::PopStyleColor();
+}
+
+/**
+ * @brief Render unchanged context next to a changed span, on the same line.
+ *
+ * @param context Unchanged text (e.g., "hello").
+ */
+void draw_context_span(const std::string_view context)
+{
+    ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+    ImGui::TextUnformatted(context.data(), context.data() + context.size());
+    ImGui::PopStyleColor();
+}
+
+}  // namespace
+
+Editor::Editor(text_inserted_callback_t on_text_inserted,
+               text_changed_callback_t on_text_changed,
+               document_closed_callback_t on_document_closed)
+    : on_text_inserted_(std::move(on_text_inserted)),
+      on_text_changed_(std::move(on_text_changed)),
+      on_document_closed_(std::move(on_document_closed))
+{
+    // Start with a single untitled document
+    this->new_document({});
+}
+
 void Editor::update_and_draw()
 {
+    // Charge the text and everything else the editor allocates to its buffer, the text engine and clipboard scopes nest inside
+    const core::memory::Scope memory_scope{core::memory::Tag::EditorBuffer};
+
     // Fetch the global ImGui IO state for display size queries
     const ImGuiIO &io = ImGui::GetIO();
 
@@ -33,9 +201,11 @@ void Editor::update_and_draw()
     ImGui::SetNextWindowSize(io.DisplaySize, ImGuiCond_Always);
 
     // Combine window flags to hide decoration, disable moving, and ignore mouse-wheel scrolling
+    // Keep the window behind when clicked, so the floating memory panel stays visible over it
     constexpr ImGuiWindowFlags root_flags = ImGuiWindowFlags_NoDecoration |
                                             ImGuiWindowFlags_NoMove |
-                                            ImGuiWindowFlags_NoScrollWithMouse;
+                                            ImGuiWindowFlags_NoScrollWithMouse |
+                                            ImGuiWindowFlags_NoBringToFrontOnFocus;
 
     // Push consistent padding derived from the configured style
     ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, style.WindowPadding);
@@ -46,6 +216,20 @@ void Editor::update_and_draw()
     // Remove window borders for a flat canvas look
     ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.0f);
 
+    // Write back what the clipboard watcher normalized since the last frame
+    this->update_clipboard_watch();
+
+    // Insert the text read by the loader since the last frame
+    this->update_loading();
+
+    // Invalidate the cached text measurements when the font was swapped or resized (e.g., after glyphs for a new script were loaded)
+    if (ImGui::GetFont() != this->layout_font_ || ImGui::GetFontSize() != this->layout_font_size_) [[unlikely]] {
+        this->layout_font_ = ImGui::GetFont();
+        this->layout_font_size_ = ImGui::GetFontSize();
+        this->toolbar_width_need_update_ = true;
+        this->status_width_need_update_ = true;
+    }
+
     // Begin the root window that contains the entire interface
     if (ImGui::Begin("##root", nullptr, root_flags)) [[likely]] {
 
@@ -91,8 +275,11 @@ void Editor::update_and_draw()
         // Close the status bar child window
         ImGui::EndChild();
 
-        // Draw the modal even if not visible so state stays in sync
+        // Draw the modals even if not visible so state stays in sync
+        this->update_and_draw_open_modal();
+        this->update_and_draw_preview_modal();
         this->update_and_draw_usage_modal();
+        this->update_and_draw_memory_panel();
 
         // Finish populating the root window contents
     }
@@ -102,9 +289,328 @@ void Editor::update_and_draw()
 
     // Pop every style override pushed before creating the root window
     ImGui::PopStyleVar(3);
+
+    // Report the text once per frame in which it changed, however many edits the frame made
+    this->report_text_change();
+}
+
+void Editor::report_text_change()
+{
+    // A file being loaded is reported once it is complete, rather than once for every part
+    if (this->text_changed_ && !this->loader_) [[unlikely]] {
+        this->text_changed_ = false;
+        this->documents_.set_active_size(this->text_.size());
+        if (this->on_text_changed_) {
+            this->on_text_changed_(this->tabs_[this->active_tab_].id, this->text_);
+        }
+    }
+}
+
+void Editor::open_file(const std::filesystem::path &path,
+                       const std::string_view title)
+{
+    const core::memory::Scope memory_scope{core::memory::Tag::EditorBuffer};
+
+    // Read the first block now, so a file that cannot be read leaves the tabs alone
+    auto loader = std::make_unique<core::loader::Loader>(path, this->cleanup_options_.repair_invalid_utf8, this->segment_words_);
+    SPDLOG_INFO("Opened '{}' ({}), loading it in the background", path.string(), core::encoding::to_string(loader->encoding()));
+
+    // Keep the current text, unless there is none to keep
+    const std::string tab_title = title.empty() ? path.filename().string() : std::string{title};
+    if (!this->text_.empty()) {
+        this->new_document(tab_title);
+    }
+    else {
+        Tab &tab = this->tabs_[this->active_tab_];
+        tab.label = std::format("{}###{}", tab_title, tab.id);
+    }
+    this->set_text({});
+
+    // The first block is inserted on the next frame, the rest as it arrives
+    this->loader_ = std::move(loader);
+    this->load_progress_ = {};
+    this->is_load_repairing_ = this->cleanup_options_.repair_invalid_utf8;
+    this->is_load_segmenting_ = this->segment_words_;
+    this->is_load_edited_ = false;
+    this->load_status_ = "Loading";
+    this->status_text_need_update_ = true;
+}
+
+std::size_t Editor::add_document(std::string text)
+{
+    const core::memory::Scope memory_scope{core::memory::Tag::EditorBuffer};
+
+    // Keep the current text, unless there is none to keep
+    if (!this->text_.empty()) {
+        this->new_document({});
+    }
+    this->set_text(std::move(text));
+    return this->tabs_[this->active_tab_].id;
+}
+
+void Editor::set_memory_budget(const std::size_t bytes)
+{
+    this->documents_.set_memory_budget(bytes);
+}
+
+void Editor::new_document(const std::string_view title)
+{
+    // Put the current text back first, so the store can compress or page it out if the budget requires
+    const bool is_first = this->tabs_.empty();
+    if (!is_first) {
+        this->finish_loading();
+        this->report_text_change();
+        this->documents_.put(this->tabs_[this->active_tab_].id, std::move(this->text_));
+    }
+    const std::size_t id = this->documents_.add({});
+    std::string text = this->documents_.take(id);
+    std::string label = title.empty() ? std::format("Untitled {}###{}", ++this->untitled_count_, id) : std::format("{}###{}", title, id);
+    this->tabs_.push_back({.id = id, .label = std::move(label)});
+    this->active_tab_ = this->tabs_.size() - 1;
+    this->tab_selection_pending_ = true;
+    this->find_cursor_ = 0;
+    this->has_pending_selection_ = false;
+    this->is_normalize_pending_ = false;
+    if (!is_first) {
+        this->set_text(std::move(text));
+    }
+    SPDLOG_DEBUG("Created document '{}'", id);
+}
+
+void Editor::activate_document(const std::size_t index)
+{
+    if (index == this->active_tab_ || index >= this->tabs_.size()) {
+        return;
+    }
+    this->finish_loading();
+    this->report_text_change();
+    this->documents_.put(this->tabs_[this->active_tab_].id, std::move(this->text_));
+    this->active_tab_ = index;
+    this->tab_selection_pending_ = true;
+    this->find_cursor_ = 0;
+    this->has_pending_selection_ = false;
+    this->is_normalize_pending_ = false;
+
+    // A page file that can no longer be read loses that document, but not the others
+    std::string text;
+    try {
+        text = this->documents_.take(this->tabs_[index].id);
+    }
+    catch (const std::exception &e) {
+        SPDLOG_ERROR("Failed to restore document '{}': {}", this->tabs_[index].id, e.what());
+    }
+    this->set_text(std::move(text));
+    SPDLOG_DEBUG("Activated document '{}'", this->tabs_[index].id);
+}
+
+void Editor::close_document(const std::size_t index)
+{
+    // A document that is closed while it loads does not need the rest of its file
+    if (index == this->active_tab_) {
+        this->cancel_loading();
+    }
+
+    // Closing the last tab replaces it with an empty one, so there is always a document to edit
+    if (this->tabs_.size() == 1) {
+        this->new_document({});
+    }
+    if (index == this->active_tab_) {
+        this->activate_document(index + 1 < this->tabs_.size() ? index + 1 : index - 1);
+    }
+    this->documents_.remove(this->tabs_[index].id);
+    if (this->on_document_closed_) {
+        this->on_document_closed_(this->tabs_[index].id);
+    }
+    this->tabs_.erase(this->tabs_.begin() + static_cast<std::ptrdiff_t>(index));
+    if (this->active_tab_ > index) {
+        --this->active_tab_;
+    }
+    this->tab_selection_pending_ = true;
+}
+
+void Editor::set_text(std::string text)
+{
+    // The new text replaces the file being loaded, if any
+    this->cancel_loading();
+    this->text_ = std::move(text);
+    this->repaired_utf8_offsets_.clear();
+    if (this->cleanup_options_.repair_invalid_utf8) {
+        core::utf8::repair(this->text_, &this->repaired_utf8_offsets_);
+    }
+    this->text_metrics_need_update_ = true;
+    this->text_changed_ = true;
+    this->find_match_count_need_update_ = true;
+    if (this->on_text_inserted_) {
+        this->on_text_inserted_(this->text_);
+    }
+}
+
+void Editor::update_loading()
+{
+    // Nothing to do while no file is being loaded
+    if (!this->loader_) [[likely]] {
+        return;
+    }
+
+    // Show the statistics and UTF-8 problems of the text loaded so far, computed by the loader in the background
+    if (this->loader_->take(this->loaded_text_, this->loaded_utf8_offsets_, this->load_progress_)) {
+        this->text_stats_ = this->load_progress_.stats;
+        this->utf8_status_.clear();
+        if (!this->loaded_utf8_offsets_.empty()) {
+            this->utf8_status_ = format_offsets(this->is_load_repairing_ ? "Repaired UTF-8" : "Invalid UTF-8", this->loaded_utf8_offsets_);
+        }
+        this->load_status_.clear();
+        if (this->load_progress_.file_size != 0) {
+            std::format_to(std::back_inserter(this->load_status_), "Loading {}%", this->load_progress_.bytes_read * 100 / this->load_progress_.file_size);
+        }
+        else {
+            this->load_status_ = "Loading";
+        }
+        this->status_text_need_update_ = true;
+    }
+
+    // While the widget is active, the input callback inserts the text instead
+    if (!this->loaded_text_.empty() && !this->is_editor_active_) {
+        this->text_.insert(this->find_load_position(this->text_), this->loaded_text_);
+        this->on_loaded_text_inserted();
+    }
+
+    if (this->load_progress_.is_done && this->loaded_text_.empty()) {
+        this->complete_loading();
+    }
+}
+
+std::size_t Editor::find_load_position(const std::string_view text) const
+{
+    // Searching backwards finds the anchor right away, unless a lot was typed after the loaded text
+    if (this->loaded_tail_.empty()) {
+        return text.size();
+    }
+    const std::size_t position = text.rfind(this->loaded_tail_);
+    return position == std::string_view::npos ? text.size() : position + this->loaded_tail_.size();
 }
 
-float Editor::calculate_center_offset_for_labels(std::span<const std::string> labels) const
+void Editor::on_loaded_text_inserted()
+{
+    if (this->on_text_inserted_) {
+        this->on_text_inserted_(this->loaded_text_);
+    }
+    this->loaded_tail_ += this->loaded_text_;
+    if (this->loaded_tail_.size() > LOAD_ANCHOR_SIZE) {
+        this->loaded_tail_.erase(0, this->loaded_tail_.size() - LOAD_ANCHOR_SIZE);
+    }
+    this->loaded_text_.clear();
+    this->text_metrics_need_update_ = true;
+    this->text_changed_ = true;
+    this->find_match_count_need_update_ = true;
+}
+
+void Editor::finish_loading()
+{
+    if (!this->loader_) [[likely]] {
+        return;
+    }
+
+    // Called from buttons and tab changes, so the widget is not holding a copy of the text that the insertion below would miss
+    while (!this->load_progress_.is_done) {
+        this->loader_->wait();
+        static_cast<void>(this->loader_->take(this->loaded_text_, this->loaded_utf8_offsets_, this->load_progress_));
+    }
+    if (!this->loaded_text_.empty()) {
+        this->text_.insert(this->find_load_position(this->text_), this->loaded_text_);
+        this->on_loaded_text_inserted();
+    }
+    this->complete_loading();
+}
+
+void Editor::cancel_loading()
+{
+    if (this->loader_) {
+        SPDLOG_INFO("Stopped loading after {} bytes", this->load_progress_.bytes_read);
+    }
+    this->loader_.reset();
+    this->loaded_text_.clear();
+    this->loaded_tail_.clear();
+    this->loaded_utf8_offsets_.clear();
+    if (!this->load_status_.empty()) {
+        this->load_status_.clear();
+        this->status_text_need_update_ = true;
+    }
+}
+
+void Editor::complete_loading()
+{
+    this->loader_.reset();
+    this->loaded_tail_.clear();
+    this->load_status_.clear();
+    if (!this->load_progress_.error.empty()) [[unlikely]] {
+        SPDLOG_ERROR("{}", this->load_progress_.error);
+        this->load_status_ = "Loading failed, the text is incomplete";
+    }
+    else {
+        SPDLOG_INFO("Loaded {} bytes", this->load_progress_.bytes_read);
+    }
+
+    // The loader already counted and validated the text, which only has to be done again if it was edited
+    if (!this->is_load_edited_) {
+        this->text_stats_ = this->load_progress_.stats;
+        if (this->is_load_repairing_) {
+            this->repaired_utf8_offsets_ = std::move(this->loaded_utf8_offsets_);
+        }
+
+        // Count again if the way words are counted changed during the load
+        this->text_metrics_need_update_ = this->is_load_segmenting_ != this->segment_words_;
+    }
+    this->loaded_utf8_offsets_.clear();
+    this->status_text_need_update_ = true;
+    this->text_changed_ = true;
+}
+
+void Editor::set_clipboard_watch(const bool enabled)
+{
+    if (enabled == (this->clipboard_watcher_ != nullptr)) {
+        return;
+    }
+    this->clipboard_watch_hits_shown_ = 0;
+    this->clipboard_watch_status_.clear();
+    this->status_text_need_update_ = true;
+    if (!enabled) {
+        this->clipboard_watcher_.reset();
+        return;
+    }
+    try {
+        this->clipboard_watcher_ = std::make_unique<core::clipboard_watch::Watcher>(this->cleanup_options_);
+        this->clipboard_watch_status_ = "Clipboard: 0 normalized";
+    }
+    catch (const std::exception &e) {
+        SPDLOG_ERROR("{}", e.what());
+        this->clipboard_watch_status_ = "Clipboard watch unavailable";
+    }
+}
+
+void Editor::update_clipboard_watch()
+{
+    // Nothing to do while the clipboard is not watched
+    if (!this->clipboard_watcher_) [[likely]] {
+        return;
+    }
+
+    // The watcher already normalized the text on its own thread, only the write-back happens here, because SFML serves the clipboard from the window's event loop
+    if (this->clipboard_watcher_->take_normalized(this->clipboard_watch_text_)) [[unlikely]] {
+        core::clipboard::write_to_clipboard(this->clipboard_watch_text_);
+    }
+
+    // Rebuild the status segment only when the hit counter moved
+    const std::size_t hits = this->clipboard_watcher_->hit_count();
+    if (hits != this->clipboard_watch_hits_shown_) [[unlikely]] {
+        this->clipboard_watch_hits_shown_ = hits;
+        this->clipboard_watch_status_.clear();
+        std::format_to(std::back_inserter(this->clipboard_watch_status_), "Clipboard: {} normalized", hits);
+        this->status_text_need_update_ = true;
+    }
+}
+
+float Editor::calculate_width_for_labels(std::span<const std::string> labels) const
 {
     // Access the active style for padding and spacing metrics
     const ImGuiStyle &style = ImGui::GetStyle();
@@ -127,23 +633,26 @@ float Editor::calculate_center_offset_for_labels(std::span<const std::string> la
         total_width += button_width + spacing_x;
     }
 
-    // Query the current region width available for the toolbar
-    const float available_width = ImGui::GetContentRegionAvail().x;
-
-    // Compute the horizontal offset that centers the toolbar row
-    const float offset_x = (available_width > total_width) ? (available_width - total_width) * 0.5f : 0.0f;
-
-    // Return the computed offset so callers can align the cursor
-    return offset_x;
+    // Return the row width so callers can center it
+    return total_width;
 }
 
 void Editor::update_and_draw_top_bar()
 {
     // Prepare a fixed list of button labels for toolbar actions
-    static const std::array<std::string, 5> labels = {"Paste", "Normalize", "Copy", "Clear", "?"};
+    static const std::array<std::string, 9> labels = {"Paste", "Open", "Normalize", "Preview", "Dedupe", "Copy", "Clear", "Find", "?"};
+
+    // Measure the labels only when the font changed, not every frame
+    if (this->toolbar_width_need_update_) [[unlikely]] {
+        this->toolbar_width_ = this->calculate_width_for_labels(std::span<const std::string>(labels));
+        this->toolbar_width_need_update_ = false;
+    }
+
+    // Query the current region width available for the toolbar
+    const float available_width = ImGui::GetContentRegionAvail().x;
 
     // Compute a horizontal offset that centers the toolbar buttons
-    const float offset_x = this->calculate_center_offset_for_labels(std::span<const std::string>(labels));
+    const float offset_x = (available_width > this->toolbar_width_) ? (available_width - this->toolbar_width_) * 0.5f : 0.0f;
 
     // Move the cursor so the buttons start centered within the region
     ImGui::SetCursorPosX(offset_x);
@@ -151,26 +660,117 @@ void Editor::update_and_draw_top_bar()
     // Render the paste button that pulls text from the clipboard helper
     if (ImGui::Button(labels[0].c_str())) [[unlikely]] {
         SPDLOG_DEBUG("Paste button was pressed");
-        this->text_ = core::clipboard::read_from_clipboard();
-        this->text_metrics_need_update_ = true;
+        this->set_text(core::clipboard::read_from_clipboard());
     }
 
     // Keep subsequent buttons on the same row
     ImGui::SameLine();
 
-    // Render the normalize button that cleans up smart punctuation via core::text
+    // Render the open button that asks for a text file to load
     if (ImGui::Button(labels[1].c_str())) [[unlikely]] {
+        SPDLOG_DEBUG("Open button was pressed");
+        this->open_error_.clear();
+        this->is_open_modal_open_ = true;
+    }
+
+    // Keep the next button on the same row
+    ImGui::SameLine();
+
+    // Render the normalize button that cleans up smart punctuation via core::text, and accept Ctrl+Shift+N (Cmd+Shift+N on macOS) from anywhere in the window
+    if (ImGui::Button(labels[2].c_str()) || ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiMod_Shift | ImGuiKey_N, ImGuiInputFlags_RouteGlobal)) [[unlikely]] {
         SPDLOG_DEBUG("Normalize button was pressed");
-        core::text::remove_unwanted_characters(this->text_);
+        this->is_normalize_pending_ = true;
+    }
+
+    // The shortcut also fires while typing, when the widget owns a copy of the text, so the input callback normalizes that copy instead
+    if (this->is_normalize_pending_ && !this->is_editor_active_) [[unlikely]] {
+        this->is_normalize_pending_ = false;
+        this->finish_loading();
+        {
+            const core::memory::Scope memory_scope{core::memory::Tag::TextEngine};
+            core::text::remove_unwanted_characters(this->text_, this->cleanup_options_);
+        }
         this->text_metrics_need_update_ = true;
+        this->text_changed_ = true;
+        this->repaired_utf8_offsets_.clear();
+        this->find_match_count_need_update_ = true;
+    }
+
+    // Hint that the optional cleanup rules live behind a right-click
+    ImGui::SetItemTooltip("Right-click for more cleanup rules");
+
+    // Open a menu with the optional cleanup rules when the normalize button is right-clicked
+    if (ImGui::BeginPopupContextItem("##cleanup_rules")) [[unlikely]] {
+        bool rules_changed = ImGui::MenuItem("Remove \"As an AI...\" disclaimers", nullptr, &this->cleanup_options_.remove_ai_disclaimers);
+        rules_changed |= ImGui::MenuItem("Remove markdown bold markers", nullptr, &this->cleanup_options_.remove_markdown_bold);
+        rules_changed |= ImGui::MenuItem("Trim trailing whitespace", nullptr, &this->cleanup_options_.trim_trailing_whitespace);
+        rules_changed |= ImGui::MenuItem("Collapse runs of spaces and tabs", nullptr, &this->cleanup_options_.collapse_whitespace);
+        rules_changed |= ImGui::MenuItem("Convert line endings to \\n", nullptr, &this->cleanup_options_.normalize_line_endings);
+        rules_changed |= ImGui::MenuItem("Leave code and URLs unchanged", nullptr, &this->cleanup_options_.preserve_code);
+        ImGui::Separator();
+        rules_changed |= ImGui::MenuItem("Repair invalid UTF-8 (also on paste and open)", nullptr, &this->cleanup_options_.repair_invalid_utf8);
+        ImGui::Separator();
+
+        // Apply the rules to text copied from now on as well
+        if (rules_changed && this->clipboard_watcher_) {
+            this->clipboard_watcher_->set_cleanup_options(this->cleanup_options_);
+        }
+
+        // Toggle the background clipboard watcher, which is only implemented for X11
+        bool is_watching = this->clipboard_watcher_ != nullptr;
+        if (ImGui::MenuItem("Watch clipboard and normalize copied text", nullptr, &is_watching, core::clipboard_watch::Watcher::is_supported())) {
+            this->set_clipboard_watch(is_watching);
+        }
+        ImGui::EndPopup();
+    }
+
+    // Keep the next button on the same row
+    ImGui::SameLine();
+
+    // Render the preview button that lists the changes normalize would make before applying any of them
+    if (ImGui::Button(labels[3].c_str())) [[unlikely]] {
+        SPDLOG_DEBUG("Preview button was pressed");
+        this->finish_loading();
+
+        // Ask the rule engine for its replacements instead of diffing the normalized text, which is both exact and linear
+        const core::memory::Scope memory_scope{core::memory::Tag::TextEngine};
+        this->open_preview(core::text::find_changes(this->text_, this->cleanup_options_));
+    }
+
+    // Keep the next button on the same row
+    ImGui::SameLine();
+
+    // Render the dedupe button that lists repeated paragraphs (or lines) as deletions in the preview, so each one can be kept or removed
+    if (ImGui::Button(labels[4].c_str())) [[unlikely]] {
+        SPDLOG_DEBUG("Dedupe button was pressed");
+        this->finish_loading();
+        const core::memory::Scope memory_scope{core::memory::Tag::TextEngine};
+        this->open_preview(core::dedupe::find_duplicates(this->text_, this->dedupe_options_));
+    }
+
+    // Hint that the comparison settings live behind a right-click
+    ImGui::SetItemTooltip("Right-click to compare lines or find near-duplicates");
+
+    // Open a menu with the comparison settings when the dedupe button is right-clicked
+    if (ImGui::BeginPopupContextItem("##dedupe_options")) [[unlikely]] {
+        bool compare_lines = this->dedupe_options_.unit == core::dedupe::Unit::Line;
+        if (ImGui::MenuItem("Compare lines instead of paragraphs", nullptr, &compare_lines)) {
+            this->dedupe_options_.unit = compare_lines ? core::dedupe::Unit::Line : core::dedupe::Unit::Paragraph;
+        }
+        bool find_near_duplicates = this->dedupe_options_.near_duplicate_threshold > 0.0;
+        if (ImGui::MenuItem("Also find near-duplicates (80% similar)", nullptr, &find_near_duplicates)) {
+            this->dedupe_options_.near_duplicate_threshold = find_near_duplicates ? 0.8 : 0.0;
+        }
+        ImGui::EndPopup();
     }
 
     // Keep the next button on the same row
     ImGui::SameLine();
 
     // Render the copy button that pushes text to the clipboard helper
-    if (ImGui::Button(labels[2].c_str())) [[unlikely]] {
+    if (ImGui::Button(labels[5].c_str())) [[unlikely]] {
         SPDLOG_DEBUG("Copy button was pressed");
+        this->finish_loading();
         core::clipboard::write_to_clipboard(this->text_);
     }
 
@@ -178,64 +778,646 @@ void Editor::update_and_draw_top_bar()
     ImGui::SameLine();
 
     // Render the clear button that empties the editor text
-    if (ImGui::Button(labels[3].c_str())) [[unlikely]] {
+    if (ImGui::Button(labels[6].c_str())) [[unlikely]] {
         SPDLOG_DEBUG("Clear button was pressed");
+        this->cancel_loading();
         this->text_.clear();
         this->text_metrics_need_update_ = true;
+        this->text_changed_ = true;
+        this->repaired_utf8_offsets_.clear();
+        this->find_match_count_need_update_ = true;
+    }
+
+    // Keep the find button on the same row
+    ImGui::SameLine();
+
+    // Render the find button, and accept Ctrl+F (Cmd+F on macOS) from anywhere in the window, both toggling the find bar
+    if (ImGui::Button(labels[7].c_str()) || ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_F, ImGuiInputFlags_RouteGlobal)) [[unlikely]] {
+        SPDLOG_DEBUG("Find button was pressed");
+        this->is_find_bar_open_ = !this->is_find_bar_open_;
     }
 
     // Keep the help button on the same row
     ImGui::SameLine();
 
     // Render the help button that opens the usage modal
-    if (ImGui::Button(labels[4].c_str())) [[unlikely]] {
+    if (ImGui::Button(labels[8].c_str())) [[unlikely]] {
         SPDLOG_DEBUG("Help button was pressed");
         this->is_help_modal_open_ = true;
     }
+
+    // Draw the find and replace row underneath the buttons
+    this->update_and_draw_find_bar();
+}
+
+void Editor::update_and_draw_find_bar()
+{
+    // Skip the row entirely while it is closed
+    if (!this->is_find_bar_open_) [[likely]] {
+        return;
+    }
+
+    // Recount the matches only when the text or the query changed, not every frame
+    if (this->find_match_count_need_update_) {
+        this->find_match_count_ = core::search::count_matches(this->text_, this->find_query_, this->find_case_sensitive_);
+        this->find_match_count_need_update_ = false;
+        SPDLOG_DEBUG("Recounted find matches ({} matches)", this->find_match_count_);
+    }
+
+    // Split the row width evenly between the two text fields, leaving room for the buttons
+    const float field_width = ImGui::GetContentRegionAvail().x * 0.3f;
+
+    // Render the query field, pressing Enter jumps to the next match
+    ImGui::SetNextItemWidth(field_width);
+    const bool query_submitted = ImGui::InputTextWithHint("##find", "Find", &this->find_query_, ImGuiInputTextFlags_EnterReturnsTrue);
+
+    // Restart the search from the top whenever the query is edited
+    if (ImGui::IsItemEdited()) {
+        this->find_cursor_ = 0;
+        this->find_match_count_need_update_ = true;
+    }
+
+    // Keep the replacement field on the same row
+    ImGui::SameLine();
+
+    // Render the replacement field
+    ImGui::SetNextItemWidth(field_width);
+    ImGui::InputTextWithHint("##replace", "Replace with", &this->replace_text_);
+
+    // Keep the case toggle on the same row
+    ImGui::SameLine();
+
+    // Render the case toggle, the match count depends on it
+    if (ImGui::Checkbox("Aa", &this->find_case_sensitive_)) {
+        this->find_cursor_ = 0;
+        this->find_match_count_need_update_ = true;
+    }
+
+    // Explain the terse case toggle label on hover
+    ImGui::SetItemTooltip("Match case");
+
+    // Keep the next button on the same row
+    ImGui::SameLine();
+
+    // Render the next button that selects the following match in the editor
+    if (ImGui::Button("Next") || query_submitted) [[unlikely]] {
+        this->select_next_match();
+    }
+
+    // Keep the replace button on the same row
+    ImGui::SameLine();
+
+    // Render the replace button that replaces every match in a single pass
+    if (ImGui::Button("Replace All")) [[unlikely]] {
+        this->finish_loading();
+        const std::size_t replaced = core::search::replace_all(this->text_, this->find_query_, this->replace_text_, this->find_case_sensitive_);
+        SPDLOG_DEBUG("Replace All button was pressed, replaced '{}' matches", replaced);
+        if (replaced != 0) {
+            this->text_metrics_need_update_ = true;
+            this->text_changed_ = true;
+            this->repaired_utf8_offsets_.clear();
+            this->find_match_count_need_update_ = true;
+            this->find_cursor_ = 0;
+            if (this->on_text_inserted_) {
+                this->on_text_inserted_(this->replace_text_);
+            }
+        }
+    }
+
+    // Hint that the replacements can be reviewed first
+    ImGui::SetItemTooltip("Right-click to preview the replacements");
+
+    // Open a menu with the preview when the replace button is right-clicked
+    if (ImGui::BeginPopupContextItem("##replace_options")) [[unlikely]] {
+        if (ImGui::MenuItem("Preview replacements", nullptr, false, !this->find_query_.empty())) {
+            this->finish_loading();
+
+            // Replacing only yields the new text, so the preview diffs it against the current one to recover the changes
+            const core::memory::Scope memory_scope{core::memory::Tag::TextEngine};
+            std::string replaced = this->text_;
+            static_cast<void>(core::search::replace_all(replaced, this->find_query_, this->replace_text_, this->find_case_sensitive_));
+            this->open_preview(core::diff::compute_changes(this->text_, replaced));
+        }
+        ImGui::EndPopup();
+    }
+
+    // Keep the match count on the same row
+    ImGui::SameLine();
+
+    // Render the match count without building a temporary string
+    ImGui::Text("%zu matches", this->find_match_count_);
+}
+
+void Editor::select_next_match()
+{
+    // Nothing to select without a query
+    if (this->find_query_.empty()) {
+        return;
+    }
+
+    // Search after the previous match first, then wrap around to the start of the text
+    const core::search::Searcher searcher{this->find_query_, this->find_case_sensitive_};
+    std::size_t position = searcher.find(this->text_, this->find_cursor_);
+    if (position == std::string_view::npos && this->find_cursor_ != 0) {
+        position = searcher.find(this->text_, 0);
+    }
+    if (position == std::string_view::npos) {
+        SPDLOG_DEBUG("No match for the find query");
+        return;
+    }
+
+    // Remember the match, the editor widget selects it on its next callback
+    this->pending_selection_start_ = position;
+    this->pending_selection_end_ = position + this->find_query_.size();
+    this->has_pending_selection_ = true;
+    this->find_cursor_ = this->pending_selection_end_;
 }
 
 void Editor::update_and_draw_editor()
 {
+    this->update_and_draw_tabs();
+
     // Query the available size to grow the editor with the window
     const ImVec2 size = ImGui::GetContentRegionAvail();
 
+    // Filter every typed or pasted character, so glyphs for new scripts are requested without rescanning the whole text
+    // Also receive a callback every frame while active, so a match found by the find bar can be selected and loaded text can be inserted
+    // ImGui reports a frame with user edits as an edit callback instead, which tells them apart from insertions by the loader
+    constexpr ImGuiInputTextFlags flags = ImGuiInputTextFlags_AllowTabInput |
+                                          ImGuiInputTextFlags_CallbackCharFilter |
+                                          ImGuiInputTextFlags_CallbackAlways |
+                                          ImGuiInputTextFlags_CallbackEdit;
+
+    // Move keyboard focus into the editor, so the pending match selection becomes visible
+    if (this->has_pending_selection_) [[unlikely]] {
+        ImGui::SetKeyboardFocusHere();
+    }
+
     // Submit the multiline text widget that edits the internal text
-    if (ImGui::InputTextMultiline("##text", &this->text_, size, ImGuiInputTextFlags_AllowTabInput)) {
+    // Scope it by document, so every tab keeps its own scroll position and undo state is not carried across tabs
+    ImGui::PushID(static_cast<int>(this->tabs_[this->active_tab_].id));
+    if (ImGui::InputTextMultiline("##text", &this->text_, size, flags, &Editor::handle_input_callback, this)) {
         this->text_metrics_need_update_ = true;
+        this->text_changed_ = true;
+        this->repaired_utf8_offsets_.clear();
+        this->find_match_count_need_update_ = true;
+    }
+    this->is_editor_active_ = ImGui::IsItemActive();
+    ImGui::PopID();
+}
+
+void Editor::update_and_draw_tabs()
+{
+    // Collect the requested changes, and apply them once the tab bar is finished, so the tabs are not modified while they are drawn
+    std::size_t selected = this->active_tab_;
+    std::size_t closed = this->tabs_.size();
+    bool add = ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_T, ImGuiInputFlags_RouteGlobal);
+    if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_W, ImGuiInputFlags_RouteGlobal)) [[unlikely]] {
+        closed = this->active_tab_;
+    }
+
+    constexpr ImGuiTabBarFlags tab_bar_flags = ImGuiTabBarFlags_AutoSelectNewTabs |
+                                               ImGuiTabBarFlags_FittingPolicyScroll |
+                                               ImGuiTabBarFlags_TabListPopupButton;
+    if (ImGui::BeginTabBar("##documents", tab_bar_flags)) [[likely]] {
+        for (std::size_t i = 0; i < this->tabs_.size(); ++i) {
+            bool open = true;
+            const ImGuiTabItemFlags tab_flags = this->tab_selection_pending_ && i == this->active_tab_ ? ImGuiTabItemFlags_SetSelected : ImGuiTabItemFlags_None;
+            if (ImGui::BeginTabItem(this->tabs_[i].label.c_str(), &open, tab_flags)) {
+                // While a programmatic selection is pending, the tab bar still reports the previously selected tab
+                if (!this->tab_selection_pending_) {
+                    selected = i;
+                }
+                ImGui::EndTabItem();
+            }
+            if (!open) [[unlikely]] {
+                closed = i;
+            }
+        }
+        if (ImGui::TabItemButton("+", ImGuiTabItemFlags_Trailing | ImGuiTabItemFlags_NoTooltip)) [[unlikely]] {
+            add = true;
+        }
+        ImGui::EndTabBar();
+    }
+    this->tab_selection_pending_ = false;
+
+    if (closed < this->tabs_.size()) [[unlikely]] {
+        this->close_document(closed);
+    }
+    else if (add) [[unlikely]] {
+        this->new_document({});
+    }
+    else if (selected != this->active_tab_) [[unlikely]] {
+        this->activate_document(selected);
     }
 }
 
+int Editor::handle_input_callback(ImGuiInputTextCallbackData *data)
+{
+    auto *editor = static_cast<Editor *>(data->UserData);
+
+    // Apply the pending match selection, then let the widget take over again
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackAlways || data->EventFlag == ImGuiInputTextFlags_CallbackEdit) {
+        if (data->EventFlag == ImGuiInputTextFlags_CallbackEdit && editor->loader_) {
+            editor->is_load_edited_ = true;
+        }
+
+        // Insert the loaded text through the widget, which owns the text while active, keeping the cursor and selection where they were
+        if (!editor->loaded_text_.empty()) [[unlikely]] {
+            const auto position = static_cast<int>(editor->find_load_position(std::string_view{data->Buf, static_cast<std::size_t>(data->BufTextLen)}));
+            const auto size = static_cast<int>(editor->loaded_text_.size());
+            const int selection_start = data->SelectionStart >= position ? data->SelectionStart + size : data->SelectionStart;
+            const int selection_end = data->SelectionEnd >= position ? data->SelectionEnd + size : data->SelectionEnd;
+            const int cursor = data->CursorPos >= position ? data->CursorPos + size : data->CursorPos;
+            data->InsertChars(position, editor->loaded_text_.data(), editor->loaded_text_.data() + editor->loaded_text_.size());
+            data->SelectionStart = selection_start;
+            data->SelectionEnd = selection_end;
+            data->CursorPos = cursor;
+            editor->on_loaded_text_inserted();
+        }
+
+        if (editor->has_pending_selection_ && editor->pending_selection_end_ <= static_cast<std::size_t>(data->BufTextLen)) [[unlikely]] {
+            data->SelectionStart = static_cast<int>(editor->pending_selection_start_);
+            data->SelectionEnd = static_cast<int>(editor->pending_selection_end_);
+            data->CursorPos = data->SelectionEnd;
+        }
+        editor->has_pending_selection_ = false;
+
+        // Normalize the widget's copy once the whole file is in, keeping the cursor as close to where it was as the shorter text allows
+        if (editor->is_normalize_pending_ && !editor->loader_) [[unlikely]] {
+            editor->is_normalize_pending_ = false;
+            std::string normalized{data->Buf, static_cast<std::size_t>(data->BufTextLen)};
+            std::size_t change_count;
+            {
+                const core::memory::Scope memory_scope{core::memory::Tag::TextEngine};
+                change_count = core::text::remove_unwanted_characters(normalized, editor->cleanup_options_);
+            }
+            if (change_count != 0) {
+                int cursor = std::min(data->CursorPos, static_cast<int>(normalized.size()));
+                while (cursor > 0 && (static_cast<unsigned char>(normalized[static_cast<std::size_t>(cursor)]) & 0xC0) == 0x80) {
+                    --cursor;
+                }
+                data->DeleteChars(0, data->BufTextLen);
+                data->InsertChars(0, normalized.data(), normalized.data() + normalized.size());
+                data->CursorPos = cursor;
+                data->SelectionStart = cursor;
+                data->SelectionEnd = cursor;
+                editor->repaired_utf8_offsets_.clear();
+            }
+        }
+        return 0;
+    }
+
+    const auto code_point = static_cast<char32_t>(data->EventChar);
+
+    // ASCII is always covered by the default font
+    if (code_point < 0x80 || !editor->on_text_inserted_) [[likely]] {
+        return 0;
+    }
+
+    // Encode the character back to UTF-8
+    std::array<char, 4> utf8{};
+    std::size_t length;
+    if (code_point < 0x800) {
+        utf8[0] = static_cast<char>(0xC0 | (code_point >> 6));
+        utf8[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+        length = 2;
+    }
+    else if (code_point < 0x10000) {
+        utf8[0] = static_cast<char>(0xE0 | (code_point >> 12));
+        utf8[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        utf8[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+        length = 3;
+    }
+    else {
+        utf8[0] = static_cast<char>(0xF0 | (code_point >> 18));
+        utf8[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        utf8[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        utf8[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+        length = 4;
+    }
+    editor->on_text_inserted_(std::string_view{utf8.data(), length});
+
+    return 0;
+}
+
 void Editor::update_and_draw_bottom_status()
 {
-    if (this->text_metrics_need_update_) {
-        this->word_count_ = core::text::count_words(this->text_);
-        this->character_count_ = core::text::count_characters(this->text_);
+    // While a file is loading, the loader provides the statistics instead, so the text is not rescanned for every part
+    if (this->text_metrics_need_update_ && !this->loader_) {
+        const core::memory::Scope memory_scope{core::memory::Tag::TextEngine};
+        this->text_stats_ = core::text::compute_stats(this->text_, 0, this->segment_words_);
         this->text_metrics_need_update_ = false;
 
-        SPDLOG_DEBUG("Recalculated text metrics ({} words, {} characters)",
-                     this->word_count_,
-                     this->character_count_);
+        // Point at broken bytes while they are there, and at the replacement characters right after a repair
+        const std::vector<std::size_t> invalid_offsets = core::utf8::find_invalid_sequences(this->text_);
+        if (!invalid_offsets.empty()) {
+            this->utf8_status_ = format_offsets("Invalid UTF-8", invalid_offsets);
+        }
+        else if (!this->repaired_utf8_offsets_.empty()) {
+            this->utf8_status_ = format_offsets("Repaired UTF-8", this->repaired_utf8_offsets_);
+        }
+        else {
+            this->utf8_status_.clear();
+        }
+        this->status_text_need_update_ = true;
+
+        SPDLOG_DEBUG("Recalculated text metrics ({} words, {} characters, {} lines)",
+                     this->text_stats_.words,
+                     this->text_stats_.characters,
+                     this->text_stats_.lines);
     }
 
-    // Calculate the metrics and format them into a status string
-    const std::string status = std::format("Words: {}  Characters: {}",
-                                           this->word_count_,
-                                           this->character_count_);
+    // Rebuild the status text in place, reusing its buffer
+    if (this->status_text_need_update_) {
+        this->status_text_.clear();
+        std::format_to(std::back_inserter(this->status_text_),
+                       "Words: {}  Characters: {}{}{}{}{}{}{}",
+                       this->text_stats_.words,
+                       this->text_stats_.characters,
+                       this->load_status_.empty() ? "" : "  ",
+                       this->load_status_,
+                       this->utf8_status_.empty() ? "" : "  ",
+                       this->utf8_status_,
+                       this->clipboard_watch_status_.empty() ? "" : "  ",
+                       this->clipboard_watch_status_);
+        this->status_text_need_update_ = false;
+        this->status_width_need_update_ = true;
+    }
+
+    // Pointers to the cached status text, so it is neither copied nor scanned for its terminator
+    const char *status_begin = this->status_text_.data();
+    const char *status_end = status_begin + this->status_text_.size();
+
+    // Measure the status text only when it or the font changed
+    if (this->status_width_need_update_) [[unlikely]] {
+        this->status_width_ = ImGui::CalcTextSize(status_begin, status_end).x;
+        this->status_width_need_update_ = false;
+    }
 
     // Determine the available width within the status bar
     const float available_width = ImGui::GetContentRegionAvail().x;
 
-    // Measure the pixel width of the status string with the active font
-    const float text_width = ImGui::CalcTextSize(status.c_str()).x;
-
     // Compute a centered X offset when there is enough room
-    const float x = (available_width > text_width) ? (available_width - text_width) * 0.5f : 0.0f;
+    const float x = (available_width > this->status_width_) ? (available_width - this->status_width_) * 0.5f : 0.0f;
 
     // Position the cursor to center the status text
     ImGui::SetCursorPosX(x);
 
-    // Render the status line using the formatted string
-    ImGui::TextUnformatted(status.c_str());
+    // Render the cached status line
+    ImGui::TextUnformatted(status_begin, status_end);
+
+    // Show the remaining statistics while the status line is hovered
+    if (ImGui::BeginItemTooltip()) {
+        const std::size_t reading_time = this->text_stats_.reading_time_seconds();
+        ImGui::Text("Lines: %zu", this->text_stats_.lines);
+        ImGui::Text("Sentences: %zu", this->text_stats_.sentences);
+        ImGui::Text("Paragraphs: %zu", this->text_stats_.paragraphs);
+        ImGui::Text("Average word length: %.1f", this->text_stats_.average_word_length());
+        ImGui::Text("Longest line: %zu characters", this->text_stats_.longest_line);
+        ImGui::Text("Non-ASCII characters: %zu", this->text_stats_.non_ascii_characters);
+        ImGui::Text("Reading time: %zu:%02zu", reading_time / 60, reading_time % 60);
+        ImGui::TextDisabled("Right-click to split Chinese and Japanese into words");
+        ImGui::EndTooltip();
+    }
+
+    // Open a menu with the word counting setting when the status line is right-clicked; the text needs an explicit ID
+    if (ImGui::BeginPopupContextItem("##word_options")) [[unlikely]] {
+        if (ImGui::MenuItem("Split Chinese and Japanese into words (UAX #29)", nullptr, &this->segment_words_)) {
+            this->text_metrics_need_update_ = true;
+        }
+        ImGui::EndPopup();
+    }
+}
+
+void Editor::update_and_draw_open_modal()
+{
+    // Lock the modal size to its content and prevent manual repositioning
+    constexpr ImGuiWindowFlags modal_flags = ImGuiWindowFlags_AlwaysAutoResize |
+                                             ImGuiWindowFlags_NoMove;
+
+    // Query whether the popup is already open to avoid redundant open calls
+    const bool popup_visible = ImGui::IsPopupOpen("Open", ImGuiPopupFlags_AnyPopupId);
+
+    // Open the popup only when the UI requested it and it is currently closed
+    if (this->is_open_modal_open_ && !popup_visible) [[unlikely]] {
+        ImGui::OpenPopup("Open");
+    }
+
+    // Fetch the global ImGui IO state for display size queries
+    const ImGuiIO &io = ImGui::GetIO();
+
+    // Force the modal to stay centered relative to the display
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+
+    // Begin the popup modal and populate it when the window becomes visible
+    if (ImGui::BeginPopupModal("Open", nullptr, modal_flags)) [[unlikely]] {
+        // Put the caret into the path field as soon as the modal appears
+        if (ImGui::IsWindowAppearing()) {
+            ImGui::SetKeyboardFocusHere();
+        }
+
+        // Render the path field, pressing Enter opens the file
+        ImGui::SetNextItemWidth(io.DisplaySize.x * 0.5f);
+        const bool path_submitted = ImGui::InputTextWithHint("##open_path", "Path to a text file", &this->open_path_, ImGuiInputTextFlags_EnterReturnsTrue);
+
+        // Explain why the last attempt failed, until the next one
+        if (!this->open_error_.empty()) {
+            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.95f, 0.45f, 0.45f, 1.0f));
+            ImGui::TextUnformatted(this->open_error_.c_str());
+            ImGui::PopStyleColor();
+        }
+
+        // Load the file and close the modal, or keep it open with the error
+        if (ImGui::Button("Open") || path_submitted) {
+            try {
+                this->open_file(this->open_path_);
+                this->is_open_modal_open_ = false;
+            }
+            catch (const std::exception &e) {
+                SPDLOG_ERROR("{}", e.what());
+                this->open_error_ = e.what();
+            }
+        }
+
+        // Keep the cancel button on the same row
+        ImGui::SameLine();
+
+        // Close the modal without touching the text, Escape does the same
+        if (ImGui::Button("Cancel") || ImGui::IsKeyPressed(ImGuiKey_Escape)) {
+            this->is_open_modal_open_ = false;
+        }
+
+        // Close the popup once either button cleared the toggle
+        if (!this->is_open_modal_open_) {
+            ImGui::CloseCurrentPopup();
+        }
+
+        // End the popup modal after populating all widgets
+        ImGui::EndPopup();
+    }
+}
+
+void Editor::open_preview(std::vector<core::diff::Change> changes)
+{
+    this->preview_changes_ = std::move(changes);
+    this->preview_accepted_count_ = this->preview_changes_.size();
+
+    // Number the lines in one pass over the text, as the changes are sorted by position
+    this->preview_line_numbers_.clear();
+    this->preview_line_numbers_.reserve(this->preview_changes_.size());
+    std::size_t line = 1;
+    std::size_t counted_until = 0;
+    for (const core::diff::Change &change : this->preview_changes_) {
+        line += static_cast<std::size_t>(std::count(this->text_.cbegin() + static_cast<std::ptrdiff_t>(counted_until),
+                                                    this->text_.cbegin() + static_cast<std::ptrdiff_t>(change.begin),
+                                                    '\n'));
+        counted_until = change.begin;
+        this->preview_line_numbers_.push_back(line);
+    }
+
+    this->is_preview_modal_open_ = true;
+    SPDLOG_DEBUG("Opened the preview with '{}' changes", this->preview_changes_.size());
+}
+
+void Editor::update_and_draw_preview_modal()
+{
+    // Query whether the popup is already open to avoid redundant open calls
+    const bool popup_visible = ImGui::IsPopupOpen("Preview", ImGuiPopupFlags_AnyPopupId);
+
+    // Open the popup only when the UI requested it and it is currently closed
+    if (this->is_preview_modal_open_ && !popup_visible) [[unlikely]] {
+        ImGui::OpenPopup("Preview");
+    }
+
+    // Fetch the global ImGui IO state for display size queries
+    const ImGuiIO &io = ImGui::GetIO();
+
+    // Cover most of the display, so long lists of changes stay readable
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+    ImGui::SetNextWindowSize(ImVec2(io.DisplaySize.x * 0.9f, io.DisplaySize.y * 0.8f), ImGuiCond_Always);
+
+    // Begin the modal popup and populate it when the window becomes visible
+    if (ImGui::BeginPopupModal("Preview", nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize)) [[unlikely]] {
+        // Render the number of accepted changes without building a temporary string
+        ImGui::Text("%zu of %zu changes accepted", this->preview_accepted_count_, this->preview_changes_.size());
+
+        // Keep the bulk toggles on the same row
+        ImGui::SameLine();
+
+        // Render the buttons that accept or reject every change at once
+        if (ImGui::Button("Accept All")) {
+            for (core::diff::Change &change : this->preview_changes_) {
+                change.is_accepted = true;
+            }
+            this->preview_accepted_count_ = this->preview_changes_.size();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Reject All")) {
+            for (core::diff::Change &change : this->preview_changes_) {
+                change.is_accepted = false;
+            }
+            this->preview_accepted_count_ = 0;
+        }
+
+        // Leave room for the apply and cancel buttons underneath the list
+        const float list_height = std::max(0.0f, ImGui::GetContentRegionAvail().y - ImGui::GetFrameHeightWithSpacing());
+
+        // Scrollable table of changes, with a header row that stays visible
+        constexpr ImGuiTableFlags table_flags = ImGuiTableFlags_ScrollY |
+                                                ImGuiTableFlags_RowBg |
+                                                ImGuiTableFlags_BordersInnerV;
+        if (ImGui::BeginTable("##changes", 4, table_flags, ImVec2(0.0f, list_height))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("##accepted", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableSetupColumn("Line", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableSetupColumn("Before", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("After", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableHeadersRow();
+
+            // Color of removed and inserted text
+            const ImVec4 removed_color{0.95f, 0.45f, 0.45f, 1.0f};
+            const ImVec4 inserted_color{0.45f, 0.85f, 0.45f, 1.0f};
+
+            // Submit only the rows that are scrolled into view, so the cost per frame does not grow with the number of changes
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(this->preview_changes_.size()));
+            while (clipper.Step()) {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                    core::diff::Change &change = this->preview_changes_[static_cast<std::size_t>(row)];
+                    const std::string_view before = context_before(this->text_, change.begin);
+                    const std::string_view after = context_after(this->text_, change.end);
+
+                    ImGui::PushID(row);
+                    ImGui::TableNextRow();
+
+                    // Toggle the change, keeping the cached count in sync
+                    ImGui::TableNextColumn();
+                    if (ImGui::Checkbox("##accepted", &change.is_accepted)) {
+                        if (change.is_accepted) {
+                            ++this->preview_accepted_count_;
+                        }
+                        else {
+                            --this->preview_accepted_count_;
+                        }
+                    }
+
+                    // Render the line the change starts on
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%zu", this->preview_line_numbers_[static_cast<std::size_t>(row)]);
+
+                    // Render the original text with the removed span highlighted
+                    ImGui::TableNextColumn();
+                    draw_context_span(before);
+                    ImGui::SameLine(0.0f, 0.0f);
+                    draw_changed_span(std::string_view{this->text_}.substr(change.begin, change.end - change.begin), removed_color);
+                    ImGui::SameLine(0.0f, 0.0f);
+                    draw_context_span(after);
+
+                    // Render the resulting text with the inserted span highlighted
+                    ImGui::TableNextColumn();
+                    draw_context_span(before);
+                    ImGui::SameLine(0.0f, 0.0f);
+                    draw_changed_span(change.replacement, inserted_color);
+                    ImGui::SameLine(0.0f, 0.0f);
+                    draw_context_span(after);
+
+                    ImGui::PopID();
+                }
+            }
+            ImGui::EndTable();
+        }
+
+        // Apply the accepted changes in a single pass, then close the preview
+        if (ImGui::Button("Apply")) {
+            this->text_ = core::diff::apply_changes(this->text_, this->preview_changes_);
+            this->text_metrics_need_update_ = true;
+            this->text_changed_ = true;
+            this->repaired_utf8_offsets_.clear();
+            this->find_match_count_need_update_ = true;
+            this->find_cursor_ = 0;
+            SPDLOG_DEBUG("Applied '{}' of '{}' previewed changes", this->preview_accepted_count_, this->preview_changes_.size());
+            this->is_preview_modal_open_ = false;
+        }
+
+        // Keep the cancel button on the same row
+        ImGui::SameLine();
+
+        // Discard the preview without touching the text, Escape does the same
+        if (ImGui::Button("Cancel") || ImGui::IsKeyPressed(ImGuiKey_Escape)) {
+            this->is_preview_modal_open_ = false;
+        }
+
+        // Close the popup once either button cleared the toggle
+        if (!this->is_preview_modal_open_) {
+            this->preview_changes_.clear();
+            this->preview_line_numbers_.clear();
+            ImGui::CloseCurrentPopup();
+        }
+
+        // End the popup modal after populating all widgets
+        ImGui::EndPopup();
+    }
 }
 
 void Editor::update_and_draw_usage_modal()
@@ -273,9 +1455,14 @@ void Editor::update_and_draw_usage_modal()
             ImGui::CloseCurrentPopup();
         }
         else {
-            ImGui::TextUnformatted("1. Click Paste to load text from the clipboard.");
-            ImGui::TextUnformatted("2. Click Normalize to modify the text in place.");
-            ImGui::TextUnformatted("3. Click Copy to write the text to the clipboard.");
+            ImGui::TextUnformatted("1. Click Paste to load text from the clipboard, or Open to load a text file (UTF-8, UTF-16, or Windows-1252).");
+            ImGui::TextUnformatted("2. Click Normalize (or press Ctrl+Shift+N) to modify the text in place (right-click it for more rules).");
+            ImGui::TextUnformatted("3. Click Preview to review the changes Normalize would make, and apply only the ones you accept.");
+            ImGui::TextUnformatted("4. Click Dedupe to review and remove repeated paragraphs (right-click it to compare lines or find near-duplicates).");
+            ImGui::TextUnformatted("5. Click Copy to write the text to the clipboard.");
+            ImGui::TextUnformatted("6. Click Find (or press Ctrl+F) to find and replace text (right-click Replace All to preview the replacements).");
+            ImGui::TextUnformatted("7. Click + (or press Ctrl+T) to open a new tab; press Ctrl+W to close the current one.");
+            ImGui::TextUnformatted("8. Press Ctrl+Shift+M to show how much memory each part of the app uses.");
         }
 
         // End the popup modal after populating all widgets
@@ -288,4 +1475,63 @@ void Editor::update_and_draw_usage_modal()
     }
 }
 
+void Editor::update_and_draw_memory_panel()
+{
+    // Accept Ctrl+Shift+M (Cmd+Shift+M on macOS) from anywhere in the window, toggling the panel
+    if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiMod_Shift | ImGuiKey_M, ImGuiInputFlags_RouteGlobal)) [[unlikely]] {
+        this->is_memory_panel_open_ = !this->is_memory_panel_open_;
+        this->memory_rates_snapshot_ = core::memory::take_snapshot();
+        this->memory_rates_ = {};
+    }
+
+    // Skip reading the counters entirely while the panel is closed
+    if (!this->is_memory_panel_open_) [[likely]] {
+        return;
+    }
+
+    // Show the live usage every frame, but recompute the rates only a few times per second, so they can be read
+    const core::memory::Snapshot snapshot = core::memory::take_snapshot();
+    if (snapshot.seconds - this->memory_rates_snapshot_.seconds >= MEMORY_RATE_INTERVAL_SECONDS) {
+        this->memory_rates_ = core::memory::compute_rates(this->memory_rates_snapshot_, snapshot);
+        this->memory_rates_snapshot_ = snapshot;
+    }
+
+    // Draw the panel as a floating window next to the editor, closed by its close button or the shortcut
+    if (ImGui::Begin("Memory", &this->is_memory_panel_open_, ImGuiWindowFlags_AlwaysAutoResize)) {
+        if (!core::memory::is_global_accounting_enabled()) {
+            ImGui::TextUnformatted("Only ImGui and the font atlas are accounted (built without ENABLE_MEMORY_ACCOUNTING).");
+        }
+        if (ImGui::BeginTable("##memory", 5, ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Subsystem");
+            ImGui::TableSetupColumn("Live");
+            ImGui::TableSetupColumn("Peak");
+            ImGui::TableSetupColumn("Allocations/s");
+            ImGui::TableSetupColumn("Allocated/s");
+            ImGui::TableHeadersRow();
+            for (std::size_t i = 0; i < core::memory::TAG_COUNT; ++i) {
+                const std::string_view name = core::memory::to_string(static_cast<core::memory::Tag>(i));
+                const core::memory::Usage &usage = snapshot.usages[i];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name.data(), name.data() + name.size());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f MiB", static_cast<double>(usage.bytes) / BYTES_PER_MIB);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f MiB", static_cast<double>(usage.peak_bytes) / BYTES_PER_MIB);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f", this->memory_rates_[i].allocations_per_second);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f MiB", this->memory_rates_[i].bytes_per_second / BYTES_PER_MIB);
+            }
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted("Total");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f MiB", static_cast<double>(snapshot.total_bytes()) / BYTES_PER_MIB);
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
+
 }  // namespace ui::editor
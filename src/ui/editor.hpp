@@ -6,13 +6,30 @@
 
 #pragma once
 
-#include <cstddef>  // for std::size_t
-#include <span>     // for std::span
-#include <string>   // for std::string
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <filesystem>   // for std::filesystem::path
+#include <functional>   // for std::function
+#include <memory>       // for std::unique_ptr
+#include <span>         // for std::span
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
 
 #include <SFML/Window/Event.hpp>
 #include <SFML/Window/Keyboard.hpp>
 
+#include "core/clipboard_watch.hpp"
+#include "core/dedupe.hpp"
+#include "core/diff.hpp"
+#include "core/documents.hpp"
+#include "core/loader.hpp"
+#include "core/memory.hpp"
+#include "core/text.hpp"
+
+struct ImFont;
+struct ImGuiInputTextCallbackData;
+
 namespace ui::editor {
 
 /**
@@ -22,69 +39,549 @@ namespace ui::editor {
  */
 class Editor {
   public:
+    using text_inserted_callback_t = std::function<void(std::string_view)>;
+    using text_changed_callback_t = std::function<void(std::size_t, std::string_view)>;
+    using document_closed_callback_t = std::function<void(std::size_t)>;
+
+    /**
+     * @brief Construct a new Editor object.
+     *
+     * @param on_text_inserted Callback invoked with text that enters the editor (pasted, or non-ASCII characters typed into the widget), so the caller can load glyphs for it. May be empty.
+     * @param on_text_changed Callback invoked with the identifier and whole text of a document at the end of every frame that changed it, and before another tab becomes the active one, so the caller can persist it. May be empty.
+     * @param on_document_closed Callback invoked with the identifier of a document whose tab was closed, so the caller can forget it. May be empty.
+     */
+    explicit Editor(text_inserted_callback_t on_text_inserted = {},
+                    text_changed_callback_t on_text_changed = {},
+                    document_closed_callback_t on_document_closed = {});
+
     /**
      * @brief Submit all ImGui widgets for the current frame.
      *
      * The method restores layout hints, draws the toolbar and editor, updates the status bar, and opens the usage modal when required.
+     * Text measurements and the status text are cached, so an idle frame does not allocate or measure text.
+     * Heap memory allocated meanwhile is charged to the editor buffer, except for the temporary results of the text engine.
      */
     void update_and_draw();
 
+    /**
+     * @brief Load a text file into a new tab, or into the current tab if it is empty.
+     *
+     * The encoding is detected and the file is transcoded into UTF-8 while it is read. The first block is shown right away; the rest is read, validated, and counted on a background thread and appended as it arrives, while the text can already be edited.
+     *
+     * @param path Path to the file (e.g., "notes.txt").
+     * @param title Title of the tab, or empty to use the file name (e.g., for a file handed over by another instance through "/proc/self/fd").
+     *
+     * @throws std::runtime_error if the file cannot be read.
+     */
+    void open_file(const std::filesystem::path &path,
+                   const std::string_view title = {});
+
+    /**
+     * @brief Replace the text of the active document.
+     *
+     * Invalid UTF-8 is repaired if the rule is enabled, the same as for pasted and opened text.
+     *
+     * @param text New text (e.g., "Hello world").
+     */
+    void set_text(std::string text);
+
+    /**
+     * @brief Add a document with a text in a new tab, or into the current tab if it is empty (e.g., a document restored from the last session).
+     *
+     * @param text Text of the document (e.g., "Hello world").
+     *
+     * @return Identifier of the document, as passed to the text-changed and document-closed callbacks (e.g., "2").
+     */
+    [[nodiscard]] std::size_t add_document(std::string text);
+
+    /**
+     * @brief Change the memory budget shared by all open documents; inactive documents beyond it are compressed or paged out to disk.
+     *
+     * @param bytes Memory budget in bytes (e.g., "268435456").
+     */
+    void set_memory_budget(const std::size_t bytes);
+
+    /**
+     * @brief Start or stop watching the clipboard, normalizing every text copied to it with the current cleanup rules.
+     *
+     * If the watcher cannot be started (e.g., no X11 display), the error is logged and shown in the status bar instead.
+     *
+     * @param enabled Whether the clipboard should be watched.
+     */
+    void set_clipboard_watch(const bool enabled);
+
   private:
     /**
-     * @brief Calculate horizontal offset that centers the toolbar buttons.
+     * @brief Calculate the width of the toolbar buttons, including the spacing between them.
      *
      * @param labels Captions that will be rendered on the toolbar buttons.
      *
-     * @return Offset in pixels relative to the current window origin.
+     * @return Width of the button row in pixels.
      */
-    [[nodiscard]] float calculate_center_offset_for_labels(std::span<const std::string> labels) const;
+    [[nodiscard]] float calculate_width_for_labels(std::span<const std::string> labels) const;
 
     /**
      * @brief Draw the toolbar that provides clipboard and normalization actions.
      */
     void update_and_draw_top_bar();
 
+    /**
+     * @brief Write the text normalized by the clipboard watcher back to the clipboard, and refresh its hit counter in the status bar.
+     */
+    void update_clipboard_watch();
+
+    /**
+     * @brief Draw the find and replace row below the toolbar, if it is open.
+     */
+    void update_and_draw_find_bar();
+
+    /**
+     * @brief Select the next match of the find query after the previous one, wrapping around to the start of the text.
+     */
+    void select_next_match();
+
     /**
      * @brief Render the multiline editor and handle caret focus.
      */
     void update_and_draw_editor();
 
+    /**
+     * @brief Render the document tabs above the editor, and switch, add, or close documents as requested.
+     */
+    void update_and_draw_tabs();
+
+    /**
+     * @brief Add an empty document in a new tab and make it the active one.
+     *
+     * @param title Title shown on the tab (e.g., "notes.txt").
+     */
+    void new_document(const std::string_view title);
+
+    /**
+     * @brief Make another tab the active one, putting the current text back into the document store.
+     *
+     * @param index Index of the tab (e.g., "2").
+     */
+    void activate_document(const std::size_t index);
+
+    /**
+     * @brief Close a tab and drop its document; closing the last tab leaves a new, empty one.
+     *
+     * @param index Index of the tab (e.g., "2").
+     */
+    void close_document(const std::size_t index);
+
+    /**
+     * @brief Pass the text of the active document to the text-changed callback, if it changed since it was last passed and is not being loaded.
+     */
+    void report_text_change();
+
+    /**
+     * @brief Take the text read by the loader since the last frame, and insert it unless the editor widget owns the text.
+     *
+     * While the widget is active, ImGui keeps its own copy of the text, so the insertion is left to "handle_input_callback()". Once everything was inserted, the load is completed.
+     */
+    void update_loading();
+
+    /**
+     * @brief Return where the next loaded text belongs, i.e., right after the text loaded so far.
+     *
+     * The position is found again every time from the last loaded bytes, so edits made during the load do not need to be tracked; if those bytes were edited away, the text is appended at the end.
+     *
+     * @param text Current text of the editor.
+     *
+     * @return Byte offset where the loaded text is inserted.
+     */
+    [[nodiscard]] std::size_t find_load_position(const std::string_view text) const;
+
+    /**
+     * @brief Update the load anchor and notify the caller after the pending loaded text was inserted, then drop it.
+     */
+    void on_loaded_text_inserted();
+
+    /**
+     * @brief Wait for the load to finish and insert the rest of the file, before an action that needs the whole text.
+     */
+    void finish_loading();
+
+    /**
+     * @brief Stop loading and drop the text that was not inserted yet, when the text is replaced or its document is closed.
+     */
+    void cancel_loading();
+
+    /**
+     * @brief Adopt the statistics and UTF-8 offsets computed by the loader, unless the text was edited meanwhile, and release it.
+     */
+    void complete_loading();
+
     /**
      * @brief Update and render the bottom status line.
      */
     void update_and_draw_bottom_status();
 
+    /**
+     * @brief Render the open modal, which asks for the path of a text file to load.
+     */
+    void update_and_draw_open_modal();
+
+    /**
+     * @brief Open the preview modal with a list of changes to accept or reject (e.g., the changes the normalize button would make).
+     *
+     * @param changes Changes sorted by position, not overlapping each other.
+     */
+    void open_preview(std::vector<core::diff::Change> changes);
+
+    /**
+     * @brief Render the preview modal, letting the user accept or reject every change before applying them.
+     */
+    void update_and_draw_preview_modal();
+
     /**
      * @brief Render the usage modal and close it on toggle or outside click.
      */
     void update_and_draw_usage_modal();
 
     /**
-     * @brief Text displayed inside the editor widget.
+     * @brief Toggle the memory panel on its shortcut, and render it while it is open.
+     *
+     * The panel lists the live and peak heap usage of every subsystem, with their allocation rates.
+     */
+    void update_and_draw_memory_panel();
+
+    /**
+     * @brief Handle callbacks from the editor widget.
+     *
+     * Non-ASCII characters typed or pasted into the widget are forwarded to the text-inserted callback, a pending match selection is applied to the widget, and text read by the loader is inserted while the widget is active.
+     *
+     * @param data ImGui callback data, whose "UserData" points to the editor.
+     *
+     * @return Always 0, so the character is kept.
+     */
+    static int handle_input_callback(ImGuiInputTextCallbackData *data);
+
+    /**
+     * @brief Callback invoked with text that enters the editor, may be empty.
+     */
+    text_inserted_callback_t on_text_inserted_;
+
+    /**
+     * @brief Callback invoked with the identifier and whole text of a document after a frame that changed it, may be empty.
+     */
+    text_changed_callback_t on_text_changed_;
+
+    /**
+     * @brief Callback invoked with the identifier of a closed document, may be empty.
+     */
+    document_closed_callback_t on_document_closed_;
+
+    /**
+     * @brief Text displayed inside the editor widget, the text of the active document.
      */
     std::string text_;
 
+    /**
+     * @brief Open document, shown as a tab.
+     */
+    struct Tab {
+        /**
+         * @brief Identifier of the document in "documents_".
+         */
+        std::size_t id = 0;
+
+        /**
+         * @brief ImGui label of the tab, the title followed by a stable "###" identifier (e.g., "notes.txt###3").
+         */
+        std::string label{};
+    };
+
+    /**
+     * @brief Text of every inactive document, kept below the memory budget.
+     */
+    core::documents::DocumentStore documents_;
+
+    /**
+     * @brief Open documents, in tab order.
+     */
+    std::vector<Tab> tabs_;
+
+    /**
+     * @brief Index of the active tab, whose text is held in "text_".
+     */
+    std::size_t active_tab_ = 0;
+
+    /**
+     * @brief Whether the tab bar should select the active tab on the next frame, after it was changed programmatically.
+     */
+    bool tab_selection_pending_ = false;
+
+    /**
+     * @brief Number of untitled documents created so far, used to number their titles.
+     */
+    std::size_t untitled_count_ = 0;
+
+    /**
+     * @brief Background loader of the file being opened into the active document, or nullptr if no load is in progress.
+     */
+    std::unique_ptr<core::loader::Loader> loader_;
+
+    /**
+     * @brief Text taken from the loader that was not inserted into the editor yet.
+     */
+    std::string loaded_text_;
+
+    /**
+     * @brief Last bytes inserted by the loader, used to find the insertion point again after edits.
+     */
+    std::string loaded_tail_;
+
+    /**
+     * @brief Offsets of the invalid (or repaired) UTF-8 sequences the loader found so far.
+     */
+    std::vector<std::size_t> loaded_utf8_offsets_;
+
+    /**
+     * @brief Progress of the load, matching the text taken so far.
+     */
+    core::loader::Progress load_progress_;
+
+    /**
+     * @brief Whether the loader repairs invalid UTF-8, so its offsets point at replacement characters.
+     */
+    bool is_load_repairing_ = false;
+
+    /**
+     * @brief Whether the loader segments words, so its word count matches "segment_words_" only if both are the same.
+     */
+    bool is_load_segmenting_ = false;
+
+    /**
+     * @brief Whether the text was edited during the load, so the statistics of the loader no longer describe it.
+     */
+    bool is_load_edited_ = false;
+
+    /**
+     * @brief Whether the editor widget was active in the last frame, so ImGui owns a copy of the text.
+     */
+    bool is_editor_active_ = false;
+
+    /**
+     * @brief Whether the text should be normalized as soon as it is safe, either directly or through the active widget.
+     */
+    bool is_normalize_pending_ = false;
+
+    /**
+     * @brief Cached status bar segment about the load, empty if there is nothing to report.
+     */
+    std::string load_status_;
+
+    /**
+     * @brief Optional cleanup rules applied by the normalize button.
+     */
+    core::text::CleanupOptions cleanup_options_;
+
+    /**
+     * @brief Comparison settings of the dedupe button.
+     */
+    core::dedupe::DedupeOptions dedupe_options_;
+
+    /**
+     * @brief Track whether the open modal should be visible.
+     */
+    bool is_open_modal_open_ = false;
+
+    /**
+     * @brief Path typed into the open modal.
+     */
+    std::string open_path_;
+
+    /**
+     * @brief Reason the last file could not be opened, shown in the open modal; empty if none.
+     */
+    std::string open_error_;
+
+    /**
+     * @brief Track whether the preview modal should be visible.
+     */
+    bool is_preview_modal_open_ = false;
+
+    /**
+     * @brief Changes shown in the preview modal, whose "is_accepted" flags are toggled by the user.
+     */
+    std::vector<core::diff::Change> preview_changes_;
+
+    /**
+     * @brief One-based line number of every change in "preview_changes_".
+     */
+    std::vector<std::size_t> preview_line_numbers_;
+
+    /**
+     * @brief Cached number of accepted changes shown in the preview modal.
+     */
+    std::size_t preview_accepted_count_ = 0;
+
     /**
      * @brief Track whether the usage modal should be visible.
      */
     bool is_help_modal_open_ = false;
 
+    /**
+     * @brief Track whether the memory panel should be visible.
+     */
+    bool is_memory_panel_open_ = false;
+
+    /**
+     * @brief Snapshot the allocation rates shown in the memory panel were last computed from.
+     */
+    core::memory::Snapshot memory_rates_snapshot_;
+
+    /**
+     * @brief Allocation rates shown in the memory panel, recomputed a few times per second.
+     */
+    std::array<core::memory::Rate, core::memory::TAG_COUNT> memory_rates_{};
+
     /**
      * @brief Cached metrics stale flag used by the status bar.
      *
-     * If true, the `update_and_draw_bottom_status()` call will recalculate `word_count_` and `character_count_` before it renders the status bar.
+     * If true, the `update_and_draw_bottom_status()` call will recalculate `text_stats_` before it renders the status bar.
      */
     bool text_metrics_need_update_ = true;
 
     /**
-     * @brief Cached word total shown in the status bar.
+     * @brief Whether the status bar splits Chinese and Japanese text into words (UAX #29) instead of counting runs of non-whitespace.
+     */
+    bool segment_words_ = false;
+
+    /**
+     * @brief Whether the text changed during the current frame, so the text-changed callback is invoked at its end.
+     */
+    bool text_changed_ = false;
+
+    /**
+     * @brief Cached statistics of the text, with the word and character totals shown in the status bar and the rest in its tooltip.
+     */
+    core::text::TextStats text_stats_;
+
+    /**
+     * @brief Cached status text stale flag, set when the metrics or one of the status segments change.
+     */
+    bool status_text_need_update_ = true;
+
+    /**
+     * @brief Cached status bar text, rebuilt in place only when the metrics or a status segment change.
+     */
+    std::string status_text_;
+
+    /**
+     * @brief Font the cached layout measurements were taken with, or nullptr before the first frame.
+     */
+    const ImFont *layout_font_ = nullptr;
+
+    /**
+     * @brief Font size the cached layout measurements were taken with.
+     */
+    float layout_font_size_ = 0.0f;
+
+    /**
+     * @brief Cached toolbar width stale flag, set when the font changes.
+     */
+    bool toolbar_width_need_update_ = true;
+
+    /**
+     * @brief Cached width of the toolbar buttons, used to center them.
+     */
+    float toolbar_width_ = 0.0f;
+
+    /**
+     * @brief Cached status width stale flag, set when the font or the status text changes.
+     */
+    bool status_width_need_update_ = true;
+
+    /**
+     * @brief Cached width of "status_text_", used to center it.
+     */
+    float status_width_ = 0.0f;
+
+    /**
+     * @brief Byte offsets of the U+FFFD characters inserted by the last repair on paste, cleared when the text changes otherwise.
+     */
+    std::vector<std::size_t> repaired_utf8_offsets_;
+
+    /**
+     * @brief Cached status bar segment about invalid or repaired UTF-8, empty if there is nothing to report.
+     */
+    std::string utf8_status_;
+
+    /**
+     * @brief Background clipboard watcher, or nullptr if the clipboard is not watched.
+     */
+    std::unique_ptr<core::clipboard_watch::Watcher> clipboard_watcher_;
+
+    /**
+     * @brief Buffer that receives the normalized clipboard text, reused between hits.
+     */
+    std::string clipboard_watch_text_;
+
+    /**
+     * @brief Hit count of the watcher shown in "clipboard_watch_status_".
+     */
+    std::size_t clipboard_watch_hits_shown_ = 0;
+
+    /**
+     * @brief Cached status bar segment about the clipboard watcher, empty if it is off.
+     */
+    std::string clipboard_watch_status_;
+
+    /**
+     * @brief Track whether the find and replace row should be visible.
+     */
+    bool is_find_bar_open_ = false;
+
+    /**
+     * @brief Text to find.
+     */
+    std::string find_query_;
+
+    /**
+     * @brief Text that replaces every match.
+     */
+    std::string replace_text_;
+
+    /**
+     * @brief Whether ASCII letters must match case exactly when finding.
+     */
+    bool find_case_sensitive_ = false;
+
+    /**
+     * @brief Cached match stale flag used by the find bar.
+     *
+     * If true, the `update_and_draw_find_bar()` call will recount the matches before it renders the find bar.
+     */
+    bool find_match_count_need_update_ = true;
+
+    /**
+     * @brief Cached number of matches shown in the find bar.
+     */
+    std::size_t find_match_count_ = 0;
+
+    /**
+     * @brief Byte offset where the next "Next" search starts.
+     */
+    std::size_t find_cursor_ = 0;
+
+    /**
+     * @brief Whether a match should be selected in the editor widget on the next callback.
+     */
+    bool has_pending_selection_ = false;
+
+    /**
+     * @brief Byte offset of the first byte of the pending selection.
      */
-    std::size_t word_count_ = 0;
+    std::size_t pending_selection_start_ = 0;
 
     /**
-     * @brief Cached character total shown in the status bar.
+     * @brief Byte offset one past the last byte of the pending selection.
      */
-    std::size_t character_count_ = 0;
+    std::size_t pending_selection_end_ = 0;
 };
 
 }  // namespace ui::editor
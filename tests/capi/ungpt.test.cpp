@@ -0,0 +1,88 @@
+/**
+ * @file ungpt.test.cpp
+ */
+
+#include <cstddef>  // for std::size_t
+#include <string>   // for std::string
+
+#include <snitch/snitch.hpp>
+
+#include "capi/ungpt.h"
+
+TEST_CASE("ungpt_normalize writes into a caller-provided buffer", "[src][capi][ungpt.h]")
+{
+    const std::string input = "“Hello” — world…";
+    const std::string expected = "\"Hello\" - world...";
+
+    // Size query first, then the real call
+    const std::size_t required = ungpt_normalize(input.data(), input.size(), nullptr, 0);
+    CHECK(required == expected.size());
+
+    std::string output(required, '\0');
+    const std::size_t written = ungpt_normalize(input.data(), input.size(), output.data(), output.size());
+    CHECK(written == required);
+    CHECK(output == expected);
+}
+
+TEST_CASE("ungpt_normalize reports the required size when the buffer is too small", "[src][capi][ungpt.h]")
+{
+    const std::string input = "a—b—c";
+    char output[3] = {'x', 'x', 'x'};
+    const std::size_t required = ungpt_normalize(input.data(), input.size(), output, 2);
+    CHECK(required == 5);
+    CHECK(output[0] == 'a');
+    CHECK(output[1] == '-');
+    CHECK(output[2] == 'x');
+}
+
+TEST_CASE("ungpt_normalize_with_flags applies optional rules", "[src][capi][ungpt.h]")
+{
+    const std::string input = "As an AI language model, **this** is fine.  \n";
+    std::string output(input.size(), '\0');
+    const std::size_t written = ungpt_normalize_with_flags(input.data(), input.size(), output.data(), output.size(), UNGPT_REMOVE_AI_DISCLAIMERS | UNGPT_REMOVE_MARKDOWN_BOLD | UNGPT_TRIM_TRAILING_WHITESPACE);
+    REQUIRE(written <= output.size());
+    output.resize(written);
+    CHECK(output == "this is fine.\n");
+}
+
+TEST_CASE("ungpt_normalize_with_flags repairs invalid UTF-8", "[src][capi][ungpt.h]")
+{
+    const std::string input = "bad\xFF—byte";
+    std::string output(32, '\0');
+    output.resize(ungpt_normalize_with_flags(input.data(), input.size(), output.data(), output.size(), UNGPT_REPAIR_INVALID_UTF8));
+    CHECK(output == "bad\uFFFD-byte");
+}
+
+TEST_CASE("ungpt_normalize_with_flags preserves code", "[src][capi][ungpt.h]")
+{
+    const std::string input = "a — `b — c` — d";
+    std::string output(32, '\0');
+    output.resize(ungpt_normalize_with_flags(input.data(), input.size(), output.data(), output.size(), UNGPT_PRESERVE_CODE));
+    CHECK(output == "a - `b — c` - d");
+}
+
+TEST_CASE("ungpt_normalize_with_flags normalizes line endings and whitespace", "[src][capi][ungpt.h]")
+{
+    const std::string input = "a  —  b\r\nc";
+    std::string output(32, '\0');
+    output.resize(ungpt_normalize_with_flags(input.data(), input.size(), output.data(), output.size(), UNGPT_NORMALIZE_LINE_ENDINGS | UNGPT_COLLAPSE_WHITESPACE));
+    CHECK(output == "a - b\nc");
+}
+
+TEST_CASE("ungpt functions reject invalid arguments", "[src][capi][ungpt.h]")
+{
+    char output[4];
+    CHECK(ungpt_normalize(nullptr, 1, output, sizeof(output)) == UNGPT_ERROR);
+    CHECK(ungpt_normalize("a", 1, nullptr, 1) == UNGPT_ERROR);
+    CHECK(ungpt_normalize_with_flags("a", 1, output, sizeof(output), 128u) == UNGPT_ERROR);
+    CHECK(ungpt_count_words(nullptr, 1) == UNGPT_ERROR);
+    CHECK(ungpt_normalize(nullptr, 0, nullptr, 0) == 0);
+}
+
+TEST_CASE("ungpt counters match the text core", "[src][capi][ungpt.h]")
+{
+    const std::string input = "Zażółć gęślą jaźń";
+    CHECK(ungpt_count_words(input.data(), input.size()) == 3);
+    CHECK(ungpt_count_characters(input.data(), input.size()) == 17);
+    CHECK(ungpt_api_version() == UNGPT_API_VERSION);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file args.test.cpp
+ */
+
+#include <stdexcept>  // for std::invalid_argument
+#include <vector>     // for std::vector
+
+#include <snitch/snitch.hpp>
+
+#include "core/args.hpp"
+
+TEST_CASE("parse_arguments returns defaults when no arguments are provided", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv;
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK_FALSE(arguments.startup_trace);
+    CHECK(arguments.memory_budget_mb == 256);
+}
+
+TEST_CASE("parse_arguments enables the startup trace", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv = {"--startup-trace"};
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK(arguments.startup_trace);
+}
+
+TEST_CASE("parse_arguments rejects unknown arguments", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv = {"--does-not-exist"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(argv)), std::invalid_argument);
+}
+
+TEST_CASE("parse_arguments parses the file to open", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv = {"--open", "notes.txt"};
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK(arguments.open_file == "notes.txt");
+
+    const std::vector<const char *> with_batch = {"--open", "notes.txt", "--batch", "corpus"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(with_batch)), std::invalid_argument);
+
+    const std::vector<const char *> positional = {"notes.txt", "--startup-trace"};
+    CHECK(core::args::parse_arguments(positional).open_file == "notes.txt");
+
+    const std::vector<const char *> two_files = {"notes.txt", "other.txt"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(two_files)), std::invalid_argument);
+}
+
+TEST_CASE("parse_arguments opts out of handing the file over to a running editor", "[src][core][args.hpp]")
+{
+    CHECK_FALSE(core::args::parse_arguments(std::vector<const char *>{}).new_instance);
+
+    const std::vector<const char *> argv = {"--new-instance", "notes.txt"};
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK(arguments.new_instance);
+    CHECK(arguments.open_file == "notes.txt");
+
+    const std::vector<const char *> with_batch = {"--new-instance", "--batch", "corpus"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(with_batch)), std::invalid_argument);
+}
+
+TEST_CASE("parse_arguments enables clipboard watching", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv = {"--watch-clipboard"};
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK(arguments.watch_clipboard);
+
+    const std::vector<const char *> with_serve = {"--watch-clipboard", "--serve", "/tmp/ungpt.sock"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(with_serve)), std::invalid_argument);
+}
+
+TEST_CASE("parse_arguments parses the memory budget", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv = {"--memory-budget-mb", "64"};
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK(arguments.memory_budget_mb == 64);
+
+    const std::vector<const char *> zero = {"--memory-budget-mb", "0"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(zero)), std::invalid_argument);
+
+    const std::vector<const char *> with_batch = {"--memory-budget-mb", "64", "--batch", "corpus"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(with_batch)), std::invalid_argument);
+}
+
+TEST_CASE("parse_arguments parses the memory report", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv = {"--memory-report", "memory.json"};
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK(arguments.memory_report == "memory.json");
+
+    const std::vector<const char *> with_serve = {"--memory-report", "memory.json", "--serve", "/tmp/ungpt.sock"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(with_serve)), std::invalid_argument);
+}
+
+TEST_CASE("parse_arguments parses batch options", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv = {"--batch", "corpus", "--output", "clean", "--jobs", "8", "--max-in-flight-mb", "16", "--trim-trailing-whitespace", "--repair-invalid-utf8", "--preserve-code", "--normalize-line-endings", "--collapse-whitespace"};
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK(arguments.batch_directory == "corpus");
+    CHECK(arguments.output_directory == "clean");
+    CHECK(arguments.jobs == 8);
+    CHECK(arguments.max_in_flight_mb == 16);
+    CHECK(arguments.cleanup_options.trim_trailing_whitespace);
+    CHECK(arguments.cleanup_options.repair_invalid_utf8);
+    CHECK(arguments.cleanup_options.preserve_code);
+    CHECK(arguments.cleanup_options.normalize_line_endings);
+    CHECK(arguments.cleanup_options.collapse_whitespace);
+    CHECK_FALSE(arguments.cleanup_options.remove_ai_disclaimers);
+}
+
+TEST_CASE("parse_arguments parses duplicate removal options", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv = {"--batch", "corpus", "--remove-duplicate-lines", "--near-duplicate-threshold", "80"};
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK(arguments.remove_duplicates);
+    CHECK(arguments.dedupe_options.unit == core::dedupe::Unit::Line);
+    CHECK(arguments.dedupe_options.near_duplicate_threshold == 0.8);
+
+    const std::vector<const char *> too_high = {"--batch", "corpus", "--remove-duplicate-paragraphs", "--near-duplicate-threshold", "101"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(too_high)), std::invalid_argument);
+
+    const std::vector<const char *> threshold_only = {"--batch", "corpus", "--near-duplicate-threshold", "80"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(threshold_only)), std::invalid_argument);
+
+    const std::vector<const char *> without_batch = {"--remove-duplicate-paragraphs"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(without_batch)), std::invalid_argument);
+}
+
+TEST_CASE("parse_arguments rejects invalid batch options", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> missing_value = {"--batch"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(missing_value)), std::invalid_argument);
+
+    const std::vector<const char *> invalid_number = {"--batch", "corpus", "--jobs", "many"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(invalid_number)), std::invalid_argument);
+
+    const std::vector<const char *> zero = {"--batch", "corpus", "--jobs", "0"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(zero)), std::invalid_argument);
+
+    const std::vector<const char *> without_batch = {"--output", "clean"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(without_batch)), std::invalid_argument);
+}
+
+TEST_CASE("parse_arguments parses daemon options", "[src][core][args.hpp]")
+{
+    const std::vector<const char *> argv = {"--serve", "/tmp/ungpt.sock", "--jobs", "4", "--remove-markdown-bold"};
+    const core::args::Arguments arguments = core::args::parse_arguments(argv);
+    CHECK(arguments.serve_socket == "/tmp/ungpt.sock");
+    CHECK(arguments.jobs == 4);
+    CHECK(arguments.cleanup_options.remove_markdown_bold);
+
+    const std::vector<const char *> batch_only = {"--serve", "/tmp/ungpt.sock", "--output", "clean"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(batch_only)), std::invalid_argument);
+
+    const std::vector<const char *> both_modes = {"--serve", "/tmp/ungpt.sock", "--batch", "corpus"};
+    CHECK_THROWS_AS(static_cast<void>(core::args::parse_arguments(both_modes)), std::invalid_argument);
+}
@@ -0,0 +1,134 @@
+/**
+ * @file batch.test.cpp
+ */
+
+#include <filesystem>  // for std::filesystem
+#include <fstream>     // for std::ifstream, std::ofstream
+#include <iterator>    // for std::istreambuf_iterator
+#include <stdexcept>   // for std::invalid_argument
+#include <string>      // for std::string
+
+#include <snitch/snitch.hpp>
+
+#include "core/batch.hpp"
+
+#include "support.hpp"
+
+namespace {
+
+/**
+ * @brief Write a file, creating its parent directories.
+ *
+ * @param path Path to the file.
+ * @param content Contents to write.
+ */
+void write_file(const std::filesystem::path &path,
+                const std::string &content)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream stream{path, std::ios::binary};
+    stream << content;
+}
+
+/**
+ * @brief Read a whole file.
+ *
+ * @param path Path to the file.
+ *
+ * @return File contents.
+ */
+[[nodiscard]] std::string read_file(const std::filesystem::path &path)
+{
+    std::ifstream stream{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+}
+
+}  // namespace
+
+TEST_CASE("run_batch normalizes files in place", "[src][core][batch.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-batch-test-in-place");
+    write_file(directory / "a.txt", "“quoted”");
+    write_file(directory / "nested" / "b.MD", "plain");
+    write_file(directory / "image.png", "“binary”");
+
+    const core::batch::BatchReport report = core::batch::run_batch({.input_directory = directory, .thread_count = 2});
+
+    CHECK(report.files_processed == 2);
+    CHECK(report.files_changed == 1);
+    CHECK(report.files_failed == 0);
+    CHECK(report.replacements == 2);
+    CHECK(read_file(directory / "a.txt") == "\"quoted\"");
+    CHECK(read_file(directory / "nested" / "b.MD") == "plain");
+    CHECK(read_file(directory / "image.png") == "“binary”");
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("run_batch mirrors files into an output directory", "[src][core][batch.hpp]")
+{
+    const std::filesystem::path input = tests::support::make_empty_directory("ungpt-batch-test-input");
+    const std::filesystem::path output = tests::support::make_empty_directory("ungpt-batch-test-output");
+    write_file(input / "nested" / "a.txt", "one—two");
+
+    // A budget smaller than the file must still let it through
+    const core::batch::BatchReport report = core::batch::run_batch({.input_directory = input, .output_directory = output, .max_in_flight_bytes = 1});
+
+    CHECK(report.files_processed == 1);
+    CHECK(read_file(input / "nested" / "a.txt") == "one—two");
+    CHECK(read_file(output / "nested" / "a.txt") == "one-two");
+
+    std::filesystem::remove_all(input);
+    std::filesystem::remove_all(output);
+}
+
+#if !defined(_WIN32)
+
+TEST_CASE("run_batch keeps the permissions of the files it rewrites", "[src][core][batch.hpp]")
+{
+    constexpr std::filesystem::perms permissions = std::filesystem::perms::owner_read | std::filesystem::perms::owner_write | std::filesystem::perms::group_read;
+    const std::filesystem::path input = tests::support::make_empty_directory("ungpt-batch-test-permissions");
+    const std::filesystem::path output = tests::support::make_empty_directory("ungpt-batch-test-permissions-output");
+    write_file(input / "a.txt", "“quoted”");
+    std::filesystem::permissions(input / "a.txt", permissions);
+
+    CHECK(core::batch::run_batch({.input_directory = input, .output_directory = output, .thread_count = 1}).files_changed == 1);
+    CHECK(std::filesystem::status(output / "a.txt").permissions() == permissions);
+
+    CHECK(core::batch::run_batch({.input_directory = input, .thread_count = 1}).files_changed == 1);
+    CHECK(read_file(input / "a.txt") == "\"quoted\"");
+    CHECK(std::filesystem::status(input / "a.txt").permissions() == permissions);
+
+    std::filesystem::remove_all(input);
+    std::filesystem::remove_all(output);
+}
+
+#endif
+
+TEST_CASE("run_batch removes duplicate paragraphs if requested", "[src][core][batch.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-batch-test-dedupe");
+    write_file(directory / "a.md", "Intro.\n\nRepeated “answer”.\n\nRepeated “answer”.\n");
+    write_file(directory / "b.txt", "unique\n");
+
+    const core::batch::BatchReport report = core::batch::run_batch({.input_directory = directory, .remove_duplicates = true});
+
+    CHECK(report.files_changed == 1);
+    CHECK(report.duplicates_removed == 1);
+    CHECK(read_file(directory / "a.md") == "Intro.\n\nRepeated \"answer\".\n\n");
+    CHECK(read_file(directory / "b.txt") == "unique\n");
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("run_batch rejects invalid directories", "[src][core][batch.hpp]")
+{
+    const std::filesystem::path input = tests::support::make_empty_directory("ungpt-batch-test-invalid");
+    const core::batch::BatchOptions missing_input{.input_directory = input / "missing"};
+    CHECK_THROWS_AS(static_cast<void>(core::batch::run_batch(missing_input)), std::invalid_argument);
+
+    const core::batch::BatchOptions nested_output{.input_directory = input, .output_directory = input / "clean"};
+    CHECK_THROWS_AS(static_cast<void>(core::batch::run_batch(nested_output)), std::invalid_argument);
+
+    std::filesystem::remove_all(input);
+}
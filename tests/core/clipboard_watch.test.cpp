@@ -0,0 +1,45 @@
+/**
+ * @file clipboard_watch.test.cpp
+ */
+
+#include <string>  // for std::string
+
+#include <snitch/snitch.hpp>
+
+#include "core/clipboard_watch.hpp"
+#include "core/text.hpp"
+
+TEST_CASE("ContentFilter normalizes new contents only once", "[src][core][clipboard_watch.hpp]")
+{
+    core::clipboard_watch::ContentFilter filter;
+
+    std::string text = "“Hello”—world";
+    CHECK(filter.normalize_if_new(text, {}));
+    CHECK(text == "\"Hello\"-world");
+
+    // The normalized text coming back after being written to the clipboard is not processed again
+    CHECK_FALSE(filter.normalize_if_new(text, {}));
+    CHECK(text == "\"Hello\"-world");
+
+    // Copying the original again is a change of contents, so it is normalized again
+    std::string copied_again = "“Hello”—world";
+    CHECK(filter.normalize_if_new(copied_again, {}));
+    CHECK(copied_again == "\"Hello\"-world");
+}
+
+TEST_CASE("ContentFilter does not report contents that need no changes", "[src][core][clipboard_watch.hpp]")
+{
+    core::clipboard_watch::ContentFilter filter;
+
+    std::string text = "plain ASCII";
+    CHECK_FALSE(filter.normalize_if_new(text, {}));
+    CHECK(text == "plain ASCII");
+
+    std::string with_bold = "**bold**";
+    CHECK_FALSE(filter.normalize_if_new(with_bold, {}));
+    std::string with_bold_again = "**bold**";
+    CHECK_FALSE(filter.normalize_if_new(with_bold_again, {.remove_markdown_bold = true}));  // Same contents, so the new rules do not matter
+    std::string other = "**other**";
+    CHECK(filter.normalize_if_new(other, {.remove_markdown_bold = true}));
+    CHECK(other == "other");
+}
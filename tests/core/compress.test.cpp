@@ -0,0 +1,41 @@
+/**
+ * @file compress.test.cpp
+ */
+
+#include <cstddef>    // for std::size_t
+#include <stdexcept>  // for std::runtime_error
+#include <string>     // for std::string
+
+#include <snitch/snitch.hpp>
+
+#include "core/compress.hpp"
+
+TEST_CASE("compress and decompress round-trip", "[src][core][compress.hpp]")
+{
+    std::string repetitive;
+    for (std::size_t i = 0; i < 2000; ++i) {
+        repetitive += "The quick brown fox jumps over the lazy dog " + std::to_string(i % 7) + ".\n";
+    }
+    const std::string inputs[] = {"", "a", "short text", std::string(100000, 'x'), repetitive, "Zażółć gęślą jaźń, 日本語のテキスト。"};
+    for (const std::string &input : inputs) {
+        const std::string block = core::compress::compress(input);
+        CHECK(block.size() <= input.size() + input.size() / 255 + 16);
+        CHECK(core::compress::decompress(block, input.size()) == input);
+    }
+
+    // Repetitive text shrinks to a fraction
+    CHECK(core::compress::compress(repetitive).size() < repetitive.size() / 4);
+}
+
+TEST_CASE("decompress rejects malformed blocks", "[src][core][compress.hpp]")
+{
+    const std::string input = "hello hello hello hello hello hello";
+    const std::string block = core::compress::compress(input);
+
+    CHECK_THROWS_AS(static_cast<void>(core::compress::decompress(block, input.size() + 1)), std::runtime_error);
+    CHECK_THROWS_AS(static_cast<void>(core::compress::decompress(block.substr(0, block.size() - 3), input.size())), std::runtime_error);
+
+    // A match that reaches before the start of the text
+    const std::string bad_offset = std::string{"\x10"} + "a" + "\x05\x00" + "abcde";
+    CHECK_THROWS_AS(static_cast<void>(core::compress::decompress(bad_offset, 10)), std::runtime_error);
+}
@@ -0,0 +1,95 @@
+/**
+ * @file dedupe.test.cpp
+ */
+
+#include <cstddef>    // for std::size_t
+#include <stdexcept>  // for std::invalid_argument
+#include <string>     // for std::string
+#include <vector>     // for std::vector
+
+#include <snitch/snitch.hpp>
+
+#include "core/dedupe.hpp"
+#include "core/diff.hpp"
+
+TEST_CASE("hash_bytes matches the XXH64 reference values", "[src][core][dedupe.hpp]")
+{
+    CHECK(core::dedupe::hash_bytes("") == 0xEF46DB3751D8E999ull);
+    CHECK(core::dedupe::hash_bytes("abc") == 0x44BC2CF5AD770999ull);
+    CHECK(core::dedupe::hash_bytes("Nobody inspects the spammish repetition") == 0xFBCEA83C8A378BF1ull);
+    CHECK(core::dedupe::hash_bytes("abc", 1) != core::dedupe::hash_bytes("abc"));
+}
+
+TEST_CASE("remove_duplicates keeps the first occurrence of every paragraph", "[src][core][dedupe.hpp]")
+{
+    std::string text = "First answer.\nIt has two lines.\n\nSecond answer.\n\nFirst answer.\nIt has two lines.\n\nThird answer.\n";
+    CHECK(core::dedupe::remove_duplicates(text) == 1);
+    CHECK(text == "First answer.\nIt has two lines.\n\nSecond answer.\n\nThird answer.\n");
+
+    // Trailing whitespace and line endings do not make a paragraph different
+    std::string crlf = "Same paragraph.\r\n\r\nSame paragraph.  \r\n";
+    CHECK(core::dedupe::remove_duplicates(crlf) == 1);
+    CHECK(crlf == "Same paragraph.\r\n\r\n");
+
+    // A paragraph that only shares its first line is not a duplicate
+    std::string partial = "a\nb\n\na\nc\n";
+    CHECK(core::dedupe::remove_duplicates(partial) == 0);
+    CHECK(partial == "a\nb\n\na\nc\n");
+}
+
+TEST_CASE("remove_duplicates compares single lines and ignores blank ones", "[src][core][dedupe.hpp]")
+{
+    std::string text = "alpha\nbeta\n\nalpha\n\ngamma\nbeta";
+    CHECK(core::dedupe::remove_duplicates(text, {.unit = core::dedupe::Unit::Line}) == 2);
+    CHECK(text == "alpha\nbeta\n\n\ngamma\n");
+
+    std::string empty;
+    CHECK(core::dedupe::remove_duplicates(empty) == 0);
+    CHECK(empty.empty());
+}
+
+TEST_CASE("find_duplicates reports deletions for the preview", "[src][core][dedupe.hpp]")
+{
+    const std::string text = "one\n\ntwo\n\none\n\n";
+    const std::vector<core::diff::Change> changes = core::dedupe::find_duplicates(text);
+    REQUIRE(changes.size() == 1);
+    CHECK(changes[0].begin == 10);
+    CHECK(changes[0].end == 15);
+    CHECK(changes[0].replacement.empty());
+    CHECK(changes[0].is_accepted);
+}
+
+TEST_CASE("find_duplicates finds near-duplicate paragraphs only when asked", "[src][core][dedupe.hpp]")
+{
+    const std::string original = "The river keeps flowing under the old stone bridge while the town sleeps and the lanterns slowly fade into the quiet morning light over the hills";
+    const std::string reworded = "The river keeps flowing under the old stone bridge while the city sleeps and the lanterns slowly fade into the quiet morning light over the hills";
+    const std::string unrelated = "Preheat the oven, whisk the eggs with sugar until pale, then fold in the flour and bake the batter for twenty minutes until golden brown";
+    const std::string text = original + "\n\n" + unrelated + "\n\n" + reworded + "\n";
+
+    CHECK(core::dedupe::find_duplicates(text).empty());
+
+    const std::vector<core::diff::Change> changes = core::dedupe::find_duplicates(text, {.near_duplicate_threshold = 0.5});
+    REQUIRE(changes.size() == 1);
+    CHECK(changes[0].begin == original.size() + unrelated.size() + 4);
+    CHECK(changes[0].end == text.size());
+
+    CHECK_THROWS_AS(static_cast<void>(core::dedupe::find_duplicates(text, {.near_duplicate_threshold = 1.5})), std::invalid_argument);
+}
+
+TEST_CASE("find_duplicates gives the same result on several threads", "[src][core][dedupe.hpp]")
+{
+    // Large enough to be hashed in parallel, with every paragraph repeated once
+    std::string text;
+    for (std::size_t i = 0; text.size() < core::dedupe::PARALLEL_THRESHOLD * 2; ++i) {
+        text += "Paragraph number " + std::to_string(i % 50000) + " of a long transcript that repeats itself.\n\n";
+    }
+
+    const std::vector<core::diff::Change> serial = core::dedupe::find_duplicates(text, {.thread_count = 1});
+    const std::vector<core::diff::Change> parallel = core::dedupe::find_duplicates(text, {.thread_count = 4});
+    REQUIRE(serial.size() == parallel.size());
+    CHECK(!serial.empty());
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        CHECK(serial[i].begin == parallel[i].begin);
+        CHECK(serial[i].end == parallel[i].end);
+    }
+}
@@ -0,0 +1,180 @@
+/**
+ * @file diff.test.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <stdexcept>    // for std::invalid_argument
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include <snitch/snitch.hpp>
+
+#include "core/diff.hpp"
+#include "core/search.hpp"
+
+namespace {
+
+/**
+ * @brief Generate a pseudo-random string over a small alphabet, so two strings share plenty of content.
+ *
+ * @param state Generator state, advanced by the call.
+ * @param size Length of the string.
+ *
+ * @return Generated string.
+ */
+[[nodiscard]] std::string random_text(std::uint32_t &state,
+                                      const std::size_t size)
+{
+    static constexpr std::string_view alphabet = "ab c\né";
+    std::string text;
+    while (text.size() < size) {
+        state = state * 1664525u + 1013904223u;
+        const std::size_t index = (state >> 16) % 5;
+        // The last entry stands for the two-byte "é"
+        text.append(index == 4 ? alphabet.substr(4) : alphabet.substr(index, 1));
+    }
+    return text;
+}
+
+/**
+ * @brief Check whether no change starts or ends inside a UTF-8 sequence of the original text or its replacement.
+ *
+ * @param text Original text.
+ * @param changes Changes to check.
+ *
+ * @return True if every change covers whole UTF-8 sequences, false otherwise.
+ */
+[[nodiscard]] bool covers_whole_sequences(const std::string_view text,
+                                          const std::vector<core::diff::Change> &changes)
+{
+    const auto is_continuation = [](const char byte) { return (static_cast<unsigned char>(byte) & 0xC0) == 0x80; };
+    for (const core::diff::Change &change : changes) {
+        if ((change.begin < text.size() && is_continuation(text[change.begin])) ||
+            (change.end < text.size() && is_continuation(text[change.end])) ||
+            (!change.replacement.empty() && is_continuation(change.replacement.front()))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("apply_changes applies only accepted changes", "[src][core][diff.hpp]")
+{
+    std::vector<core::diff::Change> changes = {
+        {.begin = 0, .end = 3, .replacement = "\""},
+        {.begin = 8, .end = 11, .replacement = "\""},
+        {.begin = 11, .end = 14, .replacement = "..."},
+    };
+    const std::string text = "“hello”…";
+    CHECK(text.size() == 14);
+
+    CHECK(core::diff::apply_changes(text, changes) == "\"hello\"...");
+
+    changes[1].is_accepted = false;
+    CHECK(core::diff::apply_changes(text, changes) == "\"hello”...");
+
+    for (core::diff::Change &change : changes) {
+        change.is_accepted = false;
+    }
+    CHECK(core::diff::apply_changes(text, changes) == text);
+    CHECK(core::diff::apply_changes(text, {}) == text);
+}
+
+TEST_CASE("apply_changes supports insertions", "[src][core][diff.hpp]")
+{
+    const std::vector<core::diff::Change> changes = {
+        {.begin = 0, .end = 0, .replacement = ">"},
+        {.begin = 5, .end = 5, .replacement = "!"},
+    };
+    CHECK(core::diff::apply_changes("hello", changes) == ">hello!");
+}
+
+TEST_CASE("apply_changes rejects unsorted, overlapping or out of range changes", "[src][core][diff.hpp]")
+{
+    const std::vector<core::diff::Change> unsorted = {{.begin = 3, .end = 4}, {.begin = 1, .end = 2}};
+    CHECK_THROWS_AS(static_cast<void>(core::diff::apply_changes("hello", unsorted)), std::invalid_argument);
+
+    const std::vector<core::diff::Change> overlapping = {{.begin = 1, .end = 3}, {.begin = 2, .end = 4}};
+    CHECK_THROWS_AS(static_cast<void>(core::diff::apply_changes("hello", overlapping)), std::invalid_argument);
+
+    const std::vector<core::diff::Change> out_of_range = {{.begin = 4, .end = 6}};
+    CHECK_THROWS_AS(static_cast<void>(core::diff::apply_changes("hello", out_of_range)), std::invalid_argument);
+
+    const std::vector<core::diff::Change> reversed = {{.begin = 3, .end = 2}};
+    CHECK_THROWS_AS(static_cast<void>(core::diff::apply_changes("hello", reversed)), std::invalid_argument);
+}
+
+TEST_CASE("compute_changes finds a minimal change list", "[src][core][diff.hpp]")
+{
+    CHECK(core::diff::compute_changes("same", "same").empty());
+    CHECK(core::diff::compute_changes("", "").empty());
+
+    const std::vector<core::diff::Change> replaced = core::diff::compute_changes("the cat sat", "the dog sat");
+    REQUIRE(replaced.size() == 1);
+    CHECK(replaced[0].begin == 4);
+    CHECK(replaced[0].end == 7);
+    CHECK(replaced[0].replacement == "dog");
+
+    const std::vector<core::diff::Change> inserted = core::diff::compute_changes("", "new");
+    REQUIRE(inserted.size() == 1);
+    CHECK(inserted[0].begin == 0);
+    CHECK(inserted[0].end == 0);
+    CHECK(inserted[0].replacement == "new");
+
+    const std::vector<core::diff::Change> deleted = core::diff::compute_changes("abc  \ndef", "abc\ndef");
+    REQUIRE(deleted.size() == 1);
+    CHECK(deleted[0].begin == 3);
+    CHECK(deleted[0].end == 5);
+    CHECK(deleted[0].replacement.empty());
+
+    const std::vector<core::diff::Change> separate = core::diff::compute_changes("a—b—c", "a-b-c");
+    REQUIRE(separate.size() == 2);
+    CHECK(separate[0].begin == 1);
+    CHECK(separate[0].end == 4);
+    CHECK(separate[0].replacement == "-");
+    CHECK(separate[1].begin == 5);
+    CHECK(separate[1].end == 8);
+}
+
+TEST_CASE("compute_changes never splits UTF-8 sequences", "[src][core][diff.hpp]")
+{
+    // "é" (C3 A9) and "ê" (C3 AA) share their first byte, the change must still cover both bytes
+    const std::string before = "café";
+    const std::vector<core::diff::Change> changes = core::diff::compute_changes(before, "cafê");
+    REQUIRE(changes.size() == 1);
+    CHECK(changes[0].begin == 3);
+    CHECK(changes[0].end == 5);
+    CHECK(changes[0].replacement == "ê");
+}
+
+TEST_CASE("compute_changes round-trips random edits", "[src][core][diff.hpp]")
+{
+    std::uint32_t state = 12345;
+    for (std::size_t round = 0; round < 200; ++round) {
+        const std::string before = random_text(state, round % 64);
+        const std::string after = random_text(state, (round * 7) % 64);
+        const std::vector<core::diff::Change> changes = core::diff::compute_changes(before, after);
+        CHECK(core::diff::apply_changes(before, changes) == after);
+        CHECK(covers_whole_sequences(before, changes));
+    }
+}
+
+TEST_CASE("compute_changes recovers every replacement of replace_all", "[src][core][diff.hpp]")
+{
+    // The Replace All preview only sees the text before and after replacing
+    const std::string before = "Cat, cat and CAT sat on the mat.\nThe cat left.";
+    std::string after = before;
+    REQUIRE(core::search::replace_all(after, "cat", "dog", false) == 4);
+    const std::vector<core::diff::Change> changes = core::diff::compute_changes(before, after);
+    CHECK(changes.size() == 4);
+    CHECK(core::diff::apply_changes(before, changes) == after);
+
+    // Rejecting a change keeps that match
+    std::vector<core::diff::Change> partial = changes;
+    partial[1].is_accepted = false;
+    CHECK(core::diff::apply_changes(before, partial) == "dog, cat and dog sat on the mat.\nThe dog left.");
+}
@@ -0,0 +1,98 @@
+/**
+ * @file documents.test.cpp
+ */
+
+#include <filesystem>  // for std::filesystem
+#include <stdexcept>   // for std::out_of_range
+#include <string>      // for std::string
+
+#include <snitch/snitch.hpp>
+
+#include "core/documents.hpp"
+
+#include "support.hpp"
+
+namespace {
+
+/**
+ * @brief Build a compressible text of a given size.
+ *
+ * @param size Size of the text, in bytes (e.g., "65536").
+ * @param seed Character that makes texts of the same size differ (e.g., 'a').
+ *
+ * @return Generated text.
+ */
+[[nodiscard]] std::string make_text(const std::size_t size,
+                                    const char seed)
+{
+    std::string text;
+    while (text.size() < size) {
+        text += seed;
+        text += " line of a long transcript, repeated until the document is large enough\n";
+    }
+    text.resize(size);
+    return text;
+}
+
+}  // namespace
+
+TEST_CASE("DocumentStore keeps documents resident within the budget", "[src][core][documents.hpp]")
+{
+    core::documents::DocumentStore store{1024 * 1024, tests::support::make_empty_directory("ungpt-documents-test")};
+    const std::size_t first = store.add("first");
+    const std::size_t second = store.add("second");
+    CHECK(first != second);
+    CHECK(store.residency(first) == core::documents::Residency::Resident);
+    CHECK(store.memory_usage() == 11);
+
+    std::string text = store.take(first);
+    CHECK(text == "first");
+    CHECK(store.residency(first) == core::documents::Residency::Active);
+    CHECK_THROWS_AS(static_cast<void>(store.take(first)), std::out_of_range);
+
+    store.put(first, text + " edited");
+    CHECK(store.take(first) == "first edited");
+    CHECK_THROWS_AS(store.put(second, "not taken"), std::out_of_range);
+}
+
+TEST_CASE("DocumentStore compresses, then pages out the least recently used documents", "[src][core][documents.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-documents-test-paging");
+    const std::string a = make_text(64 * 1024, 'a');
+    const std::string b = make_text(64 * 1024, 'b');
+    const std::string c = make_text(64 * 1024, 'c');
+    {
+        // Room for one uncompressed document and a few compressed ones
+        core::documents::DocumentStore store{80 * 1024, directory};
+        const std::size_t id_a = store.add(a);
+        const std::size_t id_b = store.add(b);
+        CHECK(store.residency(id_a) == core::documents::Residency::Compressed);
+        CHECK(store.residency(id_b) == core::documents::Residency::Resident);
+        CHECK(store.memory_usage() <= 80 * 1024);
+
+        // Activating a large document pushes the others out of memory, the oldest to disk if compression is not enough
+        const std::size_t id_c = store.add(c);
+        std::string active = store.take(id_c);
+        store.set_active_size(active.size());
+        store.set_memory_budget(64 * 1024 + 16);
+        CHECK(store.residency(id_a) == core::documents::Residency::Paged);
+        CHECK(store.residency(id_b) == core::documents::Residency::Paged);
+        CHECK(!std::filesystem::is_empty(directory));
+#if !defined(_WIN32)
+        // Page files hold the user's text, so nobody else may read them
+        for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator{directory}) {
+            CHECK(entry.status().permissions() == (std::filesystem::perms::owner_read | std::filesystem::perms::owner_write));
+        }
+#endif
+
+        // Paged documents are restored transparently
+        store.put(id_c, std::move(active));
+        CHECK(store.take(id_a) == a);
+        store.put(id_a, a);
+        CHECK(store.take(id_b) == b);
+        store.remove(id_c);
+    }
+
+    // The page files are removed with the store
+    CHECK(std::filesystem::is_empty(directory));
+}
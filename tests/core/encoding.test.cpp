@@ -0,0 +1,174 @@
+/**
+ * @file encoding.test.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <filesystem>   // for std::filesystem
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include <snitch/snitch.hpp>
+
+#include "core/encoding.hpp"
+
+#include "support.hpp"
+
+namespace {
+
+/**
+ * @brief Serialize UTF-16 code units as bytes.
+ *
+ * @param units Code units to encode (e.g., u"hi").
+ * @param is_big_endian Whether the most significant byte comes first.
+ *
+ * @return UTF-16 bytes (e.g., "h\0i\0").
+ */
+[[nodiscard]] std::string to_utf16(const std::u16string_view units,
+                                   const bool is_big_endian)
+{
+    std::string bytes;
+    for (const char16_t unit : units) {
+        const char high = static_cast<char>(unit >> 8);
+        const char low = static_cast<char>(unit & 0xFF);
+        bytes.push_back(is_big_endian ? high : low);
+        bytes.push_back(is_big_endian ? low : high);
+    }
+    return bytes;
+}
+
+}  // namespace
+
+TEST_CASE("detect recognizes byte order marks", "[src][core][encoding.hpp]")
+{
+    const core::encoding::Detection utf8 = core::encoding::detect("\xEF\xBB\xBFhello");
+    CHECK(utf8.encoding == core::encoding::Encoding::Utf8);
+    CHECK(utf8.bom_size == 3);
+
+    const core::encoding::Detection utf16_le = core::encoding::detect("\xFF\xFE\x3D\xD8");
+    CHECK(utf16_le.encoding == core::encoding::Encoding::Utf16Le);
+    CHECK(utf16_le.bom_size == 2);
+
+    const core::encoding::Detection utf16_be = core::encoding::detect("\xFE\xFF\xD8\x3D");
+    CHECK(utf16_be.encoding == core::encoding::Encoding::Utf16Be);
+    CHECK(utf16_be.bom_size == 2);
+}
+
+TEST_CASE("detect recognizes UTF-16 without a byte order mark", "[src][core][encoding.hpp]")
+{
+    CHECK(core::encoding::detect(to_utf16(u"Hello, world!", false)).encoding == core::encoding::Encoding::Utf16Le);
+    CHECK(core::encoding::detect(to_utf16(u"Hello, world!", true)).encoding == core::encoding::Encoding::Utf16Be);
+    CHECK(core::encoding::detect(to_utf16(u"Zażółć gęślą jaźń", false)).encoding == core::encoding::Encoding::Utf16Le);
+    CHECK(core::encoding::detect(to_utf16(u"Zażółć gęślą jaźń", false)).bom_size == 0);
+}
+
+TEST_CASE("detect falls back to Windows-1252 for invalid UTF-8", "[src][core][encoding.hpp]")
+{
+    CHECK(core::encoding::detect("").encoding == core::encoding::Encoding::Utf8);
+    CHECK(core::encoding::detect("plain ASCII").encoding == core::encoding::Encoding::Utf8);
+    CHECK(core::encoding::detect("café “quoted”").encoding == core::encoding::Encoding::Utf8);
+    CHECK(core::encoding::detect("caf\xE9 \x93quoted\x94").encoding == core::encoding::Encoding::Windows1252);
+
+    // A sequence cut off by the end of a partial sample is not a reason to fall back
+    CHECK(core::encoding::detect("caf\xC3", false).encoding == core::encoding::Encoding::Utf8);
+    CHECK(core::encoding::detect("caf\xC3", true).encoding == core::encoding::Encoding::Windows1252);
+}
+
+TEST_CASE("decode transcodes Windows-1252", "[src][core][encoding.hpp]")
+{
+    CHECK(core::encoding::decode("plain ASCII", core::encoding::Encoding::Windows1252) == "plain ASCII");
+    CHECK(core::encoding::decode("caf\xE9 \x93quoted\x94 \x80" "5 \x85", core::encoding::Encoding::Windows1252) == "café “quoted” €5 …");
+    CHECK(core::encoding::decode("\x81\x8D\x8F\x90\x9D", core::encoding::Encoding::Windows1252) == "\u0081\u008D\u008F\u0090\u009D");
+    CHECK(core::encoding::decode("\xFF", core::encoding::Encoding::Windows1252) == "ÿ");
+
+    // Long enough to take the vectorized path on both sides of a non-ASCII byte
+    const std::string ascii(100, 'a');
+    CHECK(core::encoding::decode(ascii + "\xE9" + ascii, core::encoding::Encoding::Windows1252) == ascii + "é" + ascii);
+}
+
+TEST_CASE("decode transcodes UTF-16", "[src][core][encoding.hpp]")
+{
+    const std::u16string_view units = u"“Zażółć” 😀 — 中文";
+    const std::string expected = "“Zażółć” 😀 — 中文";
+    CHECK(core::encoding::decode(to_utf16(units, false), core::encoding::Encoding::Utf16Le) == expected);
+    CHECK(core::encoding::decode(to_utf16(units, true), core::encoding::Encoding::Utf16Be) == expected);
+
+    // Long enough to take the vectorized path on both sides of a non-ASCII code unit
+    const std::string ascii(100, 'a');
+    const std::u16string ascii_units(100, u'a');
+    CHECK(core::encoding::decode(to_utf16(ascii_units + u"é" + ascii_units, false), core::encoding::Encoding::Utf16Le) == ascii + "é" + ascii);
+    CHECK(core::encoding::decode(to_utf16(ascii_units + u"é" + ascii_units, true), core::encoding::Encoding::Utf16Be) == ascii + "é" + ascii);
+}
+
+TEST_CASE("decode replaces unpaired surrogates and incomplete input", "[src][core][encoding.hpp]")
+{
+    const std::u16string lone_high = {u'a', char16_t{0xD83D}, u'b'};
+    const std::u16string lone_low = {u'a', char16_t{0xDE00}, u'b'};
+    const std::u16string trailing_high = {u'a', char16_t{0xD83D}};
+    CHECK(core::encoding::decode(to_utf16(lone_high, false), core::encoding::Encoding::Utf16Le) == "a\xEF\xBF\xBD" "b");
+    CHECK(core::encoding::decode(to_utf16(lone_low, false), core::encoding::Encoding::Utf16Le) == "a\xEF\xBF\xBD" "b");
+    CHECK(core::encoding::decode(to_utf16(trailing_high, false), core::encoding::Encoding::Utf16Le) == "a\xEF\xBF\xBD");
+    CHECK(core::encoding::decode(std::string_view{"a\0b", 3}, core::encoding::Encoding::Utf16Le) == "a\xEF\xBF\xBD");
+}
+
+TEST_CASE("Decoder carries split code units and surrogate pairs across blocks", "[src][core][encoding.hpp]")
+{
+    const std::string utf16 = to_utf16(u"ab😀cd€é", false);
+    const std::string expected = core::encoding::decode(utf16, core::encoding::Encoding::Utf16Le);
+
+    for (std::size_t split = 0; split <= utf16.size(); ++split) {
+        CAPTURE(split);
+        core::encoding::Decoder decoder{core::encoding::Encoding::Utf16Le};
+        std::string output;
+        decoder.decode(std::string_view{utf16}.substr(0, split), output);
+        decoder.decode(std::string_view{utf16}.substr(split), output);
+        decoder.finish(output);
+        CHECK(output == expected);
+    }
+}
+
+TEST_CASE("load_file detects and transcodes files across blocks", "[src][core][encoding.hpp]")
+{
+    // Span several blocks, with a surrogate pair straddling the first block boundary
+    std::u16string units(core::encoding::BLOCK_SIZE / 2 - 2, u'a');
+    units += u"😀";
+    units += std::u16string(core::encoding::BLOCK_SIZE, u'b');
+    const std::filesystem::path utf16_path = tests::support::write_temporary_file("ungpt-encoding-test-utf16.txt", "\xFF\xFE" + to_utf16(units, false));
+    const core::encoding::LoadedFile utf16_file = core::encoding::load_file(utf16_path);
+    CHECK(utf16_file.encoding == core::encoding::Encoding::Utf16Le);
+    CHECK(utf16_file.text == std::string(core::encoding::BLOCK_SIZE / 2 - 2, 'a') + "😀" + std::string(core::encoding::BLOCK_SIZE, 'b'));
+    std::filesystem::remove(utf16_path);
+
+    const std::filesystem::path windows_1252_path = tests::support::write_temporary_file("ungpt-encoding-test-1252.txt", "caf\xE9");
+    const core::encoding::LoadedFile windows_1252_file = core::encoding::load_file(windows_1252_path);
+    CHECK(windows_1252_file.encoding == core::encoding::Encoding::Windows1252);
+    CHECK(windows_1252_file.text == "café");
+    std::filesystem::remove(windows_1252_path);
+
+    const std::filesystem::path utf8_path = tests::support::write_temporary_file("ungpt-encoding-test-utf8.txt", "\xEF\xBB\xBF" "café");
+    const core::encoding::LoadedFile utf8_file = core::encoding::load_file(utf8_path);
+    CHECK(utf8_file.encoding == core::encoding::Encoding::Utf8);
+    CHECK(utf8_file.text == "café");
+    std::filesystem::remove(utf8_path);
+}
+
+TEST_CASE("load_file reserves for blocks that expand more than the first one", "[src][core][encoding.hpp]")
+{
+    // The first block is ASCII apart from one byte, every later byte becomes 2 bytes of UTF-8
+    std::string bytes = "caf\xE9";
+    bytes += std::string(core::encoding::BLOCK_SIZE - 4, 'a');
+    bytes += std::string(2 * core::encoding::BLOCK_SIZE, '\xE9');
+    const std::filesystem::path path = tests::support::write_temporary_file("ungpt-encoding-test-expansion.txt", bytes);
+    const core::encoding::LoadedFile file = core::encoding::load_file(path);
+    CHECK(file.encoding == core::encoding::Encoding::Windows1252);
+    CHECK(file.text.size() == core::encoding::BLOCK_SIZE + 1 + 2 * core::encoding::BLOCK_SIZE * 2);
+    CHECK(file.text.starts_with("café"));
+    CHECK(file.text.ends_with("éé"));
+    CHECK(file.text.capacity() >= core::encoding::Decoder{core::encoding::Encoding::Windows1252}.max_output_size(bytes.size()));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("load_file throws on a missing file", "[src][core][encoding.hpp]")
+{
+    CHECK_THROWS_AS(static_cast<void>(core::encoding::load_file(std::filesystem::temp_directory_path() / "ungpt-encoding-test-missing.txt")), std::runtime_error);
+}
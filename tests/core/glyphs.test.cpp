@@ -0,0 +1,85 @@
+/**
+ * @file glyphs.test.cpp
+ */
+
+#include <cstdint>     // for std::uint8_t
+#include <filesystem>  // for std::filesystem
+#include <string>      // for std::string
+#include <utility>     // for std::pair
+#include <vector>      // for std::vector
+
+#include <snitch/snitch.hpp>
+
+#include "core/glyphs.hpp"
+
+TEST_CASE("GlyphSet tracks only non-Latin-1 code points", "[src][core][glyphs.hpp]")
+{
+    static const std::pair<std::string, std::vector<char32_t>> test_cases[] = {
+        {"", {}},
+        {"hello world, this is plain ASCII text", {}},
+        {"Grüße", {}},  // Latin-1 is covered by the default font
+        {"Zażółć", {0x107, 0x142, 0x17C}},
+        {"中文 and 中文", {0x4E2D, 0x6587}},
+        {"emoji 😀 is outside the 16-bit range", {}},
+        {"broken \xC3 sequence \xE4\xB8 here \x80 ok 中", {0x4E2D}},
+    };
+
+    for (const auto &[input_text, expected_code_points] : test_cases) {
+        CAPTURE(input_text);
+        core::glyphs::GlyphSet set;
+        CHECK(set.add_from_text(input_text) == !expected_code_points.empty());
+        CHECK(set.code_points() == expected_code_points);
+        CHECK(set.size() == expected_code_points.size());
+    }
+}
+
+TEST_CASE("GlyphSet reports whether new code points were added", "[src][core][glyphs.hpp]")
+{
+    core::glyphs::GlyphSet set;
+    CHECK(set.add_from_text("中文"));
+    CHECK_FALSE(set.add_from_text("文中"));
+    CHECK(set.add_from_text("文字"));
+    CHECK(set.contains(0x5B57));
+    CHECK_FALSE(set.contains(U'a'));
+    CHECK(set.size() == 3);
+}
+
+TEST_CASE("GlyphCache round-trips through disk", "[src][core][glyphs.hpp]")
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "ungpt-glyphs-test.bin";
+
+    core::glyphs::GlyphCache cache{0x1234};
+    cache.insert({.code_point = 0x4E2D, .width = 2, .height = 3, .offset_x = 0.5f, .offset_y = 1.0f, .advance_x = 13.0f, .pixels = {1, 2, 3, 4, 5, 6}});
+    cache.insert({.code_point = 0x6587, .width = 1, .height = 1, .offset_x = 0.0f, .offset_y = 2.0f, .advance_x = 7.0f, .pixels = {255}});
+    cache.insert({.code_point = 0x3000, .width = 0, .height = 0, .offset_x = 0.0f, .offset_y = 0.0f, .advance_x = 13.0f, .pixels = {}});
+    cache.insert({.code_point = 0xE000, .width = 0, .height = 0, .offset_x = 0.0f, .offset_y = 0.0f, .advance_x = 0.0f, .pixels = {}, .is_missing = true});
+    cache.save(path);
+
+    const core::glyphs::GlyphCache loaded = core::glyphs::GlyphCache::load(path, 0x1234);
+    REQUIRE(loaded.size() == 4);
+    const core::glyphs::Glyph *glyph = loaded.find(0x4E2D);
+    REQUIRE(glyph != nullptr);
+    CHECK(glyph->width == 2);
+    CHECK(glyph->height == 3);
+    CHECK(glyph->offset_x == 0.5f);
+    CHECK(glyph->advance_x == 13.0f);
+    const std::vector<std::uint8_t> expected_pixels = {1, 2, 3, 4, 5, 6};
+    CHECK(glyph->pixels == expected_pixels);
+    CHECK_FALSE(glyph->is_missing);
+
+    // Whitespace and code points the font lacks are remembered too, so they are not rasterized again
+    const core::glyphs::Glyph *space = loaded.find(0x3000);
+    REQUIRE(space != nullptr);
+    CHECK(space->advance_x == 13.0f);
+    CHECK(space->pixels.empty());
+    CHECK_FALSE(space->is_missing);
+    const core::glyphs::Glyph *missing = loaded.find(0xE000);
+    REQUIRE(missing != nullptr);
+    CHECK(missing->is_missing);
+    CHECK(loaded.find(0x1234) == nullptr);
+
+    // A different font fingerprint must not reuse the cached bitmaps
+    CHECK(core::glyphs::GlyphCache::load(path, 0x5678).size() == 0);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file instance.test.cpp
+ */
+
+#if defined(__linux__)
+
+#include <filesystem>   // for std::filesystem
+#include <fstream>      // for std::ifstream, std::ofstream
+#include <future>       // for std::async, std::future, std::launch
+#include <iterator>     // for std::istreambuf_iterator
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include <snitch/snitch.hpp>
+
+#include "core/instance.hpp"
+
+#include "support.hpp"
+
+TEST_CASE("Instance lets only the first one become primary", "[src][core][instance.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-instance-test-lock");
+    {
+        const core::instance::Instance first{directory};
+        CHECK(first.is_primary());
+        CHECK(std::filesystem::is_socket(directory / "instance.sock"));
+
+        const core::instance::Instance second{directory};
+        CHECK_FALSE(second.is_primary());
+    }
+    CHECK_FALSE(std::filesystem::exists(directory / "instance.sock"));
+
+    // The lock is released with the primary instance, so the next launch takes over
+    const core::instance::Instance third{directory};
+    CHECK(third.is_primary());
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("hand_over passes the file to the primary instance", "[src][core][instance.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-instance-test-hand-over");
+    const std::filesystem::path file = directory / "notes.txt";
+    const std::string text = "“Hello” — world\n" + std::string(200000, 'a');
+    std::ofstream{file, std::ios::binary} << text;
+
+    core::instance::Instance primary{directory};
+    REQUIRE(primary.is_primary());
+
+    // The launch waits for the answer, which the primary instance sends from its frame loop
+    std::future<bool> handed_over = std::async(std::launch::async, [&directory, &file] { return core::instance::hand_over(directory, file); });
+    std::string received_text;
+    std::string received_title;
+    while (received_title.empty()) {
+        primary.poll([&received_text, &received_title](const std::filesystem::path &path, const std::string_view title) {
+            std::ifstream stream{path, std::ios::binary};
+            received_text.assign(std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{});
+            received_title = title;
+        });
+    }
+    CHECK(handed_over.get());
+    CHECK(received_title == "notes.txt");
+    CHECK(received_text == text);
+
+    // Without a file, the launch only asks to raise the window
+    handed_over = std::async(std::launch::async, [&directory] { return core::instance::hand_over(directory, {}); });
+    bool is_raised = false;
+    while (!is_raised) {
+        primary.poll([&is_raised](const std::filesystem::path &path, const std::string_view title) {
+            CHECK(path.empty());
+            CHECK(title.empty());
+            is_raised = true;
+        });
+    }
+    CHECK(handed_over.get());
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("hand_over reports failures of the primary instance", "[src][core][instance.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-instance-test-failure");
+    const std::filesystem::path file = directory / "notes.txt";
+    std::ofstream{file, std::ios::binary} << "text";
+
+    // Without a primary instance, there is nobody to hand the file to
+    CHECK_FALSE(core::instance::hand_over(directory, file));
+    CHECK_THROWS_AS(static_cast<void>(core::instance::hand_over(directory, directory / "missing.txt")), std::runtime_error);
+
+    core::instance::Instance primary{directory};
+    std::future<bool> handed_over = std::async(std::launch::async, [&directory, &file] { return core::instance::hand_over(directory, file); });
+    bool is_called = false;
+    while (!is_called) {
+        primary.poll([&is_called](const std::filesystem::path &, const std::string_view) {
+            is_called = true;
+            throw std::runtime_error("Failed to open");
+        });
+    }
+    CHECK_THROWS_AS(static_cast<void>(handed_over.get()), std::runtime_error);
+    std::filesystem::remove_all(directory);
+}
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file loader.test.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <filesystem>   // for std::filesystem
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <vector>       // for std::vector
+
+#include <snitch/snitch.hpp>
+
+#include "core/encoding.hpp"
+#include "core/loader.hpp"
+#include "core/text.hpp"
+#include "core/utf8.hpp"
+
+#include "support.hpp"
+
+namespace {
+
+/**
+ * @brief Result of taking everything from a loader.
+ */
+struct Loaded {
+    /**
+     * @brief Loaded text.
+     */
+    std::string text;
+
+    /**
+     * @brief Offsets of the invalid or repaired sequences.
+     */
+    std::vector<std::size_t> offsets;
+
+    /**
+     * @brief Final progress.
+     */
+    core::loader::Progress progress;
+};
+
+/**
+ * @brief Take parts from a loader until it is done.
+ *
+ * @param loader Loader to drain.
+ *
+ * @return Everything that was taken.
+ */
+[[nodiscard]] Loaded drain(core::loader::Loader &loader)
+{
+    Loaded loaded;
+    while (!loaded.progress.is_done) {
+        loader.wait();
+        CHECK(loader.take(loaded.text, loaded.offsets, loaded.progress));
+    }
+    return loaded;
+}
+
+/**
+ * @brief Build a UTF-8 text of several blocks, with multi-byte characters straddling the block boundaries and invalid bytes after the first block.
+ *
+ * @return Generated text.
+ */
+[[nodiscard]] std::string make_text()
+{
+    std::string text;
+    bool has_broken_line = false;
+    while (text.size() < 3 * core::encoding::BLOCK_SIZE + 100) {
+        text += "Zażółć gęślą jaźń. 東京です。\n";
+        if (!has_broken_line && text.size() > core::encoding::BLOCK_SIZE) {
+            text += "broken \xC3 and \xE2\x82 bytes\n";
+            has_broken_line = true;
+        }
+    }
+    return text;
+}
+
+}  // namespace
+
+TEST_CASE("Loader hands over a small file at once", "[src][core][loader.hpp]")
+{
+    const std::filesystem::path path = tests::support::write_temporary_file("ungpt-loader-test-small.txt", "caf\xE9");
+    core::loader::Loader loader{path};
+    CHECK(loader.encoding() == core::encoding::Encoding::Windows1252);
+
+    std::string text;
+    std::vector<std::size_t> offsets;
+    core::loader::Progress progress;
+    CHECK(loader.take(text, offsets, progress));
+    CHECK(text == "café");
+    CHECK(offsets.empty());
+    CHECK(progress.is_done);
+    CHECK(progress.bytes_read == 4);
+    CHECK(progress.file_size == 4);
+    CHECK(progress.stats.words == 1);
+    CHECK_FALSE(loader.take(text, offsets, progress));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Loader matches load_file on a file of several blocks", "[src][core][loader.hpp]")
+{
+    const std::string bytes = make_text();
+    const std::filesystem::path path = tests::support::write_temporary_file("ungpt-loader-test-large.txt", bytes);
+    core::loader::Loader loader{path};
+    CHECK(loader.encoding() == core::encoding::Encoding::Utf8);
+
+    // The first block is available as soon as the loader is constructed
+    std::string first_part;
+    std::vector<std::size_t> first_offsets;
+    core::loader::Progress first_progress;
+    CHECK(loader.take(first_part, first_offsets, first_progress));
+    CHECK_FALSE(first_part.empty());
+    CHECK(first_part.size() <= core::encoding::BLOCK_SIZE);
+
+    Loaded loaded = drain(loader);
+    loaded.text.insert(0, first_part);
+    CHECK(loaded.text == core::encoding::load_file(path).text);
+    CHECK(loaded.offsets == core::utf8::find_invalid_sequences(loaded.text));
+    CHECK(loaded.offsets.size() == 2);
+    CHECK(loaded.progress.bytes_read == bytes.size());
+    CHECK(loaded.progress.error.empty());
+
+    const core::text::TextStats expected = core::text::compute_stats(loaded.text);
+    CHECK(loaded.progress.stats.characters == expected.characters);
+    CHECK(loaded.progress.stats.words == expected.words);
+    CHECK(loaded.progress.stats.lines == expected.lines);
+    CHECK(loaded.progress.stats.sentences == expected.sentences);
+    CHECK(loaded.progress.stats.paragraphs == expected.paragraphs);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Loader repairs invalid UTF-8 while loading", "[src][core][loader.hpp]")
+{
+    const std::filesystem::path path = tests::support::write_temporary_file("ungpt-loader-test-repair.txt", make_text());
+    core::loader::Loader loader{path, true};
+    const Loaded loaded = drain(loader);
+
+    std::string expected = core::encoding::load_file(path).text;
+    std::vector<std::size_t> expected_offsets;
+    core::utf8::repair(expected, &expected_offsets);
+    CHECK(loaded.text == expected);
+    CHECK(loaded.offsets == expected_offsets);
+    CHECK(loaded.progress.stats.characters == core::text::count_characters(expected));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Loader stops early when destroyed", "[src][core][loader.hpp]")
+{
+    const std::filesystem::path path = tests::support::write_temporary_file("ungpt-loader-test-stop.txt", make_text());
+    {
+        const core::loader::Loader loader{path};
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Loader throws on a missing file", "[src][core][loader.hpp]")
+{
+    CHECK_THROWS_AS(core::loader::Loader{std::filesystem::temp_directory_path() / "ungpt-loader-test-missing.txt"}, std::runtime_error);
+}
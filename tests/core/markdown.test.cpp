@@ -0,0 +1,80 @@
+/**
+ * @file markdown.test.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <vector>       // for std::vector
+
+#include <snitch/snitch.hpp>
+
+#include "core/markdown.hpp"
+
+namespace {
+
+/**
+ * @brief Return the text of every verbatim range.
+ *
+ * @param text Text to scan.
+ *
+ * @return Verbatim parts of the text, in order.
+ */
+[[nodiscard]] std::vector<std::string> find_verbatim_parts(const std::string_view text)
+{
+    std::vector<std::string> parts;
+    for (const core::markdown::Range &range : core::markdown::find_verbatim_ranges(text)) {
+        parts.emplace_back(text.substr(range.begin, range.end - range.begin));
+    }
+    return parts;
+}
+
+}  // namespace
+
+TEST_CASE("find_verbatim_ranges finds fenced code blocks", "[src][core][markdown.hpp]")
+{
+    CHECK(find_verbatim_parts("Intro —\n```cpp\nx — y\n```\nOutro —\n") == std::vector<std::string>{"```cpp\nx — y\n```"});
+    CHECK(find_verbatim_parts("~~~~\n```\nstill code\n~~~~\n") == std::vector<std::string>{"~~~~\n```\nstill code\n~~~~"});
+
+    // A shorter closing fence does not close the block, an unclosed block runs to the end
+    CHECK(find_verbatim_parts("````\na\n```\nb") == std::vector<std::string>{"````\na\n```\nb"});
+
+    // Four spaces of indentation, or a backtick in the info string, do not open a fence
+    CHECK(find_verbatim_parts("    ```\ncode\n").empty());
+    CHECK(find_verbatim_parts("```a`b```\n") == std::vector<std::string>{"```a`b```"});
+}
+
+TEST_CASE("find_verbatim_ranges finds inline code spans", "[src][core][markdown.hpp]")
+{
+    CHECK(find_verbatim_parts("Use `a → b` and ``x ` y`` here.") == std::vector<std::string>{"`a → b`", "``x ` y``"});
+
+    // Spans may cross lines but not paragraphs, and unpaired or escaped backticks are ordinary text
+    CHECK(find_verbatim_parts("`a\nb`") == std::vector<std::string>{"`a\nb`"});
+    CHECK(find_verbatim_parts("`a\n\nb`").empty());
+    CHECK(find_verbatim_parts("a `` b ` c").empty());
+    CHECK(find_verbatim_parts("\\`not code` `code`") == std::vector<std::string>{"` `"});
+}
+
+TEST_CASE("find_verbatim_ranges finds URLs", "[src][core][markdown.hpp]")
+{
+    CHECK(find_verbatim_parts("See https://example.com/a—b, or <ftp://host/x>.") == std::vector<std::string>{"https://example.com/a—b", "ftp://host/x"});
+    CHECK(find_verbatim_parts("[link](https://en.wikipedia.org/wiki/C_(language)) (https://a.b/c)") == std::vector<std::string>{"https://en.wikipedia.org/wiki/C_(language)", "https://a.b/c"});
+
+    // A URL inside a code span belongs to the span, and "://" without a scheme is not a URL
+    CHECK(find_verbatim_parts("`https://a.b` ://x") == std::vector<std::string>{"`https://a.b`"});
+}
+
+TEST_CASE("find_verbatim_ranges returns sorted ranges and reuses the vector", "[src][core][markdown.hpp]")
+{
+    std::string text;
+    for (std::size_t i = 0; i < 100; ++i) {
+        text += "Text — `code` http://x.y/z\n\n```\nblock\n```\n";
+    }
+    std::vector<core::markdown::Range> ranges = {{.begin = 1, .end = 2}};
+    core::markdown::find_verbatim_ranges(text, ranges);
+    REQUIRE(ranges.size() == 300);
+    for (std::size_t i = 1; i < ranges.size(); ++i) {
+        CHECK(ranges[i - 1].end <= ranges[i].begin);
+    }
+    CHECK(core::markdown::find_verbatim_ranges("").empty());
+}
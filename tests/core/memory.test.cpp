@@ -0,0 +1,91 @@
+/**
+ * @file memory.test.cpp
+ */
+
+#include <array>    // for std::array
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uintptr_t
+#include <string>   // for std::string
+#include <thread>   // for std::jthread
+
+#include <snitch/snitch.hpp>
+
+#include "core/memory.hpp"
+
+TEST_CASE("allocate charges the tag until the memory is freed", "[src][core][memory.hpp]")
+{
+    const core::memory::Snapshot before = core::memory::take_snapshot();
+    void *pointer = core::memory::allocate(1000, alignof(std::max_align_t), core::memory::Tag::Clipboard);
+    REQUIRE(pointer != nullptr);
+
+    const core::memory::Snapshot during = core::memory::take_snapshot();
+    CHECK(during[core::memory::Tag::Clipboard].bytes == before[core::memory::Tag::Clipboard].bytes + 1000);
+    CHECK(during[core::memory::Tag::Clipboard].allocations == before[core::memory::Tag::Clipboard].allocations + 1);
+    CHECK(during[core::memory::Tag::Clipboard].allocated_bytes == before[core::memory::Tag::Clipboard].allocated_bytes + 1000);
+    CHECK(during[core::memory::Tag::Clipboard].peak_bytes >= during[core::memory::Tag::Clipboard].bytes);
+
+    // Freeing on another thread credits the same tag
+    std::jthread{[pointer] { core::memory::deallocate(pointer); }}.join();
+    const core::memory::Snapshot after = core::memory::take_snapshot();
+    CHECK(after[core::memory::Tag::Clipboard].bytes == before[core::memory::Tag::Clipboard].bytes);
+    CHECK(after[core::memory::Tag::Clipboard].peak_bytes == during[core::memory::Tag::Clipboard].peak_bytes);
+    CHECK(after[core::memory::Tag::Clipboard].allocations == during[core::memory::Tag::Clipboard].allocations);
+}
+
+TEST_CASE("allocate honors over-aligned requests", "[src][core][memory.hpp]")
+{
+    for (const std::size_t alignment : std::array<std::size_t, 4>{8, 64, 256, 4096}) {
+        void *pointer = core::memory::allocate(100, alignment, core::memory::Tag::Other);
+        REQUIRE(pointer != nullptr);
+        CHECK(reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0);
+        core::memory::deallocate(pointer);
+    }
+    core::memory::deallocate(nullptr);
+}
+
+TEST_CASE("Scope sets the tag of the current thread until it ends", "[src][core][memory.hpp]")
+{
+    CHECK(core::memory::current_tag() == core::memory::Tag::Other);
+    {
+        const core::memory::Scope outer{core::memory::Tag::EditorBuffer};
+        CHECK(core::memory::current_tag() == core::memory::Tag::EditorBuffer);
+        {
+            const core::memory::Scope inner{core::memory::Tag::TextEngine};
+            CHECK(core::memory::current_tag() == core::memory::Tag::TextEngine);
+
+            // Other threads keep their own tag
+            std::jthread{[] { CHECK(core::memory::current_tag() == core::memory::Tag::Other); }}.join();
+        }
+        CHECK(core::memory::current_tag() == core::memory::Tag::EditorBuffer);
+    }
+    CHECK(core::memory::current_tag() == core::memory::Tag::Other);
+}
+
+TEST_CASE("compute_rates divides the growth of the totals by the elapsed time", "[src][core][memory.hpp]")
+{
+    core::memory::Snapshot previous;
+    previous.seconds = 1.0;
+    previous.usages[static_cast<std::size_t>(core::memory::Tag::ImGui)] = {.bytes = 0, .peak_bytes = 0, .allocations = 10, .allocated_bytes = 1000};
+    core::memory::Snapshot current = previous;
+    current.seconds = 3.0;
+    current.usages[static_cast<std::size_t>(core::memory::Tag::ImGui)] = {.bytes = 0, .peak_bytes = 0, .allocations = 30, .allocated_bytes = 5000};
+
+    const auto rates = core::memory::compute_rates(previous, current);
+    CHECK(rates[static_cast<std::size_t>(core::memory::Tag::ImGui)].allocations_per_second == 10.0);
+    CHECK(rates[static_cast<std::size_t>(core::memory::Tag::ImGui)].bytes_per_second == 2000.0);
+    CHECK(rates[static_cast<std::size_t>(core::memory::Tag::Other)].allocations_per_second == 0.0);
+    CHECK(core::memory::compute_rates(current, current)[static_cast<std::size_t>(core::memory::Tag::ImGui)].bytes_per_second == 0.0);
+}
+
+TEST_CASE("to_json lists every tag", "[src][core][memory.hpp]")
+{
+    core::memory::Snapshot snapshot;
+    snapshot.seconds = 2.0;
+    snapshot.usages[static_cast<std::size_t>(core::memory::Tag::EditorBuffer)] = {.bytes = 512, .peak_bytes = 2048, .allocations = 4, .allocated_bytes = 4096};
+    const std::string json = core::memory::to_json(snapshot);
+    CHECK(json.starts_with("{\n  \"uptime_seconds\": 2.000,"));
+    CHECK(json.find("\"total_bytes\": 512,") != std::string::npos);
+    CHECK(json.find("{\"name\": \"Editor buffer\", \"bytes\": 512, \"peak_bytes\": 2048, \"allocations\": 4, \"allocated_bytes\": 4096, \"allocations_per_second\": 2.0, \"bytes_per_second\": 2048.0},") != std::string::npos);
+    CHECK(json.find("{\"name\": \"ImGui\", \"bytes\": 0,") != std::string::npos);
+    CHECK(json.ends_with("}\n  ]\n}\n"));
+}
@@ -0,0 +1,104 @@
+/**
+ * @file pipeline.test.cpp
+ */
+
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+#include <snitch/snitch.hpp>
+
+#include "core/pipeline.hpp"
+
+namespace {
+
+/**
+ * @brief Run the selected stages over a text and return the result.
+ *
+ * @param text Text to transform (e.g., "“a”").
+ * @param options Stages to run (e.g., "{.fold_quotes = true}").
+ *
+ * @return Transformed text (e.g., "\"a\"").
+ */
+[[nodiscard]] std::string transform(const std::string_view text,
+                                    const core::pipeline::PipelineOptions &options)
+{
+    std::string output;
+    static_cast<void>(core::pipeline::run(text, options, output));
+    return output;
+}
+
+}  // namespace
+
+TEST_CASE("run leaves the text unchanged without stages", "[src][core][pipeline.hpp]")
+{
+    CHECK(transform("", {}).empty());
+    CHECK(transform("“Zażółć” — 東京\r\n", {}) == "“Zażółć” — 東京\r\n");
+}
+
+TEST_CASE("run applies every stage on its own", "[src][core][pipeline.hpp]")
+{
+    CHECK(transform("a\r\nb\rc\n\r\n", {.normalize_line_endings = true}) == "a\nb\nc\n\n");
+    CHECK(transform("in​vis­ible﻿", {.strip_invisible = true}) == "invisible");
+    CHECK(transform("“double” ‘single’ „low‟", {.fold_quotes = true}) == "\"double\" 'single' \"low\"");
+    CHECK(transform("a – b — c − d", {.fold_dashes = true}) == "a - b - c - d");
+    CHECK(transform("a  \t b 　c\n  d", {.collapse_spaces = true}) == "a b c\n d");
+}
+
+TEST_CASE("run fuses all stages into one pass", "[src][core][pipeline.hpp]")
+{
+    const core::pipeline::PipelineOptions all = {
+        .normalize_line_endings = true,
+        .strip_invisible = true,
+        .fold_quotes = true,
+        .fold_dashes = true,
+        .collapse_spaces = true,
+    };
+    CHECK(transform("“a”  —  b\r\n", all) == "\"a\" - b\n");
+
+    // An invisible character between two spaces is removed before the spaces are collapsed
+    CHECK(transform("a ​ b", all) == "a b");
+
+    // Long ASCII runs pass through the stages intact, including at chunk boundaries
+    std::string ascii(1000, 'x');
+    ascii[7] = ' ';
+    ascii[8] = ' ';
+    std::string expected = ascii;
+    expected.erase(8, 1);
+    CHECK(transform(ascii, all) == expected);
+    CHECK(transform(ascii, {.fold_quotes = true}) == ascii);
+}
+
+TEST_CASE("run keeps invalid UTF-8 bytes unchanged", "[src][core][pipeline.hpp]")
+{
+    CHECK(transform("a\xFF“b\xC3", {.fold_quotes = true}) == "a\xFF\"b\xC3");
+    CHECK(transform("\xED\xA0\x80 \xF4\x90\x80\x80", {.collapse_spaces = true}) == "\xED\xA0\x80 \xF4\x90\x80\x80");
+
+    // An escaped byte is never mistaken for a character, even when stages transform their neighbours
+    CHECK(transform("\x80\r\n\x80", {.normalize_line_endings = true}) == "\x80\n\x80");
+}
+
+TEST_CASE("Pipeline composes custom stages at compile time", "[src][core][pipeline.hpp]")
+{
+    core::pipeline::Pipeline<core::pipeline::FoldDashes, core::pipeline::CollapseSpaces> pipeline;
+    static_assert(!decltype(pipeline)::ascii_transparent);
+    static_assert(core::pipeline::Pipeline<core::pipeline::FoldQuotes, core::pipeline::Identity>::ascii_transparent);
+
+    std::string output = "previous contents";
+    CHECK(pipeline.run("a —  b", output) == 2);
+    CHECK(output == "a - b");
+}
+
+TEST_CASE("run counts every run of changed code points once", "[src][core][pipeline.hpp]")
+{
+    std::string output;
+    CHECK(core::pipeline::run("plain text\n", {.normalize_line_endings = true, .collapse_spaces = true}, output) == 0);
+    CHECK(output == "plain text\n");
+
+    // "\r\n" is one change, as is a run of spaces
+    CHECK(core::pipeline::run("a\r\nb    c\r\n", {.normalize_line_endings = true, .collapse_spaces = true}, output) == 3);
+    CHECK(output == "a\nb c\n");
+
+    // Adjacent replacements merge into one change, separated ones do not
+    CHECK(core::pipeline::run("“”x‘’", {.fold_quotes = true}, output) == 2);
+    CHECK(output == "\"\"x''");
+}
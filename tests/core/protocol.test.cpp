@@ -0,0 +1,62 @@
+/**
+ * @file protocol.test.cpp
+ */
+
+#include <cstdint>    // for std::uint8_t
+#include <optional>   // for std::optional
+#include <stdexcept>  // for std::runtime_error
+#include <string>     // for std::string
+
+#include <snitch/snitch.hpp>
+
+#include "core/protocol.hpp"
+
+TEST_CASE("FrameDecoder reassembles frames split across reads", "[src][core][protocol.hpp]")
+{
+    std::string stream;
+    core::protocol::append_frame(stream, static_cast<std::uint8_t>(core::protocol::Opcode::Normalize), "hello");
+    core::protocol::append_frame(stream, static_cast<std::uint8_t>(core::protocol::Opcode::Count), "");
+    CHECK(stream.size() == 15);
+
+    // Feed one byte at a time, so every boundary is exercised
+    core::protocol::FrameDecoder decoder;
+    std::size_t decoded = 0;
+    for (const char byte : stream) {
+        decoder.feed({&byte, 1});
+        while (std::optional<core::protocol::Frame> frame = decoder.next()) {
+            if (decoded == 0) {
+                CHECK(frame->kind == static_cast<std::uint8_t>(core::protocol::Opcode::Normalize));
+                CHECK(frame->body == "hello");
+            }
+            else {
+                CHECK(frame->kind == static_cast<std::uint8_t>(core::protocol::Opcode::Count));
+                CHECK(frame->body.empty());
+            }
+            ++decoded;
+        }
+    }
+    CHECK(decoded == 2);
+    CHECK(decoder.buffered() == 0);
+}
+
+TEST_CASE("FrameDecoder rejects invalid frame sizes", "[src][core][protocol.hpp]")
+{
+    core::protocol::FrameDecoder empty_frame;
+    empty_frame.feed(std::string(4, '\0'));
+    CHECK_THROWS_AS(static_cast<void>(empty_frame.next()), std::runtime_error);
+
+    core::protocol::FrameDecoder oversized_frame;
+    oversized_frame.feed(std::string(4, '\xFF'));
+    CHECK_THROWS_AS(static_cast<void>(oversized_frame.next()), std::runtime_error);
+}
+
+TEST_CASE("append_u64 and read_u64 round-trip", "[src][core][protocol.hpp]")
+{
+    std::string buffer;
+    core::protocol::append_u64(buffer, 42);
+    core::protocol::append_u64(buffer, 0x0123456789ABCDEF);
+    CHECK(buffer.size() == 16);
+    CHECK(core::protocol::read_u64(buffer, 0) == 42);
+    CHECK(core::protocol::read_u64(buffer, 8) == 0x0123456789ABCDEF);
+    CHECK_THROWS_AS(static_cast<void>(core::protocol::read_u64(buffer, 9)), std::runtime_error);
+}
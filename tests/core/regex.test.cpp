@@ -0,0 +1,147 @@
+/**
+ * @file regex.test.cpp
+ */
+
+#include <array>        // for std::array
+#include <optional>     // for std::optional
+#include <stdexcept>    // for std::invalid_argument
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <tuple>        // for std::tuple
+
+#include <snitch/snitch.hpp>
+
+#include "core/regex.hpp"
+
+namespace {
+
+/**
+ * @brief Find the first match of a single regular expression.
+ *
+ * @param expression Regular expression to compile.
+ * @param text Text to search.
+ *
+ * @return Matched text, or "<none>" if there is no match.
+ */
+[[nodiscard]] std::string find_first(const std::string_view expression,
+                                     const std::string_view text)
+{
+    const std::array<core::regex::Pattern, 1> patterns = {{{.expression = expression}}};
+    const core::regex::Program program{patterns};
+    core::regex::Matcher matcher{program};
+    const std::optional<core::regex::Match> match = matcher.find(text);
+    return match ? std::string{text.substr(match->begin, match->end - match->begin)} : "<none>";
+}
+
+}  // namespace
+
+TEST_CASE("Matcher finds the leftmost-first match", "[src][core][regex.hpp]")
+{
+    static const std::tuple<std::string, std::string, std::string> test_cases[] = {
+        {"abc", "xxabcxx", "abc"},
+        {"a|ab", "ab", "a"},  // Earlier alternatives win, like Perl
+        {"ab|a", "ab", "ab"},
+        {"a+", "baaa", "aaa"},
+        {"a+?", "baaa", "a"},
+        {"a*", "baaa", "aaa"},  // The empty match at offset 0 is skipped
+        {"colou?r", "color colour", "color"},
+        {"x{2,3}", "xxxxx", "xxx"},
+        {"x{2}", "x xx", "xx"},
+        {"x{2,}", "xxxxx", "xxxxx"},
+        {"[a-c]+", "zzbcaz", "bca"},
+        {"[^ ]+", "  word  ", "word"},
+        {"[-a]+", "b-a-b", "-a-"},
+        {"\\d+", "abc 1234 def", "1234"},
+        {"\\w+", "  hello_1 world", "hello_1"},
+        {"\\s+$", "trailing   ", "   "},
+        {"[ \t]+$", "line  \nnext", "  "},
+        {"[ \t]+$", "line \t\r\nnext", " \t"},  // "$" also matches before "\r\n"
+        {"^b", "ab\nb", "b"},
+        {"^a", "ba", "<none>"},
+        {"\\*\\*", "a **bold**", "**"},
+        {"(?:ab)+", "abababx", "ababab"},
+        {"(ab|cd)e", "xcde", "cde"},
+        {"ż+", "zażżółć", "żż"},  // Quantifiers repeat whole UTF-8 characters
+        {"a.c", "ażc", "ażc"},    // "." consumes a whole UTF-8 character
+        {"a.c", "a\nc", "<none>"},
+        {"[^a]", "aż", "ż"},
+        {"As an AI(?: language model)?,[ \t]*", "As an AI language model, I think", "As an AI language model, "},
+    };
+
+    for (const auto &[expression, text, expected_match] : test_cases) {
+        CAPTURE(expression, text);
+        CHECK(find_first(expression, text) == expected_match);
+    }
+}
+
+TEST_CASE("Program prefers earlier patterns at the same position", "[src][core][regex.hpp]")
+{
+    const std::array<core::regex::Pattern, 3> patterns = {{
+        {.expression = "ab", .is_literal = true},
+        {.expression = "abc", .is_literal = true},
+        {.expression = "b.", .is_literal = false},
+    }};
+    const core::regex::Program program{patterns};
+    core::regex::Matcher matcher{program};
+
+    const std::string text = "xabc bz";
+    const std::optional<core::regex::Match> first = matcher.find(text);
+    REQUIRE(first.has_value());
+    CHECK(first->begin == 1);
+    CHECK(first->end == 3);
+    CHECK(first->pattern_index == 0);
+
+    const std::optional<core::regex::Match> second = matcher.find(text, first->end);
+    REQUIRE(second.has_value());
+    CHECK(second->begin == 5);
+    CHECK(second->pattern_index == 2);
+
+    CHECK_FALSE(matcher.find(text, second->end).has_value());
+}
+
+TEST_CASE("Matcher only starts matches before the limit", "[src][core][regex.hpp]")
+{
+    const std::array<core::regex::Pattern, 1> patterns = {{{.expression = "[ \t]+$"}}};
+    const core::regex::Program program{patterns};
+    core::regex::Matcher matcher{program};
+
+    // A match may end past the limit, and "$" sees the text after it
+    const std::string text = "a  b  ";
+    CHECK_FALSE(matcher.find(text, 0, 4).has_value());
+    const std::optional<core::regex::Match> match = matcher.find(text, 0, 5);
+    REQUIRE(match.has_value());
+    CHECK(match->begin == 4);
+    CHECK(match->end == 6);
+}
+
+TEST_CASE("Matcher runs in linear time on patterns that make backtracking engines explode", "[src][core][regex.hpp]")
+{
+    // A backtracking engine needs exponential time for this; the lockstep simulation finishes instantly
+    const std::string text(20000, 'a');
+    CHECK(find_first("(a*)*b", text) == "<none>");
+    CHECK(find_first("(a|aa)+$", text) == text);
+}
+
+TEST_CASE("Program rejects invalid patterns", "[src][core][regex.hpp]")
+{
+    static const std::string invalid_patterns[] = {
+        "",
+        "(abc",
+        "abc)",
+        "[abc",
+        "*a",
+        "a{3,1}",
+        "a{2000}",
+        "\\q",
+        "[z-a]",
+        "[ż]",
+        "(?=a)",
+        "a\\",
+    };
+
+    for (const std::string &expression : invalid_patterns) {
+        CAPTURE(expression);
+        const std::array<core::regex::Pattern, 1> patterns = {{{.expression = expression}}};
+        CHECK_THROWS_AS(core::regex::Program{patterns}, std::invalid_argument);
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file rules.test.cpp
+ */
+
+#include <stdexcept>  // for std::invalid_argument
+#include <string>     // for std::string
+#include <vector>     // for std::vector
+
+#include <snitch/snitch.hpp>
+
+#include "core/diff.hpp"
+#include "core/markdown.hpp"
+#include "core/regex.hpp"
+#include "core/rules.hpp"
+
+TEST_CASE("RuleSet applies literal and regex rules in a single pass", "[src][core][rules.hpp]")
+{
+    const core::rules::RuleSet rule_set{{
+        {.pattern = "—", .replacement = "-"},
+        {.pattern = "**", .replacement = ""},
+        {.pattern = "[ \t]+$", .replacement = "", .is_regex = true},
+        {.pattern = "a+b", .replacement = "X", .is_regex = true},
+    }};
+    CHECK(rule_set.size() == 4);
+
+    std::string text = "One — **two**  \nthree aab \t\r\nfour";
+    CHECK(rule_set.apply(text) == 6);
+    CHECK(text == "One - two\nthree X\r\nfour");
+}
+
+TEST_CASE("RuleSet does not rescan replacements", "[src][core][rules.hpp]")
+{
+    const core::rules::RuleSet rule_set{{
+        {.pattern = "a", .replacement = "b"},
+        {.pattern = "b", .replacement = "c"},
+    }};
+
+    std::string text = "ab";
+    CHECK(rule_set.apply(text) == 2);
+    CHECK(text == "bc");
+}
+
+TEST_CASE("RuleSet leaves text without matches untouched", "[src][core][rules.hpp]")
+{
+    const core::rules::RuleSet rule_set{{{.pattern = "x", .replacement = "y"}}};
+
+    std::string text = "Zażółć gęślą jaźń";
+    CHECK(rule_set.apply(text) == 0);
+    CHECK(text == "Zażółć gęślą jaźń");
+
+    std::string empty;
+    CHECK(rule_set.apply(empty) == 0);
+    CHECK(empty.empty());
+}
+
+TEST_CASE("RuleSet lists the changes it would make", "[src][core][rules.hpp]")
+{
+    const core::rules::RuleSet rule_set{{
+        {.pattern = "—", .replacement = "-"},
+        {.pattern = "x", .replacement = "x"},
+        {.pattern = "[ \t]+$", .replacement = "", .is_regex = true},
+    }};
+
+    // Matches whose replacement is identical to the matched text are not changes
+    const std::string text = "a — x  \nb";
+    const std::vector<core::diff::Change> changes = rule_set.find_changes(text);
+    REQUIRE(changes.size() == 2);
+    CHECK(changes[0].begin == 2);
+    CHECK(changes[0].end == 5);
+    CHECK(changes[0].replacement == "-");
+    CHECK(changes[1].begin == 7);
+    CHECK(changes[1].end == 9);
+    CHECK(changes[1].replacement.empty());
+
+    std::string applied = text;
+    rule_set.apply(applied);
+    CHECK(core::diff::apply_changes(text, changes) == applied);
+}
+
+TEST_CASE("RuleSet skips verbatim ranges", "[src][core][rules.hpp]")
+{
+    const core::rules::RuleSet rule_set{{
+        {.pattern = "—", .replacement = "-"},
+        {.pattern = "[ \t]+$", .replacement = "", .is_regex = true},
+        {.pattern = "a+b", .replacement = "X", .is_regex = true},
+    }};
+
+    // "—" inside the range is kept, and "$" still sees the text after the range
+    const std::string text = "— [— ]  \nx — aab";
+    const std::vector<core::markdown::Range> verbatim = {{.begin = 4, .end = 10}, {.begin = 21, .end = 22}};
+    std::string applied = text;
+    CHECK(rule_set.apply(applied, verbatim) == 3);
+    CHECK(applied == "- [— ]\nx - aab");
+
+    // A match that would run into a range is dropped
+    std::string overlapping = "aab";
+    CHECK(rule_set.apply(overlapping, std::vector<core::markdown::Range>{{.begin = 1, .end = 2}}) == 0);
+
+    const std::vector<core::diff::Change> changes = rule_set.find_changes(text, verbatim);
+    CHECK(changes.size() == 3);
+    CHECK(core::diff::apply_changes(text, changes) == applied);
+
+    core::regex::Matcher matcher{rule_set.program()};
+    std::string output(text.size(), '\0');
+    output.resize(rule_set.apply_to(text, output.data(), output.size(), matcher, verbatim));
+    CHECK(output == applied);
+}
+
+TEST_CASE("RuleSet rejects invalid regular expressions", "[src][core][rules.hpp]")
+{
+    const std::vector<core::rules::Rule> invalid_regex = {{.pattern = "(", .replacement = "", .is_regex = true}};
+    CHECK_THROWS_AS(core::rules::RuleSet{invalid_regex}, std::invalid_argument);
+
+    const std::vector<core::rules::Rule> empty_pattern = {{.pattern = "", .replacement = ""}};
+    CHECK_THROWS_AS(core::rules::RuleSet{empty_pattern}, std::invalid_argument);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file search.test.cpp
+ */
+
+#include <cstddef>  // for std::size_t
+#include <string>   // for std::string
+#include <tuple>    // for std::tuple
+#include <vector>   // for std::vector
+
+#include <snitch/snitch.hpp>
+
+#include "core/search.hpp"
+
+TEST_CASE("find_all returns non-overlapping matches", "[src][core][search.hpp]")
+{
+    static const std::tuple<std::string, std::string, bool, std::vector<std::size_t>> test_cases[] = {
+        {"", "a", true, {}},
+        {"hello world", "", true, {}},
+        {"hello world", "world", true, {6}},
+        {"hello world", "World", true, {}},
+        {"hello world", "WORLD", false, {6}},
+        {"aaaaa", "aa", true, {0, 2}},
+        {"abc", "abcd", true, {}},
+        {"x", "x", true, {0}},
+        {"As an AI language model, as an ai, AS AN AI", "as an ai", false, {0, 25, 35}},
+        {"Zażółć gęślą jaźń, zażółć", "zażółć", false, {0, 28}},
+        {"Zażółć gęślą jaźń, zażółć", "ZAŻÓŁĆ", false, {}},  // Only ASCII letters are folded
+        // Matches that start inside one 16-byte block and end in the next, and one in the scalar tail
+        {"0123456789abcdeXYZ0123456789abcdefXYZ01XYZ", "XYZ", true, {15, 34, 39}},
+        {"________________________________needle________________needle", "needle", true, {32, 54}},
+        {"..................................................q", "q", true, {50}},
+    };
+
+    for (const auto &[text, pattern, case_sensitive, expected_matches] : test_cases) {
+        CAPTURE(text, pattern, case_sensitive);
+        CHECK(core::search::find_all(text, pattern, case_sensitive) == expected_matches);
+        CHECK(core::search::count_matches(text, pattern, case_sensitive) == expected_matches.size());
+    }
+}
+
+TEST_CASE("Searcher finds the next match from an offset", "[src][core][search.hpp]")
+{
+    const core::search::Searcher searcher{"ab"};
+    const std::string text = "ab ab ab";
+    CHECK(searcher.find(text) == 0);
+    CHECK(searcher.find(text, 1) == 3);
+    CHECK(searcher.find(text, 6) == 6);
+    CHECK(searcher.find(text, 7) == std::string::npos);
+    CHECK(searcher.find(text, 100) == std::string::npos);
+}
+
+TEST_CASE("replace_all replaces every match in a single pass", "[src][core][search.hpp]")
+{
+    static const std::tuple<std::string, std::string, std::string, bool, std::string, std::size_t> test_cases[] = {
+        {"hello world", "world", "there", true, "hello there", 1},
+        {"hello world", "missing", "x", true, "hello world", 0},
+        {"aaaaa", "aa", "b", true, "bba", 2},
+        {"As an AI, I think. as an ai, I know.", "as an ai, ", "", false, "I think. I know.", 2},
+        {"a-b-c", "-", " -> ", true, "a -> b -> c", 2},
+        {"**bold** and **more**", "**", "", true, "bold and more", 4},
+    };
+
+    for (const auto &[input_text, pattern, replacement, case_sensitive, expected_text, expected_count] : test_cases) {
+        CAPTURE(input_text, pattern, replacement);
+        std::string modified_text = input_text;
+        CHECK(core::search::replace_all(modified_text, pattern, replacement, case_sensitive) == expected_count);
+        CHECK(modified_text == expected_text);
+    }
+}
@@ -0,0 +1,56 @@
+/**
+ * @file server.test.cpp
+ */
+
+#if defined(__linux__)
+
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint8_t
+#include <filesystem>  // for std::filesystem
+#include <string>      // for std::string
+#include <thread>      // for std::jthread
+
+#include <snitch/snitch.hpp>
+
+#include "core/client.hpp"
+#include "core/protocol.hpp"
+#include "core/server.hpp"
+
+TEST_CASE("Server answers pipelined requests in order", "[src][core][server.hpp]")
+{
+    const std::filesystem::path socket_path = std::filesystem::temp_directory_path() / "ungpt-server-test.sock";
+    core::server::Server server{socket_path, 4};
+    std::jthread serving{[&server] { server.run(); }};
+
+    {
+        core::client::Client client{socket_path};
+        CHECK(client.normalize("“hello”") == "\"hello\"");
+
+        // Pipeline many requests of different cost, then check that every response comes back in order
+        for (std::size_t i = 0; i < 200; ++i) {
+            client.send(core::protocol::Opcode::Normalize, std::string(i * 100, 'a') + "—" + std::to_string(i));
+        }
+        for (std::size_t i = 0; i < 200; ++i) {
+            const core::protocol::Frame response = client.receive();
+            CHECK(response.kind == static_cast<std::uint8_t>(core::protocol::Status::Ok));
+            CHECK(response.body == std::string(i * 100, 'a') + "-" + std::to_string(i));
+        }
+
+        client.send(core::protocol::Opcode::Count, "Zażółć gęślą jaźń");
+        const core::protocol::Frame counts = client.receive();
+        CHECK(core::protocol::read_u64(counts.body, 0) == 3);
+        CHECK(core::protocol::read_u64(counts.body, 8) == 17);
+
+        client.send(core::protocol::Opcode::EstimateTokens, "hello world");
+        const core::protocol::Frame tokens = client.receive();
+        CHECK(core::protocol::read_u64(tokens.body, 0) == 3);
+
+        client.send(static_cast<core::protocol::Opcode>(99), "");
+        const core::protocol::Frame error = client.receive();
+        CHECK(error.kind == static_cast<std::uint8_t>(core::protocol::Status::Error));
+    }
+
+    server.stop();
+}
+
+#endif
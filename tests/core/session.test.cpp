@@ -0,0 +1,178 @@
+/**
+ * @file session.test.cpp
+ */
+
+#include <filesystem>  // for std::filesystem
+#include <fstream>     // for std::ofstream
+#include <stdexcept>   // for std::out_of_range, std::runtime_error
+#include <string>      // for std::string
+
+#include <snitch/snitch.hpp>
+
+#include "core/session.hpp"
+
+#include "support.hpp"
+
+TEST_CASE("find_edit returns the smallest single edit", "[src][core][session.hpp]")
+{
+    const core::session::Edit insertion = core::session::find_edit("hello world", "hello brave world");
+    CHECK(insertion.offset == 6);
+    CHECK(insertion.erased == 0);
+    CHECK(insertion.inserted == "brave ");
+
+    const core::session::Edit deletion = core::session::find_edit("hello brave world", "hello world");
+    CHECK(deletion.offset == 6);
+    CHECK(deletion.erased == 6);
+    CHECK(deletion.inserted.empty());
+
+    // Repeated characters: the prefix and suffix must not overlap
+    const core::session::Edit repeated = core::session::find_edit("aaa", "aaaa");
+    CHECK(repeated.offset == 3);
+    CHECK(repeated.erased == 0);
+    CHECK(repeated.inserted == "a");
+
+    const core::session::Edit unchanged = core::session::find_edit("same", "same");
+    CHECK(unchanged.erased == 0);
+    CHECK(unchanged.inserted.empty());
+}
+
+TEST_CASE("apply_edit reverses find_edit", "[src][core][session.hpp]")
+{
+    const std::string before = "The quick brown fox";
+    const std::string after = "The slow brown dog";
+    std::string text = before;
+    core::session::apply_edit(text, core::session::find_edit(before, after));
+    CHECK(text == after);
+
+    CHECK_THROWS_AS(core::session::apply_edit(text, {.offset = 100, .erased = 0, .inserted = "x"}), std::out_of_range);
+}
+
+TEST_CASE("Journal restores the text of the last session", "[src][core][session.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-session-test");
+    CHECK(core::session::restore(directory).empty());
+
+    {
+        core::session::Journal journal{directory};
+        CHECK(journal.restored_text().empty());
+        journal.record("hello");
+        journal.record("hello world");
+        journal.record("hello brave world");
+    }
+    CHECK(core::session::restore(directory) == "hello brave world");
+
+    // Edits after a restart are journaled on top of the restored text
+    {
+        core::session::Journal journal{directory};
+        CHECK(journal.restored_text() == "hello brave world");
+        journal.record("goodbye brave world");
+    }
+    CHECK(core::session::restore(directory) == "goodbye brave world");
+}
+
+TEST_CASE("Journal survives a crash that tears the last record", "[src][core][session.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-session-test");
+    const std::filesystem::path crashed = tests::support::make_empty_directory("ungpt-session-test-crashed");
+    const std::filesystem::path resumed = tests::support::make_empty_directory("ungpt-session-test-resumed");
+
+    {
+        core::session::Journal journal{directory};
+        journal.record("first line");
+        journal.record("first line\nsecond line");
+        journal.flush();
+
+        // Copy the files while the journal is still open, which is what a crash leaves behind
+        std::filesystem::copy(directory, crashed);
+    }
+
+    // Append half of a record, as if the process died in the middle of a write
+    {
+        std::ofstream stream{crashed / "journal", std::ios::binary | std::ios::app};
+        stream << std::string(20, '\x01');
+    }
+    CHECK(core::session::restore(crashed) == "first line\nsecond line");
+
+    // Recording resumes after the last valid record
+    {
+        core::session::Journal journal{crashed};
+        CHECK(journal.restored_text() == "first line\nsecond line");
+        journal.record("first line\nsecond line\nthird line");
+        journal.flush();
+        std::filesystem::copy(crashed, resumed);
+    }
+    CHECK(core::session::restore(resumed) == "first line\nsecond line\nthird line");
+}
+
+TEST_CASE("Journal compacts large edit histories into a snapshot", "[src][core][session.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-session-test");
+
+    std::string text;
+    {
+        core::session::Journal journal{directory};
+        for (std::size_t i = 0; i < 200; ++i) {
+            text += std::string(8 * 1024, static_cast<char>('a' + i % 26));
+            journal.record(text);
+        }
+        journal.flush();
+
+        // Far more than the minimum was journaled, so a snapshot was taken and the journal started over
+        CHECK(std::filesystem::exists(directory / "snapshot"));
+        CHECK(std::filesystem::file_size(directory / "journal") < core::session::MIN_COMPACTION_SIZE + 8 * 1024 + 64);
+    }
+    CHECK(core::session::restore(directory) == text);
+}
+
+TEST_CASE("Session restores every document of the last session", "[src][core][session.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-session-test-documents");
+    {
+        core::session::Session session{directory};
+        CHECK(session.restored_count() == 0);
+        session.record(1, "first document");
+        session.record(2, "");
+        session.record(3, "third document");
+        session.record(4, "closed document");
+        session.remove(4);
+        session.flush();
+    }
+
+    // Empty and closed documents are not restored, the others keep their order
+    {
+        core::session::Session session{directory};
+        REQUIRE(session.restored_count() == 2);
+        CHECK(session.restored_text(0) == "first document");
+        CHECK(session.restored_text(1) == "third document");
+        CHECK_THROWS_AS(static_cast<void>(session.restored_text(2)), std::out_of_range);
+
+        // Adopted documents are journaled under their new identifier, the others are kept as they are
+        session.adopt(1, 10);
+        CHECK_THROWS_AS(static_cast<void>(session.restored_text(1)), std::out_of_range);
+        session.record(10, "third document, edited");
+        session.record(11, "new document");
+    }
+    {
+        core::session::Session session{directory};
+        REQUIRE(session.restored_count() == 3);
+        CHECK(session.restored_text(0) == "first document");
+        CHECK(session.restored_text(1) == "third document, edited");
+        CHECK(session.restored_text(2) == "new document");
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Session locks its directory against other instances", "[src][core][session.hpp]")
+{
+    const std::filesystem::path directory = tests::support::make_empty_directory("ungpt-session-test-lock");
+    {
+        core::session::Session session{directory};
+        session.record(1, "text");
+        CHECK_THROWS_AS(core::session::Session{directory}, std::runtime_error);
+    }
+
+    // The lock is released with the session, so the next start restores it
+    const core::session::Session session{directory};
+    REQUIRE(session.restored_count() == 1);
+    CHECK(session.restored_text(0) == "text");
+}
@@ -2,12 +2,15 @@
  * @file text.test.cpp
  */
 
-#include <cstddef>  // for std::size_t
-#include <string>   // for std::string
-#include <utility>  // for std::pair
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::pair
+#include <vector>       // for std::vector
 
 #include <snitch/snitch.hpp>
 
+#include "core/diff.hpp"
 #include "core/text.hpp"
 
 TEST_CASE("remove_unwanted_characters replaces Unicode with ASCII", "[src][core][text.hpp]")
@@ -36,6 +39,130 @@ TEST_CASE("remove_unwanted_characters replaces Unicode with ASCII", "[src][core]
     }
 }
 
+TEST_CASE("remove_unwanted_characters applies optional cleanup rules", "[src][core][text.hpp]")
+{
+    const std::string input_text = "As an AI language model, I think **this**—is fine.  \nSecond line\t\r\nas an AI, done ";
+
+    std::string untouched_text = input_text;
+    core::text::remove_unwanted_characters(untouched_text);
+    CHECK(untouched_text == "As an AI language model, I think **this**-is fine.  \nSecond line\t\r\nas an AI, done ");
+
+    std::string cleaned_text = input_text;
+    const core::text::CleanupOptions options{
+        .remove_ai_disclaimers = true,
+        .remove_markdown_bold = true,
+        .trim_trailing_whitespace = true,
+    };
+    core::text::remove_unwanted_characters(cleaned_text, options);
+    CHECK(cleaned_text == "I think this-is fine.\nSecond line\r\ndone");
+}
+
+TEST_CASE("remove_unwanted_characters trims whitespace that other rules rewrite", "[src][core][text.hpp]")
+{
+    // No-break spaces become spaces and zero-width spaces vanish, so they belong to the trailing run
+    static const std::pair<std::string, std::string> test_cases[] = {
+        {"a\u00A0\nb", "a\nb"},
+        {"a \u00A0\nb", "a\nb"},
+        {"a\t\u200B\nb", "a\nb"},
+        {"a\u00A0b \u3000", "a b"},
+    };
+
+    for (const auto &[input_text, expected_text] : test_cases) {
+        CAPTURE(input_text);
+        std::string modified_text = input_text;
+        core::text::remove_unwanted_characters(modified_text, {.trim_trailing_whitespace = true});
+        CHECK(modified_text == expected_text);
+
+        std::string output(input_text.size(), '\0');
+        output.resize(core::text::normalize_into(input_text, output.data(), output.size(), {.trim_trailing_whitespace = true}));
+        CHECK(output == expected_text);
+
+        const std::vector<core::diff::Change> changes = core::text::find_changes(input_text, {.trim_trailing_whitespace = true});
+        CHECK(core::diff::apply_changes(input_text, changes) == expected_text);
+    }
+}
+
+TEST_CASE("remove_unwanted_characters repairs invalid UTF-8 first", "[src][core][text.hpp]")
+{
+    // A truncated em dash ("\xE2\x80") followed by a complete one, and a stray continuation byte
+    const std::string input_text = "a\xE2\x80—b\x80";
+
+    std::string untouched_text = input_text;
+    CHECK(core::text::remove_unwanted_characters(untouched_text) == 1);
+    CHECK(untouched_text == "a\xE2\x80-b\x80");
+
+    std::string repaired_text = input_text;
+    CHECK(core::text::remove_unwanted_characters(repaired_text, {.repair_invalid_utf8 = true}) == 3);
+    CHECK(repaired_text == "a\uFFFD-b\uFFFD");
+
+    std::string output(32, '\0');
+    output.resize(core::text::normalize_into(input_text, output.data(), output.size(), {.repair_invalid_utf8 = true}));
+    CHECK(output == repaired_text);
+
+    const std::vector<core::diff::Change> changes = core::text::find_changes(input_text, {.repair_invalid_utf8 = true});
+    CHECK(changes.size() == 3);
+    CHECK(core::diff::apply_changes(input_text, changes) == repaired_text);
+}
+
+TEST_CASE("remove_unwanted_characters preserves Markdown code and URLs", "[src][core][text.hpp]")
+{
+    const std::string input_text = "Use `a → b` — see https://example.com/a—b.\n\n```cpp\nx = \"—\";  \n```\nDone —  \n";
+
+    std::string preserved_text = input_text;
+    CHECK(core::text::remove_unwanted_characters(preserved_text, {.trim_trailing_whitespace = true, .preserve_code = true}) == 3);
+    CHECK(preserved_text == "Use `a → b` - see https://example.com/a—b.\n\n```cpp\nx = \"—\";  \n```\nDone -\n");
+
+    std::string output(input_text.size(), '\0');
+    output.resize(core::text::normalize_into(input_text, output.data(), output.size(), {.trim_trailing_whitespace = true, .preserve_code = true}));
+    CHECK(output == preserved_text);
+
+    const std::vector<core::diff::Change> changes = core::text::find_changes(input_text, {.trim_trailing_whitespace = true, .preserve_code = true});
+    CHECK(core::diff::apply_changes(input_text, changes) == preserved_text);
+
+    // Without the option, code is normalized like everything else
+    std::string normalized_text = input_text;
+    core::text::remove_unwanted_characters(normalized_text);
+    CHECK(normalized_text.find("x = \"-\"") != std::string::npos);
+}
+
+TEST_CASE("remove_unwanted_characters normalizes line endings and collapses whitespace", "[src][core][text.hpp]")
+{
+    const core::text::CleanupOptions options{.normalize_line_endings = true, .collapse_whitespace = true};
+    const std::string input_text = "“a”  —\u00A0 b\r\nc \u200B d\re";
+    const std::string expected_text = "\"a\" - b\nc d\ne";
+
+    // The runs of spaces include the ones that the replacements produce, and every run or line ending is one change
+    std::string modified_text = input_text;
+    CHECK(core::text::remove_unwanted_characters(modified_text, options) == 10);
+    CHECK(modified_text == expected_text);
+
+    std::string output(input_text.size(), '\0');
+    output.resize(core::text::normalize_into(input_text, output.data(), output.size(), options));
+    CHECK(output == expected_text);
+
+    // A buffer that is too small receives the beginning of the text
+    std::string truncated(4, '\0');
+    CHECK(core::text::normalize_into(input_text, truncated.data(), truncated.size(), options) == expected_text.size());
+    CHECK(truncated == expected_text.substr(0, 4));
+
+    const std::vector<core::diff::Change> changes = core::text::find_changes(input_text, options);
+    CHECK(core::diff::apply_changes(input_text, changes) == expected_text);
+
+    // Trailing whitespace is trimmed before the line endings are normalized
+    std::string trimmed_text = "a  \r\nb\t\t\r\n";
+    core::text::remove_unwanted_characters(trimmed_text, {.trim_trailing_whitespace = true, .normalize_line_endings = true, .collapse_whitespace = true});
+    CHECK(trimmed_text == "a\nb\n");
+
+    // Code keeps its whitespace
+    const std::string code_text = "Use `a  b`  here\r\n";
+    std::string preserved_text = code_text;
+    CHECK(core::text::remove_unwanted_characters(preserved_text, {.preserve_code = true, .normalize_line_endings = true, .collapse_whitespace = true}) == 2);
+    CHECK(preserved_text == "Use `a  b` here\n");
+    output.assign(code_text.size(), '\0');
+    output.resize(core::text::normalize_into(code_text, output.data(), output.size(), {.preserve_code = true, .normalize_line_endings = true, .collapse_whitespace = true}));
+    CHECK(output == preserved_text);
+}
+
 TEST_CASE("count_words returns correct word count", "[src][core][text.hpp]")
 {
     static const std::pair<std::string, std::size_t> test_cases[] = {
@@ -87,3 +214,121 @@ TEST_CASE("count_characters returns correct character count", "[src][core][text.
         CHECK(core::text::count_characters(input_text) == expected_count);
     }
 }
+
+TEST_CASE("estimate_tokens returns a rough token count", "[src][core][text.hpp]")
+{
+    static const std::pair<std::string, std::size_t> test_cases[] = {
+        {"", 0},
+        {"hi", 1},
+        {"hello world", 3},
+        {"a b c d e f", 6},
+        {"Zażółć gęślą jaźń", 5},
+    };
+
+    for (const auto &[input_text, expected_count] : test_cases) {
+        CAPTURE(input_text);
+        CHECK(core::text::estimate_tokens(input_text) == expected_count);
+    }
+}
+
+TEST_CASE("compute_stats counts characters, words, lines, sentences, and paragraphs", "[src][core][text.hpp]")
+{
+    const core::text::TextStats empty = core::text::compute_stats("");
+    CHECK(empty.characters == 0);
+    CHECK(empty.words == 0);
+    CHECK(empty.lines == 0);
+    CHECK(empty.sentences == 0);
+    CHECK(empty.paragraphs == 0);
+    CHECK(empty.average_word_length() == 0.0);
+
+    const core::text::TextStats stats = core::text::compute_stats("Hello world. How are you?\n\nZażółć gęślą!\r\nOK\n");
+    CHECK(stats.characters == 45);
+    CHECK(stats.non_ascii_characters == 7);
+    CHECK(stats.words == 8);
+    CHECK(stats.word_characters == 35);
+    CHECK(stats.lines == 5);
+    CHECK(stats.longest_line == 25);
+    CHECK(stats.sentences == 4);
+    CHECK(stats.paragraphs == 2);
+
+    // A final sentence needs no terminator, and a terminator at the very end is counted once
+    CHECK(core::text::compute_stats("No terminator").sentences == 1);
+    CHECK(core::text::compute_stats("Done.").sentences == 1);
+    CHECK(core::text::compute_stats("Wait... what?!  ").sentences == 2);
+    CHECK(core::text::compute_stats("東京です。大阪です。").sentences == 2);
+    CHECK(core::text::compute_stats("   \n\t").sentences == 0);
+}
+
+TEST_CASE("compute_stats agrees with the simple counters across block boundaries", "[src][core][text.hpp]")
+{
+    // Lengths around the 64-byte blocks, with multi-byte characters straddling them
+    std::string text;
+    for (std::size_t i = 0; i < 300; ++i) {
+        text += i % 7 == 0 ? "ż " : (i % 11 == 0 ? "\n" : "ab");
+        const core::text::TextStats stats = core::text::compute_stats(text);
+        CAPTURE(text);
+        CHECK(stats.words == core::text::count_words(text));
+        CHECK(stats.characters == core::text::count_characters(text));
+    }
+}
+
+TEST_CASE("compute_stats estimates the reading time", "[src][core][text.hpp]")
+{
+    CHECK(core::text::TextStats{.words = 0}.reading_time_seconds() == 0);
+    CHECK(core::text::TextStats{.words = 1}.reading_time_seconds() == 1);
+    CHECK(core::text::TextStats{.words = 238}.reading_time_seconds() == 60);
+    CHECK(core::text::TextStats{.words = 4, .word_characters = 18}.average_word_length() == 4.5);
+}
+
+TEST_CASE("compute_stats gives the same result on several threads", "[src][core][text.hpp]")
+{
+    // Paragraphs of several lines, so chunk boundaries fall inside paragraphs
+    std::string text;
+    while (text.size() < 2 * core::text::STATS_PARALLEL_THRESHOLD) {
+        text += "First line of a paragraph. Zażółć gęślą jaźń!\nSecond line, still the same one\n東京です。\n\n";
+    }
+    text += "Last sentence";
+
+    const core::text::TextStats serial = core::text::compute_stats(text, 1);
+    const core::text::TextStats parallel = core::text::compute_stats(text, 4);
+    CHECK(parallel.characters == serial.characters);
+    CHECK(parallel.non_ascii_characters == serial.non_ascii_characters);
+    CHECK(parallel.words == serial.words);
+    CHECK(parallel.word_characters == serial.word_characters);
+    CHECK(parallel.lines == serial.lines);
+    CHECK(parallel.longest_line == serial.longest_line);
+    CHECK(parallel.sentences == serial.sentences);
+    CHECK(parallel.paragraphs == serial.paragraphs);
+    CHECK(serial.words == core::text::count_words(text));
+}
+
+TEST_CASE("StatsCounter gives the same statistics for text split anywhere", "[src][core][text.hpp]")
+{
+    const std::string text = "Hello world. 東京です。\n\nZażółć gęślą!\nOK?\n  \nLast one";
+    const core::text::TextStats whole = core::text::compute_stats(text);
+    CHECK(whole.sentences == 5);
+    CHECK(whole.paragraphs == 3);
+    for (std::size_t split = 0; split <= text.size(); ++split) {
+        core::text::StatsCounter counter;
+        counter.add(std::string_view{text}.substr(0, split));
+        counter.add(std::string_view{text}.substr(split));
+        const core::text::TextStats stats = counter.stats();
+        CAPTURE(split);
+        CHECK(stats.characters == whole.characters);
+        CHECK(stats.words == whole.words);
+        CHECK(stats.word_characters == whole.word_characters);
+        CHECK(stats.lines == whole.lines);
+        CHECK(stats.longest_line == whole.longest_line);
+        CHECK(stats.sentences == whole.sentences);
+        CHECK(stats.paragraphs == whole.paragraphs);
+    }
+
+    // One byte at a time
+    core::text::StatsCounter counter;
+    for (const char byte : text) {
+        counter.add(std::string_view{&byte, 1});
+    }
+    CHECK(counter.stats().sentences == whole.sentences);
+    CHECK(counter.stats().paragraphs == whole.paragraphs);
+    CHECK(counter.stats().words == whole.words);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file thread_pool.test.cpp
+ */
+
+#include <atomic>     // for std::atomic
+#include <cstddef>    // for std::size_t
+#include <stdexcept>  // for std::runtime_error
+
+#include <snitch/snitch.hpp>
+
+#include "core/thread_pool.hpp"
+
+TEST_CASE("ThreadPool runs every submitted task", "[src][core][thread_pool.hpp]")
+{
+    core::thread_pool::ThreadPool pool{4};
+    CHECK(pool.size() == 4);
+
+    std::atomic<std::size_t> sum{0};
+    for (std::size_t i = 1; i <= 1000; ++i) {
+        pool.submit([&sum, i] { sum.fetch_add(i); });
+    }
+    pool.wait();
+    CHECK(sum.load() == 500500);
+
+    // The pool is reusable after waiting
+    pool.submit([&sum] { sum.store(0); });
+    pool.wait();
+    CHECK(sum.load() == 0);
+}
+
+TEST_CASE("ThreadPool rethrows the first task exception from wait", "[src][core][thread_pool.hpp]")
+{
+    core::thread_pool::ThreadPool pool{2};
+    std::atomic<std::size_t> completed{0};
+    pool.submit([] { throw std::runtime_error("task failed"); });
+    for (std::size_t i = 0; i < 10; ++i) {
+        pool.submit([&completed] { completed.fetch_add(1); });
+    }
+    CHECK_THROWS_AS(pool.wait(), std::runtime_error);
+    CHECK(completed.load() == 10);
+
+    // The exception is consumed by the first wait
+    pool.wait();
+}
+
+TEST_CASE("ThreadPool finishes queued tasks on destruction", "[src][core][thread_pool.hpp]")
+{
+    std::atomic<std::size_t> completed{0};
+    {
+        core::thread_pool::ThreadPool pool{3};
+        for (std::size_t i = 0; i < 100; ++i) {
+            pool.submit([&completed] { completed.fetch_add(1); });
+        }
+    }
+    CHECK(completed.load() == 100);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file utf8.test.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::pair
+#include <vector>       // for std::vector
+
+#include <snitch/snitch.hpp>
+
+#include "core/utf8.hpp"
+
+TEST_CASE("find_invalid accepts valid UTF-8", "[src][core][utf8.hpp]")
+{
+    static const std::string valid_texts[] = {
+        "",
+        "hello world",
+        "Zażółć gęślą jaźń",
+        "“quotes” — dashes… and emoji 😀",
+        "\xEF\xBB\xBF"             // Byte order mark
+        "\xED\x9F\xBF"             // U+D7FF, just below the surrogates
+        "\xEE\x80\x80"             // U+E000, just above the surrogates
+        "\xF4\x8F\xBF\xBF",        // U+10FFFF, the last code point
+        std::string(1000, 'a') + "é" + std::string(1000, 'b'),
+    };
+
+    for (const std::string &text : valid_texts) {
+        CAPTURE(text);
+        CHECK(core::utf8::find_invalid(text) == std::string_view::npos);
+        CHECK(core::utf8::is_valid(text));
+    }
+}
+
+TEST_CASE("find_invalid rejects malformed sequences", "[src][core][utf8.hpp]")
+{
+    static const std::pair<std::string, std::size_t> test_cases[] = {
+        {"\x80", 0},                  // Stray continuation byte
+        {"ab\xC3", 2},                // Truncated at the end
+        {"a\xC3x", 1},                // Missing continuation byte
+        {"\xC0\xAF", 0},              // Overlong "/"
+        {"\xE0\x80\xAF", 0},          // Overlong three-byte form
+        {"\xF0\x80\x80\xAF", 0},      // Overlong four-byte form
+        {"ok\xED\xA0\x80", 2},        // Surrogate U+D800
+        {"\xF4\x90\x80\x80", 0},      // Above U+10FFFF
+        {"\xF5\x80\x80\x80", 0},      // Lead byte that never occurs
+        {"\xFF", 0},                  // Lead byte that never occurs
+    };
+
+    for (const auto &[text, offset] : test_cases) {
+        CAPTURE(text);
+        CHECK(core::utf8::find_invalid(text) == offset);
+        CHECK_FALSE(core::utf8::is_valid(text));
+    }
+
+    // Past the SIMD blocks, and in the middle of a long ASCII run
+    const std::string long_text = std::string(100, 'a') + "é" + std::string(37, 'b') + "\xFF" + std::string(100, 'c');
+    CHECK(core::utf8::find_invalid(long_text) == 139);
+    CHECK(core::utf8::find_invalid(long_text, 140) == std::string_view::npos);
+}
+
+TEST_CASE("invalid_sequence_length returns the maximal subpart", "[src][core][utf8.hpp]")
+{
+    CHECK(core::utf8::invalid_sequence_length("\xE2\x80x", 0) == 2);
+    CHECK(core::utf8::invalid_sequence_length("\xF0\x9F\x98", 0) == 3);
+    CHECK(core::utf8::invalid_sequence_length("\xE0\x80\x80", 0) == 1);
+    CHECK(core::utf8::invalid_sequence_length("\x80\x80", 0) == 1);
+}
+
+TEST_CASE("find_invalid_sequences lists every invalid sequence", "[src][core][utf8.hpp]")
+{
+    CHECK(core::utf8::find_invalid_sequences("valid").empty());
+
+    const std::vector<std::size_t> offsets = core::utf8::find_invalid_sequences("a\xFF" "b\xE2\x80" "c\x80\x80");
+    REQUIRE(offsets.size() == 4);
+    CHECK(offsets[0] == 1);
+    CHECK(offsets[1] == 3);
+    CHECK(offsets[2] == 6);
+    CHECK(offsets[3] == 7);
+}
+
+TEST_CASE("repair replaces every invalid sequence with U+FFFD", "[src][core][utf8.hpp]")
+{
+    std::string valid_text = "Zażółć";
+    CHECK(core::utf8::repair(valid_text) == 0);
+    CHECK(valid_text == "Zażółć");
+
+    // One replacement per maximal subpart, following the Unicode Standard's recommended practice
+    std::string broken_text = "a\xF0\x9F\x98" "b\xC0\xAF" "c";
+    std::vector<std::size_t> offsets;
+    CHECK(core::utf8::repair(broken_text, &offsets) == 3);
+    CHECK(broken_text == "a�" "b��" "c");
+    CHECK(core::utf8::is_valid(broken_text));
+    REQUIRE(offsets.size() == 3);
+    CHECK(offsets[0] == 1);
+    CHECK(offsets[1] == 5);
+    CHECK(offsets[2] == 8);
+}
+
+TEST_CASE("find_invalid agrees with a byte-by-byte reference on random input", "[src][core][utf8.hpp]")
+{
+    // Reference: decode one sequence at a time with explicit code point checks
+    const auto reference = [](const std::string_view text) -> std::size_t {
+        std::size_t i = 0;
+        while (i < text.size()) {
+            const auto lead = static_cast<unsigned char>(text[i]);
+            const std::size_t length = lead < 0x80 ? 1 : (lead >= 0xC2 && lead < 0xE0) ? 2 : (lead >= 0xE0 && lead < 0xF0) ? 3 : (lead >= 0xF0 && lead < 0xF5) ? 4 : 0;
+            if (length == 0 || i + length > text.size()) {
+                return i;
+            }
+            auto code_point = static_cast<char32_t>(length == 1 ? lead : (lead & (0x7F >> length)));
+            for (std::size_t j = 1; j < length; ++j) {
+                const auto byte = static_cast<unsigned char>(text[i + j]);
+                if ((byte & 0xC0) != 0x80) {
+                    return i;
+                }
+                code_point = (code_point << 6) | (byte & 0x3F);
+            }
+            const char32_t minimum = length == 1 ? 0 : length == 2 ? 0x80 : length == 3 ? 0x800 : 0x10000;
+            if (code_point < minimum || code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+                return i;
+            }
+            i += length;
+        }
+        return std::string_view::npos;
+    };
+
+    // Valid text with mixed widths, long enough to cross many vector blocks, then a few random byte flips
+    const std::string base = "The “quick” fox — Zażółć 😀 jaźń, 日本語 and ASCII padding that spans a whole block.\n";
+    std::uint32_t state = 2024;
+    for (std::size_t round = 0; round < 2000; ++round) {
+        std::string text;
+        for (std::size_t i = 0; i < 1 + round % 5; ++i) {
+            text += base;
+        }
+        for (std::size_t flips = round % 4; flips > 0; --flips) {
+            state = state * 1664525u + 1013904223u;
+            const std::size_t position = (state >> 8) % text.size();
+            state = state * 1664525u + 1013904223u;
+            text[position] = static_cast<char>(state >> 24);
+        }
+        if (round % 7 == 0) {
+            text.resize(text.size() - (round % 3) - 1);  // Cut the last character in half
+        }
+        CHECK(core::utf8::find_invalid(text) == reference(text));
+    }
+}
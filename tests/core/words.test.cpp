@@ -0,0 +1,115 @@
+/**
+ * @file words.test.cpp
+ */
+
+#include <cstddef>      // for std::size_t
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <utility>      // for std::pair
+
+#include <snitch/snitch.hpp>
+
+#include "core/text.hpp"
+#include "core/words.hpp"
+
+namespace {
+
+/**
+ * @brief Count the words of a text with a single segmenter.
+ *
+ * @param text Text to count.
+ *
+ * @return Number of words.
+ */
+[[nodiscard]] std::size_t count_segmented_words(const std::string_view text)
+{
+    core::words::Segmenter segmenter;
+    segmenter.add(text);
+    return segmenter.count_words(core::text::count_words(text));
+}
+
+}  // namespace
+
+TEST_CASE("get_word_break classifies code points", "[src][core][words.hpp]")
+{
+    CHECK(core::words::get_word_break(U'a') == core::words::WordBreak::ALetter);
+    CHECK(core::words::get_word_break(U'ż') == core::words::WordBreak::ALetter);
+    CHECK(core::words::get_word_break(U'א') == core::words::WordBreak::HebrewLetter);
+    CHECK(core::words::get_word_break(U'7') == core::words::WordBreak::Numeric);
+    CHECK(core::words::get_word_break(U'東') == core::words::WordBreak::Ideographic);
+    CHECK(core::words::get_word_break(U'の') == core::words::WordBreak::Ideographic);
+    CHECK(core::words::get_word_break(U'カ') == core::words::WordBreak::Katakana);
+    CHECK(core::words::get_word_break(U'ー') == core::words::WordBreak::Katakana);
+    CHECK(core::words::get_word_break(U'ก') == core::words::WordBreak::ALetter);
+    CHECK(core::words::get_word_break(U'́') == core::words::WordBreak::Extend);
+    CHECK(core::words::get_word_break(U'　') == core::words::WordBreak::Space);
+    CHECK(core::words::get_word_break(U'。') == core::words::WordBreak::Other);
+    CHECK(core::words::get_word_break(U'\'') == core::words::WordBreak::SingleQuote);
+    CHECK(core::words::get_word_break(U'_') == core::words::WordBreak::ExtendNumLet);
+    CHECK(core::words::get_word_break(U'\U00020000') == core::words::WordBreak::Ideographic);
+    CHECK(core::words::get_word_break(U'\U0010FFFF') == core::words::WordBreak::Other);
+    CHECK(core::words::get_word_break(char32_t{0x110000}) == core::words::WordBreak::Other);
+}
+
+TEST_CASE("Segmenter splits runs of scripts written without spaces", "[src][core][words.hpp]")
+{
+    static const std::pair<std::string_view, std::size_t> test_cases[] = {
+        {"", 0},
+        {"Hello, world!", 2},
+        {"can't stop 3.14 e-mail", 4},
+        {"東京タワー", 3},
+        {"東京タワーに行きました。", 9},
+        {"私はJohnです", 5},
+        {"iPhone15を買った", 5},
+        {"「こんにちは」と言った", 9},
+        {"ソフトウェア_エンジニア", 1},
+        {"第3章、12.5ページ", 5},
+        {"中文。English text", 4},
+        {"hello　world", 2},
+        {"東京 大阪", 4},
+        {"。、！", 1},
+        {"ภาษาไทย", 1},
+        {"Zażółć gęślą jaźń", 3},
+        {"\xE6\x9D\xB1\xFF\xE4\xBA", 1},
+    };
+    for (const auto &[input_text, expected_count] : test_cases) {
+        CAPTURE(input_text);
+        CHECK(count_segmented_words(input_text) == expected_count);
+    }
+}
+
+TEST_CASE("Segmenter gives the same count for text split anywhere", "[src][core][words.hpp]")
+{
+    std::string text;
+    for (std::size_t i = 0; i < 12; ++i) {
+        text += "Plain ASCII words and a longer_identifier, then 東京タワーに行きました。iPhone15 ";
+        text += "Zażółć gęślą jaźń　全角スペース\n";
+    }
+    const std::size_t whole = count_segmented_words(text);
+    CHECK(whole == 12 * 23);
+    for (std::size_t split = 0; split <= text.size(); ++split) {
+        core::words::Segmenter segmenter;
+        segmenter.add(std::string_view{text}.substr(0, split));
+        segmenter.add(std::string_view{text}.substr(split));
+        CAPTURE(split);
+        CHECK(segmenter.count_words(core::text::count_words(text)) == whole);
+    }
+}
+
+TEST_CASE("compute_stats segments words only when asked to", "[src][core][words.hpp]")
+{
+    std::string text;
+    while (text.size() < 2 * core::text::STATS_PARALLEL_THRESHOLD) {
+        text += "東京タワーに行きました。\nPlain line with five words\n";
+    }
+    CHECK(core::text::compute_stats(text, 1).words == core::text::count_words(text));
+    const core::text::TextStats serial = core::text::compute_stats(text, 1, true);
+    CHECK(serial.words == count_segmented_words(text));
+    CHECK(core::text::compute_stats(text, 4, true).words == serial.words);
+
+    core::text::StatsCounter counter{true};
+    for (std::size_t offset = 0; offset < text.size(); offset += 1000) {
+        counter.add(std::string_view{text}.substr(offset, 1000));
+    }
+    CHECK(counter.stats().words == serial.words);
+}
@@ -0,0 +1,48 @@
+/**
+ * @file support.hpp
+ *
+ * @brief Helpers shared by the tests that work with real files.
+ */
+
+#pragma once
+
+#include <filesystem>   // for std::filesystem
+#include <fstream>      // for std::ofstream
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+
+namespace tests::support {
+
+/**
+ * @brief Create an empty directory below the system temporary directory, removing whatever a previous run left in it.
+ *
+ * @param name Name of the directory (e.g., "ungpt-batch-test").
+ *
+ * @return Path to the directory.
+ */
+[[nodiscard]] inline std::filesystem::path make_empty_directory(const std::string_view name)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+/**
+ * @brief Write bytes to a file below the system temporary directory.
+ *
+ * @param name Name of the file (e.g., "ungpt-encoding-test.txt").
+ * @param bytes Contents of the file.
+ *
+ * @return Path to the file.
+ */
+[[nodiscard]] inline std::filesystem::path write_temporary_file(const std::string_view name,
+                                                                const std::string &bytes)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::ofstream stream{path, std::ios::binary};
+    stream << bytes;
+    return path;
+}
+
+}  // namespace tests::support
@@ -0,0 +1,211 @@
+/**
+ * @file editor.test.cpp
+ */
+
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for std::size_t
+#include <cstdlib>     // for std::malloc, std::free
+#include <filesystem>  // for std::filesystem
+#include <fstream>     // for std::ofstream
+#include <new>         // for std::bad_alloc
+
+#include <imgui.h>
+#include <snitch/snitch.hpp>
+
+#include "ui/editor.hpp"
+
+namespace {
+
+/**
+ * @brief Number of heap allocations made through "operator new" or the ImGui allocator since the process started.
+ */
+std::atomic<std::size_t> allocation_count{0};
+
+/**
+ * @brief Number of frames drawn before counting, so ImGui and the editor can grow their buffers.
+ */
+constexpr int WARMUP_FRAMES = 10;
+
+/**
+ * @brief Number of idle frames whose allocations are counted.
+ */
+constexpr int MEASURED_FRAMES = 120;
+
+/**
+ * @brief Allocate memory and count the allocation.
+ *
+ * @param size Number of bytes to allocate.
+ *
+ * @return Pointer to the memory, or nullptr if it could not be allocated.
+ */
+[[nodiscard]] void *counted_malloc(const std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+/**
+ * @brief Allocate memory for ImGui and count the allocation.
+ *
+ * @param size Number of bytes to allocate.
+ * @param user_data Unused.
+ *
+ * @return Pointer to the memory.
+ */
+[[nodiscard]] void *imgui_alloc(const std::size_t size,
+                                void *user_data)
+{
+    static_cast<void>(user_data);
+    return counted_malloc(size);
+}
+
+/**
+ * @brief Free memory allocated by "imgui_alloc()".
+ *
+ * @param pointer Memory to free, may be nullptr.
+ * @param user_data Unused.
+ */
+void imgui_free(void *pointer,
+                void *user_data)
+{
+    static_cast<void>(user_data);
+    std::free(pointer);
+}
+
+/**
+ * @brief Headless ImGui context with a built font atlas, so frames can be drawn without a window or renderer.
+ */
+class HeadlessContext {
+  public:
+    /**
+     * @brief Create the context with the counting allocator, no INI or log file, and a 1280x720 display.
+     */
+    HeadlessContext()
+    {
+        ImGui::SetAllocatorFunctions(imgui_alloc, imgui_free, nullptr);
+        this->context_ = ImGui::CreateContext();
+        ImGuiIO &io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.LogFilename = nullptr;
+        io.DisplaySize = ImVec2(1280.0f, 720.0f);
+        io.DeltaTime = 1.0f / 60.0f;
+        unsigned char *pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    }
+
+    /**
+     * @brief Destroy the context.
+     */
+    ~HeadlessContext()
+    {
+        ImGui::DestroyContext(this->context_);
+    }
+
+    HeadlessContext(const HeadlessContext &) = delete;
+    HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+  private:
+    /**
+     * @brief Owned ImGui context.
+     */
+    ImGuiContext *context_;
+};
+
+/**
+ * @brief Draw one frame of the editor.
+ *
+ * @param editor Editor to draw.
+ */
+void draw_frame(ui::editor::Editor &editor)
+{
+    ImGui::NewFrame();
+    editor.update_and_draw();
+    ImGui::Render();
+}
+
+/**
+ * @brief Draw idle frames after warming up, counting the heap allocations they make.
+ *
+ * @param editor Editor to draw.
+ *
+ * @return Number of heap allocations made by the measured frames.
+ */
+[[nodiscard]] std::size_t count_idle_frame_allocations(ui::editor::Editor &editor)
+{
+    for (int i = 0; i < WARMUP_FRAMES; ++i) {
+        draw_frame(editor);
+    }
+    const std::size_t before = allocation_count.load(std::memory_order_relaxed);
+    for (int i = 0; i < MEASURED_FRAMES; ++i) {
+        draw_frame(editor);
+    }
+    return allocation_count.load(std::memory_order_relaxed) - before;
+}
+
+}  // namespace
+
+// Count every allocation in the test executable; the nothrow forms call these, and the editor uses no over-aligned types
+void *operator new(const std::size_t size)
+{
+    if (void *pointer = counted_malloc(size)) [[likely]] {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void *operator new[](const std::size_t size)
+{
+    if (void *pointer = counted_malloc(size)) [[likely]] {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer,
+                     const std::size_t size) noexcept
+{
+    static_cast<void>(size);
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer,
+                       const std::size_t size) noexcept
+{
+    static_cast<void>(size);
+    std::free(pointer);
+}
+
+TEST_CASE("update_and_draw does not allocate on idle frames", "[src][ui][editor.hpp]")
+{
+    const HeadlessContext context;
+    ui::editor::Editor editor;
+    CHECK(count_idle_frame_allocations(editor) == 0);
+}
+
+TEST_CASE("update_and_draw does not allocate on idle frames with text loaded", "[src][ui][editor.hpp]")
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "ungpt-editor-test.txt";
+    {
+        std::ofstream stream{path, std::ios::binary};
+        stream << "As an AI language model, I can’t “browse” the web\n"
+                  "Zażółć gęślą jaźń\n";
+    }
+
+    const HeadlessContext context;
+    ui::editor::Editor editor;
+    editor.open_file(path);
+    std::filesystem::remove(path);
+    CHECK(count_idle_frame_allocations(editor) == 0);
+}
@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""
+Generate "src/core/word_break_table.hpp", the word break classes used by "src/core/words.cpp".
+
+The classes follow the Word_Break property of UAX #29 (https://www.unicode.org/reports/tr29/), with two additions for counting words:
+    - Letters that UAX #29 leaves as "Other" are split by East Asian width: wide ones (e.g., Han, Hiragana) become "Ideographic", one word each; narrow ones (e.g., Thai, which needs a dictionary to be split) become "ALetter", so their runs stay together.
+    - Line breaks and the spaces of "WSegSpace" share a single "Space" class.
+Regional indicators are folded into "Other", as they never belong to a word.
+
+Usage:
+    1. Download and extract https://www.unicode.org/Public/UCD/latest/ucd/UCD.zip
+    2. Run: python3 tools/generate_word_break.py path/to/UCD > src/core/word_break_table.hpp
+"""
+
+import re
+import sys
+from pathlib import Path
+
+# Must match the order of "core::words::WordBreak"
+CLASSES = [
+    "Other",
+    "Space",
+    "Extend",
+    "ALetter",
+    "HebrewLetter",
+    "Numeric",
+    "Katakana",
+    "Ideographic",
+    "ExtendNumLet",
+    "MidLetter",
+    "MidNum",
+    "MidNumLet",
+    "SingleQuote",
+    "DoubleQuote",
+]
+
+# Word_Break values of the UCD, mapped to the classes above
+WORD_BREAK_CLASSES = {
+    "CR": "Space",
+    "LF": "Space",
+    "Newline": "Space",
+    "WSegSpace": "Space",
+    "Extend": "Extend",
+    "Format": "Extend",
+    "ZWJ": "Extend",
+    "ALetter": "ALetter",
+    "Hebrew_Letter": "HebrewLetter",
+    "Numeric": "Numeric",
+    "Katakana": "Katakana",
+    "ExtendNumLet": "ExtendNumLet",
+    "MidLetter": "MidLetter",
+    "MidNum": "MidNum",
+    "MidNumLet": "MidNumLet",
+    "Single_Quote": "SingleQuote",
+    "Double_Quote": "DoubleQuote",
+    "Regional_Indicator": "Other",
+    "Other": "Other",
+}
+
+CODE_POINT_COUNT = 0x110000
+
+# Code points per second-stage block; 128 keeps every block index in a byte
+BLOCK_SHIFT = 7
+BLOCK_SIZE = 1 << BLOCK_SHIFT
+
+LINE_PATTERN = re.compile(r"^([0-9A-F]+)(?:\.\.([0-9A-F]+))?\s*;\s*([A-Za-z_]+)")
+VERSION_PATTERN = re.compile(r"^#\s*\w+-(\d+\.\d+\.\d+)\.txt")
+
+
+def read_property(path, default):
+    """Return the version of a UCD file and the value of every code point."""
+    values = [default] * CODE_POINT_COUNT
+    version = None
+    with open(path, encoding="utf-8") as file:
+        for line in file:
+            if version is None and (match := VERSION_PATTERN.match(line)):
+                version = match.group(1)
+            if not (match := LINE_PATTERN.match(line)):
+                continue
+            first = int(match.group(1), 16)
+            last = int(match.group(2) or match.group(1), 16)
+            values[first : last + 1] = [match.group(3)] * (last - first + 1)
+    return version, values
+
+
+def classify(ucd):
+    """Return the version of the UCD and the class index of every code point."""
+    version, word_breaks = read_property(ucd / "auxiliary" / "WordBreakProperty.txt", "Other")
+    _, categories = read_property(ucd / "extracted" / "DerivedGeneralCategory.txt", "Cn")
+    _, widths = read_property(ucd / "EastAsianWidth.txt", "N")
+    classes = []
+    for word_break, category, width in zip(word_breaks, categories, widths):
+        name = WORD_BREAK_CLASSES[word_break]
+        if name == "Other" and word_break == "Other" and category.startswith("L"):
+            name = "Ideographic" if width in ("W", "F") else "ALetter"
+        classes.append(CLASSES.index(name))
+    return version, classes
+
+
+def build_tables(classes):
+    """Split the classes into deduplicated blocks of packed nibbles, and the index of the block of every code point."""
+    blocks = {}
+    packed = bytearray()
+    indices = []
+    for start in range(0, CODE_POINT_COUNT, BLOCK_SIZE):
+        block = bytes(classes[i] | (classes[i + 1] << 4) for i in range(start, start + BLOCK_SIZE, 2))
+        if block not in blocks:
+            blocks[block] = len(blocks)
+            packed += block
+        indices.append(blocks[block])
+    if len(blocks) > 256:
+        sys.exit(f"error: {len(blocks)} blocks do not fit into a byte index, decrease BLOCK_SHIFT")
+    return indices, packed
+
+
+def format_array(values, per_line=24):
+    """Format integers as the lines of a C++ initializer list."""
+    lines = []
+    for start in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(value) for value in values[start : start + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(f"usage: {sys.argv[0]} path/to/UCD > src/core/word_break_table.hpp")
+    version, classes = classify(Path(sys.argv[1]))
+    indices, packed = build_tables(classes)
+    print(f"""/**
+ * @file word_break_table.hpp
+ *
+ * @brief Word break class of every code point, as a two-stage table (Unicode {version}).
+ *
+ * @note Generated by "tools/generate_word_break.py"; do not edit.
+ */
+
+#pragma once
+
+#include <array>    // for std::array
+#include <cstdint>  // for std::uint8_t
+
+namespace core::words::table {{
+
+/**
+ * @brief Number of bits of a code point that select its entry inside a block.
+ */
+inline constexpr unsigned BLOCK_SHIFT = {BLOCK_SHIFT};
+
+/**
+ * @brief Index of the block of every run of "1 << BLOCK_SHIFT" code points.
+ */
+inline constexpr std::array<std::uint8_t, {len(indices)}> BLOCK_INDICES = {{
+{format_array(indices)}
+}};
+
+/**
+ * @brief Deduplicated blocks of classes ("WordBreak" values), two per byte with the lower code point in the low nibble.
+ */
+inline constexpr std::array<std::uint8_t, {len(packed)}> BLOCKS = {{
+{format_array(list(packed))}
+}};
+
+}}  // namespace core::words::table""")
+
+
+if __name__ == "__main__":
+    main()